@@ -106,6 +106,12 @@ namespace video
 		//! Supports geometry shaders
 		EVDF_GEOMETRY_SHADER,
 
+		//! Draws instances of a mesh buffer without setting up the material again
+		EVDF_INSTANCING,
+
+		//! Renders depth into ECF_R32F render targets and shadows geometry with it
+		EVDF_SHADOW_MAP,
+
 		//! Only used for counting the elements of this enum
 		EVDF_COUNT
 	};
@@ -30,9 +30,18 @@ namespace scene
 		//! Water Surface Scene Node
 		ESNT_WATER_SURFACE  = MAKE_IRR_ID('w','a','t','r'),
 
+		//! LOD Mesh Scene Node
+		ESNT_LOD_MESH       = MAKE_IRR_ID('l','m','s','h'),
+
+		//! Instanced Mesh Scene Node
+		ESNT_INSTANCED_MESH = MAKE_IRR_ID('i','m','s','h'),
+
 		//! Terrain Scene Node
 		ESNT_TERRAIN        = MAKE_IRR_ID('t','e','r','r'),
 
+		//! Terrain Scene Node with continuous LOD and vertex morphing
+		ESNT_MORPHING_TERRAIN = MAKE_IRR_ID('m','t','e','r'),
+
 		//! Sky Box Scene Node
 		ESNT_SKY_BOX        = MAKE_IRR_ID('s','k','y','_'),
 
@@ -67,6 +67,9 @@ public:
 	virtual bool existsAttribute(const c8* attributeName) = 0;
 
 	//! Returns attribute index from name, -1 if not found
+	/** The index can be used as a handle with the index based getters
+	and setters, which need no name lookup. It stays valid until an
+	attribute is removed or the attributes are cleared. */
 	virtual s32 findAttribute(const c8* attributeName) = 0;
 
 	//! Removes all attributes
@@ -13,6 +13,7 @@
 #include "EGUIElementTypes.h"
 #include "EGUIAlignment.h"
 #include "IAttributes.h"
+#include "IGUIEnvironment.h"
 
 namespace irr
 {
@@ -32,7 +33,8 @@ public:
 		: Parent(0), RelativeRect(rectangle), AbsoluteRect(rectangle),
 		AbsoluteClippingRect(rectangle), DesiredRect(rectangle),
 		MaxSize(0,0), MinSize(1,1), IsVisible(true), IsEnabled(true),
-		IsSubElement(false), NoClip(false), ID(id), IsTabStop(false), TabOrder(-1), IsTabGroup(false),
+		IsSubElement(false), NoClip(false), IsRenderCached(false), IsDirty(true),
+		ID(id), IsTabStop(false), TabOrder(-1), IsTabGroup(false),
 		AlignLeft(EGUIA_UPPERLEFT), AlignRight(EGUIA_UPPERLEFT), AlignTop(EGUIA_UPPERLEFT), AlignBottom(EGUIA_UPPERLEFT),
 		Environment(environment), Type(type)
 	{
@@ -217,6 +219,7 @@ public:
 	virtual void updateAbsolutePosition()
 	{
 		recalculateAbsolutePosition(false);
+		invalidate();
 
 		// update all children
 		core::list<IGUIElement*>::Iterator it = Children.begin();
@@ -295,6 +298,7 @@ public:
 				(*it)->Parent = 0;
 				(*it)->drop();
 				Children.erase(it);
+				invalidate();
 				return;
 			}
 	}
@@ -315,7 +319,12 @@ public:
 		{
 			core::list<IGUIElement*>::Iterator it = Children.begin();
 			for (; it != Children.end(); ++it)
-				(*it)->draw();
+			{
+				if ((*it)->IsRenderCached && Environment)
+					Environment->drawCachedElement(*it);
+				else
+					(*it)->draw();
+			}
 		}
 	}
 
@@ -350,10 +359,80 @@ public:
 	//! Sets the visible state of this element.
 	virtual void setVisible(bool visible)
 	{
+		if (IsVisible != visible)
+			invalidate();
 		IsVisible = visible;
 	}
 
 
+	//! Sets whether this element and its children are drawn from a cached layer.
+	/** A render cached element is drawn into a render target texture,
+	which is copied to the screen in the following frames until the
+	element or one of its children is invalidated. Use this for static
+	parts of the user interface like panels, toolbars or windows which
+	rarely change. The layer has the size of the element, so children
+	drawing outside of it are cut off. Has no effect if the driver does
+	not support render targets. */
+	void setRenderCached(bool cached)
+	{
+		IsRenderCached = cached;
+		invalidate();
+	}
+
+
+	//! Returns true if this element is drawn from a cached layer.
+	bool isRenderCached() const
+	{
+		_IRR_IMPLEMENT_MANAGED_MARSHALLING_BUGFIX;
+		return IsRenderCached;
+	}
+
+
+	//! Marks this element as changed.
+	/** Cached layers containing this element are redrawn in the next
+	frame. Position, visibility, text, children and user input already
+	invalidate an element, other changes in the look of an element must
+	be reported by calling this method. */
+	void invalidate()
+	{
+		IGUIElement* e = this;
+		while (e)
+		{
+			e->IsDirty = true;
+			e = e->Parent;
+		}
+	}
+
+
+	//! Returns true if the element was invalidated since it was drawn into its cached layer.
+	bool isDirty() const
+	{
+		return IsDirty;
+	}
+
+
+	//! Marks this element as unchanged.
+	/** Called by the environment after redrawing a cached layer. */
+	void clearDirty()
+	{
+		IsDirty = false;
+	}
+
+
+	//! Moves the absolute rectangles of this element and its children without changing the layout.
+	/** Used by the environment to draw cached layers at the origin of
+	their texture. */
+	void offsetAbsolutePosition(const core::position2di& offset)
+	{
+		AbsoluteRect += offset;
+		AbsoluteClippingRect += offset;
+
+		core::list<IGUIElement*>::Iterator it = Children.begin();
+		for (; it != Children.end(); ++it)
+			(*it)->offsetAbsolutePosition(offset);
+	}
+
+
 	//! Returns true if this element was created as part of its parent control
 	virtual bool isSubElement() const
 	{
@@ -465,6 +544,8 @@ public:
 	//! Sets the enabled state of this element.
 	virtual void setEnabled(bool enabled)
 	{
+		if (IsEnabled != enabled)
+			invalidate();
 		IsEnabled = enabled;
 	}
 
@@ -473,6 +554,7 @@ public:
 	virtual void setText(const wchar_t* text)
 	{
 		Text = text;
+		invalidate();
 	}
 
 
@@ -529,6 +611,7 @@ public:
 			{
 				Children.erase(it);
 				Children.push_back(element);
+				invalidate();
 				return true;
 			}
 		}
@@ -728,6 +811,7 @@ public:
 		out->addBool("TabGroup", IsTabGroup);
 		out->addInt("TabOrder", TabOrder);
 		out->addBool("NoClip", NoClip);
+		out->addBool("RenderCached", IsRenderCached);
 	}
 
 
@@ -758,6 +842,7 @@ public:
 		setRelativePosition(in->getAttributeAsRect("Rect"));
 
 		setNotClipped(in->getAttributeAsBool("NoClip"));
+		setRenderCached(in->getAttributeAsBool("RenderCached"));
 	}
 
 protected:
@@ -771,6 +856,7 @@ protected:
 			child->LastParentRect = getAbsolutePosition();
 			child->Parent = this;
 			Children.push_back(child);
+			invalidate();
 		}
 	}
 
@@ -945,6 +1031,12 @@ protected:
 	//! does this element ignore its parent's clipping rectangle?
 	bool NoClip;
 
+	//! is this element drawn from a cached layer?
+	bool IsRenderCached;
+
+	//! was this element changed since its cached layer was drawn?
+	bool IsDirty;
+
 	//! caption
 	core::stringw Text;
 
@@ -8,6 +8,7 @@
 #include "IReferenceCounted.h"
 #include "IGUISkin.h"
 #include "rect.h"
+#include "irrArray.h"
 #include "EMessageBoxFlags.h"
 #include "IEventReceiver.h"
 #include "IXMLReader.h"
@@ -68,6 +69,23 @@ public:
 	//! Draws all gui elements by traversing the GUI environment starting at the root node.
 	virtual void drawAll() = 0;
 
+	//! Draws an element from its cached layer.
+	/** Called by IGUIElement::draw() for children with
+	IGUIElement::isRenderCached() set. The layer is redrawn first if the
+	element was invalidated since the last frame.
+	\param element Element to draw. */
+	virtual void drawCachedElement(IGUIElement* element) = 0;
+
+	//! Get the screen rectangles which were redrawn by the last call to drawAll().
+	/** Contains the top level elements without cached layer and all
+	cached layers which had to be redrawn. Cached layers which were only
+	copied to the screen are not included. */
+	virtual const core::array<core::rect<s32> >& getRedrawRectangles() const = 0;
+
+	//! Get the number of pixels redrawn by the last call to drawAll().
+	/** This is the sum of the areas of getRedrawRectangles(). */
+	virtual u32 getRedrawArea() const = 0;
+
 	//! Sets the focus to an element.
 	/** Causes a EGET_ELEMENT_FOCUS_LOST event followed by a
 	EGET_ELEMENT_FOCUSED event. If someone absorbed either of the events,
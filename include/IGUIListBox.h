@@ -30,6 +30,34 @@ namespace gui
 	};
 
 
+	//! Supplies the items of a list box which doesn't store them itself
+	/** Set with IGUIListBox::setDataSource(). The list box only asks
+	for the items it currently displays, so the cost of drawing doesn't
+	depend on the number of items. */
+	class IGUIListBoxDataSource : public virtual IReferenceCounted
+	{
+	public:
+
+		//! Returns the number of items.
+		virtual u32 getItemCount() const = 0;
+
+		//! Called before a range of items is requested.
+		/** Can be used to fetch the visible items in one go.
+		\param firstItem Index of the first item which will be requested.
+		\param itemCount Number of items which will be requested. */
+		virtual void prepareItems(u32 firstItem, u32 itemCount) {}
+
+		//! Returns the text of an item.
+		virtual const wchar_t* getItemText(u32 index) const = 0;
+
+		//! Returns the icon of an item, an index into the sprite bank of the list box, or -1.
+		virtual s32 getItemIcon(u32 index) const
+		{
+			return -1;
+		}
+	};
+
+
 	//! Default list box GUI element.
 	class IGUIListBox : public IGUIElement
 	{
@@ -120,6 +148,16 @@ namespace gui
 
 		//! Sets whether to draw the background
 		virtual void setDrawBackground(bool draw) = 0;
+
+		//! Sets a data source which supplies the items instead of the list box.
+		/** While a data source is set, the items added to the list box
+		are ignored. getItemCount(), getListItem() and getIcon() ask the
+		data source, and the override colors have no effect.
+		\param source The data source, or 0 to show the items of the list box again. */
+		virtual void setDataSource(IGUIListBoxDataSource* source) = 0;
+
+		//! Returns the data source set with setDataSource(), or 0.
+		virtual IGUIListBoxDataSource* getDataSource() const = 0;
 };
 
 
@@ -80,6 +80,41 @@ namespace gui
 		EGTDF_COUNT
 	};
 
+	//! Supplies the rows of a table which doesn't store them itself
+	/** Set with IGUITable::setDataSource(). The table only asks for
+	the rows it currently displays, so the cost of drawing doesn't
+	depend on the number of rows. */
+	class IGUITableDataSource : public virtual IReferenceCounted
+	{
+	public:
+
+		//! Returns the number of rows.
+		virtual u32 getRowCount() const = 0;
+
+		//! Called before the cells of a range of rows are requested.
+		/** Can be used to fetch the visible rows in one go.
+		\param firstRow Index of the first row which will be requested.
+		\param rowCount Number of rows which will be requested. */
+		virtual void prepareRows(u32 firstRow, u32 rowCount) {}
+
+		//! Returns the text of a cell.
+		virtual const wchar_t* getCellText(u32 rowIndex, u32 columnIndex) const = 0;
+
+		//! Returns the color of a cell.
+		/** \return False to use the default text color of the skin. */
+		virtual bool getCellColor(u32 rowIndex, u32 columnIndex, video::SColor& color) const
+		{
+			return false;
+		}
+
+		//! Orders the rows by a column.
+		/** Called when a column header with an ordering mode other than
+		EGCO_NONE and EGCO_CUSTOM is clicked, or by IGUITable::orderRows().
+		The data source should use a stable sort, so rows with the same
+		text keep the order of the last sorting. */
+		virtual void orderRows(u32 columnIndex, EGUI_ORDERING_MODE mode) {}
+	};
+
 	//! Default list box GUI element.
 	class IGUITable : public IGUIElement
 	{
@@ -187,6 +222,16 @@ namespace gui
 
 		//! Get the flags, as defined in EGUI_TABLE_DRAW_FLAGS, which influence the layout
 		virtual s32 getDrawFlags() const = 0;
+
+		//! Sets a data source which supplies the rows instead of the table.
+		/** While a data source is set, the rows added to the table are
+		ignored, and setting the cell texts, colors and data has no effect.
+		getRowCount() and getCellText() ask the data source.
+		\param source The data source, or 0 to show the rows of the table again. */
+		virtual void setDataSource(IGUITableDataSource* source) = 0;
+
+		//! Returns the data source set with setDataSource(), or 0.
+		virtual IGUITableDataSource* getDataSource() const = 0;
 	};
 
 
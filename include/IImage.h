@@ -54,6 +54,18 @@ enum ECOLOR_FORMAT
 	//! 128 bit floating point format. 32 bits are used for the red, green, blue and alpha channels.
 	ECF_A32B32G32R32F,
 
+	/** Block compressed formats. Blocks of 4x4 pixels are stored row by
+	row, the pitch of such an image is the size of one row of blocks. */
+
+	//! DXT1 (BC1), 64 bit per block, 1 bit alpha.
+	ECF_DXT1,
+
+	//! DXT3 (BC2), 128 bit per block, explicit 4 bit alpha.
+	ECF_DXT3,
+
+	//! DXT5 (BC3), 128 bit per block, interpolated alpha.
+	ECF_DXT5,
+
 	//! Unknown color format:
 	ECF_UNKNOWN
 };
@@ -167,11 +179,40 @@ public:
 			return 64;
 		case ECF_A32B32G32R32F:
 			return 128;
+		case ECF_DXT1:
+			return 4;
+		case ECF_DXT3:
+			return 8;
+		case ECF_DXT5:
+			return 8;
 		default:
 			return 0;
 		}
 	}
 
+	//! test if the color format stores blocks of 4x4 pixels
+	static bool isCompressedFormat(const ECOLOR_FORMAT format)
+	{
+		switch(format)
+		{
+			case ECF_DXT1:
+			case ECF_DXT3:
+			case ECF_DXT5:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	//! get the size in bytes of an image with the given color format and size
+	/** Compressed formats round the size up to whole blocks. */
+	static u32 getDataSizeFromFormat(const ECOLOR_FORMAT format, u32 width, u32 height)
+	{
+		if (isCompressedFormat(format))
+			return ((width+3)/4) * ((height+3)/4) * getBitsPerPixelFromFormat(format) * 2;
+		return width * height * getBitsPerPixelFromFormat(format) / 8;
+	}
+
 	//! test if the color format is only viable for RenderTarget textures
 	/** Since we don't have support for e.g. floating point IImage formats
 	one should test if the color format can be used for arbitrary usage, or
@@ -184,6 +225,9 @@ public:
 			case ECF_R5G6B5:
 			case ECF_R8G8B8:
 			case ECF_A8R8G8B8:
+			case ECF_DXT1:
+			case ECF_DXT3:
+			case ECF_DXT5:
 				return false;
 			default:
 				return true;
@@ -43,6 +43,23 @@ public:
 	/** \param file File handle to check.
 	\return Pointer to newly created image, or 0 upon error. */
 	virtual IImage* loadImage(io::IReadFile* file) const = 0;
+
+	//! Creates a surface from the file, at a reduced size if the format allows it
+	/** Formats like JPEG can be decoded at a fraction of their size
+	much faster than at full size, which helps when only a thumbnail or a
+	small mip level is needed. Loaders which can't do this return the
+	full image, so the result still has to be scaled by the caller.
+	Loaders may be called from several threads at once, see
+	IVideoDriver::createImagesFromFiles().
+	\param file File handle to check.
+	\param minSize Smallest size the image is needed at. The returned
+	image is at least this large in both directions, unless the file
+	itself is smaller. A zero dimension requests the full size.
+	\return Pointer to newly created image, or 0 upon error. */
+	virtual IImage* loadImage(io::IReadFile* file, const core::dimension2d<u32>& minSize) const
+	{
+		return loadImage(file);
+	}
 };
 
 
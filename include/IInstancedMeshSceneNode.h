@@ -0,0 +1,72 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_INSTANCED_MESH_SCENE_NODE_H_INCLUDED__
+#define __I_INSTANCED_MESH_SCENE_NODE_H_INCLUDED__
+
+#include "IMeshSceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! A scene node displaying many copies of a static mesh
+/** Each instance has its own transformation relative to the node and a
+color which is multiplied with the vertex colors. All visible instances
+of a mesh buffer are drawn with one call to
+video::IVideoDriver::drawMeshBufferInstanced(), so thousands of instances
+cost about as much setup as a single mesh scene node. Instances outside
+the view frustum are skipped. */
+class IInstancedMeshSceneNode : public IMeshSceneNode
+{
+public:
+
+	//! Constructor
+	IInstancedMeshSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1,1,1))
+		: IMeshSceneNode(parent, mgr, id, position, rotation, scale) {}
+
+	//! Adds an instance of the mesh.
+	/** \param transform Transformation of the instance relative to the node.
+	\param color Color multiplied with the vertex colors of the instance.
+	\return Index of the new instance. */
+	virtual u32 addInstance(const core::matrix4& transform,
+			video::SColor color=video::SColor(255,255,255,255)) = 0;
+
+	//! Removes an instance.
+	/** The last instance takes the index of the removed one.
+	\param index Index of the instance to remove. */
+	virtual void removeInstance(u32 index) = 0;
+
+	//! Removes all instances.
+	virtual void removeAllInstances() = 0;
+
+	//! Get the number of instances.
+	virtual u32 getInstanceCount() const = 0;
+
+	//! Sets the transformation of an instance, relative to the node.
+	virtual void setInstanceTransformation(u32 index, const core::matrix4& transform) = 0;
+
+	//! Get the transformation of an instance, relative to the node.
+	virtual const core::matrix4& getInstanceTransformation(u32 index) const = 0;
+
+	//! Sets the color of an instance.
+	virtual void setInstanceColor(u32 index, video::SColor color) = 0;
+
+	//! Get the color of an instance.
+	virtual video::SColor getInstanceColor(u32 index) const = 0;
+
+	//! Get the number of instances drawn in the last frame.
+	virtual u32 getVisibleInstanceCount() const = 0;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+
+#endif
+
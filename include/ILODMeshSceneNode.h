@@ -0,0 +1,69 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __I_LOD_MESH_SCENE_NODE_H_INCLUDED__
+#define __I_LOD_MESH_SCENE_NODE_H_INCLUDED__
+
+#include "IMeshSceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! A scene node displaying one of several levels of detail of a static mesh
+/** Each level has a geometric error, an estimate of the distance of its
+surface to the original mesh in object space. Each frame the coarsest level is
+chosen whose error, projected to the screen at the distance of the node,
+is below the maximal screen space error. A coarser level is only chosen
+once it is clearly good enough, so the node does not flicker between
+two levels at the border of their ranges.
+The levels are either generated with IMeshManipulator::createMeshSimplified()
+by generateLevels(), or prepared offline and added with addLevel(). The
+mesh set with setMesh() is always the first, most detailed level. */
+class ILODMeshSceneNode : public IMeshSceneNode
+{
+public:
+
+	//! Constructor
+	ILODMeshSceneNode(ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1,1,1))
+		: IMeshSceneNode(parent, mgr, id, position, rotation, scale) {}
+
+	//! Replaces all coarser levels by simplified versions of the first level.
+	/** \param levelCount Number of levels including the first one.
+	Fewer levels are created if the mesh can't be simplified further.
+	\param ratio Fraction of the triangles kept from one level to the next. */
+	virtual void generateLevels(u32 levelCount, f32 ratio=0.5f) = 0;
+
+	//! Appends a coarser level.
+	/** \param mesh Mesh of the level. It must have the same mesh buffers
+	with the same materials as the first level.
+	\param error Largest distance of the level to the original mesh,
+	in object space. */
+	virtual void addLevel(IMesh* mesh, f32 error) = 0;
+
+	//! Get the number of levels, including the first one.
+	virtual u32 getLevelCount() const = 0;
+
+	//! Get the level used for the last frame, 0 is the most detailed one.
+	virtual u32 getCurrentLevel() const = 0;
+
+	//! Sets the screen space error up to which coarser levels are used.
+	/** \param pixels Largest projected error in pixels. The default
+	value is 1.0f. */
+	virtual void setMaxScreenError(f32 pixels) = 0;
+
+	//! Get the screen space error up to which coarser levels are used.
+	virtual f32 getMaxScreenError() const = 0;
+};
+
+} // end namespace scene
+} // end namespace irr
+
+
+#endif
+
@@ -135,10 +135,14 @@ namespace scene
 		virtual void setHardwareMappingHint( E_HARDWARE_MAPPING newMappingHint, E_BUFFER_TYPE buffer=EBT_VERTEX_AND_INDEX ) = 0;
 
 		//! flags the meshbuffer as changed, reloads hardware buffers
+		/** Has to be called after changing vertices or indices, also
+		by meshes which animate their buffers, so hardware buffers and
+		shadow volumes pick up the change. */
 		virtual void setDirty(E_BUFFER_TYPE buffer=EBT_VERTEX_AND_INDEX) = 0;
 
 		//! Get the currently used ID for identification of changes.
-		/** This shouldn't be used for anything outside the VideoDriver. */
+		/** This shouldn't be used for anything outside the engine. The
+		video driver and shadow volumes use it to find changed buffers. */
 		virtual u32 getChangedID_Vertex() const = 0;
 
 		//! Get the currently used ID for identification of changes.
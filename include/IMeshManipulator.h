@@ -220,6 +220,33 @@ namespace scene
 		IReferenceCounted::drop() for more information. */
 		virtual IMesh* createMeshWelded(IMesh* mesh, f32 tolerance=core::ROUNDING_ERROR_f32) const = 0;
 
+		//! Creates a copy of a mesh with fewer triangles
+		/** Edges are collapsed in the order of the smallest quadric
+		error (the squared distance to the planes of the original
+		triangles around a vertex), until the requested number of
+		triangles or the maximal error is reached. Collapses are only
+		done onto existing vertices, so all vertex attributes are kept.
+		Vertices sharing their position with others, like on texture
+		seams, are never removed, and open borders are kept in place.
+		Each mesh buffer is simplified separately and keeps its
+		material, even if no triangles are left.
+		\param mesh Input mesh
+		\param ratio Fraction of the triangles to keep, between 0 and 1.
+		\param maxError Largest allowed error of a collapse, in the units
+		of the mesh. The error of a collapse is the root mean square
+		distance of the moved vertex to the planes of the original
+		triangles around both vertices.
+		\param error If not 0, receives the largest error of all done
+		collapses, measured like maxError. Being a root mean square, it
+		estimates but does not bound the distance to the original
+		surface. It can be used to select the level of detail by screen
+		space error.
+		\return Simplified mesh. If you no longer need the mesh, you
+		should call IMesh::drop(). See IReferenceCounted::drop() for
+		more information. */
+		virtual IMesh* createMeshSimplified(IMesh* mesh, f32 ratio,
+			f32 maxError=FLT_MAX, f32* error=0) const = 0;
+
 		//! Get amount of polygons in mesh.
 		/** \param mesh Input mesh
 		\return Number of polygons in mesh. */
@@ -42,6 +42,18 @@ namespace io
 		//! Get name of file.
 		/** \return File name as zero terminated character string. */
 		virtual const io::path& getFileName() const = 0;
+
+		//! Get the whole content of the file, if it is available in memory.
+		/** Memory files and memory mapped files return their bytes here,
+		so loaders can parse them in place instead of reading a copy into
+		their own buffer. The content is not zero terminated and stays valid
+		until the file is dropped. The file position is not changed.
+		\return Pointer to getSize() bytes, or 0 if the file has to be
+		read with read(). */
+		virtual const void* getMappedData() const
+		{
+			return 0;
+		}
 	};
 
 	//! Internal function, please do not use.
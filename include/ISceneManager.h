@@ -17,6 +17,7 @@
 #include "ESceneNodeAnimatorTypes.h"
 #include "EMeshWriterEnums.h"
 #include "SceneParameters.h"
+#include "SLightmapBakeParameters.h"
 #include "IGeometryCreator.h"
 #include "ISkinnedMesh.h"
 
@@ -45,6 +46,7 @@ namespace video
 	class SMaterial;
 	class IImage;
 	class ITexture;
+	struct SLight;
 } // end namespace video
 
 namespace scene
@@ -109,6 +111,8 @@ namespace scene
 	class IBillboardSceneNode;
 	class ITerrainSceneNode;
 	class IMeshSceneNode;
+	class ILODMeshSceneNode;
+	class IInstancedMeshSceneNode;
 	class IMeshLoader;
 	class ISceneCollisionManager;
 	class IParticleSystemSceneNode;
@@ -470,6 +474,51 @@ namespace scene
 			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
 			bool alsoAddIfMeshPointerZero=false) = 0;
 
+		//! Adds a scene node for rendering a static mesh with several levels of detail.
+		/** The coarser levels are generated with
+		IMeshManipulator::createMeshSimplified(), each one with half the
+		triangles of the previous one. See ILODMeshSceneNode for details.
+		\param mesh: Pointer to the loaded static mesh to be displayed.
+		\param levelCount: Number of levels including the original mesh.
+		\param maxScreenError: Largest projected error of a level in pixels
+		up to which it is used.
+		\param parent: Parent of the scene node. Can be NULL if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\param position: Position of the space relative to its parent where the
+		scene node will be placed.
+		\param rotation: Initital rotation of the scene node.
+		\param scale: Initial scale of the scene node.
+		\param alsoAddIfMeshPointerZero: Add the scene node even if a 0 pointer is passed.
+		\return Pointer to the created scene node.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual ILODMeshSceneNode* addLODMeshSceneNode(IMesh* mesh, u32 levelCount=4,
+			f32 maxScreenError=1.f, ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
+			bool alsoAddIfMeshPointerZero=false) = 0;
+
+		//! Adds a scene node for rendering many instances of a static mesh.
+		/** Use IInstancedMeshSceneNode::addInstance() to place the
+		instances. All visible instances of a mesh buffer are drawn with
+		one call to video::IVideoDriver::drawMeshBufferInstanced().
+		\param mesh: Pointer to the loaded static mesh to be displayed.
+		\param parent: Parent of the scene node. Can be NULL if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\param position: Position of the space relative to its parent where the
+		scene node will be placed.
+		\param rotation: Initital rotation of the scene node.
+		\param scale: Initial scale of the scene node.
+		\param alsoAddIfMeshPointerZero: Add the scene node even if a 0 pointer is passed.
+		\return Pointer to the created scene node.
+		This pointer should not be dropped. See IReferenceCounted::drop() for more information. */
+		virtual IInstancedMeshSceneNode* addInstancedMeshSceneNode(IMesh* mesh,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
+			bool alsoAddIfMeshPointerZero=false) = 0;
+
 		//! Adds a scene node for rendering a animated water surface mesh.
 		/** Looks really good when the Material type EMT_TRANSPARENT_REFLECTION
 		is used.
@@ -857,6 +906,64 @@ namespace scene
 			s32 maxLOD=5, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17, s32 smoothFactor=0,
 			bool addAlsoIfHeightmapEmpty = false) = 0;
 
+		//! Adds a terrain scene node with continuous level of detail to the scene graph.
+		/** The heightmap is loaded like in addTerrainSceneNode(), but
+		the terrain is drawn from a quadtree of chunks using CDLOD
+		(continuous distance dependent level of detail). Each level of
+		the quadtree is used in a distance range where one of its grid
+		edges appears at most screenSpaceError pixels long, and the
+		vertices smoothly morph into the next coarser level before it
+		takes over. This avoids the popping and the wasted triangles
+		at the patch borders of the geo mip map terrain, and bounds the
+		number of triangles independently of the size of the terrain,
+		which directly sets the frame time of the software renderers.
+		The morphing is done on the CPU each time the camera moves, so
+		it works with all drivers.
+		\param heightMapFileName: The name of the file on disk, to read vertex data from. This should
+		be a gray scale bitmap.
+		\param parent: Parent of the scene node. Can be 0 if no parent.
+		\param id: Id of the node. This id can be used to identify the scene node.
+		\param position: The absolute position of this node.
+		\param rotation: The absolute rotation of this node. ( NOT YET IMPLEMENTED )
+		\param scale: The scale factor for the terrain.
+		\param vertexColor: The default color of all the vertices.
+		\param screenSpaceError: Length of a grid edge in pixels at
+		which the next coarser level is used. Smaller values give more
+		triangles. Can be changed later with the "ScreenSpaceError"
+		attribute.
+		\param patchSize: Size of the chunks, which is also the size
+		of the patches of the triangle selector.
+		\param smoothFactor: The number of times the vertices are smoothed.
+		\param addAlsoIfHeightmapEmpty: Add terrain node even with empty heightmap.
+		\return Pointer to the created scene node. Can be null
+		if the terrain could not be created, for example because the
+		heightmap could not be loaded. The returned pointer should
+		not be dropped. See IReferenceCounted::drop() for more
+		information. */
+		virtual ITerrainSceneNode* addMorphingTerrainSceneNode(
+			const io::path& heightMapFileName,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0.0f,0.0f,0.0f),
+			const core::vector3df& rotation = core::vector3df(0.0f,0.0f,0.0f),
+			const core::vector3df& scale = core::vector3df(1.0f,1.0f,1.0f),
+			video::SColor vertexColor = video::SColor(255,255,255,255),
+			f32 screenSpaceError=4.f, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17,
+			s32 smoothFactor=0, bool addAlsoIfHeightmapEmpty = false) = 0;
+
+		//! Adds a terrain scene node with continuous level of detail to the scene graph.
+		/** Just like the other addMorphingTerrainSceneNode() method,
+		but takes an IReadFile pointer as parameter for the heightmap.
+		For more informations take a look at the other function. */
+		virtual ITerrainSceneNode* addMorphingTerrainSceneNode(
+			io::IReadFile* heightMapFile,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0.0f,0.0f,0.0f),
+			const core::vector3df& rotation = core::vector3df(0.0f,0.0f,0.0f),
+			const core::vector3df& scale = core::vector3df(1.0f,1.0f,1.0f),
+			video::SColor vertexColor = video::SColor(255,255,255,255),
+			f32 screenSpaceError=4.f, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17,
+			s32 smoothFactor=0, bool addAlsoIfHeightmapEmpty = false) = 0;
+
 		//! Adds a quake3 scene node to the scene graph.
 		/** A Quake3 Scene renders multiple meshes for a specific HighLanguage Shader (Quake3 Style )
 		\return Pointer to the quake3 scene node if successful, otherwise NULL.
@@ -1308,6 +1415,32 @@ namespace scene
 		virtual ITriangleSelector* createTerrainTriangleSelector(
 			ITerrainSceneNode* node, s32 LOD=0) = 0;
 
+		//! Bakes the lighting of a mesh into a lightmap.
+		/** The triangles are grouped into charts of connected triangles
+		facing about the same axis, which are projected along that axis
+		and packed into one lightmap texture. Each texel is lit by the
+		given lights with Lambert's law, the usual attenuation and the
+		cones of spot lights, shadowed by rays against the occluders. The
+		ambient light is darkened by ambient occlusion. Rays are traced
+		on all processors. The new mesh keeps the materials, vertices
+		and first texture coordinates of the original one, and draws the
+		lightmap as second texture instead of dynamic lighting.
+		\param mesh: Mesh to bake, in its own coordinate system.
+		\param transform: Transformation of the mesh into world space,
+		usually ISceneNode::getAbsoluteTransformation().
+		\param lights: Lights in world space, for example the
+		ILightSceneNode::getLightData() of the light scene nodes.
+		\param occluders: Triangles which cast shadows, in world space,
+		for example a meta triangle selector of all static scene nodes.
+		If 0, the mesh shadows itself.
+		\param parameters: Size and quality of the lightmap.
+		\return Mesh of S3DVertex2TCoords vertices, or null if it has no
+		triangles. If you no longer need the mesh, you should call
+		IMesh::drop(). See IReferenceCounted::drop() for more information. */
+		virtual IMesh* createLightmappedMesh(IMesh* mesh, const core::matrix4& transform,
+			const core::array<video::SLight>& lights, ITriangleSelector* occluders=0,
+			const SLightmapBakeParameters& parameters=SLightmapBakeParameters()) = 0;
+
 		//! Adds an external mesh loader for extending the engine with new file formats.
 		/** If you want the engine to be extended with
 		file formats it currently is not able to load (e.g. .cob), just implement
@@ -1444,6 +1577,21 @@ namespace scene
 		\return True if successful. */
 		virtual bool saveScene(const io::path& filename, ISceneUserDataSerializer* userDataSerializer=0) = 0;
 
+		//! Saves the current scene into a binary file.
+		/** Binary scene files (.irrb) hold the same data as .irr files:
+		node attributes, materials, animators and user data. Names and
+		strings are stored once in a string table, all other values in
+		binary, so they load much faster than .irr files. They are meant
+		for shipping levels and are not portable between machines with a
+		different byte order. saveScene() also writes this format if the
+		filename ends with .irrb, and loadScene() detects it.
+		\param file: File where the scene is saved into.
+		\param userDataSerializer: If you want to save some user data for every scene node into the
+		file, implement the ISceneUserDataSerializer interface and provide it as parameter here.
+		Otherwise, simply specify 0 as this parameter.
+		\return True if successful. */
+		virtual bool saveSceneBinary(io::IWriteFile* file, ISceneUserDataSerializer* userDataSerializer=0) = 0;
+
 		//! Saves the current scene into a file.
 		/** Scene nodes with the option isDebugObject set to true are not being saved.
 		The scene is usually written to an .irr file, an xml based format. .irr files can
@@ -1473,6 +1621,8 @@ namespace scene
 		/** The scene is usually load from an .irr file, an xml based format. .irr files can
 		Be edited with the Irrlicht Engine Editor, irrEdit (http://irredit.irrlicht3d.org) or
 		saved directly by the engine using ISceneManager::saveScene().
+		Binary scene files written by ISceneManager::saveSceneBinary()
+		are detected and loaded as well.
 		\param file: File where the scene is going to be saved into.
 		\param userDataSerializer: If you want to load user data
 		possibily saved in that file for some scene nodes in the file,
@@ -24,6 +24,9 @@ namespace scene
 
 		//! Sets the mesh from which the shadow volume should be generated.
 		/** To optimize shadow rendering, use a simpler mesh for shadows.
+		Positions are only read again from mesh buffers which were
+		flagged with IMeshBuffer::setDirty() since the last update, so
+		meshes which change their vertices have to call it.
 		*/
 		virtual void setShadowMesh(const IMesh* mesh) = 0;
 
@@ -102,7 +102,8 @@ namespace scene
 		//! Manually sets the LOD of a patch
 		/** \param patchX Patch x coordinate.
 		\param patchZ Patch z coordinate.
-		\param LOD The level of detail to set the patch to. */
+		\param LOD The level of detail to set the patch to, from 0 to
+		the maximum LOD - 1. Patches and LODs out of range are ignored. */
 		virtual void setLODOfPatch(s32 patchX, s32 patchZ, s32 LOD=0) =0;
 
 		//! Get center of terrain.
@@ -172,6 +173,37 @@ namespace scene
 			video::SColor vertexColor=video::SColor(255,255,255,255),
 			s32 smoothFactor=0) =0;
 
+		//! Initializes the terrain in paged mode from a tiled heightfield file.
+		/** Only a window of tiles around the camera is kept in the render
+		buffer, so the size of the world is only limited by the file. Tiles
+		are read and decoded on a background thread when the camera comes
+		near, and the least recently used ones are released when more than
+		maxResidentTiles are loaded. getHeight() and the terrain triangle
+		selector work on all resident tiles and on the current window
+		respectively. The window starts in the center of the world.
+
+		The file starts with a little endian header of six 32 bit values:
+		the characters "ITHF", the version (1), the tile size in quads
+		(must be a multiple of the patch size minus one), the number of
+		tiles along x and along z, and the bits per sample (8 and 16 for
+		unsigned integers, 32 for floats). Then follow the tiles, x major,
+		each with (tileSize+1)^2 samples, again x major. Neighbouring tiles
+		repeat their shared border samples. Integer samples are converted
+		to heights just like in loadHeightMapRAW().
+		\param file The file to read the tiles from. It is grabbed and
+		read from a background thread until another heightmap is loaded,
+		so it must not be used elsewhere in the meantime.
+		\param pageRadius Number of tiles kept around the tile of the
+		camera in each direction.
+		\param maxResidentTiles Number of decoded tiles kept in memory.
+		0 selects twice the number of tiles in the window and its border.
+		\param vertexColor Color of all vertices.
+		\return True if the header was valid and the first window could be
+		loaded. */
+		virtual bool loadHeightMapTiled(io::IReadFile* file, s32 pageRadius=2,
+			u32 maxResidentTiles=0,
+			video::SColor vertexColor=video::SColor(255,255,255,255)) =0;
+
 	};
 
 } // end namespace scene
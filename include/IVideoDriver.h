@@ -423,6 +423,27 @@ namespace video
 		0 or another texture first. */
 		virtual void removeAllTextures() =0;
 
+		//! Sets the memory budget for streamed textures
+		/** Textures loaded from files with mip maps are streamed, if
+		the driver supports it. Only the mip levels the renderer
+		sampled are kept in memory, and levels of the least recently
+		used textures are released when the budget is exceeded.
+		Released levels are loaded from the file again when they are
+		sampled, at most a few textures per frame. Textures which are
+		locked for writing are no longer streamed.
+		\param bytes Memory for the mip levels of all streamed textures,
+		0 for no limit, which is the default. */
+		virtual void setTextureMemoryBudget(u32 bytes) =0;
+
+		//! Returns the memory budget for streamed textures
+		/** \return Budget in bytes, 0 if there is no limit. */
+		virtual u32 getTextureMemoryBudget() const =0;
+
+		//! Returns the memory used by the resident mip levels of streamed textures
+		/** Updated once per frame in endScene().
+		\return Memory in bytes. */
+		virtual u32 getTextureMemoryUsed() const =0;
+
 		//! Remove hardware buffer
 		virtual void removeHardwareBuffer(const scene::IMeshBuffer* mb) =0;
 
@@ -936,10 +957,49 @@ namespace video
 			video::SColor leftDownEdge = video::SColor(255,0,0,0),
 			video::SColor rightDownEdge = video::SColor(255,0,0,0)) =0;
 
+		//! Sets a depth texture which shadows the geometry drawn afterwards
+		/** Drivers supporting EVDF_SHADOW_MAP only write depth into
+		render target textures of format ECF_R32F, see
+		addRenderTargetTexture(). To shadow the scene, draw it into such
+		a texture as seen from the light, then pass the texture and the
+		light's projection and view matrix to this method, and draw the
+		scene as usual. Solid geometry is blended to the shadow color
+		where it is farther from the light than the depth in the
+		texture, with edges filtered over the four nearest texels.
+		Orthographic projections, as used for directional lights, are
+		exact. Perspective ones are only interpolated per vertex.
+		\param depth Depth texture drawn from the light, or 0 to disable
+		shadow mapping.
+		\param lightViewProjection Projection matrix multiplied with the
+		view matrix the depth texture was drawn with.
+		\param shadowColor Color of the shadow, its alpha is the
+		strength of the shadow.
+		\param bias Depth offset which keeps surfaces from shadowing
+		themselves, in the depth units of the light's projection. */
+		virtual void setShadowMap(ITexture* depth, const core::matrix4& lightViewProjection,
+			SColor shadowColor=SColor(150,0,0,0), f32 bias=0.002f) =0;
+
 		//! Draws a mesh buffer
 		/** \param mb Buffer to draw; */
 		virtual void drawMeshBuffer(const scene::IMeshBuffer* mb) =0;
 
+		//! Draws many instances of a mesh buffer with one call
+		/** Each instance is drawn with the current material, the current
+		view and projection, and its own world transformation. Drivers
+		supporting EVDF_INSTANCING set up the material, the textures and
+		the render states only once and multiply the vertex colors of each
+		instance with its color, after lighting. Other drivers draw each
+		instance separately, with a copy of the vertices whose colors are
+		multiplied with the instance color. The world transformation set
+		before is restored afterwards.
+		\param mb Buffer to draw.
+		\param transforms World transformation of each instance.
+		\param colors Color of each instance, or 0 for white.
+		\param instanceCount Number of instances. */
+		virtual void drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+				const core::matrix4* transforms, const SColor* colors,
+				u32 instanceCount) =0;
+
 		//! Sets the fog mode.
 		/** These are global values attached to each 3d object rendered,
 		which has the fog flag enabled in its material.
@@ -982,6 +1042,11 @@ namespace video
 		\return Size of render target or screen/window */
 		virtual const core::dimension2d<u32>& getCurrentRenderTargetSize() const =0;
 
+		//! Get the texture which is the current render target
+		/** \return Texture set with setRenderTarget(), or 0 if the
+		screen or window is the current render target. */
+		virtual ITexture* getCurrentRenderTarget() const =0;
+
 		//! Returns current frames per second value.
 		/** This value is updated approximately every 1.5 seconds and
 		is only intended to provide a rough guide to the average frame
@@ -1077,20 +1142,45 @@ namespace video
 		for a terrain renderer.
 		\param filename Name of the file from which the image is
 		created.
+		\param minSize Smallest size the image is needed at, see
+		IImageLoader::loadImage(). JPEG files are decoded at a reduced
+		scale when this is much smaller than the file. A zero dimension
+		loads the full image.
 		\return The created image.
 		If you no longer need the image, you should call IImage::drop().
 		See IReferenceCounted::drop() for more information. */
-		virtual IImage* createImageFromFile(const io::path& filename) = 0;
+		virtual IImage* createImageFromFile(const io::path& filename,
+				const core::dimension2d<u32>& minSize=core::dimension2d<u32>(0,0)) = 0;
 
 		//! Creates a software image from a file.
 		/** No hardware texture will be created for this image. This
 		method is useful for example if you want to read a heightmap
 		for a terrain renderer.
 		\param file File from which the image is created.
+		\param minSize Smallest size the image is needed at, see
+		IImageLoader::loadImage(). A zero dimension loads the full image.
 		\return The created image.
 		If you no longer need the image, you should call IImage::drop().
 		See IReferenceCounted::drop() for more information. */
-		virtual IImage* createImageFromFile(io::IReadFile* file) =0;
+		virtual IImage* createImageFromFile(io::IReadFile* file,
+				const core::dimension2d<u32>& minSize=core::dimension2d<u32>(0,0)) =0;
+
+		//! Creates software images from many files at once.
+		/** The files are opened and read in the calling thread, and
+		decoded concurrently on the engine's thread pool. Image loaders
+		added with addExternalImageLoader() must therefore be thread safe
+		if this method is used.
+		\param filenames Names of the files from which the images are
+		created.
+		\param images Receives one image per file name, in the same
+		order, or 0 for files which could not be loaded. The images have
+		to be dropped by the caller.
+		\param minSize Smallest size the images are needed at, see
+		createImageFromFile().
+		\return Number of images which were loaded. */
+		virtual u32 createImagesFromFiles(const core::array<io::path>& filenames,
+				core::array<IImage*>& images,
+				const core::dimension2d<u32>& minSize=core::dimension2d<u32>(0,0)) =0;
 
 		//! Writes the provided image to a file.
 		/** Requires that there is a suitable image writer registered
@@ -161,6 +161,47 @@ define out. */
 you will not be able to use anything provided by the GUI Environment, including loading fonts. */
 #define _IRR_COMPILE_WITH_GUI_
 
+//! Define _IRR_COMPILE_WITH_THREADS_ to let the engine use worker threads
+/** Used for background loading and for splitting large bulk operations
+across processors. If disabled, all this work is done in the calling thread.
+Needs pthreads on posix systems (link with -lpthread) and Windows Vista or
+newer on Windows. */
+#if !defined(_IRR_XBOX_PLATFORM_) && !defined(_WIN32_WCE)
+#define _IRR_COMPILE_WITH_THREADS_
+#endif
+
+
+//! Define _IRR_COMPILE_WITH_SSE2_ to use SSE2 instructions for image processing
+/** Enabled whenever the compiler generates SSE2 code anyway, which all
+x86-64 compilers do. Image scaling and color conversion then process
+several pixels per instruction, shadow volumes classify four faces at once. */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define _IRR_COMPILE_WITH_SSE2_
+#endif
+
+
+//! Define _IRR_COMPILE_WITH_AVX2_ to add AVX2 versions of the color conversions
+/** They are compiled next to the SSE2 code without special compiler flags
+and are only used if the processor and operating system support AVX2 when
+the engine runs. */
+#if defined(_IRR_COMPILE_WITH_SSE2_) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) || (defined(_MSC_VER) && _MSC_VER >= 1700))
+#define _IRR_COMPILE_WITH_AVX2_
+#endif
+
+
+//! Define _IRR_COMPILE_WITH_MAPPED_FILES_ to read files from disk through memory mapping
+/** Files are mapped into memory instead of being read with stdio, so loaders
+and archives can use their content in place, see IReadFile::getMappedData().
+If mapping a file fails, it is read with stdio as before. This is disabled by
+default: on POSIX systems, accessing a mapped file which another program
+truncates crashes with SIGBUS, and on Windows other programs can't write to
+files while they are mapped. Only enable it if the files read by the engine
+are not changed by other programs while they are open. */
+//#define _IRR_COMPILE_WITH_MAPPED_FILES_
+#if defined(_IRR_COMPILE_WITH_MAPPED_FILES_) && !(defined(_IRR_POSIX_API_) || defined(_IRR_OSX_PLATFORM_) || (defined(_IRR_WINDOWS_API_) && !defined(_IRR_XBOX_PLATFORM_) && !defined(_WIN32_WCE)))
+#undef _IRR_COMPILE_WITH_MAPPED_FILES_
+#endif
+
 
 //! Define _IRR_WCHAR_FILESYSTEM to enable unicode filesystem support for the engine.
 /** This enables the engine to read/write from unicode filesystem. If you
@@ -319,6 +360,8 @@ B3D, MS3D or X meshes */
 #define _IRR_COMPILE_WITH_WAL_LOADER_
 //! Define _IRR_COMPILE_WITH_RGB_LOADER_ if you want to load Silicon Graphics .rgb/.rgba/.sgi/.int/.inta/.bw files
 #define _IRR_COMPILE_WITH_RGB_LOADER_
+//! Define _IRR_COMPILE_WITH_DDS_LOADER_ if you want to load DirectDraw .dds files
+#define _IRR_COMPILE_WITH_DDS_LOADER_
 
 //! Define _IRR_COMPILE_WITH_BMP_WRITER_ if you want to write .bmp files
 #define _IRR_COMPILE_WITH_BMP_WRITER_
@@ -479,6 +522,7 @@ precision will be lower but speed higher. currently X86 only
 	#undef _IRR_COMPILE_WITH_PSD_LOADER_
 	//#undef _IRR_COMPILE_WITH_TGA_LOADER_
 	#undef _IRR_COMPILE_WITH_WAL_LOADER_
+	#undef _IRR_COMPILE_WITH_DDS_LOADER_
 	#undef _IRR_COMPILE_WITH_BMP_WRITER_
 	#undef _IRR_COMPILE_WITH_JPG_WRITER_
 	#undef _IRR_COMPILE_WITH_PCX_WRITER_
@@ -0,0 +1,71 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __S_LIGHTMAP_BAKE_PARAMETERS_H_INCLUDED__
+#define __S_LIGHTMAP_BAKE_PARAMETERS_H_INCLUDED__
+
+#include "irrTypes.h"
+#include "SColor.h"
+#include "EMaterialTypes.h"
+#include "path.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Settings for baking lightmaps with ISceneManager::createLightmappedMesh()
+	struct SLightmapBakeParameters
+	{
+		SLightmapBakeParameters() : TexelsPerUnit(4.f), AtlasSize(1024),
+			Padding(2), AmbientColor(0.2f, 0.2f, 0.2f),
+			AmbientOcclusionSamples(16), AmbientOcclusionDistance(0.f),
+			CastShadows(true), MaterialType(video::EMT_LIGHTMAP),
+			TextureName("lightmap")
+		{}
+
+		//! Lightmap texels per unit of the mesh in world space.
+		/** If the charts do not fit into the atlas, this is reduced
+		until they do. */
+		f32 TexelsPerUnit;
+
+		//! Width and largest height of the lightmap texture, should be a power of two.
+		/** The height is reduced to the next power of two above the
+		used rows. */
+		u32 AtlasSize;
+
+		//! Texels kept free around each chart, filled with the nearest lit texels.
+		/** Keeps bilinear filtering and smaller mip maps from mixing
+		charts. */
+		u32 Padding;
+
+		//! Light reaching every surface, darkened by ambient occlusion.
+		/** The ambient colors of the lights are added to it. */
+		video::SColorf AmbientColor;
+
+		//! Rays per texel testing how much of the ambient light reaches it.
+		/** 0 disables ambient occlusion. */
+		u32 AmbientOcclusionSamples;
+
+		//! Distance up to which geometry occludes ambient light.
+		/** 0 means a tenth of the size of the occluding geometry. */
+		f32 AmbientOcclusionDistance;
+
+		//! Whether lights with SLight::CastShadows are blocked by the occluders.
+		bool CastShadows;
+
+		//! Material type of the baked mesh, one of the EMT_LIGHTMAP types.
+		/** The lightmap is scaled down to make up for the brightening
+		of the _M2 and _M4 types. */
+		video::E_MATERIAL_TYPE MaterialType;
+
+		//! Name of the lightmap texture added to the video driver.
+		io::path TextureName;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
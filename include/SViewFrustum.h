@@ -88,6 +88,12 @@ namespace scene
 		/** \return True if the line was clipped, false if not */
 		bool clipLine(core::line3d<f32>& line) const;
 
+		//! tests a box against the planes of the frustum
+		/** \return False if the box is completely on the outer side of
+		one of the planes. Boxes near the edges of the frustum may pass
+		although they are outside. */
+		bool intersectsBox(const core::aabbox3d<f32>& box) const;
+
 		//! the position of the camera
 		core::vector3df cameraPosition;
 
@@ -310,6 +316,25 @@ namespace scene
 		return wasClipped;
 	}
 
+	//! Tests a box against the planes of the frustum
+	inline bool SViewFrustum::intersectsBox(const core::aabbox3d<f32>& box) const
+	{
+		for (u32 i=0; i < VF_PLANE_COUNT; ++i)
+		{
+			const core::plane3d<f32>& plane = planes[i];
+
+			// the corner which lies furthest on the inner side of the plane
+			const core::vector3df corner(
+				plane.Normal.X > 0.f ? box.MinEdge.X : box.MaxEdge.X,
+				plane.Normal.Y > 0.f ? box.MinEdge.Y : box.MaxEdge.Y,
+				plane.Normal.Z > 0.f ? box.MinEdge.Z : box.MaxEdge.Z);
+
+			if (plane.classifyPointRelation(corner) == core::ISREL3D_FRONT)
+				return false;
+		}
+		return true;
+	}
+
 
 } // end namespace scene
 } // end namespace irr
@@ -190,6 +190,214 @@ inline float fast_atof(const char* floatAsString)
 	return ret;
 }
 
+// powers of ten which are exact in double precision
+const f64 fast_atof_pow10[23] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+//! Converts a string into a float with correct rounding.
+//! Up to 15 significant digits are collected exactly in a double and scaled
+//! by a power of ten once, so every float written with 9 significant digits
+//! reads back as the same float.
+//! \param[in] in: The string to convert.
+//! \param[out] out: The resultant float will be written here, 0 if no number was found.
+//! \return A pointer to the first character in the string that wasn't
+//!         used to create the float value, in if no number was found.
+inline const char* fast_atof_exact_move(const char* in, f32& out)
+{
+	out = 0.f;
+	if (!in)
+		return 0;
+
+	const char* const start = in;
+	bool negative = false;
+	if ('-' == *in)
+	{
+		negative = true;
+		++in;
+	}
+	else if ('+' == *in)
+		++in;
+
+	// the first 9 significant digits are collected in high, up to 6 more in low
+	u32 high = 0;
+	u32 low = 0;
+	u32 lowDigits = 0;
+	u32 digits = 0;
+	s32 exponent = 0;
+	bool found = false;
+
+	for (; (u32)(*in - '0') < 10; ++in)
+	{
+		found = true;
+		if (digits < 9)
+		{
+			high = high*10 + (*in - '0');
+			if (high)
+				++digits;
+		}
+		else if (digits < 15)
+		{
+			low = low*10 + (*in - '0');
+			++lowDigits;
+			++digits;
+		}
+		else
+			++exponent;
+	}
+
+	if ('.' == *in)
+	{
+		++in;
+		for (; (u32)(*in - '0') < 10; ++in)
+		{
+			found = true;
+			if (digits < 9)
+			{
+				high = high*10 + (*in - '0');
+				if (high)
+					++digits;
+				--exponent;
+			}
+			else if (digits < 15)
+			{
+				low = low*10 + (*in - '0');
+				++lowDigits;
+				++digits;
+				--exponent;
+			}
+		}
+	}
+
+	if (!found)
+		return start;
+
+	if ('e' == *in || 'E' == *in)
+	{
+		const char* p = in+1;
+		bool negativeExponent = false;
+		if ('-' == *p)
+		{
+			negativeExponent = true;
+			++p;
+		}
+		else if ('+' == *p)
+			++p;
+
+		if ((u32)(*p - '0') < 10)
+		{
+			s32 e = 0;
+			for (; (u32)(*p - '0') < 10; ++p)
+			{
+				if (e < 100000)
+					e = e*10 + (*p - '0');
+			}
+			exponent += negativeExponent ? -e : e;
+			in = p;
+		}
+	}
+
+	// the mantissa and powers of ten up to 1e22 are exact doubles, so
+	// the result is rounded only once in this case. Larger exponents
+	// are out of the float range anyway.
+	f64 value = high;
+	if (lowDigits)
+		value = value*fast_atof_pow10[lowDigits] + low;
+	if (value != 0.0)
+	{
+		exponent = core::clamp(exponent, -100, 100);
+		if (exponent < 0)
+		{
+			for (; exponent < -22; exponent += 22)
+				value /= fast_atof_pow10[22];
+			value /= fast_atof_pow10[-exponent];
+		}
+		else
+		{
+			for (; exponent > 22; exponent -= 22)
+				value *= fast_atof_pow10[22];
+			value *= fast_atof_pow10[exponent];
+		}
+	}
+
+	out = (f32)(negative ? -value : value);
+	return in;
+}
+
+//! Converts a whitespace separated list of floats into an array.
+//! Use this instead of single calls for long lists of numbers like vertex
+//! data, every number is converted with fast_atof_exact_move().
+//! \param[in] in: The string to convert.
+//! \param[out] out: Array receiving up to count floats.
+//! \param[in] count: Maximal number of floats to read.
+//! \param[out] end: (optional) If provided, it will be set to point at the
+//!					 first character after the last converted number.
+//! \return The number of floats written to out. Conversion stops early at the
+//!			end of the string or at a character which doesn't start a number.
+inline u32 fast_atof_array(const char* in, f32* out, u32 count, const char** end=0)
+{
+	u32 i=0;
+	if (in)
+	{
+		for (; i<count; ++i)
+		{
+			while (' ' == *in || '\t' == *in || '\n' == *in || '\r' == *in)
+				++in;
+
+			f32 value;
+			const char* next = fast_atof_exact_move(in, value);
+			if (next == in)
+				break;
+			out[i] = value;
+			in = next;
+		}
+	}
+	if (end)
+		*end = in;
+	return i;
+}
+
+//! Converts a whitespace separated list of integers into an array.
+//! Numbers written as floats are truncated to integers.
+//! \param[in] in: The string to convert.
+//! \param[out] out: Array receiving up to count integers.
+//! \param[in] count: Maximal number of integers to read.
+//! \param[out] end: (optional) If provided, it will be set to point at the
+//!					 first character after the last converted number.
+//! \return The number of integers written to out. Conversion stops early at the
+//!			end of the string or at a character which doesn't start a number.
+inline u32 strtol10_array(const char* in, s32* out, u32 count, const char** end=0)
+{
+	u32 i=0;
+	if (in)
+	{
+		for (; i<count; ++i)
+		{
+			while (' ' == *in || '\t' == *in || '\n' == *in || '\r' == *in)
+				++in;
+
+			const char* p = in;
+			if ('-' == *p || '+' == *p)
+				++p;
+			if ((u32)(*p - '0') >= 10)
+				break;
+
+			out[i] = strtol10(in, &p);
+			if ('.' == *p || 'e' == *p || 'E' == *p)
+			{
+				f32 value;
+				p = fast_atof_exact_move(in, value);
+				out[i] = (s32)value;
+			}
+			in = p;
+		}
+	}
+	if (end)
+		*end = in;
+	return i;
+}
+
 } // end namespace core
 } // end namespace irr
 
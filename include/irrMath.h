@@ -649,6 +649,17 @@ namespace core
 		return x - floorf ( x );
 	}
 
+	//! FNV-1a hash of size bytes
+	/** Pass the result of a previous call as hash to continue hashing
+	more bytes. */
+	inline u32 hashFNV1a(const void* data, u32 size, u32 hash=2166136261u)
+	{
+		const u8* p = (const u8*)data;
+		for (u32 i=0; i<size; ++i)
+			hash = (hash ^ p[i]) * 16777619u;
+		return hash;
+	}
+
 } // end namespace core
 } // end namespace irr
 
@@ -440,6 +440,21 @@ namespace io
 	IRRLICHT_API IrrXMLReader* IRRCALLCONV createIrrXMLReader(IFileReadCallBack* callback,
 																bool deleteCallback = false);
 
+	//! Creates an instance of an UFT-8 or ASCII character xml parser working directly on a text buffer.
+	/** The text is not copied. The parser terminates names and values
+	inside of the buffer and replaces xml special characters in place,
+	so all strings returned by the parser point into the buffer. This
+	makes parsing large files in memory, for example mapped files,
+	much faster.
+	\param buffer: ASCII or UTF-8 text without byte order mark,
+	terminated by a 0 character. It is modified while parsing, and
+	must stay valid until the parser is deleted.
+	\param size: Number of characters in the buffer, without the
+	terminating 0.
+	\return Returns a pointer to the created xml parser. This pointer should be
+	deleted using 'delete' after no longer needed. Returns 0 if buffer is 0. */
+	IRRLICHT_API IrrXMLReader* IRRCALLCONV createIrrXMLReaderInSitu(char* buffer, unsigned int size);
+
 	//! Creates an instance of an UFT-16 xml parser.
 	/** This means that
 	all character data will be returned in UTF-16. The file to read can
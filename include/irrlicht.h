@@ -111,6 +111,8 @@
 #include "IMeshLoader.h"
 #include "IMeshManipulator.h"
 #include "IMeshSceneNode.h"
+#include "ILODMeshSceneNode.h"
+#include "IInstancedMeshSceneNode.h"
 #include "IMeshWriter.h"
 #include "IMetaTriangleSelector.h"
 #include "IOSOperator.h"
@@ -170,6 +172,7 @@
 #include "SIrrCreationParameters.h"
 #include "SKeyMap.h"
 #include "SLight.h"
+#include "SLightmapBakeParameters.h"
 #include "SMaterial.h"
 #include "SMesh.h"
 #include "SMeshBuffer.h"
@@ -263,6 +263,9 @@ void CAnimatedMeshMD3::buildVertexArray ( u32 frameA, u32 frameB, f32 interpolat
 	}
 
 	dest->recalculateBoundingBox ();
+
+	// hardware buffers and shadow volumes look for changed vertices
+	dest->setDirty ( EBT_VERTEX );
 }
 
 
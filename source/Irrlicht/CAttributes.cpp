@@ -40,6 +40,8 @@ void CAttributes::clear()
 		Attributes[i]->drop();
 
 	Attributes.clear();
+	NameHashes.clear();
+	HashBuckets.clear();
 }
 
 
@@ -48,23 +50,20 @@ void CAttributes::clear()
 //! \param value: Value for the attribute. Set this to 0 to delete the attribute
 void CAttributes::setAttribute(const c8* attributeName, const c8* value)
 {
-	for (u32 i=0; i<Attributes.size(); ++i)
-		if (Attributes[i]->Name == attributeName)
-		{
-			if (!value)
-			{
-				Attributes[i]->drop();
-				Attributes.erase(i);
-			}
-			else
-				Attributes[i]->setString(value);
+	const s32 i = findAttribute(attributeName);
+	if (i != -1)
+	{
+		if (!value)
+			removeAttributeP(i);
+		else
+			Attributes[i]->setString(value);
 
-			return;
-		}
+		return;
+	}
 
 	if (value)
 	{
-		Attributes.push_back(new CStringAttribute(attributeName, value));
+		addAttributeP(new CStringAttribute(attributeName, value));
 	}
 }
 
@@ -116,25 +115,20 @@ core::stringc CAttributes::getAttributeAsString(s32 index)
 //! \param value: Value for the attribute. Set this to 0 to delete the attribute
 void CAttributes::setAttribute(const c8* attributeName, const wchar_t* value)
 {
-	for (u32 i=0; i<Attributes.size(); ++i)
+	const s32 i = findAttribute(attributeName);
+	if (i != -1)
 	{
-		if (Attributes[i]->Name == attributeName)
-		{
-			if (!value)
-			{
-				Attributes[i]->drop();
-				Attributes.erase(i);
-			}
-			else
-				Attributes[i]->setString(value);
+		if (!value)
+			removeAttributeP(i);
+		else
+			Attributes[i]->setString(value);
 
-			return;
-		}
+		return;
 	}
 
 	if (value)
 	{
-		Attributes.push_back(new CStringAttribute(attributeName, value));
+		addAttributeP(new CStringAttribute(attributeName, value));
 	}
 }
 
@@ -183,7 +177,7 @@ core::stringw CAttributes::getAttributeAsStringW(s32 index)
 //! Adds an attribute as an array of wide strings
 void CAttributes::addArray(const c8* attributeName, const core::array<core::stringw>& value)
 {
-	Attributes.push_back(new CStringWArrayAttribute(attributeName, value));
+	addAttributeP(new CStringWArrayAttribute(attributeName, value));
 }
 
 //! Sets an attribute value as an array of wide strings.
@@ -194,7 +188,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::array<core::
 		att->setArray(value);
 	else
 	{
-		Attributes.push_back(new CStringWArrayAttribute(attributeName, value));
+		addAttributeP(new CStringWArrayAttribute(attributeName, value));
 	}
 }
 
@@ -229,12 +223,31 @@ void CAttributes::setAttribute(s32 index, const core::array<core::stringw>& valu
 
 
 
+namespace
+{
+	//! FNV-1a hash of an attribute name
+	u32 hashAttributeName(const c8* name)
+	{
+		return core::hashFNV1a(name, (u32)strlen(name));
+	}
+}
+
+
 //! Returns attribute index from name, -1 if not found
 s32 CAttributes::findAttribute(const c8* attributeName)
 {
-	for (u32 i=0; i<Attributes.size(); ++i)
-		if (Attributes[i]->Name == attributeName)
+	if (!attributeName || HashBuckets.empty())
+		return -1;
+
+	const u32 hash = hashAttributeName(attributeName);
+	const u32 mask = HashBuckets.size() - 1;
+
+	for (u32 b = hash & mask; HashBuckets[b] != -1; b = (b+1) & mask)
+	{
+		const s32 i = HashBuckets[b];
+		if (NameHashes[i] == hash && Attributes[i]->Name == attributeName)
 			return i;
+	}
 
 	return -1;
 }
@@ -242,11 +255,68 @@ s32 CAttributes::findAttribute(const c8* attributeName)
 
 IAttribute* CAttributes::getAttributeP(const c8* attributeName)
 {
-	for (u32 i=0; i<Attributes.size(); ++i)
-		if (Attributes[i]->Name == attributeName)
-			return Attributes[i];
+	const s32 i = findAttribute(attributeName);
+	return i != -1 ? Attributes[i] : 0;
+}
+
+
+//! appends an attribute and adds its name to the hash index
+void CAttributes::addAttributeP(IAttribute* attribute)
+{
+	Attributes.push_back(attribute);
+	NameHashes.push_back(hashAttributeName(attribute->Name.c_str()));
+
+	// keep the table at most half full
+	if (Attributes.size() * 2 > HashBuckets.size())
+		rebuildIndex();
+	else
+		insertIndex(Attributes.size()-1);
+}
+
+
+//! drops and removes the attribute at the index
+void CAttributes::removeAttributeP(u32 index)
+{
+	Attributes[index]->drop();
+	Attributes.erase(index);
+	NameHashes.erase(index);
+
+	// all following indices moved
+	rebuildIndex();
+}
+
 
-	return 0;
+//! inserts the name of the attribute at the index into the hash index
+void CAttributes::insertIndex(u32 index)
+{
+	const u32 mask = HashBuckets.size() - 1;
+	u32 b = NameHashes[index] & mask;
+
+	for (; HashBuckets[b] != -1; b = (b+1) & mask)
+	{
+		// duplicate names are only found by their first occurrence
+		const s32 i = HashBuckets[b];
+		if (NameHashes[i] == NameHashes[index] && Attributes[i]->Name == Attributes[index]->Name)
+			return;
+	}
+
+	HashBuckets[b] = (s32)index;
+}
+
+
+//! recreates the hash index with enough buckets for all attributes
+void CAttributes::rebuildIndex()
+{
+	u32 size = 16;
+	while (size < Attributes.size() * 2)
+		size <<= 1;
+
+	HashBuckets.set_used(size);
+	for (u32 i=0; i<size; ++i)
+		HashBuckets[i] = -1;
+
+	for (u32 i=0; i<Attributes.size(); ++i)
+		insertIndex(i);
 }
 
 
@@ -258,7 +328,7 @@ void CAttributes::setAttribute(const c8* attributeName, bool value)
 		att->setBool(value);
 	else
 	{
-		Attributes.push_back(new CBoolAttribute(attributeName, value));
+		addAttributeP(new CBoolAttribute(attributeName, value));
 	}
 }
 
@@ -286,7 +356,7 @@ void CAttributes::setAttribute(const c8* attributeName, s32 value)
 		att->setInt(value);
 	else
 	{
-		Attributes.push_back(new CIntAttribute(attributeName, value));
+		addAttributeP(new CIntAttribute(attributeName, value));
 	}
 }
 
@@ -310,7 +380,7 @@ void CAttributes::setAttribute(const c8* attributeName, f32 value)
 	if (att)
 		att->setFloat(value);
 	else
-		Attributes.push_back(new CFloatAttribute(attributeName, value));
+		addAttributeP(new CFloatAttribute(attributeName, value));
 }
 
 //! Gets a attribute as integer value
@@ -333,7 +403,7 @@ void CAttributes::setAttribute(const c8* attributeName, video::SColor value)
 	if (att)
 		att->setColor(value);
 	else
-		Attributes.push_back(new CColorAttribute(attributeName, value));
+		addAttributeP(new CColorAttribute(attributeName, value));
 }
 
 //! Gets an attribute as color
@@ -357,7 +427,7 @@ void CAttributes::setAttribute(const c8* attributeName, video::SColorf value)
 	if (att)
 		att->setColor(value);
 	else
-		Attributes.push_back(new CColorfAttribute(attributeName, value));
+		addAttributeP(new CColorfAttribute(attributeName, value));
 }
 
 //! Gets an attribute as floating point color
@@ -379,7 +449,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::position2di value)
 	if (att)
 		att->setPosition(value);
 	else
-		Attributes.push_back(new CPosition2DAttribute(attributeName, value));
+		addAttributeP(new CPosition2DAttribute(attributeName, value));
 }
 
 //! Gets an attribute as 2d position
@@ -401,7 +471,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::rect<s32> value)
 	if (att)
 		att->setRect(value);
 	else
-		Attributes.push_back(new CRectAttribute(attributeName, value));
+		addAttributeP(new CRectAttribute(attributeName, value));
 }
 
 //! Gets an attribute as rectangle
@@ -423,7 +493,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::vector3df value)
 	if (att)
 		att->setVector(value);
 	else
-		Attributes.push_back(new CVector3DAttribute(attributeName, value));
+		addAttributeP(new CVector3DAttribute(attributeName, value));
 }
 
 //! Gets an attribute as vector
@@ -445,7 +515,7 @@ void CAttributes::setAttribute(const c8* attributeName, void* data, s32 dataSize
 	if (att)
 		att->setBinary(data, dataSizeInBytes);
 	else
-		Attributes.push_back(new CBinaryAttribute(attributeName, data, dataSizeInBytes));
+		addAttributeP(new CBinaryAttribute(attributeName, data, dataSizeInBytes));
 }
 
 //! Gets an attribute as binary data
@@ -464,7 +534,7 @@ void CAttributes::setAttribute(const c8* attributeName, const char* enumValue, c
 	if (att)
 		att->setEnum(enumValue, enumerationLiterals);
 	else
-		Attributes.push_back(new CEnumAttribute(attributeName, enumValue, enumerationLiterals));
+		addAttributeP(new CEnumAttribute(attributeName, enumValue, enumerationLiterals));
 }
 
 //! Gets an attribute as enumeration
@@ -515,7 +585,7 @@ void CAttributes::setAttribute(const c8* attributeName, video::ITexture* value )
 	if (att)
 		att->setTexture(value);
 	else
-		Attributes.push_back(new CTextureAttribute(attributeName, value, Driver));
+		addAttributeP(new CTextureAttribute(attributeName, value, Driver));
 }
 
 
@@ -741,37 +811,37 @@ void CAttributes::getAttributeEnumerationLiteralsOfEnumeration(s32 index, core::
 //! Adds an attribute as integer
 void CAttributes::addInt(const c8* attributeName, s32 value)
 {
-	Attributes.push_back(new CIntAttribute(attributeName, value));
+	addAttributeP(new CIntAttribute(attributeName, value));
 }
 
 //! Adds an attribute as float
 void CAttributes::addFloat(const c8* attributeName, f32 value)
 {
-	Attributes.push_back(new CFloatAttribute(attributeName, value));
+	addAttributeP(new CFloatAttribute(attributeName, value));
 }
 
 //! Adds an attribute as string
 void CAttributes::addString(const c8* attributeName, const char* value)
 {
-	Attributes.push_back(new CStringAttribute(attributeName, value));
+	addAttributeP(new CStringAttribute(attributeName, value));
 }
 
 //! Adds an attribute as wchar string
 void CAttributes::addString(const c8* attributeName, const wchar_t* value)
 {
-	Attributes.push_back(new CStringAttribute(attributeName, value));
+	addAttributeP(new CStringAttribute(attributeName, value));
 }
 
 //! Adds an attribute as bool
 void CAttributes::addBool(const c8* attributeName, bool value)
 {
-	Attributes.push_back(new CBoolAttribute(attributeName, value));
+	addAttributeP(new CBoolAttribute(attributeName, value));
 }
 
 //! Adds an attribute as enum
 void CAttributes::addEnum(const c8* attributeName, const char* enumValue, const char* const* enumerationLiterals)
 {
-	Attributes.push_back(new CEnumAttribute(attributeName, enumValue, enumerationLiterals));
+	addAttributeP(new CEnumAttribute(attributeName, enumValue, enumerationLiterals));
 }
 
 //! Adds an attribute as enum
@@ -784,43 +854,43 @@ void CAttributes::addEnum(const c8* attributeName, s32 enumValue, const char* co
 //! Adds an attribute as color
 void CAttributes::addColor(const c8* attributeName, video::SColor value)
 {
-	Attributes.push_back(new CColorAttribute(attributeName, value));
+	addAttributeP(new CColorAttribute(attributeName, value));
 }
 
 //! Adds an attribute as floating point color
 void CAttributes::addColorf(const c8* attributeName, video::SColorf value)
 {
-	Attributes.push_back(new CColorfAttribute(attributeName, value));
+	addAttributeP(new CColorfAttribute(attributeName, value));
 }
 
 //! Adds an attribute as 3d vector
 void CAttributes::addVector3d(const c8* attributeName, core::vector3df value)
 {
-	Attributes.push_back(new CVector3DAttribute(attributeName, value));
+	addAttributeP(new CVector3DAttribute(attributeName, value));
 }
 
 //! Adds an attribute as 2d position
 void CAttributes::addPosition2d(const c8* attributeName, core::position2di value)
 {
-	Attributes.push_back(new CPosition2DAttribute(attributeName, value));
+	addAttributeP(new CPosition2DAttribute(attributeName, value));
 }
 
 //! Adds an attribute as rectangle
 void CAttributes::addRect(const c8* attributeName, core::rect<s32> value)
 {
-	Attributes.push_back(new CRectAttribute(attributeName, value));
+	addAttributeP(new CRectAttribute(attributeName, value));
 }
 
 //! Adds an attribute as binary data
 void CAttributes::addBinary(const c8* attributeName, void* data, s32 dataSizeInBytes)
 {
-	Attributes.push_back(new CBinaryAttribute(attributeName, data, dataSizeInBytes));
+	addAttributeP(new CBinaryAttribute(attributeName, data, dataSizeInBytes));
 }
 
 //! Adds an attribute as texture reference
 void CAttributes::addTexture(const c8* attributeName, video::ITexture* texture)
 {
-	Attributes.push_back(new CTextureAttribute(attributeName, texture, Driver));
+	addAttributeP(new CTextureAttribute(attributeName, texture, Driver));
 }
 
 //! Returns if an attribute with a name exists
@@ -928,7 +998,7 @@ void CAttributes::setAttribute(s32 index, video::ITexture* texture)
 //! Adds an attribute as matrix
 void CAttributes::addMatrix(const c8* attributeName, const core::matrix4& v)
 {
-	Attributes.push_back(new CMatrixAttribute(attributeName, v));
+	addAttributeP(new CMatrixAttribute(attributeName, v));
 }
 
 
@@ -939,7 +1009,7 @@ void CAttributes::setAttribute(const c8* attributeName, const core::matrix4& v)
 	if (att)
 		att->setMatrix(v);
 	else
-		Attributes.push_back(new CMatrixAttribute(attributeName, v));
+		addAttributeP(new CMatrixAttribute(attributeName, v));
 }
 
 //! Gets an attribute as a matrix4
@@ -973,7 +1043,7 @@ void CAttributes::setAttribute(s32 index, const core::matrix4& v)
 //! Adds an attribute as quaternion
 void CAttributes::addQuaternion(const c8* attributeName, core::quaternion v)
 {
-	Attributes.push_back(new CQuaternionAttribute(attributeName, v));
+	addAttributeP(new CQuaternionAttribute(attributeName, v));
 }
 
 
@@ -985,7 +1055,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::quaternion v)
 		att->setQuaternion(v);
 	else
 	{
-		Attributes.push_back(new CQuaternionAttribute(attributeName, v));
+		addAttributeP(new CQuaternionAttribute(attributeName, v));
 	}
 }
 
@@ -1022,7 +1092,7 @@ if (index >= 0 && index < (s32)Attributes.size() )
 //! Adds an attribute as axis aligned bounding box
 void CAttributes::addBox3d(const c8* attributeName, core::aabbox3df v)
 {
-	Attributes.push_back(new CBBoxAttribute(attributeName, v));
+	addAttributeP(new CBBoxAttribute(attributeName, v));
 }
 
 //! Sets an attribute as axis aligned bounding box
@@ -1033,7 +1103,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::aabbox3df v)
 		att->setBBox(v);
 	else
 	{
-		Attributes.push_back(new CBBoxAttribute(attributeName, v));
+		addAttributeP(new CBBoxAttribute(attributeName, v));
 	}
 }
 
@@ -1070,7 +1140,7 @@ if (index >= 0 && index < (s32)Attributes.size() )
 //! Adds an attribute as 3d plane
 void CAttributes::addPlane3d(const c8* attributeName, core::plane3df v)
 {
-	Attributes.push_back(new CPlaneAttribute(attributeName, v));
+	addAttributeP(new CPlaneAttribute(attributeName, v));
 }
 
 //! Sets an attribute as 3d plane
@@ -1081,7 +1151,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::plane3df v)
 		att->setPlane(v);
 	else
 	{
-		Attributes.push_back(new CPlaneAttribute(attributeName, v));
+		addAttributeP(new CPlaneAttribute(attributeName, v));
 	}
 }
 
@@ -1118,7 +1188,7 @@ void CAttributes::setAttribute(s32 index, core::plane3df v)
 //! Adds an attribute as 3d triangle
 void CAttributes::addTriangle3d(const c8* attributeName, core::triangle3df v)
 {
-	Attributes.push_back(new CTriangleAttribute(attributeName, v));
+	addAttributeP(new CTriangleAttribute(attributeName, v));
 }
 
 //! Sets an attribute as 3d triangle
@@ -1129,7 +1199,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::triangle3df v)
 		att->setTriangle(v);
 	else
 	{
-		Attributes.push_back(new CTriangleAttribute(attributeName, v));
+		addAttributeP(new CTriangleAttribute(attributeName, v));
 	}
 }
 
@@ -1168,7 +1238,7 @@ void CAttributes::setAttribute(s32 index, core::triangle3df v)
 //! Adds an attribute as a 2d line
 void CAttributes::addLine2d(const c8* attributeName, core::line2df v)
 {
-	Attributes.push_back(new CLine2dAttribute(attributeName, v));
+	addAttributeP(new CLine2dAttribute(attributeName, v));
 }
 
 //! Sets an attribute as a 2d line
@@ -1179,7 +1249,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::line2df v)
 		att->setLine2d(v);
 	else
 	{
-		Attributes.push_back(new CLine2dAttribute(attributeName, v));
+		addAttributeP(new CLine2dAttribute(attributeName, v));
 	}
 }
 
@@ -1216,7 +1286,7 @@ void CAttributes::setAttribute(s32 index, core::line2df v)
 //! Adds an attribute as a 3d line
 void CAttributes::addLine3d(const c8* attributeName, core::line3df v)
 {
-	Attributes.push_back(new CLine3dAttribute(attributeName, v));
+	addAttributeP(new CLine3dAttribute(attributeName, v));
 }
 
 //! Sets an attribute as a 3d line
@@ -1227,7 +1297,7 @@ void CAttributes::setAttribute(const c8* attributeName, core::line3df v)
 		att->setLine3d(v);
 	else
 	{
-		Attributes.push_back(new CLine3dAttribute(attributeName, v));
+		addAttributeP(new CLine3dAttribute(attributeName, v));
 	}
 }
 
@@ -1266,7 +1336,7 @@ void CAttributes::setAttribute(s32 index, core::line3df v)
 //! Adds an attribute as user pointner
 void CAttributes::addUserPointer(const c8* attributeName, void* userPointer)
 {
-	Attributes.push_back(new CUserPointerAttribute(attributeName, userPointer));
+	addAttributeP(new CUserPointerAttribute(attributeName, userPointer));
 }
 
 //! Sets an attribute as user pointer
@@ -1277,7 +1347,7 @@ void CAttributes::setAttribute(const c8* attributeName, void* userPointer)
 		att->setUserPointer(userPointer);
 	else
 	{
-		Attributes.push_back(new CUserPointerAttribute(attributeName, userPointer));
+		addAttributeP(new CUserPointerAttribute(attributeName, userPointer));
 	}
 }
 
@@ -651,6 +651,24 @@ protected:
 
 	IAttribute* getAttributeP(const c8* attributeName);
 
+	//! appends an attribute and adds its name to the hash index
+	void addAttributeP(IAttribute* attribute);
+
+	//! drops and removes the attribute at the index
+	void removeAttributeP(u32 index);
+
+	//! inserts the name of the attribute at the index into the hash index
+	void insertIndex(u32 index);
+
+	//! recreates the hash index with enough buckets for all attributes
+	void rebuildIndex();
+
+	//! hash of the name of each attribute, parallel to Attributes
+	core::array<u32> NameHashes;
+
+	//! open addressing hash table of attribute indices, -1 for empty buckets
+	core::array<s32> HashBuckets;
+
 	video::IVideoDriver* Driver;
 };
 
@@ -6,6 +6,11 @@
 #define _C_BLIT_H_INCLUDED_
 
 #include "SoftwareDriver2_helper.h"
+#include "CColorConverter.h"
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+#include <emmintrin.h>
+#endif
 
 namespace irr
 {
@@ -532,19 +537,8 @@ static void executeBlit_TextureCopy_24_to_16( const SBlitJob * job )
 */
 static void executeBlit_TextureCopy_16_to_32( const SBlitJob * job )
 {
-	const u16 *src = (u16*) job->src;
-	u32 *dst = (u32*) job->dst;
-
-	for ( s32 dy = 0; dy != job->height; ++dy )
-	{
-		for ( s32 dx = 0; dx != job->width; ++dx )
-		{
-			dst[dx] = video::A1R5G5B5toA8R8G8B8( src[dx] );
-		}
-
-		src = (u16*) ( (u8*) (src) + job->srcPitch );
-		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
-	}
+	video::CColorConverter::convert_viaFormat( job->src, video::ECF_A1R5G5B5, job->srcPitch,
+		job->dst, video::ECF_A8R8G8B8, job->dstPitch, job->width, job->height );
 }
 
 static void executeBlit_TextureCopy_16_to_24( const SBlitJob * job )
@@ -573,43 +567,14 @@ static void executeBlit_TextureCopy_16_to_24( const SBlitJob * job )
 */
 static void executeBlit_TextureCopy_24_to_32( const SBlitJob * job )
 {
-	void *src = (void*) job->src;
-	u32 *dst = (u32*) job->dst;
-
-	for ( s32 dy = 0; dy != job->height; ++dy )
-	{
-		u8 * s = (u8*) src;
-
-		for ( s32 dx = 0; dx != job->width; ++dx )
-		{
-			dst[dx] = 0xFF000000 | s[0] << 16 | s[1] << 8 | s[2];
-			s += 3;
-		}
-
-		src = (void*) ( (u8*) (src) + job->srcPitch );
-		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
-	}
+	video::CColorConverter::convert_viaFormat( job->src, video::ECF_R8G8B8, job->srcPitch,
+		job->dst, video::ECF_A8R8G8B8, job->dstPitch, job->width, job->height );
 }
 
 static void executeBlit_TextureCopy_32_to_24( const SBlitJob * job )
 {
-	const u32 * src = (u32*) job->src;
-	u8 * dst = (u8*) job->dst;
-
-	for ( s32 dy = 0; dy != job->height; ++dy )
-	{
-		for ( s32 dx = 0; dx != job->width; ++dx )
-		{
-			u8 * writeTo = &dst[dx * 3];
-			*writeTo++ = (src[dx] >> 16)& 0xFF;
-			*writeTo++ = (src[dx] >> 8) & 0xFF;
-			*writeTo++ = src[dx] & 0xFF;
-		}
-
-		src = (u32*) ( (u8*) (src) + job->srcPitch );
-		dst += job->dstPitch ;
-	}
-
+	video::CColorConverter::convert_viaFormat( job->src, video::ECF_A8R8G8B8, job->srcPitch,
+		job->dst, video::ECF_R8G8B8, job->dstPitch, job->width, job->height );
 }
 
 
@@ -788,6 +753,322 @@ static void executeBlit_ColorAlpha_32_to_32( const SBlitJob * job )
 	}
 }
 
+#ifdef _IRR_COMPILE_WITH_SSE2_
+
+/*
+	SSE2 versions of the blitters, four 32 bit or eight 16 bit pixels per
+	iteration. They do the same fixed point math as the plain versions and
+	give the same results, pixels which don't fill a vector are done with the
+	plain pixel functions.
+*/
+
+/*!
+	low 32 bit of a * b, b < 65536 has to be stored in both 16 bit halfs of each lane
+*/
+inline __m128i Mul32_16_SSE2 ( const __m128i a, const __m128i b )
+{
+	return _mm_add_epi32 ( _mm_mullo_epi16 ( a, b ), _mm_slli_epi32 ( _mm_mulhi_epu16 ( a, b ), 16 ) );
+}
+
+/*!
+	PixelBlend32 ( c2, c1, alpha ) of four pixels
+	alpha [0;256] in both 16 bit halfs of each lane
+*/
+inline __m128i PixelBlend32_SSE2 ( const __m128i c2, const __m128i c1, const __m128i alpha )
+{
+	const __m128i maskRB = _mm_set1_epi32 ( 0x00FF00FF );
+	const __m128i maskXG = _mm_set1_epi32 ( 0x0000FF00 );
+
+	const __m128i dstRB = _mm_and_si128 ( c2, maskRB );
+	const __m128i dstXG = _mm_and_si128 ( c2, maskXG );
+
+	__m128i rb = _mm_sub_epi32 ( _mm_and_si128 ( c1, maskRB ), dstRB );
+	__m128i xg = _mm_sub_epi32 ( _mm_and_si128 ( c1, maskXG ), dstXG );
+
+	rb = _mm_srli_epi32 ( Mul32_16_SSE2 ( rb, alpha ), 8 );
+	xg = _mm_srli_epi32 ( Mul32_16_SSE2 ( xg, alpha ), 8 );
+
+	rb = _mm_and_si128 ( _mm_add_epi32 ( rb, dstRB ), maskRB );
+	xg = _mm_and_si128 ( _mm_add_epi32 ( xg, dstXG ), maskXG );
+
+	return _mm_or_si128 ( rb, xg );
+}
+
+/*!
+	PixelBlend32 ( c2, c1 ) of four pixels
+*/
+inline __m128i PixelBlend32_SSE2 ( const __m128i c2, const __m128i c1 )
+{
+	const __m128i a = _mm_srli_epi32 ( c1, 24 );
+
+	// add highbit alpha, if ( alpha > 127 ) alpha += 1;
+	__m128i alpha = _mm_add_epi32 ( a, _mm_srli_epi32 ( a, 7 ) );
+	alpha = _mm_or_si128 ( alpha, _mm_slli_epi32 ( alpha, 16 ) );
+
+	const __m128i blend = _mm_or_si128 ( _mm_and_si128 ( c1, _mm_set1_epi32 ( (s32) 0xFF000000 ) ),
+								PixelBlend32_SSE2 ( c2, c1, alpha ) );
+
+	// fully transparent pixels keep the destination
+	const __m128i transparent = _mm_cmpeq_epi32 ( a, _mm_setzero_si128 () );
+	return _mm_or_si128 ( _mm_and_si128 ( transparent, c2 ), _mm_andnot_si128 ( transparent, blend ) );
+}
+
+/*!
+	PixelMul32_2 ( c0, c1 ) of four pixels
+*/
+inline __m128i PixelMul32_2_SSE2 ( const __m128i c0, const __m128i c1 )
+{
+	const __m128i zero = _mm_setzero_si128 ();
+	const __m128i lo = _mm_srli_epi16 ( _mm_mullo_epi16 ( _mm_unpacklo_epi8 ( c0, zero ), _mm_unpacklo_epi8 ( c1, zero ) ), 8 );
+	const __m128i hi = _mm_srli_epi16 ( _mm_mullo_epi16 ( _mm_unpackhi_epi8 ( c0, zero ), _mm_unpackhi_epi8 ( c1, zero ) ), 8 );
+	return _mm_packus_epi16 ( lo, hi );
+}
+
+/*!
+	A8R8G8B8toA1R5G5B5 ( PixelLerp32 ( c | 0xFF000000, extractAlpha ( c ) ) ) of four pixels
+	the results are sign extended to 32 bit, ready for _mm_packs_epi32
+*/
+inline __m128i PixelPremultiply16_SSE2 ( const __m128i c )
+{
+	const __m128i zero = _mm_setzero_si128 ();
+	const __m128i a = _mm_srli_epi32 ( c, 24 );
+
+	__m128i value = _mm_add_epi32 ( a, _mm_srli_epi32 ( c, 31 ) );
+	value = _mm_or_si128 ( value, _mm_slli_epi32 ( value, 16 ) );
+
+	const __m128i s = _mm_or_si128 ( c, _mm_set1_epi32 ( (s32) 0xFF000000 ) );
+	const __m128i lo = _mm_srli_epi16 ( _mm_mullo_epi16 ( _mm_unpacklo_epi8 ( s, zero ), _mm_unpacklo_epi32 ( value, value ) ), 8 );
+	const __m128i hi = _mm_srli_epi16 ( _mm_mullo_epi16 ( _mm_unpackhi_epi8 ( s, zero ), _mm_unpackhi_epi32 ( value, value ) ), 8 );
+	const __m128i l = _mm_packus_epi16 ( lo, hi );
+
+	const __m128i r = _mm_or_si128 (
+				_mm_or_si128 ( _mm_and_si128 ( _mm_srli_epi32 ( l, 16 ), _mm_set1_epi32 ( 0x8000 ) ),
+							_mm_and_si128 ( _mm_srli_epi32 ( l, 9 ), _mm_set1_epi32 ( 0x7C00 ) ) ),
+				_mm_or_si128 ( _mm_and_si128 ( _mm_srli_epi32 ( l, 6 ), _mm_set1_epi32 ( 0x03E0 ) ),
+							_mm_and_si128 ( _mm_srli_epi32 ( l, 3 ), _mm_set1_epi32 ( 0x001F ) ) ) );
+	return _mm_srai_epi32 ( _mm_slli_epi32 ( r, 16 ), 16 );
+}
+
+
+/*!
+*/
+static void executeBlit_TextureCopy_32_to_16_SSE2( const SBlitJob * job )
+{
+	const u32 *src = static_cast<const u32*>(job->src);
+	u16 *dst = static_cast<u16*>(job->dst);
+
+	const s32 vecWidth = job->width & ~7;
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		s32 dx;
+		for ( dx = 0; dx != vecWidth; dx += 8 )
+		{
+			const __m128i lo = PixelPremultiply16_SSE2 ( _mm_loadu_si128 ( (const __m128i*) ( src + dx ) ) );
+			const __m128i hi = PixelPremultiply16_SSE2 ( _mm_loadu_si128 ( (const __m128i*) ( src + dx + 4 ) ) );
+			_mm_storeu_si128 ( (__m128i*) ( dst + dx ), _mm_packs_epi32 ( lo, hi ) );
+		}
+
+		for ( ; dx != job->width; ++dx )
+		{
+			//16 bit Blitter depends on pre-multiplied color
+			const u32 s = PixelLerp32( src[dx] | 0xFF000000, extractAlpha( src[dx] ) );
+			dst[dx] = video::A8R8G8B8toA1R5G5B5( s );
+		}
+
+		src = (u32*) ( (u8*) (src) + job->srcPitch );
+		dst = (u16*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+/*!
+*/
+static void executeBlit_TextureBlend_16_to_16_SSE2( const SBlitJob * job )
+{
+	u16 *src = (u16*) job->src;
+	u16 *dst = (u16*) job->dst;
+
+	const s32 vecWidth = job->width & ~7;
+	const __m128i low15 = _mm_set1_epi16 ( 0x7fff );
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		s32 dx;
+		for ( dx = 0; dx != vecWidth; dx += 8 )
+		{
+			const __m128i s = _mm_loadu_si128 ( (__m128i*) ( src + dx ) );
+			const __m128i d = _mm_loadu_si128 ( (__m128i*) ( dst + dx ) );
+			const __m128i mask = _mm_add_epi16 ( _mm_srli_epi16 ( s, 15 ), low15 );
+			_mm_storeu_si128 ( (__m128i*) ( dst + dx ), _mm_or_si128 ( _mm_and_si128 ( d, mask ), _mm_andnot_si128 ( mask, s ) ) );
+		}
+
+		for ( ; dx != job->width; ++dx )
+		{
+			dst[dx] = PixelBlend16( dst[dx], src[dx] );
+		}
+
+		src = (u16*) ( (u8*) (src) + job->srcPitch );
+		dst = (u16*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+/*!
+*/
+static void executeBlit_TextureBlend_32_to_32_SSE2( const SBlitJob * job )
+{
+	u32 *src = (u32*) job->src;
+	u32 *dst = (u32*) job->dst;
+
+	const s32 vecWidth = job->width & ~3;
+	const __m128i zero = _mm_setzero_si128 ();
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		s32 dx;
+		for ( dx = 0; dx != vecWidth; dx += 4 )
+		{
+			const __m128i s = _mm_loadu_si128 ( (__m128i*) ( src + dx ) );
+			const __m128i a = _mm_srli_epi32 ( s, 24 );
+
+			// skip transparent parts and copy opaque parts, typical for fonts and gui images
+			const s32 transparent = _mm_movemask_epi8 ( _mm_cmpeq_epi32 ( a, zero ) );
+			if ( 0xFFFF == transparent )
+				continue;
+			if ( 0xFFFF == _mm_movemask_epi8 ( _mm_cmpeq_epi32 ( a, _mm_set1_epi32 ( 0xFF ) ) ) )
+			{
+				_mm_storeu_si128 ( (__m128i*) ( dst + dx ), s );
+				continue;
+			}
+
+			const __m128i d = _mm_loadu_si128 ( (__m128i*) ( dst + dx ) );
+			_mm_storeu_si128 ( (__m128i*) ( dst + dx ), PixelBlend32_SSE2 ( d, s ) );
+		}
+
+		for ( ; dx != job->width; ++dx )
+		{
+			dst[dx] = PixelBlend32( dst[dx], src[dx] );
+		}
+
+		src = (u32*) ( (u8*) (src) + job->srcPitch );
+		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+/*!
+*/
+static void executeBlit_TextureBlendColor_16_to_16_SSE2( const SBlitJob * job )
+{
+	u16 *src = (u16*) job->src;
+	u16 *dst = (u16*) job->dst;
+
+	const u16 blend = video::A8R8G8B8toA1R5G5B5 ( job->argb );
+	const __m128i mask5 = _mm_set1_epi16 ( 0x1F );
+	const __m128i blendR = _mm_set1_epi16 ( ( blend >> 10 ) & 0x1F );
+	const __m128i blendG = _mm_set1_epi16 ( ( blend >> 5 ) & 0x1F );
+	const __m128i blendB = _mm_set1_epi16 ( blend & 0x1F );
+	const __m128i blendA = _mm_set1_epi16 ( (s16) ( blend & 0x8000 ) );
+
+	const s32 vecWidth = job->width & ~7;
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		s32 dx;
+		for ( dx = 0; dx != vecWidth; dx += 8 )
+		{
+			const __m128i s = _mm_loadu_si128 ( (__m128i*) ( src + dx ) );
+			const __m128i visible = _mm_srai_epi16 ( s, 15 );
+			if ( 0 == _mm_movemask_epi8 ( visible ) )
+				continue;
+
+			const __m128i r = _mm_mullo_epi16 ( _mm_and_si128 ( _mm_srli_epi16 ( s, 10 ), mask5 ), blendR );
+			const __m128i g = _mm_mullo_epi16 ( _mm_and_si128 ( _mm_srli_epi16 ( s, 5 ), mask5 ), blendG );
+			const __m128i b = _mm_mullo_epi16 ( _mm_and_si128 ( s, mask5 ), blendB );
+
+			const __m128i c = _mm_or_si128 (
+						_mm_or_si128 ( _mm_slli_epi16 ( _mm_srli_epi16 ( r, 5 ), 10 ), _mm_slli_epi16 ( _mm_srli_epi16 ( g, 5 ), 5 ) ),
+						_mm_or_si128 ( _mm_srli_epi16 ( b, 5 ), _mm_and_si128 ( s, blendA ) ) );
+
+			const __m128i d = _mm_loadu_si128 ( (__m128i*) ( dst + dx ) );
+			_mm_storeu_si128 ( (__m128i*) ( dst + dx ), _mm_or_si128 ( _mm_and_si128 ( visible, c ), _mm_andnot_si128 ( visible, d ) ) );
+		}
+
+		for ( ; dx != job->width; ++dx )
+		{
+			if ( 0 == (src[dx] & 0x8000) )
+				continue;
+
+			dst[dx] = PixelMul16_2( src[dx], blend );
+		}
+
+		src = (u16*) ( (u8*) (src) + job->srcPitch );
+		dst = (u16*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+/*!
+*/
+static void executeBlit_TextureBlendColor_32_to_32_SSE2( const SBlitJob * job )
+{
+	u32 *src = (u32*) job->src;
+	u32 *dst = (u32*) job->dst;
+
+	const s32 vecWidth = job->width & ~3;
+	const __m128i color = _mm_set1_epi32 ( job->argb );
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		s32 dx;
+		for ( dx = 0; dx != vecWidth; dx += 4 )
+		{
+			const __m128i s = PixelMul32_2_SSE2 ( _mm_loadu_si128 ( (__m128i*) ( src + dx ) ), color );
+			const __m128i d = _mm_loadu_si128 ( (__m128i*) ( dst + dx ) );
+			_mm_storeu_si128 ( (__m128i*) ( dst + dx ), PixelBlend32_SSE2 ( d, s ) );
+		}
+
+		for ( ; dx != job->width; ++dx )
+		{
+			dst[dx] = PixelBlend32( dst[dx], PixelMul32_2( src[dx], job->argb ) );
+		}
+
+		src = (u32*) ( (u8*) (src) + job->srcPitch );
+		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+/*!
+*/
+static void executeBlit_ColorAlpha_32_to_32_SSE2( const SBlitJob * job )
+{
+	u32 *dst = (u32*) job->dst;
+
+	const u32 alpha = extractAlpha( job->argb );
+	const u32 src = job->argb;
+
+	const s32 vecWidth = job->width & ~3;
+	const __m128i color = _mm_set1_epi32 ( src );
+	const __m128i colorAlpha = _mm_set1_epi32 ( src & 0xFF000000 );
+	const __m128i alpha2 = _mm_set1_epi32 ( alpha | alpha << 16 );
+
+	for ( s32 dy = 0; dy != job->height; ++dy )
+	{
+		s32 dx;
+		for ( dx = 0; dx != vecWidth; dx += 4 )
+		{
+			const __m128i d = _mm_loadu_si128 ( (__m128i*) ( dst + dx ) );
+			_mm_storeu_si128 ( (__m128i*) ( dst + dx ), _mm_or_si128 ( colorAlpha, PixelBlend32_SSE2 ( d, color, alpha2 ) ) );
+		}
+
+		for ( ; dx != job->width; ++dx )
+		{
+			dst[dx] = (job->argb & 0xFF000000 ) | PixelBlend32( dst[dx], src, alpha );
+		}
+
+		dst = (u32*) ( (u8*) (dst) + job->dstPitch );
+	}
+}
+
+#endif // _IRR_COMPILE_WITH_SSE2_
+
 // Blitter Operation
 enum eBlitter
 {
@@ -812,8 +1093,17 @@ struct blitterTable
 	tExecuteBlit func;
 };
 
+// the first matching entry is used, so specialized versions come first
 static const blitterTable blitTable[] =
 {
+#ifdef _IRR_COMPILE_WITH_SSE2_
+	{ BLITTER_TEXTURE, video::ECF_A1R5G5B5, video::ECF_A8R8G8B8, executeBlit_TextureCopy_32_to_16_SSE2 },
+	{ BLITTER_TEXTURE_ALPHA_BLEND, video::ECF_A1R5G5B5, video::ECF_A1R5G5B5, executeBlit_TextureBlend_16_to_16_SSE2 },
+	{ BLITTER_TEXTURE_ALPHA_BLEND, video::ECF_A8R8G8B8, video::ECF_A8R8G8B8, executeBlit_TextureBlend_32_to_32_SSE2 },
+	{ BLITTER_TEXTURE_ALPHA_COLOR_BLEND, video::ECF_A1R5G5B5, video::ECF_A1R5G5B5, executeBlit_TextureBlendColor_16_to_16_SSE2 },
+	{ BLITTER_TEXTURE_ALPHA_COLOR_BLEND, video::ECF_A8R8G8B8, video::ECF_A8R8G8B8, executeBlit_TextureBlendColor_32_to_32_SSE2 },
+	{ BLITTER_COLOR_ALPHA, video::ECF_A8R8G8B8, -1, executeBlit_ColorAlpha_32_to_32_SSE2 },
+#endif
 	{ BLITTER_TEXTURE, -2, -2, executeBlit_TextureCopy_x_to_x },
 	{ BLITTER_TEXTURE, video::ECF_A1R5G5B5, video::ECF_A8R8G8B8, executeBlit_TextureCopy_32_to_16 },
 	{ BLITTER_TEXTURE, video::ECF_A1R5G5B5, video::ECF_R8G8B8, executeBlit_TextureCopy_24_to_16 },
@@ -838,6 +1128,11 @@ static inline tExecuteBlit getBlitter2( eBlitter operation,const video::IImage *
 	video::ECOLOR_FORMAT sourceFormat = (video::ECOLOR_FORMAT) ( source ? source->getColorFormat() : -1 );
 	video::ECOLOR_FORMAT destFormat = (video::ECOLOR_FORMAT) ( dest ? dest->getColorFormat() : -1 );
 
+	// blocks of compressed images can't be addressed per pixel
+	if ((source && video::IImage::isCompressedFormat(sourceFormat)) ||
+		(dest && video::IImage::isCompressedFormat(destFormat)))
+		return 0;
+
 	const blitterTable * b = blitTable;
 
 	while ( b->operation != BLITTER_INVALID )
@@ -0,0 +1,426 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CBlockCompression.h"
+#include "CColorConverter.h"
+#include "CThreadPool.h"
+#include "irrArray.h"
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+
+// bands of block rows on the thread pool have at least this many blocks
+const u32 BLOCK_BAND_SIZE = 1024;
+
+//! expands a R5G6B5 color to an opaque A8R8G8B8 color
+inline u32 expand565(u32 c)
+{
+	const u32 r = (c >> 11) & 0x1F;
+	const u32 g = (c >> 5) & 0x3F;
+	const u32 b = c & 0x1F;
+	return 0xFF000000 | ((r << 3) | (r >> 2)) << 16 | ((g << 2) | (g >> 4)) << 8 | ((b << 3) | (b >> 2));
+}
+
+//! (a*wa + b*wb) / (wa+wb) for each color channel, alpha is opaque
+inline u32 mixColors(u32 a, u32 b, u32 wa, u32 wb)
+{
+	const u32 w = wa + wb;
+	return 0xFF000000 |
+		(((a >> 16 & 0xFF) * wa + (b >> 16 & 0xFF) * wb) / w) << 16 |
+		(((a >> 8 & 0xFF) * wa + (b >> 8 & 0xFF) * wb) / w) << 8 |
+		(((a & 0xFF) * wa + (b & 0xFF) * wb) / w);
+}
+
+//! builds the four colors of a color block, the fourth is transparent black in three color mode
+void buildColorPalette(u32 c0, u32 c1, bool fourColors, u32* palette)
+{
+	palette[0] = expand565(c0);
+	palette[1] = expand565(c1);
+	if (fourColors)
+	{
+		palette[2] = mixColors(palette[0], palette[1], 2, 1);
+		palette[3] = mixColors(palette[0], palette[1], 1, 2);
+	}
+	else
+	{
+		palette[2] = mixColors(palette[0], palette[1], 1, 1);
+		palette[3] = 0;
+	}
+}
+
+//! builds the eight alpha values of a DXT5 alpha block
+void buildAlphaPalette(u32 a0, u32 a1, u32* palette)
+{
+	palette[0] = a0;
+	palette[1] = a1;
+	if (a0 > a1)
+	{
+		for (u32 i=1; i<7; ++i)
+			palette[i+1] = ((7-i) * a0 + i * a1) / 7;
+	}
+	else
+	{
+		for (u32 i=1; i<5; ++i)
+			palette[i+1] = ((5-i) * a0 + i * a1) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+//! decodes the 8 byte color part of a block, DXT3 and DXT5 always use four colors
+void decodeColors(const u8* block, u32* pixels, bool dxt1)
+{
+	const u32 c0 = block[0] | block[1] << 8;
+	const u32 c1 = block[2] | block[3] << 8;
+
+	u32 palette[4];
+	buildColorPalette(c0, c1, !dxt1 || c0 > c1, palette);
+
+	const u32 indices = block[4] | block[5] << 8 | block[6] << 16 | (u32)block[7] << 24;
+	for (u32 i=0; i<16; ++i)
+		pixels[i] = palette[(indices >> (2*i)) & 3];
+}
+
+//! decodes the 8 byte alpha part of a DXT3 block
+void decodeExplicitAlpha(const u8* block, u32* pixels)
+{
+	for (u32 i=0; i<16; ++i)
+	{
+		const u32 a = (block[i >> 1] >> ((i & 1) * 4)) & 0xF;
+		pixels[i] = (pixels[i] & 0x00FFFFFF) | (a * 17) << 24;
+	}
+}
+
+//! decodes the 8 byte alpha part of a DXT5 block
+void decodeInterpolatedAlpha(const u8* block, u32* pixels)
+{
+	u32 palette[8];
+	buildAlphaPalette(block[0], block[1], palette);
+
+	for (u32 half=0; half<2; ++half)
+	{
+		const u8* p = block + 2 + half * 3;
+		const u32 indices = p[0] | p[1] << 8 | p[2] << 16;
+		for (u32 i=0; i<8; ++i)
+		{
+			u32& pixel = pixels[half * 8 + i];
+			pixel = (pixel & 0x00FFFFFF) | palette[(indices >> (3*i)) & 7] << 24;
+		}
+	}
+}
+
+inline u32 colorDistance(u32 a, u32 b)
+{
+	const s32 r = (s32)(a >> 16 & 0xFF) - (s32)(b >> 16 & 0xFF);
+	const s32 g = (s32)(a >> 8 & 0xFF) - (s32)(b >> 8 & 0xFF);
+	const s32 bl = (s32)(a & 0xFF) - (s32)(b & 0xFF);
+	return r*r + g*g + bl*bl;
+}
+
+inline u32 to565(u32 r, u32 g, u32 b)
+{
+	return (r >> 3) << 11 | (g >> 2) << 5 | (b >> 3);
+}
+
+//! encodes the colors of 16 pixels into 8 bytes
+/** \param transparency Pixels with alpha below 128 become transparent,
+only possible for DXT1. */
+void encodeColors(const u32* pixels, u8* block, bool transparency)
+{
+	u32 minC[3] = { 255, 255, 255 };
+	u32 maxC[3] = { 0, 0, 0 };
+	bool hasTransparent = false;
+
+	for (u32 i=0; i<16; ++i)
+	{
+		if (transparency && pixels[i] < 0x80000000)
+		{
+			hasTransparent = true;
+			continue;
+		}
+		for (u32 c=0; c<3; ++c)
+		{
+			const u32 v = (pixels[i] >> (16 - 8*c)) & 0xFF;
+			minC[c] = core::min_(minC[c], v);
+			maxC[c] = core::max_(maxC[c], v);
+		}
+	}
+
+	// move the end points inside the box a bit, this reduces the error
+	// for the colors in between
+	for (u32 c=0; c<3; ++c)
+	{
+		if (minC[c] > maxC[c])
+			minC[c] = maxC[c] = 0;
+		const u32 inset = (maxC[c] - minC[c]) >> 4;
+		minC[c] += inset;
+		maxC[c] -= inset;
+	}
+
+	u32 c0 = to565(maxC[0], maxC[1], maxC[2]);
+	u32 c1 = to565(minC[0], minC[1], minC[2]);
+
+	// four colors need c0 > c1, three colors and transparency c0 <= c1
+	if (hasTransparent ? c0 > c1 : c0 < c1)
+		core::swap(c0, c1);
+
+	u32 indices = 0;
+	if (c0 != c1 || hasTransparent)
+	{
+		const bool fourColors = !hasTransparent;
+		u32 palette[4];
+		buildColorPalette(c0, c1, fourColors, palette);
+
+		for (u32 i=0; i<16; ++i)
+		{
+			u32 index = 3;
+			if (!hasTransparent || pixels[i] >= 0x80000000)
+			{
+				u32 best = colorDistance(pixels[i], palette[0]);
+				index = 0;
+				for (u32 j=1; j<(fourColors ? 4u : 3u); ++j)
+				{
+					const u32 d = colorDistance(pixels[i], palette[j]);
+					if (d < best)
+					{
+						best = d;
+						index = j;
+					}
+				}
+			}
+			indices |= index << (2*i);
+		}
+	}
+
+	block[0] = (u8)c0;
+	block[1] = (u8)(c0 >> 8);
+	block[2] = (u8)c1;
+	block[3] = (u8)(c1 >> 8);
+	block[4] = (u8)indices;
+	block[5] = (u8)(indices >> 8);
+	block[6] = (u8)(indices >> 16);
+	block[7] = (u8)(indices >> 24);
+}
+
+//! encodes the alpha of 16 pixels into the 8 byte DXT3 alpha part
+void encodeExplicitAlpha(const u32* pixels, u8* block)
+{
+	for (u32 i=0; i<8; ++i)
+		block[i] = (u8)((pixels[2*i] >> 28) | ((pixels[2*i+1] >> 28) << 4));
+}
+
+//! encodes the alpha of 16 pixels into the 8 byte DXT5 alpha part
+void encodeInterpolatedAlpha(const u32* pixels, u8* block)
+{
+	u32 minA = 255;
+	u32 maxA = 0;
+	for (u32 i=0; i<16; ++i)
+	{
+		minA = core::min_(minA, pixels[i] >> 24);
+		maxA = core::max_(maxA, pixels[i] >> 24);
+	}
+
+	u32 palette[8];
+	buildAlphaPalette(maxA, minA, palette);
+
+	block[0] = (u8)maxA;
+	block[1] = (u8)minA;
+	for (u32 half=0; half<2; ++half)
+	{
+		u32 indices = 0;
+		for (u32 i=0; i<8; ++i)
+		{
+			const s32 a = pixels[half * 8 + i] >> 24;
+			u32 index = 0;
+			s32 best = core::abs_(a - (s32)palette[0]);
+			for (u32 j=1; j<8 && best; ++j)
+			{
+				const s32 d = core::abs_(a - (s32)palette[j]);
+				if (d < best)
+				{
+					best = d;
+					index = j;
+				}
+			}
+			indices |= index << (3*i);
+		}
+		u8* p = block + 2 + half * 3;
+		p[0] = (u8)indices;
+		p[1] = (u8)(indices >> 8);
+		p[2] = (u8)(indices >> 16);
+	}
+}
+
+
+//! block rows processed by the thread pool
+struct SBlockTask
+{
+	const u8* Source;
+	u8* Target;
+	core::dimension2d<u32> Size;
+	u32 Pitch;
+	ECOLOR_FORMAT SourceFormat;
+	ECOLOR_FORMAT TargetFormat;
+};
+
+void decompressBand(void* userData, u32 begin, u32 end)
+{
+	const SBlockTask& task = *(const SBlockTask*)userData;
+	const u32 blockSize = CBlockCompression::getBlockSize(task.SourceFormat);
+	const u32 blocksX = (task.Size.Width + 3) / 4;
+
+	// four rows of decoded pixels
+	core::array<u32> rows;
+	rows.set_used(blocksX * 16);
+
+	for (u32 by=begin; by<end; ++by)
+	{
+		const u8* block = task.Source + by * blocksX * blockSize;
+		for (u32 bx=0; bx<blocksX; ++bx, block+=blockSize)
+		{
+			u32 pixels[16];
+			CBlockCompression::decodeBlock(task.SourceFormat, block, pixels);
+			for (u32 y=0; y<4; ++y)
+				memcpy(&rows[y * blocksX * 4 + bx * 4], pixels + y * 4, 16);
+		}
+
+		const u32 rowCount = core::min_(4u, task.Size.Height - by * 4);
+		for (u32 y=0; y<rowCount; ++y)
+			CColorConverter::convert_viaFormat(&rows[y * blocksX * 4], ECF_A8R8G8B8, task.Size.Width,
+					task.Target + (by * 4 + y) * task.Pitch, task.TargetFormat);
+	}
+}
+
+void compressBand(void* userData, u32 begin, u32 end)
+{
+	const SBlockTask& task = *(const SBlockTask*)userData;
+	const u32 blockSize = CBlockCompression::getBlockSize(task.TargetFormat);
+	const u32 blocksX = (task.Size.Width + 3) / 4;
+
+	for (u32 by=begin; by<end; ++by)
+	{
+		u8* block = task.Target + by * blocksX * blockSize;
+		for (u32 bx=0; bx<blocksX; ++bx, block+=blockSize)
+		{
+			// pixels outside of the image repeat the last row and column
+			u32 pixels[16];
+			for (u32 y=0; y<4; ++y)
+			{
+				const u32* row = (const u32*)(task.Source + core::min_(by * 4 + y, task.Size.Height - 1) * task.Pitch);
+				for (u32 x=0; x<4; ++x)
+					pixels[y * 4 + x] = row[core::min_(bx * 4 + x, task.Size.Width - 1)];
+			}
+
+			switch (task.TargetFormat)
+			{
+			case ECF_DXT1:
+				encodeColors(pixels, block, true);
+				break;
+			case ECF_DXT3:
+				encodeExplicitAlpha(pixels, block);
+				encodeColors(pixels, block + 8, false);
+				break;
+			case ECF_DXT5:
+				encodeInterpolatedAlpha(pixels, block);
+				encodeColors(pixels, block + 8, false);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
+
+} // end anonymous namespace
+
+
+//! returns the size of a block in bytes, 0 for uncompressed formats
+u32 CBlockCompression::getBlockSize(ECOLOR_FORMAT format)
+{
+	return IImage::isCompressedFormat(format) ? IImage::getBitsPerPixelFromFormat(format) * 2 : 0;
+}
+
+
+//! decodes one block into 16 A8R8G8B8 pixels, stored row by row
+void CBlockCompression::decodeBlock(ECOLOR_FORMAT format, const void* block, u32* pixels)
+{
+	const u8* b = (const u8*)block;
+	switch (format)
+	{
+	case ECF_DXT1:
+		decodeColors(b, pixels, true);
+		break;
+	case ECF_DXT3:
+		decodeColors(b + 8, pixels, false);
+		decodeExplicitAlpha(b, pixels);
+		break;
+	case ECF_DXT5:
+		decodeColors(b + 8, pixels, false);
+		decodeInterpolatedAlpha(b, pixels);
+		break;
+	default:
+		memset(pixels, 0, 16 * sizeof(u32));
+		break;
+	}
+}
+
+
+//! decompresses an image into one of the formats CColorConverter supports
+bool CBlockCompression::decompress(const void* source, ECOLOR_FORMAT sourceFormat,
+		const core::dimension2d<u32>& size,
+		void* target, ECOLOR_FORMAT targetFormat, u32 targetPitch)
+{
+	if (!source || !target || !IImage::isCompressedFormat(sourceFormat) ||
+		IImage::isCompressedFormat(targetFormat) || IImage::isRenderTargetOnlyFormat(targetFormat))
+		return false;
+	if (!size.Width || !size.Height)
+		return true;
+
+	SBlockTask task;
+	task.Source = (const u8*)source;
+	task.Target = (u8*)target;
+	task.Size = size;
+	task.Pitch = targetPitch;
+	task.SourceFormat = sourceFormat;
+	task.TargetFormat = targetFormat;
+
+	const u32 blocksX = (size.Width + 3) / 4;
+	CThreadPool::getSharedPool()->parallelFor((size.Height + 3) / 4,
+			core::max_(1u, BLOCK_BAND_SIZE / blocksX), decompressBand, &task);
+	return true;
+}
+
+
+//! compresses an A8R8G8B8 image
+bool CBlockCompression::compress(const void* source, const core::dimension2d<u32>& size, u32 sourcePitch,
+		void* target, ECOLOR_FORMAT targetFormat)
+{
+	if (!source || !target || !IImage::isCompressedFormat(targetFormat))
+		return false;
+	if (!size.Width || !size.Height)
+		return true;
+
+	SBlockTask task;
+	task.Source = (const u8*)source;
+	task.Target = (u8*)target;
+	task.Size = size;
+	task.Pitch = sourcePitch;
+	task.SourceFormat = ECF_A8R8G8B8;
+	task.TargetFormat = targetFormat;
+
+	const u32 blocksX = (size.Width + 3) / 4;
+	CThreadPool::getSharedPool()->parallelFor((size.Height + 3) / 4,
+			core::max_(1u, BLOCK_BAND_SIZE / blocksX), compressBand, &task);
+	return true;
+}
+
+
+} // end namespace video
+} // end namespace irr
+
@@ -0,0 +1,47 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_BLOCK_COMPRESSION_H_INCLUDED__
+#define __C_BLOCK_COMPRESSION_H_INCLUDED__
+
+#include "IImage.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! Encodes and decodes the block compressed formats ECF_DXT1, ECF_DXT3 and ECF_DXT5
+/** Whole images are processed in bands of block rows on the shared thread
+pool. The encoder fits the colors of a block into their bounding box,
+which is fast and good enough for generated mip maps and rescaled
+textures, but not as good as offline tools. */
+class CBlockCompression
+{
+public:
+
+	//! returns the size of a block in bytes, 0 for uncompressed formats
+	static u32 getBlockSize(ECOLOR_FORMAT format);
+
+	//! decodes one block into 16 A8R8G8B8 pixels, stored row by row
+	static void decodeBlock(ECOLOR_FORMAT format, const void* block, u32* pixels);
+
+	//! decompresses an image into one of the formats CColorConverter supports
+	/** \return False if a color format is not supported. */
+	static bool decompress(const void* source, ECOLOR_FORMAT sourceFormat,
+			const core::dimension2d<u32>& size,
+			void* target, ECOLOR_FORMAT targetFormat, u32 targetPitch);
+
+	//! compresses an A8R8G8B8 image
+	/** The target must hold IImage::getDataSizeFromFormat() bytes.
+	\return False if the target format is not compressed. */
+	static bool compress(const void* source, const core::dimension2d<u32>& size, u32 sourcePitch,
+			void* target, ECOLOR_FORMAT targetFormat);
+};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
@@ -1642,7 +1642,7 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 
 	core::stringc VertexPositionSource; // each mesh has exactly one <vertex> member, containing
 										// a POSITION input. This string stores the source of this input.
-	core::array<SSource> sources;
+	core::list<SSource> sources; // a list, so the arrays are never copied while sources are added
 	bool okToReadArray = false;
 
 	SAnimatedMesh* amesh = new SAnimatedMesh();
@@ -1666,10 +1666,10 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 			{
 				// create a new source
 				sources.push_back(SSource());
-				sources.getLast().Id = readId(reader);
+				(*sources.getLast()).Id = readId(reader);
 
 				#ifdef COLLADA_READER_DEBUG
-				os::Printer::log("Reading source", sources.getLast().Id.c_str());
+				os::Printer::log("Reading source", (*sources.getLast()).Id.c_str());
 				#endif
 			}
 			else
@@ -1678,17 +1678,18 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 				// create a new array and read it.
 				if (!sources.empty())
 				{
-					sources.getLast().Array.Name = readId(reader);
+					SNumberArray& array = (*sources.getLast()).Array;
+					array.Name = readId(reader);
 
 					int count = reader->getAttributeValueAsInt("count");
-					sources.getLast().Array.Data.set_used(count); // pre allocate
+					array.Data.set_used(count); // pre allocate
 
 					// check if type of array is ok
 					const char* type = reader->getAttributeValue("type");
 					okToReadArray = (type && (!strcmp("float", type) || !strcmp("int", type))) || floatArraySectionName == nodeName || intArraySectionName == nodeName;
 
 					#ifdef COLLADA_READER_DEBUG
-					os::Printer::log("Read array", sources.getLast().Array.Name.c_str());
+					os::Printer::log("Read array", array.Name.c_str());
 					#endif
 				}
 				#ifdef COLLADA_READER_DEBUG
@@ -1716,8 +1717,8 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 				readColladaParameters(reader, accessorSectionName);
 				if (!sources.empty())
 				{
-					sources.getLast().Accessors.push_back(accessor);
-					sources.getLast().Accessors.getLast().Parameters = ColladaParameters;
+					(*sources.getLast()).Accessors.push_back(accessor);
+					(*sources.getLast()).Accessors.getLast().Parameters = ColladaParameters;
 				}
 			}
 			else
@@ -1772,19 +1773,12 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 			// read array data
 			if (okToReadArray && !sources.empty())
 			{
-				core::array<f32>& a = sources.getLast().Array.Data;
-				core::stringc data = reader->getNodeData();
-				data.trim();
-				const c8* p = &data[0];
-
-				for (u32 i=0; i<a.size(); ++i)
-				{
-					findNextNoneWhiteSpace(&p);
-					if (*p)
-						a[i] = readFloat(&p);
-					else
-						a[i] = 0.0f;
-				}
+				// parse straight from the text of the reader, big arrays
+				// are not copied into temporary strings
+				core::array<f32>& a = (*sources.getLast()).Array.Data;
+				const u32 read = a.size() ? core::fast_atof_array(reader->getNodeData(), a.pointer(), a.size()) : 0;
+				for (u32 i=read; i<a.size(); ++i)
+					a[i] = 0.0f;
 			} // end reading array
 
 			okToReadArray = false;
@@ -1842,14 +1836,249 @@ void CColladaFileLoader::readGeometry(io::IXMLReaderUTF8* reader)
 }
 
 
-struct SPolygon
+namespace
 {
-	core::array<s32> Indices;
+
+//! Builds a mesh buffer from the index groups of a polygon section while they are parsed
+/** Every group of indices becomes one vertex, which is appended to the buffer
+right away. Standard vertices are merged with equal vertices already in the
+buffer through a hash table, so apart from the source arrays only the final
+vertices and indices are kept in memory. */
+struct SPrimitiveAssembler
+{
+	SPrimitiveAssembler(const core::array<SColladaInput>& inputs, bool flipAxis)
+		: Inputs(inputs), Buffer(0), LightMapBuffer(0), Indices(0),
+		SecondTexCoordSet(0xFFFFFFFF), GroupSize(1), GroupFill(0),
+		NextPrimitive(0), ExplicitEnd(false), FlipAxis(flipAxis)
+	{
+	}
+
+	~SPrimitiveAssembler()
+	{
+		if (getBuffer())
+			getBuffer()->drop();
+	}
+
+	//! creates the mesh buffer, call after all inputs of the section have been read
+	/** \param groupSize Number of indices per vertex.
+	\param explicitEnd True if primitives are closed by endPrimitive() only, otherwise
+	they are closed after the number of corners given in VertexCounts or after 3 corners. */
+	void begin(u32 groupSize, bool explicitEnd)
+	{
+		if (getBuffer())
+			return;
+
+		GroupSize = groupSize;
+		ExplicitEnd = explicitEnd;
+		Group.set_used(GroupSize);
+
+		// if there is more than one texture coordinate set, create a lightmap mesh buffer,
+		// otherwise use a standard mesh buffer
+		u32 textureCoordSetCount = 0;
+		for (u32 i=0; i<Inputs.size(); ++i)
+		{
+			if (Inputs[i].Semantic == ECIS_TEXCOORD || Inputs[i].Semantic == ECIS_UV)
+			{
+				++textureCoordSetCount;
+				if (textureCoordSetCount==2)
+					SecondTexCoordSet = i;
+			}
+		}
+
+		if (textureCoordSetCount < 2)
+		{
+			Buffer = new SMeshBuffer();
+			Indices = &Buffer->Indices;
+			Buckets.set_used(1024);
+			memset(Buckets.pointer(), 0, Buckets.size()*sizeof(u32));
+		}
+		else
+		{
+			LightMapBuffer = new SMeshBufferLightMap();
+			Indices = &LightMapBuffer->Indices;
+		}
+		skipEmptyPrimitives();
+	}
+
+	IMeshBuffer* getBuffer() const
+	{
+		return Buffer ? (IMeshBuffer*)Buffer : (IMeshBuffer*)LightMapBuffer;
+	}
+
+	//! adds the next index of the section
+	void addIndex(s32 index)
+	{
+		Group[GroupFill] = index;
+		if (++GroupFill < GroupSize)
+			return;
+		GroupFill = 0;
+
+		video::S3DVertex2TCoords vtx;
+		buildVertex(vtx);
+		if (Buffer)
+			Corners.push_back(findOrAddVertex(vtx));
+		else
+		{
+			vtx.Color.set(100,255,255,255);
+			Corners.push_back((u16)LightMapBuffer->Vertices.size());
+			LightMapBuffer->Vertices.push_back(vtx);
+		}
+
+		if (!ExplicitEnd && Corners.size() == (NextPrimitive < VertexCounts.size() ? VertexCounts[NextPrimitive] : 3))
+			endPrimitive();
+	}
+
+	//! triangulates the current primitive as triangle fan
+	void endPrimitive()
+	{
+		for (u32 i=1; i+1<Corners.size(); ++i)
+		{
+			Indices->push_back(Corners[0]);
+			if (FlipAxis)
+			{
+				Indices->push_back(Corners[i+1]);
+				Indices->push_back(Corners[i]);
+			}
+			else
+			{
+				Indices->push_back(Corners[i]);
+				Indices->push_back(Corners[i+1]);
+			}
+		}
+		Corners.set_used(0);
+		GroupFill = 0;
+
+		++NextPrimitive;
+		skipEmptyPrimitives();
+	}
+
+	//! number of corners of each primitive, from a <vcount> element
+	core::array<u32> VertexCounts;
+
+private:
+
+	void skipEmptyPrimitives()
+	{
+		while (NextPrimitive < VertexCounts.size() && !VertexCounts[NextPrimitive])
+			++NextPrimitive;
+	}
+
+	void buildVertex(video::S3DVertex2TCoords& vtx) const
+	{
+		vtx.Color.set(255,255,255,255);
+
+		// for all input semantics
+		for (u32 k=0; k<Inputs.size(); ++k)
+		{
+			if (!Inputs[k].Data)
+				continue;
+			// build vertex from input semantics.
+
+			const f32* data = Inputs[k].Data + Inputs[k].Stride*Group[Inputs[k].Offset];
+
+			switch(Inputs[k].Semantic)
+			{
+			case ECIS_POSITION:
+			case ECIS_VERTEX:
+				if (FlipAxis)
+					vtx.Pos.set(data[0], data[2], data[1]);
+				else
+					vtx.Pos.set(data[0], data[1], data[2]);
+				break;
+			case ECIS_NORMAL:
+				if (FlipAxis)
+					vtx.Normal.set(data[0], data[2], data[1]);
+				else
+					vtx.Normal.set(data[0], data[1], data[2]);
+				break;
+			case ECIS_TEXCOORD:
+			case ECIS_UV:
+				if (k==SecondTexCoordSet)
+					vtx.TCoords2.set(data[0], 1-data[1]);
+				else
+					vtx.TCoords.set(data[0], 1-data[1]);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	static u32 hashVertex(const video::S3DVertex& vtx)
+	{
+		f32 f[8] = { vtx.Pos.X, vtx.Pos.Y, vtx.Pos.Z,
+			vtx.Normal.X, vtx.Normal.Y, vtx.Normal.Z,
+			vtx.TCoords.X, vtx.TCoords.Y };
+
+		// -0.0 equals 0.0 but has other bits, so all zeros are hashed as 0.0
+		for (u32 i=0; i<8; ++i)
+			if (f[i] == 0.f)
+				f[i] = 0.f;
+
+		const u32 hash = core::hashFNV1a(f, sizeof(f));
+		return core::hashFNV1a(&vtx.Color.color, sizeof(u32), hash);
+	}
+
+	u16 findOrAddVertex(const video::S3DVertex& vtx)
+	{
+		core::array<video::S3DVertex>& vertices = Buffer->Vertices;
+
+		// keep the table at most half full
+		if ((vertices.size()+1)*2 > Buckets.size())
+		{
+			Buckets.set_used(Buckets.size()*2);
+			memset(Buckets.pointer(), 0, Buckets.size()*sizeof(u32));
+			for (u32 i=0; i<vertices.size(); ++i)
+			{
+				u32 b = hashVertex(vertices[i]) & (Buckets.size()-1);
+				while (Buckets[b])
+					b = (b+1) & (Buckets.size()-1);
+				Buckets[b] = i+1;
+			}
+		}
+
+		u32 b = hashVertex(vtx) & (Buckets.size()-1);
+		while (Buckets[b])
+		{
+			if (vertices[Buckets[b]-1] == vtx)
+				return (u16)(Buckets[b]-1);
+			b = (b+1) & (Buckets.size()-1);
+		}
+
+		Buckets[b] = vertices.size()+1;
+		vertices.push_back(vtx);
+		return (u16)(vertices.size()-1);
+	}
+
+	const core::array<SColladaInput>& Inputs;
+
+	SMeshBuffer* Buffer;
+	SMeshBufferLightMap* LightMapBuffer;
+	core::array<u16>* Indices;
+
+	//! indices of the vertex being read
+	core::array<s32> Group;
+	//! vertices of the primitive being read
+	core::array<u16> Corners;
+	//! open addressing table of vertex index+1, 0 for empty buckets
+	core::array<u32> Buckets;
+
+	u32 SecondTexCoordSet;
+	u32 GroupSize;
+	u32 GroupFill;
+	u32 NextPrimitive;
+	bool ExplicitEnd;
+	bool FlipAxis;
 };
 
-//! reads a polygons section and creates a mesh from it
+} // end anonymous namespace
+
+
+//! reads a polygons section and adds its primitives to the mesh as one mesh buffer
+/** The index data is assembled into the mesh buffer while it is parsed,
+without collecting the polygons first. */
 void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
-	const core::stringc& vertexPositionSource, core::array<SSource>& sources,
+	const core::stringc& vertexPositionSource, core::list<SSource>& sources,
 	scene::SMesh* mesh, const core::stringc& geometryId)
 {
 	#ifdef COLLADA_READER_DEBUG
@@ -1859,18 +2088,17 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 	core::stringc materialName = reader->getAttributeValue("material");
 
 	core::stringc polygonType = reader->getNodeName();
-	const int polygonCount = reader->getAttributeValueAsInt("count"); // Not useful because it only determines the number of primitives, which have arbitrary vertices in case of polygon
-	core::array<SPolygon> polygons;
-	if (polygonType == polygonsSectionName)
-		polygons.reallocate(polygonCount);
-	core::array<int> vCounts;
+	// <polygons> has one <p> per polygon, <polylist> the corner counts in <vcount>
+	const bool polygonPerElement = (polygonType == polygonsSectionName);
 	bool parsePolygonOK = false;
 	bool parseVcountOK = false;
-	u32 inputSemanticCount = 0;
 	bool unresolvedInput=false;
+	bool normalSlotCount = false;
 	u32 maxOffset = 0;
 	Inputs.clear();
 
+	SPrimitiveAssembler assembler(Inputs, FlipAxis);
+
 	// read all <input> and primitives
 	if (!reader->isEmptyElement())
 	while(reader->read())
@@ -1899,19 +2127,19 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 				uriToId(sourceArrayURI);
 
 				// find source array (we'll ignore accessors for this implementation)
-				u32 s;
-				for (s=0; s<sources.size(); ++s)
+				core::list<SSource>::Iterator s = sources.begin();
+				for (; s!=sources.end(); ++s)
 				{
-					if (sources[s].Id == sourceArrayURI)
+					if ((*s).Id == sourceArrayURI)
 					{
 						// slot found
-						inp.Data = sources[s].Array.Data.pointer();
-						inp.Stride = sources[s].Accessors[0].Stride;
+						inp.Data = (*s).Array.Data.pointer();
+						inp.Stride = (*s).Accessors[0].Stride;
 						break;
 					}
 				}
 
-				if (s == sources.size())
+				if (s == sources.end())
 				{
 					os::Printer::log("COLLADA Warning, polygon input source not found",
 						sourceArrayURI.c_str());
@@ -1929,14 +2157,19 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 					#endif
 				}
 
+				if (inp.Semantic == ECIS_NORMAL)
+					normalSlotCount = true;
+
 				maxOffset = core::max_(maxOffset,inp.Offset);
-				++inputSemanticCount;
 			}
 			else
 			if (primitivesName == nodeName)
 			{
-				parsePolygonOK = true;
-				polygons.push_back(SPolygon());
+				// all inputs are known now, start the mesh buffer. We cannot
+				// create the mesh if one of the input semantics wasn't found.
+				parsePolygonOK = !Inputs.empty() && !unresolvedInput;
+				if (parsePolygonOK)
+					assembler.begin(maxOffset+1, polygonPerElement);
 			}
 			else
 			if (vcountName == nodeName)
@@ -1948,7 +2181,11 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 		if (reader->getNodeType() == io::EXN_ELEMENT_END)
 		{
 			if (primitivesName == nodeName)
+			{
+				if (parsePolygonOK && polygonPerElement)
+					assembler.endPrimitive();
 				parsePolygonOK = false; // end parsing a polygon
+			}
 			else
 			if (vcountName == nodeName)
 				parseVcountOK = false; // end parsing vcounts
@@ -1960,329 +2197,35 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 		else
 		if (reader->getNodeType() == io::EXN_TEXT)
 		{
+			// parse straight from the text of the reader, in chunks of numbers
+			const c8* p = reader->getNodeData();
+			s32 numbers[256];
+			u32 count;
 			if (parseVcountOK)
 			{
-				core::stringc data = reader->getNodeData();
-				data.trim();
-				const c8* p = &data[0];
-				while(*p)
+				while ((count = core::strtol10_array(p, numbers, 256, &p)))
 				{
-					findNextNoneWhiteSpace(&p);
-					if (*p)
-						vCounts.push_back(readInt(&p));
+					for (u32 i=0; i<count; ++i)
+						assembler.VertexCounts.push_back(numbers[i]);
 				}
 				parseVcountOK = false;
 			}
 			else
-			if (parsePolygonOK && polygons.size())
+			if (parsePolygonOK)
 			{
-				core::stringc data = reader->getNodeData();
-				data.trim();
-				const c8* p = &data[0];
-				SPolygon& poly = polygons.getLast();
-				if (polygonType == polygonsSectionName)
-					poly.Indices.reallocate((maxOffset+1)*3);
-				else
-					poly.Indices.reallocate(polygonCount*(maxOffset+1)*3);
-
-				if (vCounts.empty())
-				{
-					while(*p)
-					{
-						findNextNoneWhiteSpace(&p);
-						poly.Indices.push_back(readInt(&p));
-					}
-				}
-				else
+				while ((count = core::strtol10_array(p, numbers, 256, &p)))
 				{
-					for (u32 i = 0; i < vCounts.size(); i++)
-					{
-						const int polyVCount = vCounts[i];
-
-						core::array<int> polyCorners;
-
-						for (u32 j = 0; j < polyVCount * inputSemanticCount; j++)
-						{
-							if (!*p)
-								break;
-							findNextNoneWhiteSpace(&p);
-							polyCorners.push_back(readInt(&p));
-						}
-
-						while (polyCorners.size() >= 3 * inputSemanticCount)
-						{
-							// add one triangle's worth of indices
-							for (u32 k = 0; k < inputSemanticCount * 3; ++k)
-							{
-								poly.Indices.push_back(polyCorners[k]);
-							}
-
-							// remove one corner from our poly
-							polyCorners.erase(inputSemanticCount,inputSemanticCount);
-						}
-						polyCorners.clear();
-					}
-					vCounts.clear();
+					for (u32 i=0; i<count; ++i)
+						assembler.addIndex(numbers[i]);
 				}
-				parsePolygonOK = false;
 			}
 		}
 	} // end while reader->read()
 
-	if (inputSemanticCount == 0 || unresolvedInput)
-		return; // we cannot create the mesh if one of the input semantics wasn't found.
-
-	if (!polygons.size())
+	scene::IMeshBuffer* buffer = assembler.getBuffer();
+	if (!buffer || !buffer->getIndexCount())
 		return; // cancel if there are no polygons anyway.
 
-	// analyze content of Inputs to create a fitting mesh buffer
-
-	u32 u;
-	u32 textureCoordSetCount = 0;
-	bool normalSlotCount = false;
-	u32 secondTexCoordSetIndex = 0xFFFFFFFF;
-
-	for (u=0; u<Inputs.size(); ++u)
-	{
-		if (Inputs[u].Semantic == ECIS_TEXCOORD || Inputs[u].Semantic == ECIS_UV )
-		{
-			++textureCoordSetCount;
-
-			if (textureCoordSetCount==2)
-				secondTexCoordSetIndex = u;
-		}
-		else
-		if (Inputs[u].Semantic == ECIS_NORMAL)
-			normalSlotCount=true;
-	}
-
-	// if there is more than one texture coordinate set, create a lightmap mesh buffer,
-	// otherwise use a standard mesh buffer
-
-	scene::IMeshBuffer* buffer = 0;
-	++maxOffset; // +1 to jump to the next value
-
-	if ( textureCoordSetCount < 2 )
-	{
-		// standard mesh buffer
-
-		scene::SMeshBuffer* mbuffer = new SMeshBuffer();
-		buffer = mbuffer;
-
-		core::map<video::S3DVertex, int> vertMap;
-
-		for (u32 i=0; i<polygons.size(); ++i)
-		{
-			core::array<u16> indices;
-			const u32 vertexCount = polygons[i].Indices.size() / maxOffset;
-			mbuffer->Vertices.reallocate(mbuffer->Vertices.size()+vertexCount);
-
-			// for all index/semantic groups
-			for (u32 v=0; v<polygons[i].Indices.size(); v+=maxOffset)
-			{
-				video::S3DVertex vtx;
-				vtx.Color.set(255,255,255,255);
-
-				// for all input semantics
-				for (u32 k=0; k<Inputs.size(); ++k)
-				{
-					if (!Inputs[k].Data)
-						continue;
-					// build vertex from input semantics.
-
-					const u32 idx = Inputs[k].Stride*polygons[i].Indices[v+Inputs[k].Offset];
-
-					switch(Inputs[k].Semantic)
-					{
-					case ECIS_POSITION:
-					case ECIS_VERTEX:
-						vtx.Pos.X = Inputs[k].Data[idx+0];
-						if (FlipAxis)
-						{
-							vtx.Pos.Z = Inputs[k].Data[idx+1];
-							vtx.Pos.Y = Inputs[k].Data[idx+2];
-						}
-						else
-						{
-							vtx.Pos.Y = Inputs[k].Data[idx+1];
-							vtx.Pos.Z = Inputs[k].Data[idx+2];
-						}
-						break;
-					case ECIS_NORMAL:
-						vtx.Normal.X = Inputs[k].Data[idx+0];
-						if (FlipAxis)
-						{
-							vtx.Normal.Z = Inputs[k].Data[idx+1];
-							vtx.Normal.Y = Inputs[k].Data[idx+2];
-						}
-						else
-						{
-							vtx.Normal.Y = Inputs[k].Data[idx+1];
-							vtx.Normal.Z = Inputs[k].Data[idx+2];
-						}
-						break;
-					case ECIS_TEXCOORD:
-					case ECIS_UV:
-						vtx.TCoords.X = Inputs[k].Data[idx+0];
-						vtx.TCoords.Y = 1-Inputs[k].Data[idx+1];
-						break;
-					case ECIS_TANGENT:
-						break;
-					default:
-						break;
-					}
-				}
-
-				//first, try to find this vertex in the mesh
-				core::map<video::S3DVertex, int>::Node* n = vertMap.find(vtx);
-				if (n)
-				{
-					indices.push_back(n->getValue());
-				}
-				else
-				{
-					indices.push_back(mbuffer->getVertexCount());
-					mbuffer->Vertices.push_back(vtx);
-					vertMap.insert(vtx, mbuffer->getVertexCount()-1);
-				}
-			} // end for all vertices
-
-			if (polygonsSectionName == polygonType &&
-				indices.size() > 3)
-			{
-				// need to tesselate for polygons of 4 or more vertices
-				// for now we naively turn interpret it as a triangle fan
-				// as full tesselation is problematic
-				if (FlipAxis)
-				{
-					for (u32 ind = indices.size()-3; ind>0 ; --ind)
-					{
-						mbuffer->Indices.push_back(indices[0]);
-						mbuffer->Indices.push_back(indices[ind+2]);
-						mbuffer->Indices.push_back(indices[ind+1]);
-					}
-				}
-				else
-				{
-					for (u32 ind = 0; ind+2 < indices.size(); ++ind)
-					{
-						mbuffer->Indices.push_back(indices[0]);
-						mbuffer->Indices.push_back(indices[ind+1]);
-						mbuffer->Indices.push_back(indices[ind+2]);
-					}
-				}
-			}
-			else
-			{
-				// it's just triangles
-				for (u32 ind = 0; ind < indices.size(); ind+=3)
-				{
-					if (FlipAxis)
-					{
-						mbuffer->Indices.push_back(indices[ind+2]);
-						mbuffer->Indices.push_back(indices[ind+1]);
-						mbuffer->Indices.push_back(indices[ind+0]);
-					}
-					else
-					{
-						mbuffer->Indices.push_back(indices[ind+0]);
-						mbuffer->Indices.push_back(indices[ind+1]);
-						mbuffer->Indices.push_back(indices[ind+2]);
-					}
-				}
-			}
-
-		} // end for all polygons
-	}
-	else
-	{
-		// lightmap mesh buffer
-
-		scene::SMeshBufferLightMap* mbuffer = new SMeshBufferLightMap();
-		buffer = mbuffer;
-
-		for (u32 i=0; i<polygons.size(); ++i)
-		{
-			const u32 vertexCount = polygons[i].Indices.size() / maxOffset;
-			mbuffer->Vertices.reallocate(mbuffer->Vertices.size()+vertexCount);
-			// for all vertices in array
-			for (u32 v=0; v<polygons[i].Indices.size(); v+=maxOffset)
-			{
-				video::S3DVertex2TCoords vtx;
-				vtx.Color.set(100,255,255,255);
-
-				// for all input semantics
-				for (u32 k=0; k<Inputs.size(); ++k)
-				{
-					// build vertex from input semantics.
-
-					const u32 idx = Inputs[k].Stride*polygons[i].Indices[v+Inputs[k].Offset];
-
-					switch(Inputs[k].Semantic)
-					{
-					case ECIS_POSITION:
-					case ECIS_VERTEX:
-						vtx.Pos.X = Inputs[k].Data[idx+0];
-						if (FlipAxis)
-						{
-							vtx.Pos.Z = Inputs[k].Data[idx+1];
-							vtx.Pos.Y = Inputs[k].Data[idx+2];
-						}
-						else
-						{
-							vtx.Pos.Y = Inputs[k].Data[idx+1];
-							vtx.Pos.Z = Inputs[k].Data[idx+2];
-						}
-						break;
-					case ECIS_NORMAL:
-						vtx.Normal.X = Inputs[k].Data[idx+0];
-						if (FlipAxis)
-						{
-							vtx.Normal.Z = Inputs[k].Data[idx+1];
-							vtx.Normal.Y = Inputs[k].Data[idx+2];
-						}
-						else
-						{
-							vtx.Normal.Y = Inputs[k].Data[idx+1];
-							vtx.Normal.Z = Inputs[k].Data[idx+2];
-						}
-						break;
-					case ECIS_TEXCOORD:
-					case ECIS_UV:
-						if (k==secondTexCoordSetIndex)
-						{
-							vtx.TCoords2.X = Inputs[k].Data[idx+0];
-							vtx.TCoords2.Y = 1-Inputs[k].Data[idx+1];
-						}
-						else
-						{
-							vtx.TCoords.X = Inputs[k].Data[idx+0];
-							vtx.TCoords.Y = 1-Inputs[k].Data[idx+1];
-						}
-						break;
-					case ECIS_TANGENT:
-						break;
-					default:
-						break;
-					}
-				}
-
-				mbuffer->Vertices.push_back(vtx);
-
-			} // end for all vertices
-
-			// add vertex indices
-			const u32 oldVertexCount = mbuffer->Vertices.size() - vertexCount;
-			for (u32 face=0; face<vertexCount-2; ++face)
-			{
-				mbuffer->Indices.push_back(oldVertexCount + 0);
-				mbuffer->Indices.push_back(oldVertexCount + 1 + face);
-				mbuffer->Indices.push_back(oldVertexCount + 2 + face);
-			}
-
-		} // end for all polygons
-	}
-
 	const SColladaMaterial* m = findMaterial(materialName);
 	if (m)
 	{
@@ -2312,8 +2255,6 @@ void CColladaFileLoader::readPolygonSection(io::IXMLReaderUTF8* reader,
 
 	// add mesh buffer
 	mesh->addMeshBuffer(buffer);
-
-	buffer->drop();
 }
 
 
@@ -2532,38 +2473,6 @@ void CColladaFileLoader::readColladaParameters(io::IXMLReaderUTF8* reader,
 }
 
 
-//! parses a float from a char pointer and moves the pointer
-//! to the end of the parsed float
-inline f32 CColladaFileLoader::readFloat(const c8** p)
-{
-	f32 ftmp;
-	*p = core::fast_atof_move(*p, ftmp);
-	return ftmp;
-}
-
-
-//! parses an int from a char pointer and moves the pointer to
-//! the end of the parsed float
-inline s32 CColladaFileLoader::readInt(const c8** p)
-{
-	return (s32)readFloat(p);
-}
-
-
-//! places pointer to next begin of a token
-void CColladaFileLoader::findNextNoneWhiteSpace(const c8** start)
-{
-	const c8* p = *start;
-
-	while(*p && (*p==' ' || *p=='\n' || *p=='\r' || *p=='\t'))
-		++p;
-
-	// TODO: skip comments <!-- -->
-
-	*start = p;
-}
-
-
 //! reads floats from inside of xml element until end of xml element
 void CColladaFileLoader::readFloatsInsideElement(io::IXMLReaderUTF8* reader, f32* floats, u32 count)
 {
@@ -2578,18 +2487,8 @@ void CColladaFileLoader::readFloatsInsideElement(io::IXMLReaderUTF8* reader, f32
 		if (reader->getNodeType() == io::EXN_TEXT)
 		{
 			// parse float data
-			core::stringc data = reader->getNodeData();
-			data.trim();
-			const c8* p = &data[0];
-
-			for (u32 i=0; i<count; ++i)
-			{
-				findNextNoneWhiteSpace(&p);
-				if (*p)
-					floats[i] = readFloat(&p);
-				else
-					floats[i] = 0.0f;
-			}
+			for (u32 i=core::fast_atof_array(reader->getNodeData(), floats, count); i<count; ++i)
+				floats[i] = 0.0f;
 		}
 		else
 		if (reader->getNodeType() == io::EXN_ELEMENT_END)
@@ -2611,19 +2510,9 @@ void CColladaFileLoader::readIntsInsideElement(io::IXMLReaderUTF8* reader, s32*
 
 		if (reader->getNodeType() == io::EXN_TEXT)
 		{
-			// parse float data
-			core::stringc data = reader->getNodeData();
-			data.trim();
-			const c8* p = &data[0];
-
-			for (u32 i=0; i<count; ++i)
-			{
-				findNextNoneWhiteSpace(&p);
-				if (*p)
-					ints[i] = readInt(&p);
-				else
-					ints[i] = 0;
-			}
+			// parse int data
+			for (u32 i=core::strtol10_array(reader->getNodeData(), ints, count); i<count; ++i)
+				ints[i] = 0;
 		}
 		else
 		if (reader->getNodeType() == io::EXN_ELEMENT_END)
@@ -13,6 +13,7 @@
 #include "SMeshBuffer.h"
 #include "ISceneManager.h"
 #include "irrMap.h"
+#include "irrList.h"
 #include "CAttributes.h"
 
 namespace irr
@@ -275,17 +276,6 @@ private:
 	//! reads a <geometry> element and stores it as mesh if possible
 	void readGeometry(io::IXMLReaderUTF8* reader);
 
-	//! parses a float from a char pointer and moves the pointer to
-	//! the end of the parsed float
-	inline f32 readFloat(const c8** p);
-
-	//! parses an int from a char pointer and moves the pointer to
-	//! the end of the parsed float
-	inline s32 readInt(const c8** p);
-
-	//! places pointer to next begin of a token
-	void findNextNoneWhiteSpace(const c8** p);
-
 	//! reads floats from inside of xml element until end of xml element
 	void readFloatsInsideElement(io::IXMLReaderUTF8* reader, f32* floats, u32 count);
 
@@ -317,9 +307,9 @@ private:
 	//! changes the XML URI into an internal id
 	void uriToId(core::stringc& str);
 
-	//! reads a polygons section and creates a mesh from it
+	//! reads a polygons section and adds its primitives to the mesh as one mesh buffer
 	void readPolygonSection(io::IXMLReaderUTF8* reader,
-		const core::stringc& vertexPositionSource, core::array<SSource>& sources,
+		const core::stringc& vertexPositionSource, core::list<SSource>& sources,
 		scene::SMesh* mesh, const core::stringc& geometryId);
 
 	//! finds a material, possible instancing it
@@ -6,6 +6,22 @@
 #include "SColor.h"
 #include "os.h"
 #include "irrString.h"
+#include "CThreadPool.h"
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+#include <emmintrin.h>
+#endif
+
+#ifdef _IRR_COMPILE_WITH_AVX2_
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define IRR_TARGET_AVX2
+#else
+#include <cpuid.h>
+#define IRR_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
 
 namespace irr
 {
@@ -239,6 +255,441 @@ void CColorConverter::convert32BitTo32Bit(const s32* in, s32* out, s32 width, s3
 
 
 
+namespace
+{
+
+// bands of rows on the thread pool have at least this many pixels
+const u32 CONVERT_BAND_PIXELS = 65536;
+
+//! converts a multiple of the vector width of sN pixels, returns the number of converted pixels
+typedef s32 (*ConvertKernel)(const void* sP, s32 sN, void* dP);
+
+//! vectorized conversions, 0 for those which only have the plain loop
+struct SConvertKernels
+{
+	ConvertKernel A1R5G5B5toA8R8G8B8;
+	ConvertKernel A1R5G5B5toR5G6B5;
+	ConvertKernel A8R8G8B8toR8G8B8;
+	ConvertKernel A8R8G8B8toB8G8R8;
+	ConvertKernel A8R8G8B8toA1R5G5B5;
+	ConvertKernel A8R8G8B8toR5G6B5;
+	ConvertKernel R8G8B8toA8R8G8B8;
+	ConvertKernel B8G8R8toA8R8G8B8;
+	ConvertKernel B8G8R8A8toA8R8G8B8;
+	ConvertKernel R5G6B5toA8R8G8B8;
+	ConvertKernel R5G6B5toA1R5G5B5;
+};
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+
+// the kernels below follow the formulas in SColor.h bit by bit
+
+inline __m128i A1R5G5B5toA8R8G8B8_SSE2(__m128i c)
+{
+	const __m128i a = _mm_and_si128(_mm_srai_epi32(_mm_slli_epi32(c, 16), 31), _mm_set1_epi32((s32)0xFF000000));
+	const __m128i r = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x7C00)), 9),
+			_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x7000)), 4));
+	const __m128i g = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x03E0)), 6),
+			_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x0380)), 1));
+	const __m128i b = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x001F)), 3),
+			_mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x001C)), 2));
+	return _mm_or_si128(_mm_or_si128(a, r), _mm_or_si128(g, b));
+}
+
+inline __m128i R5G6B5toA8R8G8B8_SSE2(__m128i c)
+{
+	const __m128i r = _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0xF800)), 8);
+	const __m128i g = _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x07E0)), 5);
+	const __m128i b = _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x001F)), 3);
+	return _mm_or_si128(_mm_or_si128(_mm_set1_epi32((s32)0xFF000000), r), _mm_or_si128(g, b));
+}
+
+// results are u16 values in 32 bit lanes, sign extended so that they survive _mm_packs_epi32
+inline __m128i A8R8G8B8toA1R5G5B5_SSE2(__m128i c)
+{
+	const __m128i a = _mm_and_si128(_mm_srli_epi32(c, 16), _mm_set1_epi32(0x8000));
+	const __m128i r = _mm_and_si128(_mm_srli_epi32(c, 9), _mm_set1_epi32(0x7C00));
+	const __m128i g = _mm_and_si128(_mm_srli_epi32(c, 6), _mm_set1_epi32(0x03E0));
+	const __m128i b = _mm_and_si128(_mm_srli_epi32(c, 3), _mm_set1_epi32(0x001F));
+	return _mm_srai_epi32(_mm_slli_epi32(_mm_or_si128(_mm_or_si128(a, r), _mm_or_si128(g, b)), 16), 16);
+}
+
+inline __m128i A8R8G8B8toR5G6B5_SSE2(__m128i c)
+{
+	const __m128i r = _mm_and_si128(_mm_srli_epi32(c, 8), _mm_set1_epi32(0xF800));
+	const __m128i g = _mm_and_si128(_mm_srli_epi32(c, 5), _mm_set1_epi32(0x07E0));
+	const __m128i b = _mm_and_si128(_mm_srli_epi32(c, 3), _mm_set1_epi32(0x001F));
+	return _mm_srai_epi32(_mm_slli_epi32(_mm_or_si128(r, _mm_or_si128(g, b)), 16), 16);
+}
+
+s32 convert_A1R5G5B5toA8R8G8B8_SSE2(const void* sP, s32 sN, void* dP)
+{
+	const __m128i* sB = (const __m128i*)sP;
+	__m128i* dB = (__m128i*)dP;
+	const __m128i zero = _mm_setzero_si128();
+
+	const s32 n = sN & ~7;
+	for (s32 x = 0; x < n; x += 8)
+	{
+		const __m128i c = _mm_loadu_si128(sB++);
+		_mm_storeu_si128(dB++, A1R5G5B5toA8R8G8B8_SSE2(_mm_unpacklo_epi16(c, zero)));
+		_mm_storeu_si128(dB++, A1R5G5B5toA8R8G8B8_SSE2(_mm_unpackhi_epi16(c, zero)));
+	}
+	return n;
+}
+
+s32 convert_R5G6B5toA8R8G8B8_SSE2(const void* sP, s32 sN, void* dP)
+{
+	const __m128i* sB = (const __m128i*)sP;
+	__m128i* dB = (__m128i*)dP;
+	const __m128i zero = _mm_setzero_si128();
+
+	const s32 n = sN & ~7;
+	for (s32 x = 0; x < n; x += 8)
+	{
+		const __m128i c = _mm_loadu_si128(sB++);
+		_mm_storeu_si128(dB++, R5G6B5toA8R8G8B8_SSE2(_mm_unpacklo_epi16(c, zero)));
+		_mm_storeu_si128(dB++, R5G6B5toA8R8G8B8_SSE2(_mm_unpackhi_epi16(c, zero)));
+	}
+	return n;
+}
+
+s32 convert_A8R8G8B8toA1R5G5B5_SSE2(const void* sP, s32 sN, void* dP)
+{
+	const __m128i* sB = (const __m128i*)sP;
+	__m128i* dB = (__m128i*)dP;
+
+	const s32 n = sN & ~7;
+	for (s32 x = 0; x < n; x += 8)
+	{
+		const __m128i lo = A8R8G8B8toA1R5G5B5_SSE2(_mm_loadu_si128(sB++));
+		const __m128i hi = A8R8G8B8toA1R5G5B5_SSE2(_mm_loadu_si128(sB++));
+		_mm_storeu_si128(dB++, _mm_packs_epi32(lo, hi));
+	}
+	return n;
+}
+
+s32 convert_A8R8G8B8toR5G6B5_SSE2(const void* sP, s32 sN, void* dP)
+{
+	const __m128i* sB = (const __m128i*)sP;
+	__m128i* dB = (__m128i*)dP;
+
+	const s32 n = sN & ~7;
+	for (s32 x = 0; x < n; x += 8)
+	{
+		const __m128i lo = A8R8G8B8toR5G6B5_SSE2(_mm_loadu_si128(sB++));
+		const __m128i hi = A8R8G8B8toR5G6B5_SSE2(_mm_loadu_si128(sB++));
+		_mm_storeu_si128(dB++, _mm_packs_epi32(lo, hi));
+	}
+	return n;
+}
+
+s32 convert_A1R5G5B5toR5G6B5_SSE2(const void* sP, s32 sN, void* dP)
+{
+	const __m128i* sB = (const __m128i*)sP;
+	__m128i* dB = (__m128i*)dP;
+
+	const s32 n = sN & ~7;
+	for (s32 x = 0; x < n; x += 8)
+	{
+		const __m128i c = _mm_loadu_si128(sB++);
+		_mm_storeu_si128(dB++, _mm_or_si128(
+				_mm_slli_epi16(_mm_and_si128(c, _mm_set1_epi16(0x7FE0)), 1),
+				_mm_and_si128(c, _mm_set1_epi16(0x001F))));
+	}
+	return n;
+}
+
+s32 convert_R5G6B5toA1R5G5B5_SSE2(const void* sP, s32 sN, void* dP)
+{
+	const __m128i* sB = (const __m128i*)sP;
+	__m128i* dB = (__m128i*)dP;
+
+	const s32 n = sN & ~7;
+	for (s32 x = 0; x < n; x += 8)
+	{
+		const __m128i c = _mm_loadu_si128(sB++);
+		_mm_storeu_si128(dB++, _mm_or_si128(_mm_set1_epi16((s16)0x8000), _mm_or_si128(
+				_mm_srli_epi16(_mm_and_si128(c, _mm_set1_epi16((s16)0xFFC0)), 1),
+				_mm_and_si128(c, _mm_set1_epi16(0x001F)))));
+	}
+	return n;
+}
+
+#endif // _IRR_COMPILE_WITH_SSE2_
+
+#ifdef _IRR_COMPILE_WITH_AVX2_
+
+IRR_TARGET_AVX2 inline __m256i A1R5G5B5toA8R8G8B8_AVX2(__m256i c)
+{
+	const __m256i a = _mm256_and_si256(_mm256_srai_epi32(_mm256_slli_epi32(c, 16), 31), _mm256_set1_epi32((s32)0xFF000000));
+	const __m256i r = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x7C00)), 9),
+			_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x7000)), 4));
+	const __m256i g = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x03E0)), 6),
+			_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x0380)), 1));
+	const __m256i b = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x001F)), 3),
+			_mm256_srli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x001C)), 2));
+	return _mm256_or_si256(_mm256_or_si256(a, r), _mm256_or_si256(g, b));
+}
+
+IRR_TARGET_AVX2 inline __m256i R5G6B5toA8R8G8B8_AVX2(__m256i c)
+{
+	const __m256i r = _mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0xF800)), 8);
+	const __m256i g = _mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x07E0)), 5);
+	const __m256i b = _mm256_slli_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x001F)), 3);
+	return _mm256_or_si256(_mm256_or_si256(_mm256_set1_epi32((s32)0xFF000000), r), _mm256_or_si256(g, b));
+}
+
+IRR_TARGET_AVX2 inline __m256i A8R8G8B8toA1R5G5B5_AVX2(__m256i c)
+{
+	const __m256i a = _mm256_and_si256(_mm256_srli_epi32(c, 16), _mm256_set1_epi32(0x8000));
+	const __m256i r = _mm256_and_si256(_mm256_srli_epi32(c, 9), _mm256_set1_epi32(0x7C00));
+	const __m256i g = _mm256_and_si256(_mm256_srli_epi32(c, 6), _mm256_set1_epi32(0x03E0));
+	const __m256i b = _mm256_and_si256(_mm256_srli_epi32(c, 3), _mm256_set1_epi32(0x001F));
+	return _mm256_srai_epi32(_mm256_slli_epi32(_mm256_or_si256(_mm256_or_si256(a, r), _mm256_or_si256(g, b)), 16), 16);
+}
+
+IRR_TARGET_AVX2 inline __m256i A8R8G8B8toR5G6B5_AVX2(__m256i c)
+{
+	const __m256i r = _mm256_and_si256(_mm256_srli_epi32(c, 8), _mm256_set1_epi32(0xF800));
+	const __m256i g = _mm256_and_si256(_mm256_srli_epi32(c, 5), _mm256_set1_epi32(0x07E0));
+	const __m256i b = _mm256_and_si256(_mm256_srli_epi32(c, 3), _mm256_set1_epi32(0x001F));
+	return _mm256_srai_epi32(_mm256_slli_epi32(_mm256_or_si256(r, _mm256_or_si256(g, b)), 16), 16);
+}
+
+IRR_TARGET_AVX2 s32 convert_A1R5G5B5toA8R8G8B8_AVX2(const void* sP, s32 sN, void* dP)
+{
+	const __m128i* sB = (const __m128i*)sP;
+	__m256i* dB = (__m256i*)dP;
+
+	const s32 n = sN & ~7;
+	for (s32 x = 0; x < n; x += 8)
+		_mm256_storeu_si256(dB++, A1R5G5B5toA8R8G8B8_AVX2(_mm256_cvtepu16_epi32(_mm_loadu_si128(sB++))));
+	return n;
+}
+
+IRR_TARGET_AVX2 s32 convert_R5G6B5toA8R8G8B8_AVX2(const void* sP, s32 sN, void* dP)
+{
+	const __m128i* sB = (const __m128i*)sP;
+	__m256i* dB = (__m256i*)dP;
+
+	const s32 n = sN & ~7;
+	for (s32 x = 0; x < n; x += 8)
+		_mm256_storeu_si256(dB++, R5G6B5toA8R8G8B8_AVX2(_mm256_cvtepu16_epi32(_mm_loadu_si128(sB++))));
+	return n;
+}
+
+// _mm256_packs_epi32 works on 128 bit lanes, the permute restores the pixel order
+IRR_TARGET_AVX2 s32 convert_A8R8G8B8toA1R5G5B5_AVX2(const void* sP, s32 sN, void* dP)
+{
+	const __m256i* sB = (const __m256i*)sP;
+	__m256i* dB = (__m256i*)dP;
+
+	const s32 n = sN & ~15;
+	for (s32 x = 0; x < n; x += 16)
+	{
+		const __m256i lo = A8R8G8B8toA1R5G5B5_AVX2(_mm256_loadu_si256(sB++));
+		const __m256i hi = A8R8G8B8toA1R5G5B5_AVX2(_mm256_loadu_si256(sB++));
+		_mm256_storeu_si256(dB++, _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8));
+	}
+	return n;
+}
+
+IRR_TARGET_AVX2 s32 convert_A8R8G8B8toR5G6B5_AVX2(const void* sP, s32 sN, void* dP)
+{
+	const __m256i* sB = (const __m256i*)sP;
+	__m256i* dB = (__m256i*)dP;
+
+	const s32 n = sN & ~15;
+	for (s32 x = 0; x < n; x += 16)
+	{
+		const __m256i lo = A8R8G8B8toR5G6B5_AVX2(_mm256_loadu_si256(sB++));
+		const __m256i hi = A8R8G8B8toR5G6B5_AVX2(_mm256_loadu_si256(sB++));
+		_mm256_storeu_si256(dB++, _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8));
+	}
+	return n;
+}
+
+//! packs 16 pixels of 32 bit into 48 bytes, shuffle moves the three kept bytes of each pixel to the front
+IRR_TARGET_AVX2 s32 convert32to24_AVX2(const void* sP, s32 sN, void* dP, __m128i shuffle)
+{
+	const __m128i* sB = (const __m128i*)sP;
+	__m128i* dB = (__m128i*)dP;
+
+	const s32 n = sN & ~15;
+	for (s32 x = 0; x < n; x += 16)
+	{
+		const __m128i c0 = _mm_shuffle_epi8(_mm_loadu_si128(sB++), shuffle);
+		const __m128i c1 = _mm_shuffle_epi8(_mm_loadu_si128(sB++), shuffle);
+		const __m128i c2 = _mm_shuffle_epi8(_mm_loadu_si128(sB++), shuffle);
+		const __m128i c3 = _mm_shuffle_epi8(_mm_loadu_si128(sB++), shuffle);
+		_mm_storeu_si128(dB++, _mm_or_si128(c0, _mm_slli_si128(c1, 12)));
+		_mm_storeu_si128(dB++, _mm_or_si128(_mm_srli_si128(c1, 4), _mm_slli_si128(c2, 8)));
+		_mm_storeu_si128(dB++, _mm_or_si128(_mm_srli_si128(c2, 8), _mm_slli_si128(c3, 4)));
+	}
+	return n;
+}
+
+//! expands 48 bytes into 16 opaque pixels of 32 bit, shuffle spreads 12 bytes over 4 pixels
+IRR_TARGET_AVX2 s32 convert24to32_AVX2(const void* sP, s32 sN, void* dP, __m128i shuffle)
+{
+	const __m128i* sB = (const __m128i*)sP;
+	__m128i* dB = (__m128i*)dP;
+	const __m128i alpha = _mm_set1_epi32((s32)0xFF000000);
+
+	const s32 n = sN & ~15;
+	for (s32 x = 0; x < n; x += 16)
+	{
+		const __m128i c0 = _mm_loadu_si128(sB++);
+		const __m128i c1 = _mm_loadu_si128(sB++);
+		const __m128i c2 = _mm_loadu_si128(sB++);
+		_mm_storeu_si128(dB++, _mm_or_si128(alpha, _mm_shuffle_epi8(c0, shuffle)));
+		_mm_storeu_si128(dB++, _mm_or_si128(alpha, _mm_shuffle_epi8(_mm_alignr_epi8(c1, c0, 12), shuffle)));
+		_mm_storeu_si128(dB++, _mm_or_si128(alpha, _mm_shuffle_epi8(_mm_alignr_epi8(c2, c1, 8), shuffle)));
+		_mm_storeu_si128(dB++, _mm_or_si128(alpha, _mm_shuffle_epi8(_mm_srli_si128(c2, 4), shuffle)));
+	}
+	return n;
+}
+
+IRR_TARGET_AVX2 s32 convert_A8R8G8B8toR8G8B8_AVX2(const void* sP, s32 sN, void* dP)
+{
+	return convert32to24_AVX2(sP, sN, dP, _mm_setr_epi8(2,1,0, 6,5,4, 10,9,8, 14,13,12, -1,-1,-1,-1));
+}
+
+IRR_TARGET_AVX2 s32 convert_A8R8G8B8toB8G8R8_AVX2(const void* sP, s32 sN, void* dP)
+{
+	return convert32to24_AVX2(sP, sN, dP, _mm_setr_epi8(0,1,2, 4,5,6, 8,9,10, 12,13,14, -1,-1,-1,-1));
+}
+
+IRR_TARGET_AVX2 s32 convert_R8G8B8toA8R8G8B8_AVX2(const void* sP, s32 sN, void* dP)
+{
+	return convert24to32_AVX2(sP, sN, dP, _mm_setr_epi8(2,1,0,-1, 5,4,3,-1, 8,7,6,-1, 11,10,9,-1));
+}
+
+IRR_TARGET_AVX2 s32 convert_B8G8R8toA8R8G8B8_AVX2(const void* sP, s32 sN, void* dP)
+{
+	return convert24to32_AVX2(sP, sN, dP, _mm_setr_epi8(0,1,2,-1, 3,4,5,-1, 6,7,8,-1, 9,10,11,-1));
+}
+
+IRR_TARGET_AVX2 s32 convert_B8G8R8A8toA8R8G8B8_AVX2(const void* sP, s32 sN, void* dP)
+{
+	const __m256i* sB = (const __m256i*)sP;
+	__m256i* dB = (__m256i*)dP;
+	const __m256i shuffle = _mm256_setr_epi8(3,2,1,0, 7,6,5,4, 11,10,9,8, 15,14,13,12,
+			3,2,1,0, 7,6,5,4, 11,10,9,8, 15,14,13,12);
+
+	const s32 n = sN & ~7;
+	for (s32 x = 0; x < n; x += 8)
+		_mm256_storeu_si256(dB++, _mm256_shuffle_epi8(_mm256_loadu_si256(sB++), shuffle));
+	return n;
+}
+
+//! returns true if the processor and the operating system support AVX2
+bool isAVX2Supported()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuid(info, 1);
+	// OSXSAVE and AVX
+	if ((info[2] & 0x18000000) != 0x18000000)
+		return false;
+	// the operating system saves the ymm registers
+	if ((_xgetbv(0) & 6) != 6)
+		return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & 0x20) != 0;
+#else
+	u32 eax, ebx, ecx, edx;
+	if (__get_cpuid_max(0, 0) < 7)
+		return false;
+	__cpuid(1, eax, ebx, ecx, edx);
+	// OSXSAVE and AVX
+	if ((ecx & 0x18000000) != 0x18000000)
+		return false;
+	// the operating system saves the ymm registers
+	__asm__ __volatile__ ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	if ((eax & 6) != 6)
+		return false;
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	return (ebx & 0x20) != 0;
+#endif
+}
+
+#endif // _IRR_COMPILE_WITH_AVX2_
+
+//! picks the fastest kernels the processor supports
+SConvertKernels selectKernels()
+{
+	SConvertKernels kernels;
+	memset(&kernels, 0, sizeof(kernels));
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+	kernels.A1R5G5B5toA8R8G8B8 = convert_A1R5G5B5toA8R8G8B8_SSE2;
+	kernels.A1R5G5B5toR5G6B5 = convert_A1R5G5B5toR5G6B5_SSE2;
+	kernels.A8R8G8B8toA1R5G5B5 = convert_A8R8G8B8toA1R5G5B5_SSE2;
+	kernels.A8R8G8B8toR5G6B5 = convert_A8R8G8B8toR5G6B5_SSE2;
+	kernels.R5G6B5toA8R8G8B8 = convert_R5G6B5toA8R8G8B8_SSE2;
+	kernels.R5G6B5toA1R5G5B5 = convert_R5G6B5toA1R5G5B5_SSE2;
+#endif
+
+#ifdef _IRR_COMPILE_WITH_AVX2_
+	if (isAVX2Supported())
+	{
+		kernels.A1R5G5B5toA8R8G8B8 = convert_A1R5G5B5toA8R8G8B8_AVX2;
+		kernels.A8R8G8B8toR8G8B8 = convert_A8R8G8B8toR8G8B8_AVX2;
+		kernels.A8R8G8B8toB8G8R8 = convert_A8R8G8B8toB8G8R8_AVX2;
+		kernels.A8R8G8B8toA1R5G5B5 = convert_A8R8G8B8toA1R5G5B5_AVX2;
+		kernels.A8R8G8B8toR5G6B5 = convert_A8R8G8B8toR5G6B5_AVX2;
+		kernels.R8G8B8toA8R8G8B8 = convert_R8G8B8toA8R8G8B8_AVX2;
+		kernels.B8G8R8toA8R8G8B8 = convert_B8G8R8toA8R8G8B8_AVX2;
+		kernels.B8G8R8A8toA8R8G8B8 = convert_B8G8R8A8toA8R8G8B8_AVX2;
+		kernels.R5G6B5toA8R8G8B8 = convert_R5G6B5toA8R8G8B8_AVX2;
+	}
+#endif
+
+	return kernels;
+}
+
+//! returns the kernels for this processor, selected on first use
+const SConvertKernels& getKernels()
+{
+	static const SConvertKernels kernels = selectKernels();
+	return kernels;
+}
+
+//! runs a kernel if there is one, returns the number of converted pixels
+inline s32 runKernel(ConvertKernel kernel, const void* sP, s32 sN, void* dP)
+{
+	return kernel ? kernel(sP, sN, dP) : 0;
+}
+
+
+//! rows converted by the thread pool
+struct SConvertTask
+{
+	const u8* Source;
+	u8* Dest;
+	u32 SourcePitch;
+	u32 DestPitch;
+	u32 Width;
+	ECOLOR_FORMAT SourceFormat;
+	ECOLOR_FORMAT DestFormat;
+};
+
+void convertBand(void* userData, u32 begin, u32 end)
+{
+	const SConvertTask& task = *(const SConvertTask*)userData;
+	for (u32 y=begin; y<end; ++y)
+		CColorConverter::convert_viaFormat(task.Source + y * task.SourcePitch, task.SourceFormat,
+				task.Width, task.Dest + y * task.DestPitch, task.DestFormat);
+}
+
+} // end anonymous namespace
+
+
 void CColorConverter::convert_A1R5G5B5toR8G8B8(const void* sP, s32 sN, void* dP)
 {
 	u16* sB = (u16*)sP;
@@ -273,10 +724,11 @@ void CColorConverter::convert_A1R5G5B5toB8G8R8(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_A1R5G5B5toA8R8G8B8(const void* sP, s32 sN, void* dP)
 {
-	u16* sB = (u16*)sP;
-	u32* dB = (u32*)dP;
+	const s32 done = runKernel(getKernels().A1R5G5B5toA8R8G8B8, sP, sN, dP);
+	u16* sB = (u16*)sP + done;
+	u32* dB = (u32*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 		*dB++ = A1R5G5B5toA8R8G8B8(*sB++);
 }
 
@@ -287,19 +739,21 @@ void CColorConverter::convert_A1R5G5B5toA1R5G5B5(const void* sP, s32 sN, void* d
 
 void CColorConverter::convert_A1R5G5B5toR5G6B5(const void* sP, s32 sN, void* dP)
 {
-	u16* sB = (u16*)sP;
-	u16* dB = (u16*)dP;
+	const s32 done = runKernel(getKernels().A1R5G5B5toR5G6B5, sP, sN, dP);
+	u16* sB = (u16*)sP + done;
+	u16* dB = (u16*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 		*dB++ = A1R5G5B5toR5G6B5(*sB++);
 }
 
 void CColorConverter::convert_A8R8G8B8toR8G8B8(const void* sP, s32 sN, void* dP)
 {
-	u8* sB = (u8*)sP;
-	u8* dB = (u8*)dP;
+	const s32 done = runKernel(getKernels().A8R8G8B8toR8G8B8, sP, sN, dP);
+	u8* sB = (u8*)sP + 4 * done;
+	u8* dB = (u8*)dP + 3 * done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 	{
 		// sB[3] is alpha
 		dB[0] = sB[2];
@@ -313,10 +767,11 @@ void CColorConverter::convert_A8R8G8B8toR8G8B8(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_A8R8G8B8toB8G8R8(const void* sP, s32 sN, void* dP)
 {
-	u8* sB = (u8*)sP;
-	u8* dB = (u8*)dP;
+	const s32 done = runKernel(getKernels().A8R8G8B8toB8G8R8, sP, sN, dP);
+	u8* sB = (u8*)sP + 4 * done;
+	u8* dB = (u8*)dP + 3 * done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 	{
 		// sB[3] is alpha
 		dB[0] = sB[0];
@@ -335,19 +790,21 @@ void CColorConverter::convert_A8R8G8B8toA8R8G8B8(const void* sP, s32 sN, void* d
 
 void CColorConverter::convert_A8R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* dP)
 {
-	u32* sB = (u32*)sP;
-	u16* dB = (u16*)dP;
+	const s32 done = runKernel(getKernels().A8R8G8B8toA1R5G5B5, sP, sN, dP);
+	u32* sB = (u32*)sP + done;
+	u16* dB = (u16*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 		*dB++ = A8R8G8B8toA1R5G5B5(*sB++);
 }
 
 void CColorConverter::convert_A8R8G8B8toR5G6B5(const void* sP, s32 sN, void* dP)
 {
-	u8 * sB = (u8 *)sP;
-	u16* dB = (u16*)dP;
+	const s32 done = runKernel(getKernels().A8R8G8B8toR5G6B5, sP, sN, dP);
+	u8 * sB = (u8 *)sP + 4 * done;
+	u16* dB = (u16*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 	{
 		s32 r = sB[2] >> 3;
 		s32 g = sB[1] >> 2;
@@ -385,10 +842,11 @@ void CColorConverter::convert_R8G8B8toR8G8B8(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_R8G8B8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 {
-	u8*  sB = (u8* )sP;
-	u32* dB = (u32*)dP;
+	const s32 done = runKernel(getKernels().R8G8B8toA8R8G8B8, sP, sN, dP);
+	u8*  sB = (u8* )sP + 3 * done;
+	u32* dB = (u32*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 	{
 		*dB = 0xff000000 | (sB[0]<<16) | (sB[1]<<8) | sB[2];
 
@@ -417,10 +875,11 @@ void CColorConverter::convert_R8G8B8toA1R5G5B5(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_B8G8R8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 {
-	u8*  sB = (u8* )sP;
-	u32* dB = (u32*)dP;
+	const s32 done = runKernel(getKernels().B8G8R8toA8R8G8B8, sP, sN, dP);
+	u8*  sB = (u8* )sP + 3 * done;
+	u32* dB = (u32*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 	{
 		*dB = 0xff000000 | (sB[2]<<16) | (sB[1]<<8) | sB[0];
 
@@ -431,10 +890,11 @@ void CColorConverter::convert_B8G8R8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_B8G8R8A8toA8R8G8B8(const void* sP, s32 sN, void* dP)
 {
-	u8* sB = (u8*)sP;
-	u8* dB = (u8*)dP;
+	const s32 done = runKernel(getKernels().B8G8R8A8toA8R8G8B8, sP, sN, dP);
+	u8* sB = (u8*)sP + 4 * done;
+	u8* dB = (u8*)dP + 4 * done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 	{
 		dB[0] = sB[3];
 		dB[1] = sB[2];
@@ -504,19 +964,21 @@ void CColorConverter::convert_R5G6B5toB8G8R8(const void* sP, s32 sN, void* dP)
 
 void CColorConverter::convert_R5G6B5toA8R8G8B8(const void* sP, s32 sN, void* dP)
 {
-	u16* sB = (u16*)sP;
-	u32* dB = (u32*)dP;
+	const s32 done = runKernel(getKernels().R5G6B5toA8R8G8B8, sP, sN, dP);
+	u16* sB = (u16*)sP + done;
+	u32* dB = (u32*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 		*dB++ = R5G6B5toA8R8G8B8(*sB++);
 }
 
 void CColorConverter::convert_R5G6B5toA1R5G5B5(const void* sP, s32 sN, void* dP)
 {
-	u16* sB = (u16*)sP;
-	u16* dB = (u16*)dP;
+	const s32 done = runKernel(getKernels().R5G6B5toA1R5G5B5, sP, sN, dP);
+	u16* sB = (u16*)sP + done;
+	u16* dB = (u16*)dP + done;
 
-	for (s32 x = 0; x < sN; ++x)
+	for (s32 x = done; x < sN; ++x)
 		*dB++ = R5G6B5toA1R5G5B5(*sB++);
 }
 
@@ -541,6 +1003,11 @@ void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN
 				case ECF_R8G8B8:
 					convert_A1R5G5B5toR8G8B8(sP, sN, dP);
 				break;
+				case ECF_DXT1:
+				case ECF_DXT3:
+				case ECF_DXT5:
+					os::Printer::log("Can not convert pixels into a compressed format", ELL_ERROR);
+				break;
 			}
 		break;
 		case ECF_R5G6B5:
@@ -558,6 +1025,11 @@ void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN
 				case ECF_R8G8B8:
 					convert_R5G6B5toR8G8B8(sP, sN, dP);
 				break;
+				case ECF_DXT1:
+				case ECF_DXT3:
+				case ECF_DXT5:
+					os::Printer::log("Can not convert pixels into a compressed format", ELL_ERROR);
+				break;
 			}
 		break;
 		case ECF_A8R8G8B8:
@@ -575,6 +1047,11 @@ void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN
 				case ECF_R8G8B8:
 					convert_A8R8G8B8toR8G8B8(sP, sN, dP);
 				break;
+				case ECF_DXT1:
+				case ECF_DXT3:
+				case ECF_DXT5:
+					os::Printer::log("Can not convert pixels into a compressed format", ELL_ERROR);
+				break;
 			}
 		break;
 		case ECF_R8G8B8:
@@ -592,12 +1069,46 @@ void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN
 				case ECF_R8G8B8:
 					convert_R8G8B8toR8G8B8(sP, sN, dP);
 				break;
+				case ECF_DXT1:
+				case ECF_DXT3:
+				case ECF_DXT5:
+					os::Printer::log("Can not convert pixels into a compressed format", ELL_ERROR);
+				break;
 			}
 		break;
+		case ECF_DXT1:
+		case ECF_DXT3:
+		case ECF_DXT5:
+			os::Printer::log("Can not convert pixels of a compressed format", ELL_ERROR);
+		break;
 	}
 }
 
 
+void CColorConverter::convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, u32 sPitch,
+			void* dP, ECOLOR_FORMAT dF, u32 dPitch,
+			u32 width, u32 height, bool parallel)
+{
+	if (!width || !height)
+		return;
+
+	SConvertTask task;
+	task.Source = (const u8*)sP;
+	task.Dest = (u8*)dP;
+	task.SourcePitch = sPitch;
+	task.DestPitch = dPitch;
+	task.Width = width;
+	task.SourceFormat = sF;
+	task.DestFormat = dF;
+
+	if (parallel && width * height >= 2 * CONVERT_BAND_PIXELS)
+		CThreadPool::getSharedPool()->parallelFor(height,
+				core::max_(1u, CONVERT_BAND_PIXELS / width), convertBand, &task);
+	else
+		convertBand(&task, 0, height);
+}
+
+
 } // end namespace video
 } // end namespace irr
 
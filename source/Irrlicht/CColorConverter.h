@@ -76,6 +76,20 @@ public:
 	static void convert_R5G6B5toA1R5G5B5(const void* sP, s32 sN, void* dP);
 	static void convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, s32 sN,
 				void* dP, ECOLOR_FORMAT dF);
+
+	//! converts a rectangle of pixels between two images
+	/** Rows are converted with convert_viaFormat. Where the processor
+	supports it, all conversions between 16 and 32 bit formats use SSE2 or
+	AVX2 instructions, selected when the engine runs.
+	\param sP pointer to the first source row
+	\param sPitch bytes between two source rows
+	\param dP pointer to the first destination row
+	\param dPitch bytes between two destination rows
+	\param parallel if true, large images are split into bands of rows
+	which are converted on the thread pool */
+	static void convert_viaFormat(const void* sP, ECOLOR_FORMAT sF, u32 sPitch,
+				void* dP, ECOLOR_FORMAT dF, u32 dPitch,
+				u32 width, u32 height, bool parallel=true);
 };
 
 
@@ -30,7 +30,7 @@ CD3D8Driver::CD3D8Driver(const core::dimension2d<u32>& screenSize, HWND window,
 			io::IFileSystem* io, bool pureSoftware, bool vsync)
 : CNullDriver(io, screenSize), CurrentRenderMode(ERM_NONE),
 	ResetRenderStates(true), Transformation3DChanged(false), StencilBuffer(stencilbuffer),
-	D3DLibrary(0), pID3D(0), pID3DDevice(0), PrevRenderTarget(0),
+	D3DLibrary(0), pID3D(0), pID3DDevice(0), PrevRenderTarget(0), RenderTargetTexture(0),
 	WindowId(0), SceneSourceRect(0),
 	LastVertexType((video::E_VERTEX_TYPE)-1), MaxTextureUnits(0), MaxUserClipPlanes(0),
 	MaxLightDistance(0), LastSetLight(-1), DeviceLost(false),
@@ -743,6 +743,7 @@ bool CD3D8Driver::setRenderTarget(video::ITexture* texture,
 				dss->Release();
 
 			CurrentRendertargetSize = core::dimension2d<u32>(0,0);
+			RenderTargetTexture = 0;
 			PrevRenderTarget->Release();
 			PrevRenderTarget = 0;
 		}
@@ -774,6 +775,7 @@ bool CD3D8Driver::setRenderTarget(video::ITexture* texture,
 			dss->Release();
 
 		CurrentRendertargetSize = tex->getSize();
+		RenderTargetTexture = texture;
 	}
 
 	if (clearBackBuffer || clearZBuffer)
@@ -2301,6 +2303,13 @@ const core::dimension2d<u32>& CD3D8Driver::getCurrentRenderTargetSize() const
 }
 
 
+//! returns the current render target texture, or 0 for the screen
+ITexture* CD3D8Driver::getCurrentRenderTarget() const
+{
+	return RenderTargetTexture;
+}
+
+
 // Set/unset a clipping plane.
 bool CD3D8Driver::setClipPlane(u32 index, const core::plane3df& plane, bool enable)
 {
@@ -259,6 +259,9 @@ namespace video
 		// returns the current size of the screen or rendertarget
 		virtual const core::dimension2d<u32>& getCurrentRenderTargetSize() const;
 
+		//! returns the current render target texture, or 0 for the screen
+		virtual ITexture* getCurrentRenderTarget() const;
+
 		//! Adds a new material renderer to the VideoDriver, using pixel and/or
 		//! vertex shaders to render geometry.
 		s32 addShaderMaterial(const c8* vertexShaderProgram, const c8* pixelShaderProgram,
@@ -300,6 +303,7 @@ namespace video
 		IDirect3DDevice8* pID3DDevice;
 
 		IDirect3DSurface8* PrevRenderTarget;
+		ITexture* RenderTargetTexture;
 		core::dimension2d<u32> CurrentRendertargetSize;
 
 		HWND WindowId;
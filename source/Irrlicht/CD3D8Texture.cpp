@@ -114,6 +114,9 @@ bool CD3D8Texture::createTexture(u32 flags, video::IImage* image)
 			{
 			case ECF_R8G8B8:
 			case ECF_A8R8G8B8:
+			case ECF_DXT1:
+			case ECF_DXT3:
+			case ECF_DXT5:
 				format = D3DFMT_A8R8G8B8; break;
 			case ECF_A1R5G5B5:
 			case ECF_R5G6B5:
@@ -29,7 +29,7 @@ CD3D9Driver::CD3D9Driver(const core::dimension2d<u32>& screenSize, HWND window,
 : CNullDriver(io, screenSize), CurrentRenderMode(ERM_NONE),
 	ResetRenderStates(true), Transformation3DChanged(false),
 	StencilBuffer(stencilbuffer), AntiAliasing(0),
-	D3DLibrary(0), pID3D(0), pID3DDevice(0), PrevRenderTarget(0),
+	D3DLibrary(0), pID3D(0), pID3DDevice(0), PrevRenderTarget(0), RenderTargetTexture(0),
 	WindowId(0), SceneSourceRect(0),
 	LastVertexType((video::E_VERTEX_TYPE)-1), VendorID(0),
 	MaxTextureUnits(0), MaxUserClipPlanes(0),
@@ -782,6 +782,7 @@ bool CD3D9Driver::setRenderTarget(video::ITexture* texture,
 			}
 
 			CurrentRendertargetSize = core::dimension2d<u32>(0,0);
+			RenderTargetTexture = 0;
 			PrevRenderTarget->Release();
 			PrevRenderTarget = 0;
 		}
@@ -809,6 +810,7 @@ bool CD3D9Driver::setRenderTarget(video::ITexture* texture,
 			return false;
 		}
 		CurrentRendertargetSize = tex->getSize();
+		RenderTargetTexture = texture;
 
 		if (FAILED(pID3DDevice->SetDepthStencilSurface(tex->DepthSurface->Surface)))
 		{
@@ -924,6 +926,7 @@ bool CD3D9Driver::setRenderTarget(const core::array<video::IRenderTarget>& targe
 	}
 
 	CurrentRendertargetSize = tex->getSize();
+	RenderTargetTexture = targets[0].RenderTexture;
 
 	if (FAILED(pID3DDevice->SetDepthStencilSurface(tex->DepthSurface->Surface)))
 	{
@@ -3116,6 +3119,13 @@ const core::dimension2d<u32>& CD3D9Driver::getCurrentRenderTargetSize() const
 }
 
 
+//! returns the current render target texture, or 0 for the screen
+ITexture* CD3D9Driver::getCurrentRenderTarget() const
+{
+	return RenderTargetTexture;
+}
+
+
 // Set/unset a clipping plane.
 bool CD3D9Driver::setClipPlane(u32 index, const core::plane3df& plane, bool enable)
 {
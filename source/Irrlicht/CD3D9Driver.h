@@ -334,6 +334,9 @@ namespace video
 		//! returns the current size of the screen or rendertarget
 		virtual const core::dimension2d<u32>& getCurrentRenderTargetSize() const;
 
+		//! returns the current render target texture, or 0 for the screen
+		virtual ITexture* getCurrentRenderTarget() const;
+
 		//! Check if a proper depth buffer for the RTT is available, otherwise create it.
 		void checkDepthBuffer(ITexture* tex);
 
@@ -399,6 +402,7 @@ namespace video
 		IDirect3DDevice9* pID3DDevice;
 
 		IDirect3DSurface9* PrevRenderTarget;
+		ITexture* RenderTargetTexture;
 		core::dimension2d<u32> CurrentRendertargetSize;
 		core::dimension2d<u32> CurrentDepthBufferSize;
 
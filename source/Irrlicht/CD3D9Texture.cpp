@@ -282,6 +282,9 @@ bool CD3D9Texture::createTexture(u32 flags, IImage * image)
 			{
 			case ECF_R8G8B8:
 			case ECF_A8R8G8B8:
+			case ECF_DXT1:
+			case ECF_DXT3:
+			case ECF_DXT5:
 				format = D3DFMT_A8R8G8B8; break;
 			case ECF_A1R5G5B5:
 			case ECF_R5G6B5:
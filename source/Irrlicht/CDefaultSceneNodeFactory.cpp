@@ -13,6 +13,8 @@
 #include "IParticleSystemSceneNode.h"
 #include "ILightSceneNode.h"
 #include "IMeshSceneNode.h"
+#include "ILODMeshSceneNode.h"
+#include "IInstancedMeshSceneNode.h"
 
 namespace irr
 {
@@ -35,6 +37,7 @@ CDefaultSceneNodeFactory::CDefaultSceneNodeFactory(ISceneManager* mgr)
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_TEXT, "text"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_WATER_SURFACE, "waterSurface"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_TERRAIN, "terrain"));
+	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_MORPHING_TERRAIN, "morphingTerrain"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_SKY_BOX, "skyBox"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_SKY_DOME, "skyDome"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_SHADOW_VOLUME, "shadowVolume"));
@@ -42,6 +45,8 @@ CDefaultSceneNodeFactory::CDefaultSceneNodeFactory(ISceneManager* mgr)
 	// Legacy support
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_OCTREE, "octTree"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_MESH, "mesh"));
+	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_LOD_MESH, "lodMesh"));
+	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_INSTANCED_MESH, "instancedMesh"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_LIGHT, "light"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_EMPTY, "empty"));
 	SupportedSceneNodeTypes.push_back(SSceneNodeTypePair(ESNT_DUMMY_TRANSFORMATION, "dummyTransformation"));
@@ -79,6 +84,13 @@ ISceneNode* CDefaultSceneNodeFactory::addSceneNode(ESCENE_NODE_TYPE type, IScene
 							core::vector3df(1.0f,1.0f,1.0f),
 							video::SColor(255,255,255,255),
 							4, ETPS_17, 0, true);
+	case ESNT_MORPHING_TERRAIN:
+		return Manager->addMorphingTerrainSceneNode("", parent, -1,
+							core::vector3df(0.0f,0.0f,0.0f),
+							core::vector3df(0.0f,0.0f,0.0f),
+							core::vector3df(1.0f,1.0f,1.0f),
+							video::SColor(255,255,255,255),
+							4.f, ETPS_17, 0, true);
 	case ESNT_SKY_BOX:
 		return Manager->addSkyBoxSceneNode(0,0,0,0,0,0, parent);
 	case ESNT_SKY_DOME:
@@ -90,6 +102,12 @@ ISceneNode* CDefaultSceneNodeFactory::addSceneNode(ESCENE_NODE_TYPE type, IScene
 	case ESNT_MESH:
 		return Manager->addMeshSceneNode(0, parent, -1, core::vector3df(),
 										 core::vector3df(), core::vector3df(1,1,1), true);
+	case ESNT_LOD_MESH:
+		return Manager->addLODMeshSceneNode(0, 1, 1.f, parent, -1, core::vector3df(),
+										 core::vector3df(), core::vector3df(1,1,1), true);
+	case ESNT_INSTANCED_MESH:
+		return Manager->addInstancedMeshSceneNode(0, parent, -1, core::vector3df(),
+										 core::vector3df(), core::vector3df(1,1,1), true);
 	case ESNT_LIGHT:
 		return Manager->addLightSceneNode(parent);
 	case ESNT_EMPTY:
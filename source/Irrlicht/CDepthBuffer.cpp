@@ -80,6 +80,63 @@ const core::dimension2d<u32>& CDepthBuffer::getSize() const
 
 
 
+//! constructor
+CStencilBuffer::CStencilBuffer(const core::dimension2d<u32>& size)
+: Buffer(0), Size(0,0)
+{
+	#ifdef _DEBUG
+	setDebugName("CStencilBuffer");
+	#endif
+
+	setSize(size);
+}
+
+
+
+//! destructor
+CStencilBuffer::~CStencilBuffer()
+{
+	if (Buffer)
+		delete [] Buffer;
+}
+
+
+
+//! clears the stencil buffer
+void CStencilBuffer::clear()
+{
+	memset ( Buffer, 0, TotalSize );
+}
+
+
+
+//! sets the new size of the stencil buffer
+void CStencilBuffer::setSize(const core::dimension2d<u32>& size)
+{
+	if (size == Size)
+		return;
+
+	Size = size;
+
+	if (Buffer)
+		delete [] Buffer;
+
+	Pitch = size.Width;
+	TotalSize = Pitch * size.Height;
+	Buffer = new u8[TotalSize];
+	clear();
+}
+
+
+
+//! returns the size of the stencil buffer
+const core::dimension2d<u32>& CStencilBuffer::getSize() const
+{
+	return Size;
+}
+
+
+
 } // end namespace video
 } // end namespace irr
 
@@ -100,6 +157,17 @@ IDepthBuffer* createDepthBuffer(const core::dimension2d<u32>& size)
 	#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
 }
 
+
+//! creates an 8 bit stencil buffer
+IStencilBuffer* createStencilBuffer(const core::dimension2d<u32>& size)
+{
+	#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+	return new CStencilBuffer(size);
+	#else
+	return 0;
+	#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
+}
+
 } // end namespace video
 } // end namespace irr
 
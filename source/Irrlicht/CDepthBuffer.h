@@ -57,6 +57,51 @@ namespace video
 		u32 Pitch;
 	};
 
+
+	class CStencilBuffer : public IStencilBuffer
+	{
+	public:
+
+		//! constructor
+		CStencilBuffer(const core::dimension2d<u32>& size);
+
+		//! destructor
+		virtual ~CStencilBuffer();
+
+		//! clears the stencil buffer
+		virtual void clear();
+
+		//! sets the new size of the stencil buffer
+		virtual void setSize(const core::dimension2d<u32>& size);
+
+		//! returns the size of the stencil buffer
+		virtual const core::dimension2d<u32>& getSize() const;
+
+		//! locks the stencil buffer
+		virtual void* lock()
+		{
+			return (void*) Buffer;
+		}
+
+		//! unlocks the stencil buffer
+		virtual void unlock()
+		{
+		}
+
+		//! returns pitch of stencil buffer (in bytes)
+		virtual u32 getPitch() const
+		{
+			return Pitch;
+		}
+
+	private:
+
+		u8* Buffer;
+		core::dimension2d<u32> Size;
+		u32 TotalSize;
+		u32 Pitch;
+	};
+
 } // end namespace video
 } // end namespace irr
 
@@ -59,6 +59,7 @@ CGUIButton::~CGUIButton()
 //! Sets if the images should be scaled to fit the button
 void CGUIButton::setScaleImage(bool scaleImage)
 {
+	invalidate();
 	ScaleImage = scaleImage;
 }
 
@@ -74,12 +75,14 @@ bool CGUIButton::isScalingImage() const
 //! Sets if the button should use the skin to draw its border
 void CGUIButton::setDrawBorder(bool border)
 {
+	invalidate();
 	DrawBorder = border;
 }
 
 
 void CGUIButton::setSpriteBank(IGUISpriteBank* sprites)
 {
+	invalidate();
 	if (sprites)
 		sprites->grab();
 
@@ -92,6 +95,7 @@ void CGUIButton::setSpriteBank(IGUISpriteBank* sprites)
 
 void CGUIButton::setSprite(EGUI_BUTTON_STATE state, s32 index, video::SColor color, bool loop)
 {
+	invalidate();
 	if (SpriteBank)
 	{
 		ButtonSprites[(u32)state].Index	= index;
@@ -308,6 +312,7 @@ void CGUIButton::draw()
 //! sets another skin independent font. if this is set to zero, the button uses the font of the skin.
 void CGUIButton::setOverrideFont(IGUIFont* font)
 {
+	invalidate();
 	if (OverrideFont == font)
 		return;
 
@@ -324,6 +329,7 @@ void CGUIButton::setOverrideFont(IGUIFont* font)
 //! Sets an image which should be displayed on the button when it is in normal state.
 void CGUIButton::setImage(video::ITexture* image)
 {
+	invalidate();
 	if (image)
 		image->grab();
 	if (Image)
@@ -349,6 +355,7 @@ void CGUIButton::setImage(video::ITexture* image, const core::rect<s32>& pos)
 //! Sets an image which should be displayed on the button when it is in pressed state.
 void CGUIButton::setPressedImage(video::ITexture* image)
 {
+	invalidate();
 	if (image)
 		image->grab();
 
@@ -374,6 +381,7 @@ void CGUIButton::setPressedImage(video::ITexture* image, const core::rect<s32>&
 //! the user can change the state of the button.
 void CGUIButton::setIsPushButton(bool isPushButton)
 {
+	invalidate();
 	IsPushButton = isPushButton;
 }
 
@@ -389,6 +397,7 @@ bool CGUIButton::isPressed() const
 //! Sets the pressed state of the button if this is a pushbutton
 void CGUIButton::setPressed(bool pressed)
 {
+	invalidate();
 	if (Pressed != pressed)
 	{
 		ClickTime = os::Timer::getTime();
@@ -408,6 +417,7 @@ bool CGUIButton::isPushButton() const
 //! Sets if the alpha channel should be used for drawing images on the button (default is false)
 void CGUIButton::setUseAlphaChannel(bool useAlphaChannel)
 {
+	invalidate();
 	UseAlphaChannel = useAlphaChannel;
 }
 
@@ -164,6 +164,7 @@ void CGUICheckBox::draw()
 //! set if box is checked
 void CGUICheckBox::setChecked(bool checked)
 {
+	invalidate();
 	Checked = checked;
 }
 
@@ -75,6 +75,7 @@ CGUIComboBox::CGUIComboBox(IGUIEnvironment* environment, IGUIElement* parent,
 
 void CGUIComboBox::setTextAlignment(EGUI_ALIGNMENT horizontal, EGUI_ALIGNMENT vertical)
 {
+	invalidate();
 	HAlign = horizontal;
 	VAlign = vertical;
 	SelectedText->setTextAlignment(horizontal, vertical);
@@ -121,6 +122,7 @@ s32 CGUIComboBox::getIndexForItemData(u32 data ) const
 //! Removes an item from the combo box.
 void CGUIComboBox::removeItem(u32 idx)
 {
+	invalidate();
 	if (idx >= Items.size())
 		return;
 
@@ -141,6 +143,7 @@ const wchar_t* CGUIComboBox::getText() const
 //! adds an item and returns the index of it
 u32 CGUIComboBox::addItem(const wchar_t* text, u32 data)
 {
+	invalidate();
 	Items.push_back( SComboData ( text, data ) );
 
 	if (Selected == -1)
@@ -153,6 +156,7 @@ u32 CGUIComboBox::addItem(const wchar_t* text, u32 data)
 //! deletes all items in the combo box
 void CGUIComboBox::clear()
 {
+	invalidate();
 	Items.clear();
 	setSelected(-1);
 }
@@ -168,6 +172,7 @@ s32 CGUIComboBox::getSelected() const
 //! sets the selected item. Set this to -1 if no item should be selected
 void CGUIComboBox::setSelected(s32 idx)
 {
+	invalidate();
 	if (idx < -1 || idx >= (s32)Items.size())
 		return;
 
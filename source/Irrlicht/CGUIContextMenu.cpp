@@ -80,6 +80,7 @@ u32 CGUIContextMenu::addItem(const wchar_t* text, s32 commandId, bool enabled, b
 u32 CGUIContextMenu::insertItem(u32 idx, const wchar_t* text, s32 commandId, bool enabled,
     bool hasSubMenu, bool checked, bool autoChecking)
 {
+	invalidate();
 	SItem s;
 	s.Enabled = enabled;
 	s.Checked = checked;
@@ -126,6 +127,7 @@ s32 CGUIContextMenu::findItemWithCommandId(s32 commandId, u32 idxStartSearch) co
 //! Adds a sub menu from an element that already exists.
 void CGUIContextMenu::setSubMenu(u32 index, CGUIContextMenu* menu)
 {
+	invalidate();
 	if (index >= Items.size())
 		return;
 
@@ -170,6 +172,7 @@ const wchar_t* CGUIContextMenu::getItemText(u32 idx) const
 //! Sets text of the menu item.
 void CGUIContextMenu::setItemText(u32 idx, const wchar_t* text)
 {
+	invalidate();
 	if (idx >= Items.size())
 		return;
 
@@ -180,6 +183,7 @@ void CGUIContextMenu::setItemText(u32 idx, const wchar_t* text)
 //! should the element change the checked status on clicking
 void CGUIContextMenu::setItemAutoChecking(u32 idx, bool autoChecking)
 {
+	invalidate();
 	if ( idx >= Items.size())
 		return;
 
@@ -227,6 +231,7 @@ bool CGUIContextMenu::isItemChecked(u32 idx) const
 //! Sets if the menu item should be enabled.
 void CGUIContextMenu::setItemEnabled(u32 idx, bool enabled)
 {
+	invalidate();
 	if (idx >= Items.size())
 		return;
 
@@ -237,6 +242,7 @@ void CGUIContextMenu::setItemEnabled(u32 idx, bool enabled)
 //! Sets if the menu item should be checked.
 void CGUIContextMenu::setItemChecked(u32 idx, bool checked )
 {
+	invalidate();
 	if (idx >= Items.size())
 		return;
 
@@ -247,6 +253,7 @@ void CGUIContextMenu::setItemChecked(u32 idx, bool checked )
 //! Removes a menu item
 void CGUIContextMenu::removeItem(u32 idx)
 {
+	invalidate();
 	if (idx >= Items.size())
 		return;
 
@@ -264,6 +271,7 @@ void CGUIContextMenu::removeItem(u32 idx)
 //! Removes all menu items
 void CGUIContextMenu::removeAllItems()
 {
+	invalidate();
 	for (u32 i=0; i<Items.size(); ++i)
 		if (Items[i].SubMenu)
 			Items[i].SubMenu->drop();
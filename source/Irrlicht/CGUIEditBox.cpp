@@ -34,7 +34,7 @@ CGUIEditBox::CGUIEditBox(const wchar_t* text, bool border,
 	: IGUIEditBox(environment, parent, id, rectangle), MouseMarking(false),
 	Border(border), OverrideColorEnabled(false), MarkBegin(0), MarkEnd(0),
 	OverrideColor(video::SColor(101,255,255,255)), OverrideFont(0), LastBreakFont(0),
-	Operator(0), BlinkStartTime(0), CursorPos(0), HScrollPos(0), VScrollPos(0), Max(0),
+	Operator(0), BlinkStartTime(0), CursorVisible(false), CursorPos(0), HScrollPos(0), VScrollPos(0), Max(0),
 	WordWrap(false), MultiLine(false), AutoScroll(true), PasswordBox(false),
 	PasswordChar(L'*'), HAlign(EGUIA_UPPERLEFT), VAlign(EGUIA_CENTER),
 	CurrentTextRect(0,0,1,1), FrameRect(rectangle)
@@ -76,6 +76,7 @@ CGUIEditBox::~CGUIEditBox()
 //! Sets another skin independent font.
 void CGUIEditBox::setOverrideFont(IGUIFont* font)
 {
+	invalidate();
 	if (OverrideFont == font)
 		return;
 
@@ -94,6 +95,7 @@ void CGUIEditBox::setOverrideFont(IGUIFont* font)
 //! Sets another color for the text.
 void CGUIEditBox::setOverrideColor(video::SColor color)
 {
+	invalidate();
 	OverrideColor = color;
 	OverrideColorEnabled = true;
 }
@@ -102,6 +104,7 @@ void CGUIEditBox::setOverrideColor(video::SColor color)
 //! Turns the border on or off
 void CGUIEditBox::setDrawBorder(bool border)
 {
+	invalidate();
 	Border = border;
 }
 
@@ -116,6 +119,7 @@ void CGUIEditBox::enableOverrideColor(bool enable)
 //! Enables or disables word wrap
 void CGUIEditBox::setWordWrap(bool enable)
 {
+	invalidate();
 	WordWrap = enable;
 	breakText();
 }
@@ -145,6 +149,7 @@ bool CGUIEditBox::isWordWrapEnabled() const
 //! Enables or disables newlines.
 void CGUIEditBox::setMultiLine(bool enable)
 {
+	invalidate();
 	MultiLine = enable;
 }
 
@@ -159,6 +164,7 @@ bool CGUIEditBox::isMultiLineEnabled() const
 
 void CGUIEditBox::setPasswordBox(bool passwordBox, wchar_t passwordChar)
 {
+	invalidate();
 	PasswordBox = passwordBox;
 	if (PasswordBox)
 	{
@@ -180,6 +186,7 @@ bool CGUIEditBox::isPasswordBox() const
 //! Sets text justification
 void CGUIEditBox::setTextAlignment(EGUI_ALIGNMENT horizontal, EGUI_ALIGNMENT vertical)
 {
+	invalidate();
 	HAlign = horizontal;
 	VAlign = vertical;
 }
@@ -863,9 +870,26 @@ void CGUIEditBox::draw()
 }
 
 
+//! redraws the cached edit box when the cursor blinks
+void CGUIEditBox::OnPostRender(u32 timeMs)
+{
+	const bool cursorVisible = IsEnabled && Environment->hasFocus(this) &&
+		(timeMs - BlinkStartTime) % 700 < 350;
+
+	if (cursorVisible != CursorVisible)
+	{
+		CursorVisible = cursorVisible;
+		invalidate();
+	}
+
+	IGUIElement::OnPostRender(timeMs);
+}
+
+
 //! Sets the new caption of this element.
 void CGUIEditBox::setText(const wchar_t* text)
 {
+	invalidate();
 	Text = text;
 	if (u32(CursorPos) > Text.size())
 		CursorPos = Text.size();
@@ -916,6 +940,7 @@ core::dimension2du CGUIEditBox::getTextDimension()
 //! infinity.
 void CGUIEditBox::setMax(u32 max)
 {
+	invalidate();
 	Max = max;
 
 	if (Text.size() > Max && Max != 0)
@@ -1431,6 +1456,7 @@ void CGUIEditBox::calculateFrameRect()
 //! set text markers
 void CGUIEditBox::setTextMarkers(s32 begin, s32 end)
 {
+	invalidate();
     if ( begin != MarkBegin || end != MarkEnd )
     {
         MarkBegin = begin;
@@ -77,6 +77,9 @@ namespace gui
 		//! draws the element and its children
 		virtual void draw();
 
+		//! redraws the cached edit box when the cursor blinks
+		virtual void OnPostRender(u32 timeMs);
+
 		//! Sets the new caption of this element.
 		virtual void setText(const wchar_t* text);
 
@@ -139,6 +142,7 @@ namespace gui
 		IOSOperator* Operator;
 
 		u32 BlinkStartTime;
+		bool CursorVisible;
 		s32 CursorPos;
 		s32 HScrollPos, VScrollPos; // scroll position in characters
 		u32 Max;
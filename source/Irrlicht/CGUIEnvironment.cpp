@@ -56,7 +56,7 @@ const wchar_t* IRR_XML_FORMAT_GUI_ELEMENT_ATTR_TYPE	= L"type";
 CGUIEnvironment::CGUIEnvironment(io::IFileSystem* fs, video::IVideoDriver* driver, IOSOperator* op)
 : IGUIElement(EGUIET_ELEMENT, 0, 0, 0, core::rect<s32>(core::position2d<s32>(0,0), driver ? core::dimension2d<s32>(driver->getScreenSize()) : core::dimension2d<s32>(0,0))),
 	Driver(driver), Hovered(0), HoveredNoSubelement(0), Focus(0), LastHoveredMousePos(0,0), CurrentSkin(0),
-	FileSystem(fs), UserReceiver(0), Operator(op)
+	FileSystem(fs), UserReceiver(0), Operator(op), RenderLayerCounter(0), DrawingLayer(false)
 {
 	if (Driver)
 		Driver->grab();
@@ -110,6 +110,8 @@ CGUIEnvironment::~CGUIEnvironment()
 		Hovered = 0;
 	}
 
+	removeUnusedLayers(true);
+
 	if (Driver)
 	{
 		Driver->drop();
@@ -209,11 +211,146 @@ void CGUIEnvironment::drawAll()
 	if (ToolTip.Element)
 		bringToFront(ToolTip.Element);
 
+	removeUnusedLayers();
+	RedrawRectangles.set_used(0);
+
+	core::list<IGUIElement*>::Iterator it = Children.begin();
+	for (; it != Children.end(); ++it)
+	{
+		if ((*it)->isVisible() && !(*it)->isRenderCached())
+			RedrawRectangles.push_back((*it)->getAbsoluteClippingRect());
+	}
+
 	draw();
 	OnPostRender ( os::Timer::getTime () );
 }
 
 
+//! draws an element from its cached layer
+void CGUIEnvironment::drawCachedElement(IGUIElement* element)
+{
+	if (!element || !element->isVisible())
+		return;
+
+	// nested layers are drawn into the layer of their parent,
+	// and without render targets there are no layers at all
+	if (DrawingLayer || !Driver || !Driver->queryFeature(video::EVDF_RENDER_TO_TARGET))
+	{
+		element->draw();
+		return;
+	}
+
+	const core::rect<s32> rect = element->getAbsolutePosition();
+	const core::rect<s32> clip = element->getAbsoluteClippingRect();
+	if (!clip.isValid() || clip.getArea() == 0)
+		return;
+
+	SRenderLayer* layer = 0;
+	for (u32 i=0; i<RenderLayers.size(); ++i)
+	{
+		if (RenderLayers[i].Element == element)
+		{
+			layer = &RenderLayers[i];
+			break;
+		}
+	}
+
+	if (!layer)
+	{
+		SRenderLayer newLayer;
+		newLayer.Element = element;
+		newLayer.Texture = 0;
+		newLayer.Used = false;
+		element->grab();
+		RenderLayers.push_back(newLayer);
+		layer = &RenderLayers.getLast();
+	}
+	layer->Used = true;
+
+	const core::dimension2du size(rect.getWidth(), rect.getHeight());
+	if (layer->Texture && layer->Texture->getOriginalSize() != size)
+	{
+		Driver->removeTexture(layer->Texture);
+		layer->Texture = 0;
+	}
+
+	if (!layer->Texture)
+	{
+		io::path name("<GUILayer");
+		name += io::path(RenderLayerCounter++);
+		name += ">";
+		layer->Texture = Driver->addRenderTargetTexture(size, name);
+		if (!layer->Texture)
+		{
+			element->draw();
+			return;
+		}
+		element->invalidate();
+	}
+
+	if (element->isDirty())
+	{
+		// the gui may itself be drawn into a render target of the user
+		video::ITexture* previousTarget = Driver->getCurrentRenderTarget();
+		Driver->setRenderTarget(layer->Texture, true, true, video::SColor(0,0,0,0));
+
+		// draw the element at the origin of the layer
+		DrawingLayer = true;
+		element->offsetAbsolutePosition(-rect.UpperLeftCorner);
+		element->draw();
+		element->offsetAbsolutePosition(rect.UpperLeftCorner);
+		DrawingLayer = false;
+
+		Driver->setRenderTarget(previousTarget, false, false);
+
+		element->clearDirty();
+		RedrawRectangles.push_back(clip);
+	}
+
+	Driver->draw2DImage(layer->Texture, clip.UpperLeftCorner,
+		core::rect<s32>(clip.UpperLeftCorner - rect.UpperLeftCorner, clip.getSize()),
+		0, video::SColor(255,255,255,255), true);
+}
+
+
+//! returns the screen rectangles redrawn by the last call to drawAll()
+const core::array<core::rect<s32> >& CGUIEnvironment::getRedrawRectangles() const
+{
+	return RedrawRectangles;
+}
+
+
+//! returns the number of pixels redrawn by the last call to drawAll()
+u32 CGUIEnvironment::getRedrawArea() const
+{
+	u32 area = 0;
+	for (u32 i=0; i<RedrawRectangles.size(); ++i)
+		area += RedrawRectangles[i].getArea();
+	return area;
+}
+
+
+//! removes the layers which were not drawn since the last call
+void CGUIEnvironment::removeUnusedLayers(bool all)
+{
+	for (s32 i=(s32)RenderLayers.size()-1; i>=0; --i)
+	{
+		SRenderLayer& layer = RenderLayers[i];
+
+		// removed, hidden and no longer cached elements don't draw their layer
+		if (all || !layer.Used)
+		{
+			if (layer.Texture && Driver)
+				Driver->removeTexture(layer.Texture);
+			layer.Element->drop();
+			RenderLayers.erase(i);
+		}
+		else
+			layer.Used = false;
+	}
+}
+
+
 //! sets the focus to an element
 bool CGUIEnvironment::setFocus(IGUIElement* element)
 {
@@ -281,10 +418,15 @@ bool CGUIEnvironment::setFocus(IGUIElement* element)
 		currentFocus->drop();
 
 	if (Focus)
+	{
+		Focus->invalidate();
 		Focus->drop();
+	}
 
 	// element is the new focus so it doesn't have to be dropped
 	Focus = element;
+	if (Focus)
+		Focus->invalidate();
 
 	return true;
 }
@@ -315,6 +457,7 @@ bool CGUIEnvironment::removeFocus(IGUIElement* element)
 	}
 	if (Focus)
 	{
+		Focus->invalidate();
 		Focus->drop();
 		Focus = 0;
 	}
@@ -492,6 +635,11 @@ void CGUIEnvironment::updateHoveredElement(core::position2d<s32> mousePos)
 
 	if (Hovered != lastHovered)
 	{
+		if (lastHovered)
+			lastHovered->invalidate();
+		if (Hovered)
+			Hovered->invalidate();
+
 		SEvent event;
 		event.EventType = EET_GUI_EVENT;
 
@@ -555,6 +703,10 @@ bool CGUIEnvironment::postEventFromUser(const SEvent& event)
 
 		updateHoveredElement(core::position2d<s32>(event.MouseInput.X, event.MouseInput.Y));
 
+		// elements only change on mouse moves while a button is held down
+		if (Focus && (event.MouseInput.Event != EMIE_MOUSE_MOVED || event.MouseInput.ButtonStates))
+			Focus->invalidate();
+
 		if (event.MouseInput.Event == EMIE_LMOUSE_PRESSED_DOWN)
 			if ( (Hovered && Hovered != Focus) || !Focus )
 		{
@@ -575,6 +727,9 @@ bool CGUIEnvironment::postEventFromUser(const SEvent& event)
 		break;
 	case EET_KEY_INPUT_EVENT:
 		{
+			if (Focus)
+				Focus->invalidate();
+
 			// send focus changing event
 			if (event.EventType == EET_KEY_INPUT_EVENT &&
 				event.KeyInput.PressedDown &&
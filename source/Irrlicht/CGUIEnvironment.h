@@ -36,6 +36,15 @@ public:
 	//! draws all gui elements
 	virtual void drawAll();
 
+	//! draws an element from its cached layer
+	virtual void drawCachedElement(IGUIElement* element);
+
+	//! returns the screen rectangles redrawn by the last call to drawAll()
+	virtual const core::array<core::rect<s32> >& getRedrawRectangles() const;
+
+	//! returns the number of pixels redrawn by the last call to drawAll()
+	virtual u32 getRedrawArea() const;
+
 	//! returns the current video driver
 	virtual video::IVideoDriver* getVideoDriver() const;
 
@@ -256,6 +265,9 @@ private:
 
 	void loadBuiltInFont();
 
+	//! removes the layers which were not drawn since the last call
+	void removeUnusedLayers(bool all=false);
+
 	struct SFont
 	{
 		io::SNamedPath NamedPath;
@@ -287,6 +299,14 @@ private:
 		u32 RelaunchTime;
 	};
 
+	struct SRenderLayer
+	{
+		IGUIElement* Element;
+		video::ITexture* Texture;
+		//! set when the layer is drawn, cleared by removeUnusedLayers
+		bool Used;
+	};
+
 	SToolTip ToolTip;
 
 	core::array<IGUIElementFactory*> GUIElementFactoryList;
@@ -302,6 +322,11 @@ private:
 	io::IFileSystem* FileSystem;
 	IEventReceiver* UserReceiver;
 	IOSOperator* Operator;
+
+	core::array<SRenderLayer> RenderLayers;
+	core::array<core::rect<s32> > RedrawRectangles;
+	u32 RenderLayerCounter;
+	bool DrawingLayer;
 };
 
 } // end namespace gui
@@ -40,6 +40,9 @@ CGUIFont::CGUIFont(IGUIEnvironment *env, const io::path& filename)
 	if (Driver)
 		Driver->grab();
 
+	for (u32 i=0; i<GLYPH_TABLE_SIZE; ++i)
+		GlyphTable[i] = 0;
+
 	setInvisibleCharacters ( L" " );
 }
 
@@ -181,7 +184,7 @@ bool CGUIFont::load(io::IXMLReader* xml)
 	}
 
 	// set bad character
-	WrongCharacter = getAreaFromCharacter(L' ');
+	updateGlyphTable();
 
 	setMaxHeight();
 
@@ -189,6 +192,21 @@ bool CGUIFont::load(io::IXMLReader* xml)
 }
 
 
+void CGUIFont::updateGlyphTable()
+{
+	core::map<wchar_t, s32>::Node* n = CharacterMap.find(L' ');
+	WrongCharacter = n ? n->getValue() : 0;
+
+	for (u32 i=0; i<GLYPH_TABLE_SIZE; ++i)
+	{
+		n = CharacterMap.find((wchar_t)i);
+		GlyphTable[i] = n ? n->getValue() : WrongCharacter;
+	}
+
+	clearGlyphRuns();
+}
+
+
 void CGUIFont::setMaxHeight()
 {
 	MaxHeight = 0;
@@ -253,10 +271,15 @@ bool CGUIFont::loadTexture(video::IImage* image, const io::path& name)
 		image->copyTo(tmpImage);
 		deleteTmpImage=true;
 		break;
+	case video::ECF_DXT1:
+	case video::ECF_DXT3:
+	case video::ECF_DXT5:
+		os::Printer::log("Can not load font from a compressed image", name, ELL_ERROR);
+		return false;
 	}
 	readPositions(tmpImage, lowerRightPositions);
 
-	WrongCharacter = getAreaFromCharacter(L' ');
+	updateGlyphTable();
 
 	// output warnings
 	if (!lowerRightPositions || !SpriteBank->getSprites().size())
@@ -361,6 +384,8 @@ void CGUIFont::readPositions(video::IImage* image, s32& lowerRightPositions)
 //! set an Pixel Offset on Drawing ( scale position on width )
 void CGUIFont::setKerningWidth(s32 kerning)
 {
+	if (GlobalKerningWidth != kerning)
+		clearGlyphRuns();
 	GlobalKerningWidth = kerning;
 }
 
@@ -387,6 +412,8 @@ s32 CGUIFont::getKerningWidth(const wchar_t* thisLetter, const wchar_t* previous
 //! set an Pixel Offset on Drawing ( scale position on height )
 void CGUIFont::setKerningHeight(s32 kerning)
 {
+	if (GlobalKerningHeight != kerning)
+		clearGlyphRuns();
 	GlobalKerningHeight = kerning;
 }
 
@@ -407,6 +434,9 @@ u32 CGUIFont::getSpriteNoFromChar(const wchar_t *c) const
 
 s32 CGUIFont::getAreaFromCharacter(const wchar_t c) const
 {
+	if ((u32)c < GLYPH_TABLE_SIZE)
+		return GlyphTable[(u32)c];
+
 	core::map<wchar_t, s32>::Node* n = CharacterMap.find(c);
 	if (n)
 		return n->getValue();
@@ -414,9 +444,96 @@ s32 CGUIFont::getAreaFromCharacter(const wchar_t c) const
 		return WrongCharacter;
 }
 
+
+bool CGUIFont::isInvisible(const wchar_t c) const
+{
+	if ((u32)c < GLYPH_TABLE_SIZE)
+		return InvisibleTable[(u32)c];
+
+	return Invisible.findFirst(c) >= 0;
+}
+
+
 void CGUIFont::setInvisibleCharacters( const wchar_t *s )
 {
 	Invisible = s;
+
+	for (u32 i=0; i<GLYPH_TABLE_SIZE; ++i)
+		InvisibleTable[i] = false;
+	for (u32 i=0; i<Invisible.size(); ++i)
+	{
+		if ((u32)Invisible[i] < GLYPH_TABLE_SIZE)
+			InvisibleTable[(u32)Invisible[i]] = true;
+	}
+
+	clearGlyphRuns();
+}
+
+
+//! returns the cached layout of a text, creates it if needed
+const CGUIFont::SGlyphRun& CGUIFont::getGlyphRun(const core::stringw& text)
+{
+	core::map<core::stringw, u32>::Node* n = GlyphRunMap.find(text);
+	if (n)
+		return GlyphRuns[n->getValue()];
+
+	// flush instead of tracking usage, texts drawn every frame come back at once
+	if (GlyphRuns.size() >= GLYPH_RUN_CACHE_SIZE)
+		clearGlyphRuns();
+
+	GlyphRunMap.insert(text, GlyphRuns.size());
+	GlyphRuns.push_back(SGlyphRun());
+	SGlyphRun& run = GlyphRuns.getLast();
+
+	run.Dimension = core::dimension2d<s32>(getDimension(text.c_str()));
+	run.Indices.reallocate(text.size());
+	run.Offsets.reallocate(text.size());
+
+	core::position2di offset(0,0);
+	for (u32 i = 0; i < text.size(); ++i)
+	{
+		wchar_t c = text[i];
+
+		bool lineBreak=false;
+		if ( c == L'\r') // Mac or Windows breaks
+		{
+			lineBreak = true;
+			if ( text[i + 1] == L'\n') // Windows breaks
+				c = text[++i];
+		}
+		else if ( c == L'\n') // Unix breaks
+		{
+			lineBreak = true;
+		}
+
+		if (lineBreak)
+		{
+			offset.Y += MaxHeight;
+			offset.X = 0;
+			continue;
+		}
+
+		const SFontArea& area = Areas[getAreaFromCharacter(c)];
+
+		offset.X += area.underhang;
+		if (!isInvisible(c))
+		{
+			run.Indices.push_back(area.spriteno);
+			run.Offsets.push_back(offset);
+		}
+
+		offset.X += area.width + area.overhang + GlobalKerningWidth;
+	}
+
+	return run;
+}
+
+
+//! removes all cached layouts
+void CGUIFont::clearGlyphRuns()
+{
+	GlyphRunMap.clear();
+	GlyphRuns.clear();
 }
 
 
@@ -470,70 +587,31 @@ void CGUIFont::draw(const core::stringw& text, const core::rect<s32>& position,
 	if (!Driver)
 		return;
 
-	core::dimension2d<s32> textDimension;	// NOTE: don't make this u32 or the >> later on can fail when the dimension widht is < position width
-	core::position2d<s32> offset = position.UpperLeftCorner;
+	const SGlyphRun& run = getGlyphRun(text);
+	if (run.Indices.empty())
+		return;
 
-	if (hcenter || vcenter || clip)
-		textDimension = getDimension(text.c_str());
+	core::position2d<s32> offset = position.UpperLeftCorner;
 
 	if (hcenter)
-		offset.X += (position.getWidth() - textDimension.Width) >> 1;
+		offset.X += (position.getWidth() - run.Dimension.Width) >> 1;
 
 	if (vcenter)
-		offset.Y += (position.getHeight() - textDimension.Height) >> 1;
+		offset.Y += (position.getHeight() - run.Dimension.Height) >> 1;
 
 	if (clip)
 	{
-		core::rect<s32> clippedRect(offset, textDimension);
+		core::rect<s32> clippedRect(offset, run.Dimension);
 		clippedRect.clipAgainst(*clip);
 		if (!clippedRect.isValid())
 			return;
 	}
 
-	core::array<u32> indices(text.size());
-	core::array<core::position2di> offsets(text.size());
-
-	for(u32 i = 0;i < text.size();i++)
-	{
-		wchar_t c = text[i];
-
-		bool lineBreak=false;
-		if ( c == L'\r') // Mac or Windows breaks
-		{
-			lineBreak = true;
-			if ( text[i + 1] == L'\n') // Windows breaks
-				c = text[++i];
-		}
-		else if ( c == L'\n') // Unix breaks
-		{
-			lineBreak = true;
-		}
-
-		if (lineBreak)
-		{
-			offset.Y += MaxHeight;
-			offset.X = position.UpperLeftCorner.X;
-
-			if ( hcenter )
-			{
-				offset.X += (position.getWidth() - textDimension.Width) >> 1;
-			}
-			continue;
-		}
-
-		SFontArea& area = Areas[getAreaFromCharacter(c)];
-
-		offset.X += area.underhang;
-		if ( Invisible.findFirst ( c ) < 0 )
-		{
-			indices.push_back(area.spriteno);
-			offsets.push_back(offset);
-		}
-
-		offset.X += area.width + area.overhang + GlobalKerningWidth;
-	}
+	DrawOffsets.set_used(run.Offsets.size());
+	for (u32 i = 0; i < run.Offsets.size(); ++i)
+		DrawOffsets[i] = run.Offsets[i] + offset;
 
-	SpriteBank->draw2DSpriteBatch(indices, offsets, clip, color);
+	SpriteBank->draw2DSpriteBatch(run.Indices, DrawOffsets, clip, color);
 }
 
 
@@ -97,8 +97,39 @@ private:
 	s32 getAreaFromCharacter (const wchar_t c) const;
 	void setMaxHeight();
 
+	//! returns true if the character is not drawn
+	bool isInvisible(const wchar_t c) const;
+
+	//! fills the direct mapped glyph table from the character map
+	void updateGlyphTable();
+
+	//! a laid out text, positions are relative to the upper left corner
+	struct SGlyphRun
+	{
+		core::array<u32> Indices;
+		core::array<core::position2di> Offsets;
+		core::dimension2d<s32> Dimension;
+	};
+
+	//! returns the cached layout of a text, creates it if needed
+	const SGlyphRun& getGlyphRun(const core::stringw& text);
+
+	//! removes all cached layouts
+	void clearGlyphRuns();
+
+	//! characters below this have their areas in a flat table instead of the map
+	enum { GLYPH_TABLE_SIZE = 0x800 };
+
+	//! maximum number of cached layouts before the cache is flushed
+	enum { GLYPH_RUN_CACHE_SIZE = 512 };
+
 	core::array<SFontArea>		Areas;
 	core::map<wchar_t, s32>		CharacterMap;
+	s32				GlyphTable[GLYPH_TABLE_SIZE];
+	bool				InvisibleTable[GLYPH_TABLE_SIZE];
+	core::map<core::stringw, u32>	GlyphRunMap;
+	core::array<SGlyphRun>		GlyphRuns;
+	core::array<core::position2di>	DrawOffsets;
 	video::IVideoDriver*		Driver;
 	IGUISpriteBank*			SpriteBank;
 	IGUIEnvironment*		Environment;
@@ -37,6 +37,7 @@ CGUIImage::~CGUIImage()
 //! sets an image
 void CGUIImage::setImage(video::ITexture* image)
 {
+	invalidate();
 	if (image == Texture)
 		return;
 
@@ -53,6 +54,7 @@ void CGUIImage::setImage(video::ITexture* image)
 //! sets the color of the image
 void CGUIImage::setColor(video::SColor color)
 {
+	invalidate();
 	Color = color;
 }
 
@@ -97,6 +99,7 @@ void CGUIImage::draw()
 //! sets if the image should use its alpha channel to draw itself
 void CGUIImage::setUseAlphaChannel(bool use)
 {
+	invalidate();
 	UseAlphaChannel = use;
 }
 
@@ -104,6 +107,7 @@ void CGUIImage::setUseAlphaChannel(bool use)
 //! sets if the image should use its alpha channel to draw itself
 void CGUIImage::setScaleImage(bool scale)
 {
+	invalidate();
 	ScaleImage = scale;
 }
 
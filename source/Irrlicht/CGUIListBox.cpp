@@ -23,7 +23,7 @@ namespace gui
 CGUIListBox::CGUIListBox(IGUIEnvironment* environment, IGUIElement* parent,
 			s32 id, core::rect<s32> rectangle, bool clip,
 			bool drawBack, bool moveOverSelect)
-: IGUIListBox(environment, parent, id, rectangle), Selected(-1),
+: IGUIListBox(environment, parent, id, rectangle), DataSource(0), Selected(-1),
 	ItemHeight(0),ItemHeightOverride(0),
 	TotalItemHeight(0), ItemsIconWidth(0), Font(0), IconBank(0),
 	ScrollBar(0), selectTime(0), LastKeyTime(0), Selecting(false), DrawBack(drawBack),
@@ -66,12 +66,18 @@ CGUIListBox::~CGUIListBox()
 
 	if (IconBank)
 		IconBank->drop();
+
+	if (DataSource)
+		DataSource->drop();
 }
 
 
 //! returns amount of list items
 u32 CGUIListBox::getItemCount() const
 {
+	if (DataSource)
+		return DataSource->getItemCount();
+
 	return Items.size();
 }
 
@@ -79,6 +85,9 @@ u32 CGUIListBox::getItemCount() const
 //! returns string of a list item. the may be a value from 0 to itemCount-1
 const wchar_t* CGUIListBox::getListItem(u32 id) const
 {
+	if (DataSource)
+		return id < DataSource->getItemCount() ? DataSource->getItemText(id) : 0;
+
 	if (id>=Items.size())
 		return 0;
 
@@ -89,6 +98,9 @@ const wchar_t* CGUIListBox::getListItem(u32 id) const
 //! Returns the icon of an item
 s32 CGUIListBox::getIcon(u32 id) const
 {
+	if (DataSource)
+		return id < DataSource->getItemCount() ? DataSource->getItemIcon(id) : -1;
+
 	if (id>=Items.size())
 		return -1;
 
@@ -106,6 +118,7 @@ u32 CGUIListBox::addItem(const wchar_t* text)
 //! adds a list item, returns id of item
 void CGUIListBox::removeItem(u32 id)
 {
+	invalidate();
 	if (id >= Items.size())
 		return;
 
@@ -128,6 +141,7 @@ void CGUIListBox::removeItem(u32 id)
 //! clears the list
 void CGUIListBox::clear()
 {
+	invalidate();
 	Items.clear();
 	ItemsIconWidth = 0;
 	Selected = -1;
@@ -161,7 +175,7 @@ void CGUIListBox::recalculateItemHeight()
 		}
 	}
 
-	TotalItemHeight = ItemHeight * Items.size();
+	TotalItemHeight = ItemHeight * getItemCount();
 	ScrollBar->setMax( core::max_(0, TotalItemHeight - AbsoluteRect.getHeight()) );
 	s32 minItemHeight = ItemHeight > 0 ? ItemHeight : 1;
 	ScrollBar->setSmallStep ( minItemHeight );
@@ -184,7 +198,8 @@ s32 CGUIListBox::getSelected() const
 //! sets the selected item. Set this to -1 if no item should be selected
 void CGUIListBox::setSelected(s32 id)
 {
-	if ((u32)id>=Items.size())
+	invalidate();
+	if ((u32)id>=getItemCount())
 		Selected = -1;
 	else
 		Selected = id;
@@ -197,13 +212,16 @@ void CGUIListBox::setSelected(s32 id)
 //! sets the selected item. Set this to -1 if no item should be selected
 void CGUIListBox::setSelected(const wchar_t *item)
 {
+	invalidate();
 	s32 index = -1;
 
 	if ( item )
 	{
-		for ( index = 0; index < (s32) Items.size(); ++index )
+		const s32 count = (s32)getItemCount();
+		for ( index = 0; index < count; ++index )
 		{
-			if ( Items[index].text == item )
+			const wchar_t* text = getListItem(index);
+			if ( text && core::stringw(text) == item )
 				break;
 		}
 	}
@@ -239,7 +257,7 @@ bool CGUIListBox::OnEvent(const SEvent& event)
 						Selected = 0;
 						break;
 					case KEY_END:
-						Selected = (s32)Items.size()-1;
+						Selected = (s32)getItemCount()-1;
 						break;
 					case KEY_NEXT:
 						Selected += AbsoluteRect.getHeight() / ItemHeight;
@@ -250,8 +268,8 @@ bool CGUIListBox::OnEvent(const SEvent& event)
 					default:
 						break;
 				}
-				if (Selected >= (s32)Items.size())
-					Selected = Items.size() - 1;
+				if (Selected >= (s32)getItemCount())
+					Selected = getItemCount() - 1;
 				else
 				if (Selected<0)
 					Selected = 0;
@@ -312,51 +330,44 @@ bool CGUIListBox::OnEvent(const SEvent& event)
 				// dont change selection if the key buffer matches the current item
 				if (Selected > -1 && KeyBuffer.size() > 1)
 				{
-					if (Items[Selected].text.size() >= KeyBuffer.size() &&
-						KeyBuffer.equals_ignore_case(Items[Selected].text.subString(0,KeyBuffer.size())))
+					if (matchesKeyBuffer(Selected))
 						return true;
 				}
 
 				s32 current;
-				for (current = start+1; current < (s32)Items.size(); ++current)
+				for (current = start+1; current < (s32)getItemCount(); ++current)
 				{
-					if (Items[current].text.size() >= KeyBuffer.size())
+					if (matchesKeyBuffer(current))
 					{
-						if (KeyBuffer.equals_ignore_case(Items[current].text.subString(0,KeyBuffer.size())))
+						if (Parent && Selected != current && !Selecting && !MoveOverSelect)
 						{
-							if (Parent && Selected != current && !Selecting && !MoveOverSelect)
-							{
-								SEvent e;
-								e.EventType = EET_GUI_EVENT;
-								e.GUIEvent.Caller = this;
-								e.GUIEvent.Element = 0;
-								e.GUIEvent.EventType = EGET_LISTBOX_CHANGED;
-								Parent->OnEvent(e);
-							}
-							setSelected(current);
-							return true;
+							SEvent e;
+							e.EventType = EET_GUI_EVENT;
+							e.GUIEvent.Caller = this;
+							e.GUIEvent.Element = 0;
+							e.GUIEvent.EventType = EGET_LISTBOX_CHANGED;
+							Parent->OnEvent(e);
 						}
+						setSelected(current);
+						return true;
 					}
 				}
 				for (current = 0; current <= start; ++current)
 				{
-					if (Items[current].text.size() >= KeyBuffer.size())
+					if (matchesKeyBuffer(current))
 					{
-						if (KeyBuffer.equals_ignore_case(Items[current].text.subString(0,KeyBuffer.size())))
+						if (Parent && Selected != current && !Selecting && !MoveOverSelect)
 						{
-							if (Parent && Selected != current && !Selecting && !MoveOverSelect)
-							{
-								Selected = current;
-								SEvent e;
-								e.EventType = EET_GUI_EVENT;
-								e.GUIEvent.Caller = this;
-								e.GUIEvent.Element = 0;
-								e.GUIEvent.EventType = EGET_LISTBOX_CHANGED;
-								Parent->OnEvent(e);
-							}
-							setSelected(current);
-							return true;
+							Selected = current;
+							SEvent e;
+							e.EventType = EET_GUI_EVENT;
+							e.GUIEvent.Caller = this;
+							e.GUIEvent.Element = 0;
+							e.GUIEvent.EventType = EGET_LISTBOX_CHANGED;
+							Parent->OnEvent(e);
 						}
+						setSelected(current);
+						return true;
 					}
 				}
 
@@ -445,8 +456,8 @@ void CGUIListBox::selectNew(s32 ypos, bool onlyHover)
 	if (Selected<0)
 		Selected = 0;
 	else
-	if ((u32)Selected >= Items.size())
-		Selected = Items.size() - 1;
+	if ((u32)Selected >= getItemCount())
+		Selected = getItemCount() - 1;
 
 	recalculateScrollPos();
 
@@ -517,7 +528,29 @@ void CGUIListBox::draw()
 
 	bool hl = (HighlightWhenNotFocused || Environment->hasFocus(this) || Environment->hasFocus(ScrollBar));
 
-	for (s32 i=0; i<(s32)Items.size(); ++i)
+	// only the items overlapping the element are drawn
+	const s32 itemCount = (s32)getItemCount();
+	s32 firstItem = 0;
+	s32 lastItem = itemCount;
+	if (ItemHeight > 0)
+	{
+		firstItem = core::clamp(ScrollBar->getPos() / ItemHeight - 1, 0, itemCount);
+		lastItem = core::clamp((ScrollBar->getPos() + AbsoluteRect.getHeight()) / ItemHeight + 1, firstItem, itemCount);
+
+		frameRect.UpperLeftCorner.Y += firstItem * ItemHeight;
+		frameRect.LowerRightCorner.Y += firstItem * ItemHeight;
+	}
+
+	if (DataSource && lastItem > firstItem)
+	{
+		DataSource->prepareItems(firstItem, lastItem - firstItem);
+
+		// the icons of a data source are only known once they are visible
+		for (s32 i=firstItem; i<lastItem; ++i)
+			recalculateItemWidth(DataSource->getItemIcon(i));
+	}
+
+	for (s32 i=firstItem; i<lastItem; ++i)
 	{
 		if (frameRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y &&
 			frameRect.UpperLeftCorner.Y <= AbsoluteRect.LowerRightCorner.Y)
@@ -530,7 +563,10 @@ void CGUIListBox::draw()
 
 			if (Font)
 			{
-				if (IconBank && (Items[i].icon > -1))
+				const s32 icon = getIcon(i);
+				const wchar_t* text = getListItem(i);
+
+				if (IconBank && (icon > -1))
 				{
 					core::position2di iconPos = textRect.UpperLeftCorner;
 					iconPos.Y += textRect.getHeight() / 2;
@@ -538,14 +574,14 @@ void CGUIListBox::draw()
 
 					if ( i==Selected && hl )
 					{
-						IconBank->draw2DSprite( (u32)Items[i].icon, iconPos, &clientClip,
+						IconBank->draw2DSprite( (u32)icon, iconPos, &clientClip,
 							hasItemOverrideColor(i, EGUI_LBC_ICON_HIGHLIGHT) ?
 							getItemOverrideColor(i, EGUI_LBC_ICON_HIGHLIGHT) : getItemDefaultColor(EGUI_LBC_ICON_HIGHLIGHT),
 							selectTime, os::Timer::getTime(), false, true);
 					}
 					else
 					{
-						IconBank->draw2DSprite( (u32)Items[i].icon, iconPos, &clientClip,
+						IconBank->draw2DSprite( (u32)icon, iconPos, &clientClip,
 							hasItemOverrideColor(i, EGUI_LBC_ICON) ? getItemOverrideColor(i, EGUI_LBC_ICON) : getItemDefaultColor(EGUI_LBC_ICON),
 							0 , (i==Selected) ? os::Timer::getTime() : 0, false, true);
 					}
@@ -555,14 +591,14 @@ void CGUIListBox::draw()
 
 				if ( i==Selected && hl )
 				{
-					Font->draw(Items[i].text.c_str(), textRect,
+					Font->draw(text, textRect,
 						hasItemOverrideColor(i, EGUI_LBC_TEXT_HIGHLIGHT) ?
 						getItemOverrideColor(i, EGUI_LBC_TEXT_HIGHLIGHT) : getItemDefaultColor(EGUI_LBC_TEXT_HIGHLIGHT),
 						false, true, &clientClip);
 				}
 				else
 				{
-					Font->draw(Items[i].text.c_str(), textRect,
+					Font->draw(text, textRect,
 						hasItemOverrideColor(i, EGUI_LBC_TEXT) ? getItemOverrideColor(i, EGUI_LBC_TEXT) : getItemDefaultColor(EGUI_LBC_TEXT),
 						false, true, &clientClip);
 				}
@@ -582,6 +618,7 @@ void CGUIListBox::draw()
 //! adds an list item with an icon
 u32 CGUIListBox::addItem(const wchar_t* text, s32 icon)
 {
+	invalidate();
 	ListItem i;
 	i.text = text;
 	i.icon = icon;
@@ -596,6 +633,7 @@ u32 CGUIListBox::addItem(const wchar_t* text, s32 icon)
 
 void CGUIListBox::setSpriteBank(IGUISpriteBank* bank)
 {
+	invalidate();
     if ( bank == IconBank )
         return;
 	if (IconBank)
@@ -666,6 +704,49 @@ bool CGUIListBox::getSerializationLabels(EGUI_LISTBOX_COLOR colorType, core::str
 }
 
 
+//! returns true if the text of an item starts with the typed keys
+bool CGUIListBox::matchesKeyBuffer(s32 index) const
+{
+	const wchar_t* text = getListItem(index);
+	if (!text)
+		return false;
+
+	for (u32 i=0; i<KeyBuffer.size(); ++i)
+	{
+		if (!text[i] || core::locale_lower(text[i]) != core::locale_lower(KeyBuffer[i]))
+			return false;
+	}
+	return true;
+}
+
+
+//! Sets a data source which supplies the items instead of the list box.
+void CGUIListBox::setDataSource(IGUIListBoxDataSource* source)
+{
+	invalidate();
+	if (source == DataSource)
+		return;
+
+	if (source)
+		source->grab();
+	if (DataSource)
+		DataSource->drop();
+
+	DataSource = source;
+	Selected = -1;
+	ScrollBar->setPos(0);
+
+	recalculateItemHeight();
+}
+
+
+//! Returns the data source set with setDataSource(), or 0.
+IGUIListBoxDataSource* CGUIListBox::getDataSource() const
+{
+	return DataSource;
+}
+
+
 //! Writes attributes of the element.
 void CGUIListBox::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options=0) const
 {
@@ -762,6 +843,7 @@ void CGUIListBox::recalculateItemWidth(s32 icon)
 
 void CGUIListBox::setItem(u32 index, const wchar_t* text, s32 icon)
 {
+	invalidate();
 	if ( index >= Items.size() )
 		return;
 
@@ -777,6 +859,7 @@ void CGUIListBox::setItem(u32 index, const wchar_t* text, s32 icon)
 //! Return the index on success or -1 on failure.
 s32 CGUIListBox::insertItem(u32 index, const wchar_t* text, s32 icon)
 {
+	invalidate();
 	ListItem i;
 	i.text = text;
 	i.icon = icon;
@@ -791,6 +874,7 @@ s32 CGUIListBox::insertItem(u32 index, const wchar_t* text, s32 icon)
 
 void CGUIListBox::swapItems(u32 index1, u32 index2)
 {
+	invalidate();
 	if ( index1 >= Items.size() || index2 >= Items.size() )
 		return;
 
@@ -802,6 +886,7 @@ void CGUIListBox::swapItems(u32 index1, u32 index2)
 
 void CGUIListBox::setItemOverrideColor(u32 index, const video::SColor &color)
 {
+	invalidate();
 	for ( u32 c=0; c < EGUI_LBC_COUNT; ++c )
 	{
 		Items[index].OverrideColors[c].Use = true;
@@ -812,6 +897,7 @@ void CGUIListBox::setItemOverrideColor(u32 index, const video::SColor &color)
 
 void CGUIListBox::setItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType, const video::SColor &color)
 {
+	invalidate();
 	if ( index >= Items.size() || colorType < 0 || colorType >= EGUI_LBC_COUNT )
 		return;
 
@@ -822,6 +908,7 @@ void CGUIListBox::setItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType,
 
 void CGUIListBox::clearItemOverrideColor(u32 index)
 {
+	invalidate();
 	for (u32 c=0; c < (u32)EGUI_LBC_COUNT; ++c )
 	{
 		Items[index].OverrideColors[c].Use = false;
@@ -831,6 +918,7 @@ void CGUIListBox::clearItemOverrideColor(u32 index)
 
 void CGUIListBox::clearItemOverrideColor(u32 index, EGUI_LISTBOX_COLOR colorType)
 {
+	invalidate();
 	if ( index >= Items.size() || colorType < 0 || colorType >= EGUI_LBC_COUNT )
 		return;
 
@@ -880,6 +968,7 @@ video::SColor CGUIListBox::getItemDefaultColor(EGUI_LISTBOX_COLOR colorType) con
 //! set global itemHeight
 void CGUIListBox::setItemHeight( s32 height )
 {
+	invalidate();
 	ItemHeight = height;
 	ItemHeightOverride = 1;
 }
@@ -888,6 +977,7 @@ void CGUIListBox::setItemHeight( s32 height )
 //! Sets whether to draw the background
 void CGUIListBox::setDrawBackground(bool draw)
 {
+	invalidate();
     DrawBack = draw;
 }
 
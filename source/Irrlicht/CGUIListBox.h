@@ -128,6 +128,12 @@ namespace gui
         //! Sets whether to draw the background
         virtual void setDrawBackground(bool draw);
 
+		//! Sets a data source which supplies the items instead of the list box.
+		virtual void setDataSource(IGUIListBoxDataSource* source);
+
+		//! Returns the data source set with setDataSource(), or 0.
+		virtual IGUIListBoxDataSource* getDataSource() const;
+
 
 	private:
 
@@ -153,6 +159,9 @@ namespace gui
 		void selectNew(s32 ypos, bool onlyHover=false);
 		void recalculateScrollPos();
 
+		//! returns true if the text of an item starts with the typed keys
+		bool matchesKeyBuffer(s32 index) const;
+
 		// extracted that function to avoid copy&paste code
 		void recalculateItemWidth(s32 icon);
 
@@ -160,6 +169,7 @@ namespace gui
 		bool getSerializationLabels(EGUI_LISTBOX_COLOR colorType, core::stringc & useColorLabel, core::stringc & colorLabel) const;
 
 		core::array< ListItem > Items;
+		IGUIListBoxDataSource* DataSource;
 		s32 Selected;
 		s32 ItemHeight;
 		s32 ItemHeightOverride;
@@ -40,6 +40,7 @@ CGUIMeshViewer::~CGUIMeshViewer()
 //! sets the mesh to be shown
 void CGUIMeshViewer::setMesh(scene::IAnimatedMesh* mesh)
 {
+	invalidate();
     if (mesh)
         mesh->grab();
 	if (Mesh)
@@ -67,6 +68,7 @@ scene::IAnimatedMesh* CGUIMeshViewer::getMesh() const
 //! sets the material
 void CGUIMeshViewer::setMaterial(const video::SMaterial& material)
 {
+	invalidate();
 	Material = material;
 }
 
@@ -347,6 +347,7 @@ s32 CGUIScrollBar::getPosFromMousePos(const core::position2di &pos) const
 //! sets the position of the scrollbar
 void CGUIScrollBar::setPos(s32 pos)
 {
+	invalidate();
 	Pos = core::s32_clamp ( pos, Min, Max );
 
 	if (Horizontal)
@@ -410,6 +411,7 @@ s32 CGUIScrollBar::getMax() const
 //! sets the maximum value of the scrollbar.
 void CGUIScrollBar::setMax(s32 max)
 {
+	invalidate();
 	Max = max;
 	if ( Min > Max )
 		Min = Max;
@@ -430,6 +432,7 @@ s32 CGUIScrollBar::getMin() const
 //! sets the minimum value of the scrollbar.
 void CGUIScrollBar::setMin(s32 min)
 {
+	invalidate();
 	Min = min;
 	if ( Max < Min )
 		Max = Min;
@@ -109,6 +109,7 @@ IGUIEditBox* CGUISpinBox::getEditBox() const
 
 void CGUISpinBox::setValue(f32 val)
 {
+	invalidate();
 	wchar_t str[100];
 
 	swprintf(str, 99, FormatString.c_str(), val);
@@ -129,6 +130,7 @@ f32 CGUISpinBox::getValue() const
 
 void CGUISpinBox::setRange(f32 min, f32 max)
 {
+	invalidate();
 	RangeMin = min;
 	RangeMax = max;
 	verifyValueRange();
@@ -162,6 +164,7 @@ void CGUISpinBox::setStepSize(f32 step)
 //! Sets the number of decimal places to display.
 void CGUISpinBox::setDecimalPlaces(s32 places)
 {
+	invalidate();
 	DecimalPlaces = places;
 	if (places == -1)
 		FormatString = "%f";
@@ -147,6 +147,7 @@ void CGUIStaticText::draw()
 //! Sets another skin independent font.
 void CGUIStaticText::setOverrideFont(IGUIFont* font)
 {
+	invalidate();
 	if (OverrideFont == font)
 		return;
 
@@ -171,6 +172,7 @@ IGUIFont * CGUIStaticText::getOverrideFont() const
 //! Sets another color for the text.
 void CGUIStaticText::setOverrideColor(video::SColor color)
 {
+	invalidate();
 	OverrideColor = color;
 	OverrideColorEnabled = true;
 }
@@ -179,6 +181,7 @@ void CGUIStaticText::setOverrideColor(video::SColor color)
 //! Sets another color for the text.
 void CGUIStaticText::setBackgroundColor(video::SColor color)
 {
+	invalidate();
 	BGColor = color;
 	OverrideBGColorEnabled = true;
 	Background = true;
@@ -188,6 +191,7 @@ void CGUIStaticText::setBackgroundColor(video::SColor color)
 //! Sets whether to draw the background
 void CGUIStaticText::setDrawBackground(bool draw)
 {
+	invalidate();
 	Background = draw;
 }
 
@@ -195,12 +199,14 @@ void CGUIStaticText::setDrawBackground(bool draw)
 //! Sets whether to draw the border
 void CGUIStaticText::setDrawBorder(bool draw)
 {
+	invalidate();
 	Border = draw;
 }
 
 
 void CGUIStaticText::setTextAlignment(EGUI_ALIGNMENT horizontal, EGUI_ALIGNMENT vertical)
 {
+	invalidate();
 	HAlign = horizontal;
 	VAlign = vertical;
 }
@@ -231,6 +237,7 @@ bool CGUIStaticText::isOverrideColorEnabled() const
 //! multiline text control.
 void CGUIStaticText::setWordWrap(bool enable)
 {
+	invalidate();
 	WordWrap = enable;
 	breakText();
 }
@@ -357,6 +364,7 @@ void CGUIStaticText::breakText()
 //! Sets the new caption of this element.
 void CGUIStaticText::setText(const wchar_t* text)
 {
+	invalidate();
 	IGUIElement::setText(text);
 	breakText();
 }
@@ -80,6 +80,7 @@ void CGUITab::draw()
 //! sets if the tab should draw its background
 void CGUITab::setDrawBackground(bool draw)
 {
+	invalidate();
 	DrawBackground = draw;
 }
 
@@ -87,6 +88,7 @@ void CGUITab::setDrawBackground(bool draw)
 //! sets the color of the background, if it should be drawn.
 void CGUITab::setBackgroundColor(video::SColor c)
 {
+	invalidate();
 	BackColor = c;
 }
 
@@ -94,6 +96,7 @@ void CGUITab::setBackgroundColor(video::SColor c)
 //! sets the color of the text
 void CGUITab::setTextColor(video::SColor c)
 {
+	invalidate();
 	OverrideTextColorEnabled = true;
 	TextColor = c;
 }
@@ -239,6 +242,7 @@ CGUITabControl::~CGUITabControl()
 //! Adds a tab
 IGUITab* CGUITabControl::addTab(const wchar_t* caption, s32 id)
 {
+	invalidate();
 	IGUISkin* skin = Environment->getSkin();
 	if (!skin)
 		return 0;
@@ -265,6 +269,7 @@ IGUITab* CGUITabControl::addTab(const wchar_t* caption, s32 id)
 //! adds a tab which has been created elsewhere
 void CGUITabControl::addTab(CGUITab* tab)
 {
+	invalidate();
 	if (!tab)
 		return;
 
@@ -720,6 +725,7 @@ void CGUITabControl::draw()
 //! Set the height of the tabs
 void CGUITabControl::setTabHeight( s32 height )
 {
+	invalidate();
 	if ( height < 0 )
 		height = 0;
 
@@ -739,6 +745,7 @@ s32 CGUITabControl::getTabHeight() const
 //! set the maximal width of a tab. Per default width is 0 which means "no width restriction".
 void CGUITabControl::setTabMaxWidth(s32 width )
 {
+	invalidate();
 	TabMaxWidth = width;
 }
 
@@ -752,6 +759,7 @@ s32 CGUITabControl::getTabMaxWidth() const
 //! Set the extra width added to tabs on each side of the text
 void CGUITabControl::setTabExtraWidth( s32 extraWidth )
 {
+	invalidate();
 	if ( extraWidth < 0 )
 		extraWidth = 0;
 
@@ -794,6 +802,7 @@ void CGUITabControl::recalculateScrollBar()
 //! Set the alignment of the tabs
 void CGUITabControl::setTabVerticalAlignment( EGUI_ALIGNMENT alignment )
 {
+	invalidate();
 	VerticalAlignment = alignment;
 
 	recalculateScrollButtonPlacement();
@@ -858,6 +867,7 @@ s32 CGUITabControl::getActiveTab() const
 //! Brings a tab to front.
 bool CGUITabControl::setActiveTab(s32 idx)
 {
+	invalidate();
 	if ((u32)idx >= Tabs.size())
 		return false;
 
@@ -885,6 +895,7 @@ bool CGUITabControl::setActiveTab(s32 idx)
 
 bool CGUITabControl::setActiveTab(IGUIElement *tab)
 {
+	invalidate();
 	for (s32 i=0; i<(s32)Tabs.size(); ++i)
 		if (Tabs[i] == tab)
 			return setActiveTab(i);
@@ -26,7 +26,7 @@ namespace gui
 CGUITable::CGUITable(IGUIEnvironment* environment, IGUIElement* parent,
 						s32 id, const core::rect<s32>& rectangle, bool clip,
 						bool drawBack, bool moveOverSelect)
-: IGUITable(environment, parent, id, rectangle), Font(0),
+: IGUITable(environment, parent, id, rectangle), DataSource(0), Font(0),
 	VerticalScrollBar(0), HorizontalScrollBar(0),
 	Clip(clip), DrawBack(drawBack), MoveOverSelect(moveOverSelect),
 	Selecting(false), CurrentResizedColumn(-1), ResizeStart(0), ResizableColumns(true),
@@ -66,6 +66,9 @@ CGUITable::~CGUITable()
 	if ( HorizontalScrollBar )
 		HorizontalScrollBar->drop();
 
+	if (DataSource)
+		DataSource->drop();
+
 	if (Font)
 		Font->drop();
 }
@@ -73,6 +76,7 @@ CGUITable::~CGUITable()
 
 void CGUITable::addColumn(const wchar_t* caption, s32 columnIndex)
 {
+	invalidate();
 	Column tabHeader;
 	tabHeader.Name = caption;
 	tabHeader.Width = Font->getDimension(caption).Width + (CellWidthPadding * 2) + ARROW_PAD;
@@ -107,6 +111,7 @@ void CGUITable::addColumn(const wchar_t* caption, s32 columnIndex)
 //! remove a column from the table
 void CGUITable::removeColumn(u32 columnIndex)
 {
+	invalidate();
 	if ( columnIndex < Columns.size() )
 	{
 		Columns.erase(columnIndex);
@@ -130,12 +135,16 @@ s32 CGUITable::getColumnCount() const
 
 s32 CGUITable::getRowCount() const
 {
+	if (DataSource)
+		return DataSource->getRowCount();
+
 	return Rows.size();
 }
 
 
 bool CGUITable::setActiveColumn(s32 idx, bool doOrder )
 {
+	invalidate();
 	if (idx < 0 || idx >= (s32)Columns.size())
 		return false;
 
@@ -213,6 +222,7 @@ EGUI_ORDERING_MODE CGUITable::getActiveColumnOrdering() const
 
 void CGUITable::setColumnWidth(u32 columnIndex, u32 width)
 {
+	invalidate();
 	if ( columnIndex < Columns.size() )
 	{
 		const u32 MIN_WIDTH = Font->getDimension(Columns[columnIndex].Name.c_str() ).Width + (CellWidthPadding * 2);
@@ -244,6 +254,7 @@ bool CGUITable::hasResizableColumns() const
 
 u32 CGUITable::addRow(u32 rowIndex)
 {
+	invalidate();
 	if ( rowIndex > Rows.size() )
 	{
 		rowIndex = Rows.size();
@@ -269,6 +280,7 @@ u32 CGUITable::addRow(u32 rowIndex)
 
 void CGUITable::removeRow(u32 rowIndex)
 {
+	invalidate();
 	if ( rowIndex > Rows.size() )
 		return;
 
@@ -284,6 +296,7 @@ void CGUITable::removeRow(u32 rowIndex)
 //! adds an list item, returns id of item
 void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw& text)
 {
+	invalidate();
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		Rows[rowIndex].Items[columnIndex].Text = text;
@@ -297,6 +310,7 @@ void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw&
 
 void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw& text, video::SColor color)
 {
+	invalidate();
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		Rows[rowIndex].Items[columnIndex].Text = text;
@@ -309,6 +323,7 @@ void CGUITable::setCellText(u32 rowIndex, u32 columnIndex, const core::stringw&
 
 void CGUITable::setCellColor(u32 rowIndex, u32 columnIndex, video::SColor color)
 {
+	invalidate();
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		Rows[rowIndex].Items[columnIndex].Color = color;
@@ -319,6 +334,7 @@ void CGUITable::setCellColor(u32 rowIndex, u32 columnIndex, video::SColor color)
 
 void CGUITable::setCellData(u32 rowIndex, u32 columnIndex, void *data)
 {
+	invalidate();
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		Rows[rowIndex].Items[columnIndex].Data = data;
@@ -328,6 +344,13 @@ void CGUITable::setCellData(u32 rowIndex, u32 columnIndex, void *data)
 
 const wchar_t* CGUITable::getCellText(u32 rowIndex, u32 columnIndex ) const
 {
+	if (DataSource)
+	{
+		if ( rowIndex < DataSource->getRowCount() && columnIndex < Columns.size() )
+			return DataSource->getCellText(rowIndex, columnIndex);
+		return 0;
+	}
+
 	if ( rowIndex < Rows.size() && columnIndex < Columns.size() )
 	{
 		return Rows[rowIndex].Items[columnIndex].Text.c_str();
@@ -351,6 +374,7 @@ void* CGUITable::getCellData(u32 rowIndex, u32 columnIndex ) const
 //! clears the list
 void CGUITable::clear()
 {
+	invalidate();
     Selected = -1;
 	Rows.clear();
 	Columns.clear();
@@ -367,6 +391,7 @@ void CGUITable::clear()
 
 void CGUITable::clearRows()
 {
+	invalidate();
     Selected = -1;
 	Rows.clear();
 
@@ -387,8 +412,9 @@ s32 CGUITable::getSelected() const
 //! set wich row is currently selected
 void CGUITable::setSelected( s32 index )
 {
+	invalidate();
 	Selected = -1;
-	if ( index >= 0 && index < (s32) Rows.size() )
+	if ( index >= 0 && index < getRowCount() )
 		Selected = index;
 }
 
@@ -423,7 +449,7 @@ void CGUITable::recalculateHeights()
 			Font->grab();
 		}
 	}
-	TotalItemHeight = ItemHeight * Rows.size();		//  header is not counted, because we only want items
+	TotalItemHeight = ItemHeight * getRowCount();		//  header is not counted, because we only want items
 	checkScrollbars();
 }
 
@@ -666,6 +692,7 @@ bool CGUITable::OnEvent(const SEvent &event)
 
 void CGUITable::setColumnOrdering(u32 columnIndex, EGUI_COLUMN_ORDERING mode)
 {
+	invalidate();
 	if ( columnIndex < Columns.size() )
 		Columns[columnIndex].OrderingMode = mode;
 }
@@ -673,6 +700,7 @@ void CGUITable::setColumnOrdering(u32 columnIndex, EGUI_COLUMN_ORDERING mode)
 
 void CGUITable::swapRows(u32 rowIndexA, u32 rowIndexB)
 {
+	invalidate();
 	if ( rowIndexA >= Rows.size() )
 		return;
 
@@ -772,55 +800,89 @@ bool CGUITable::selectColumnHeader(s32 xpos, s32 ypos)
 }
 
 
-void CGUITable::orderRows(s32 columnIndex, EGUI_ORDERING_MODE mode)
+//! stable merge sort of row indices by the text of a column
+void CGUITable::sortRowIndices(core::array<u32>& indices, u32 columnIndex, bool descending) const
 {
-	Row swap;
+	const u32 count = indices.size();
+	core::array<u32> temp;
+	temp.set_used(count);
 
-	if ( columnIndex == -1 )
-		columnIndex = getActiveColumn();
-	if ( columnIndex < 0 )
-		return;
+	u32* source = indices.pointer();
+	u32* dest = temp.pointer();
 
-	if ( mode == EGOM_ASCENDING )
+	for (u32 width = 1; width < count; width *= 2)
 	{
-		for ( s32 i = 0 ; i < s32(Rows.size()) - 1 ; ++i )
+		for (u32 start = 0; start < count; start += 2*width)
 		{
-			for ( s32 j = 0 ; j < s32(Rows.size()) - i - 1 ; ++j )
+			const u32 middle = core::min_(start + width, count);
+			const u32 end = core::min_(start + 2*width, count);
+			u32 left = start;
+			u32 right = middle;
+			u32 out = start;
+
+			while (left < middle && right < end)
 			{
-				if ( Rows[j+1].Items[columnIndex].Text < Rows[j].Items[columnIndex].Text )
-				{
-					swap = Rows[j];
-					Rows[j] = Rows[j+1];
-					Rows[j+1] = swap;
-
-					if ( Selected == j )
-						Selected = j+1;
-					else if( Selected == j+1 )
-						Selected = j;
-				}
+				const core::stringw& a = Rows[source[left]].Items[columnIndex].Text;
+				const core::stringw& b = Rows[source[right]].Items[columnIndex].Text;
+
+				// only take from the right side if it is strictly before, to keep the sort stable
+				if (descending ? a < b : b < a)
+					dest[out++] = source[right++];
+				else
+					dest[out++] = source[left++];
 			}
+			while (left < middle)
+				dest[out++] = source[left++];
+			while (right < end)
+				dest[out++] = source[right++];
 		}
+		core::swap(source, dest);
 	}
-	else if ( mode == EGOM_DESCENDING )
+
+	if (source != indices.pointer())
+		memcpy(indices.pointer(), source, count*sizeof(u32));
+}
+
+
+void CGUITable::orderRows(s32 columnIndex, EGUI_ORDERING_MODE mode)
+{
+	invalidate();
+	if ( columnIndex == -1 )
+		columnIndex = getActiveColumn();
+	if ( columnIndex < 0 || columnIndex >= (s32)Columns.size() )
+		return;
+
+	if ( mode != EGOM_ASCENDING && mode != EGOM_DESCENDING )
+		return;
+
+	if (DataSource)
 	{
-		for ( s32 i = 0 ; i < s32(Rows.size()) - 1 ; ++i )
-		{
-			for ( s32 j = 0 ; j < s32(Rows.size()) - i - 1 ; ++j )
-			{
-				if ( Rows[j].Items[columnIndex].Text < Rows[j+1].Items[columnIndex].Text)
-				{
-					swap = Rows[j];
-					Rows[j] = Rows[j+1];
-					Rows[j+1] = swap;
-
-					if ( Selected == j )
-						Selected = j+1;
-					else if( Selected == j+1 )
-						Selected = j;
-				}
-			}
-		}
+		DataSource->orderRows(columnIndex, mode);
+		return;
 	}
+
+	// sort indices instead of the rows, so each row is only moved once
+	core::array<u32> indices;
+	indices.set_used(Rows.size());
+	for ( u32 i = 0 ; i < Rows.size() ; ++i )
+		indices[i] = i;
+
+	sortRowIndices(indices, columnIndex, mode == EGOM_DESCENDING);
+
+	// swapping the cell arrays moves the rows without copying the cells
+	core::array< Row > sorted;
+	sorted.reallocate(Rows.size());
+	s32 newSelected = -1;
+	for ( u32 i = 0 ; i < indices.size() ; ++i )
+	{
+		sorted.push_back(Row());
+		sorted[i].Items.swap(Rows[indices[i]].Items);
+		if ( (s32)indices[i] == Selected )
+			newSelected = i;
+	}
+
+	Rows.swap(sorted);
+	Selected = newSelected;
 }
 
 
@@ -839,8 +901,8 @@ void CGUITable::selectNew(s32 ypos, bool onlyHover)
 	if (ItemHeight!=0)
 		Selected = ((ypos - AbsoluteRect.UpperLeftCorner.Y - ItemHeight - 1) + VerticalScrollBar->getPos()) / ItemHeight;
 
-	if (Selected >= (s32)Rows.size())
-		Selected = Rows.size() - 1;
+	if (Selected >= getRowCount())
+		Selected = getRowCount() - 1;
 	else if (Selected<0)
 		Selected = 0;
 
@@ -873,6 +935,10 @@ void CGUITable::draw()
 	if (!font)
 		return;
 
+	// rows of a data source can be added or removed at any time
+	if ( DataSource && TotalItemHeight != ItemHeight * getRowCount() )
+		recalculateHeights();
+
 	// CAREFUL: near identical calculations for tableRect and clientClip are also done in checkScrollbars and selectColumnHeader
 	// Area of table used for drawing without scrollbars
 	core::rect<s32> tableRect(AbsoluteRect);
@@ -909,12 +975,27 @@ void CGUITable::draw()
 		scrolledTableClient.LowerRightCorner.X -= HorizontalScrollBar->getPos();
 	}
 
+	// only the rows overlapping the element are drawn
+	const s32 rowCount = getRowCount();
+	s32 firstRow = 0;
+	s32 lastRow = rowCount;
+	if ( ItemHeight > 0 )
+	{
+		firstRow = core::clamp((AbsoluteRect.UpperLeftCorner.Y - scrolledTableClient.UpperLeftCorner.Y) / ItemHeight - 1, 0, rowCount);
+		lastRow = core::clamp((AbsoluteRect.LowerRightCorner.Y - scrolledTableClient.UpperLeftCorner.Y) / ItemHeight + 1, firstRow, rowCount);
+	}
+
+	if ( DataSource && lastRow > firstRow )
+		DataSource->prepareRows(firstRow, lastRow - firstRow);
+
 	// rowRect is around the scrolled row
 	core::rect<s32> rowRect(scrolledTableClient);
+	rowRect.UpperLeftCorner.Y += firstRow * ItemHeight;
 	rowRect.LowerRightCorner.Y = rowRect.UpperLeftCorner.Y + ItemHeight;
 
 	u32 pos;
-	for ( u32 i = 0 ; i < Rows.size() ; ++i )
+	core::stringw brokenText;
+	for ( s32 i = firstRow ; i < lastRow ; ++i )
 	{
 		if (rowRect.LowerRightCorner.Y >= AbsoluteRect.UpperLeftCorner.Y &&
 			rowRect.UpperLeftCorner.Y <= AbsoluteRect.LowerRightCorner.Y)
@@ -931,7 +1012,7 @@ void CGUITable::draw()
 			pos = rowRect.UpperLeftCorner.X;
 
 			// draw selected row background highlighted
-			if ((s32)i == Selected && DrawFlags & EGTDF_ACTIVE_ROW )
+			if (i == Selected && DrawFlags & EGTDF_ACTIVE_ROW )
 				driver->draw2DRectangle(skin->getColor(EGDC_HIGH_LIGHT), rowRect, &clientClip);
 
 			for ( u32 j = 0 ; j < Columns.size() ; ++j )
@@ -939,8 +1020,24 @@ void CGUITable::draw()
 				textRect.UpperLeftCorner.X = pos + CellWidthPadding;
 				textRect.LowerRightCorner.X = pos + Columns[j].Width - CellWidthPadding;
 
+				if ( DataSource )
+				{
+					// cells of a data source are only broken when they are visible
+					const wchar_t* text = DataSource->getCellText(i, j);
+					breakText( text ? core::stringw(text) : core::stringw(), brokenText, Columns[j].Width );
+
+					video::SColor color = skin->getColor(EGDC_BUTTON_TEXT);
+					if ( i == Selected )
+						color = skin->getColor(IsEnabled ? EGDC_HIGH_LIGHT_TEXT : EGDC_GRAY_TEXT);
+					else if ( !IsEnabled )
+						color = skin->getColor(EGDC_GRAY_TEXT);
+					else
+						DataSource->getCellColor(i, j, color);
+
+					font->draw(brokenText.c_str(), textRect, color, false, true, &clientClip);
+				}
 				// draw item text
-				if ((s32)i == Selected)
+				else if (i == Selected)
 				{
 					font->draw(Rows[i].Items[j].BrokenText.c_str(), textRect, skin->getColor(IsEnabled ? EGDC_HIGH_LIGHT_TEXT : EGDC_GRAY_TEXT), false, true, &clientClip);
 				}
@@ -1069,6 +1166,7 @@ void CGUITable::breakText(const core::stringw& text, core::stringw& brokenText,
 //! Set some flags influencing the layout of the table
 void CGUITable::setDrawFlags(s32 flags)
 {
+	invalidate();
 	DrawFlags = flags;
 }
 
@@ -1080,6 +1178,35 @@ s32 CGUITable::getDrawFlags() const
 }
 
 
+//! Sets a data source which supplies the rows instead of the table.
+void CGUITable::setDataSource(IGUITableDataSource* source)
+{
+	invalidate();
+	if (source == DataSource)
+		return;
+
+	if (source)
+		source->grab();
+	if (DataSource)
+		DataSource->drop();
+
+	DataSource = source;
+	Selected = -1;
+
+	if (VerticalScrollBar)
+		VerticalScrollBar->setPos(0);
+
+	recalculateHeights();
+}
+
+
+//! Returns the data source set with setDataSource(), or 0.
+IGUITableDataSource* CGUITable::getDataSource() const
+{
+	return DataSource;
+}
+
+
 //! Writes attributes of the element.
 void CGUITable::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
 {
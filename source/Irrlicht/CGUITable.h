@@ -140,6 +140,12 @@ namespace gui
 		//! Get the flags, as defined in EGUI_TABLE_DRAW_FLAGS, which influence the layout
 		virtual s32 getDrawFlags() const;
 
+		//! Sets a data source which supplies the rows instead of the table.
+		virtual void setDataSource(IGUITableDataSource* source);
+
+		//! Returns the data source set with setDataSource(), or 0.
+		virtual IGUITableDataSource* getDataSource() const;
+
 		//! Writes attributes of the object.
 		//! Implement this to expose the attributes of your scene node animator for
 		//! scripting languages, editors, debuggers or xml serialization purposes.
@@ -188,8 +194,12 @@ namespace gui
 		void recalculateHeights();
 		void recalculateWidths();
 
+		//! stable merge sort of row indices by the text of a column
+		void sortRowIndices(core::array<u32>& indices, u32 columnIndex, bool descending) const;
+
 		core::array< Column > Columns;
 		core::array< Row > Rows;
+		IGUITableDataSource* DataSource;
 		gui::IGUIFont* Font;
 		gui::IGUIScrollBar* VerticalScrollBar;
 		gui::IGUIScrollBar* HorizontalScrollBar;
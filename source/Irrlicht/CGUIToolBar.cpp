@@ -119,6 +119,7 @@ IGUIButton* CGUIToolBar::addButton(s32 id, const wchar_t* text,const wchar_t* to
 	video::ITexture* img, video::ITexture* pressed, bool isPushButton,
 	bool useAlphaChannel)
 {
+	invalidate();
 	ButtonX += 3;
 
 	core::rect<s32> rectangle(ButtonX,2,ButtonX+1,3);
@@ -54,16 +54,19 @@ IGUITreeViewNode* CGUITreeViewNode::getParent() const
 
 void CGUITreeViewNode::setText( const wchar_t* text )
 {
+	Owner->invalidate();
 	Text = text;
 }
 
 void CGUITreeViewNode::setIcon( const wchar_t* icon )
 {
+	Owner->invalidate();
 	Icon = icon;
 }
 
 void CGUITreeViewNode::clearChilds()
 {
+	Owner->invalidate();
 	core::list<CGUITreeViewNode*>::Iterator	it;
 
 	for( it = Childs.begin(); it != Childs.end(); it++ )
@@ -81,6 +84,7 @@ IGUITreeViewNode* CGUITreeViewNode::addChildBack(
 	void*					data /*= 0*/,
 	IReferenceCounted*			data2 /*= 0*/ )
 {
+	Owner->invalidate();
 	CGUITreeViewNode*	newChild = new CGUITreeViewNode( Owner, this );
 
 	Childs.push_back( newChild );
@@ -105,6 +109,7 @@ IGUITreeViewNode* CGUITreeViewNode::addChildFront(
 	void*					data /*= 0*/,
 	IReferenceCounted*			data2 /*= 0*/ )
 {
+	Owner->invalidate();
 	CGUITreeViewNode*	newChild = new CGUITreeViewNode( Owner, this );
 
 	Childs.push_front( newChild );
@@ -130,6 +135,7 @@ IGUITreeViewNode* CGUITreeViewNode::insertChildAfter(
 	void*					data /*= 0*/,
 	IReferenceCounted*			data2/* = 0*/ )
 {
+	Owner->invalidate();
 	core::list<CGUITreeViewNode*>::Iterator	itOther;
 	CGUITreeViewNode*									newChild = 0;
 
@@ -164,6 +170,7 @@ IGUITreeViewNode* CGUITreeViewNode::insertChildBefore(
 	void*					data /*= 0*/,
 	IReferenceCounted*			data2/* = 0*/ )
 {
+	Owner->invalidate();
 	core::list<CGUITreeViewNode*>::Iterator	itOther;
 	CGUITreeViewNode*									newChild = 0;
 
@@ -306,6 +313,7 @@ bool CGUITreeViewNode::deleteChild( IGUITreeViewNode* child )
 
 bool CGUITreeViewNode::moveChildUp( IGUITreeViewNode* child )
 {
+	Owner->invalidate();
 	core::list<CGUITreeViewNode*>::Iterator	itChild;
 	core::list<CGUITreeViewNode*>::Iterator	itOther;
 	CGUITreeViewNode*									nodeTmp;
@@ -331,6 +339,7 @@ bool CGUITreeViewNode::moveChildUp( IGUITreeViewNode* child )
 
 bool CGUITreeViewNode::moveChildDown( IGUITreeViewNode* child )
 {
+	Owner->invalidate();
 	core::list<CGUITreeViewNode*>::Iterator	itChild;
 	core::list<CGUITreeViewNode*>::Iterator	itOther;
 	CGUITreeViewNode*									nodeTmp;
@@ -357,11 +366,13 @@ bool CGUITreeViewNode::moveChildDown( IGUITreeViewNode* child )
 
 void CGUITreeViewNode::setExpanded( bool expanded )
 {
+	Owner->invalidate();
 	Expanded = expanded;
 }
 
 void CGUITreeViewNode::setSelected( bool selected )
 {
+	Owner->invalidate();
 	if( Owner )
 	{
 		if( selected )
@@ -1053,6 +1064,7 @@ void CGUITreeView::draw()
 //! Irrlicht engine as icon font, the icon strings defined in GUIIcons.h can be used.
 void CGUITreeView::setIconFont( IGUIFont* font )
 {
+	invalidate();
 	s32	height;
 
     if ( font )
@@ -1077,6 +1089,7 @@ void CGUITreeView::setIconFont( IGUIFont* font )
 //! The default is 0 (no images).
 void CGUITreeView::setImageList( IGUIImageList* imageList )
 {
+	invalidate();
     if (imageList )
         imageList->grab();
 	if( ImageList )
@@ -55,7 +55,7 @@ namespace gui
 		
 		//! sets the image index of the node
 		virtual void setImageIndex( u32 imageIndex )
-		{ ImageIndex = imageIndex; }
+		{ ImageIndex = imageIndex; getOwner()->invalidate(); }
 		
 		//! returns the image index of the node		
 		virtual u32 getSelectedImageIndex() const
@@ -63,7 +63,7 @@ namespace gui
 		
 		//! sets the image index of the node
 		virtual void setSelectedImageIndex( u32 imageIndex )
-		{ SelectedImageIndex = imageIndex; }
+		{ SelectedImageIndex = imageIndex; getOwner()->invalidate(); }
 		
 		//! returns the user data (void*) of this node
 		virtual void* getData() const
@@ -263,7 +263,7 @@ namespace gui
 
 		//! sets if the tree lines are visible
 		virtual void setLinesVisible( bool visible )
-		{ LinesVisible = visible; }
+		{ LinesVisible = visible; invalidate(); }
 
 		//! called if an event happened.
 		virtual bool OnEvent( const SEvent &event );
@@ -287,7 +287,7 @@ namespace gui
 		
 		//! Sets if the image is left of the icon. Default is true.
 		virtual void setImageLeftOfIcon( bool bLeftOf )
-		{ ImageLeftOfIcon = bLeftOf; }
+		{ ImageLeftOfIcon = bLeftOf; invalidate(); }
 		
 		//! Returns if the Image is left of the icon. Default is true.
 		virtual bool getImageLeftOfIcon() const
@@ -5,7 +5,10 @@
 #include "CImage.h"
 #include "irrString.h"
 #include "CColorConverter.h"
+#include "CImageResampler.h"
 #include "CBlit.h"
+#include "CBlockCompression.h"
+#include "os.h"
 
 namespace irr
 {
@@ -35,7 +38,7 @@ CImage::CImage(ECOLOR_FORMAT format, const core::dimension2d<u32>& size, void* d
 	{
 		Data = 0;
 		initData();
-		memcpy(Data, data, Size.Height * Pitch);
+		memcpy(Data, data, getImageDataSizeInBytes());
 	}
 }
 
@@ -49,12 +52,16 @@ void CImage::initData()
 	BytesPerPixel = getBitsPerPixelFromFormat(Format) / 8;
 
 	// Pitch should be aligned...
-	Pitch = BytesPerPixel * Size.Width;
+	// compressed images use the size of one row of blocks
+	if (isCompressedFormat(Format))
+		Pitch = getDataSizeFromFormat(Format, Size.Width, 1);
+	else
+		Pitch = BytesPerPixel * Size.Width;
 
 	if (!Data)
 	{
 		DeleteMemory=true;
-		Data = new u8[Size.Height * Pitch];
+		Data = new u8[getImageDataSizeInBytes()];
 	}
 }
 
@@ -91,7 +98,7 @@ u32 CImage::getBytesPerPixel() const
 //! Returns image data size in bytes
 u32 CImage::getImageDataSizeInBytes() const
 {
-	return Pitch * Size.Height;
+	return getDataSizeFromFormat(Format, Size.Width, Size.Height);
 }
 
 
@@ -211,6 +218,15 @@ void CImage::setPixel(u32 x, u32 y, const SColor &color, bool blend)
 			u32 * dest = (u32*) (Data + ( y * Pitch ) + ( x << 2 ));
 			*dest = blend ? PixelBlend32 ( *dest, color.color ) : color.color;
 		} break;
+
+		case ECF_DXT1:
+		case ECF_DXT3:
+		case ECF_DXT5:
+		// compressed images are read only
+		break;
+
+		default:
+		break;
 	}
 }
 
@@ -234,6 +250,17 @@ SColor CImage::getPixel(u32 x, u32 y) const
 			u8* p = Data+(y*3)*Size.Width + (x*3);
 			return SColor(255,p[0],p[1],p[2]);
 		}
+	case ECF_DXT1:
+	case ECF_DXT3:
+	case ECF_DXT5:
+		{
+			u32 pixels[16];
+			CBlockCompression::decodeBlock(Format,
+					Data + (y>>2)*Pitch + (x>>2)*CBlockCompression::getBlockSize(Format), pixels);
+			return pixels[(y&3)*4 + (x&3)];
+		}
+	default:
+		break;
 	}
 
 	return SColor(0);
@@ -250,6 +277,13 @@ ECOLOR_FORMAT CImage::getColorFormat() const
 //! copies this surface into another at given position
 void CImage::copyTo(IImage* target, const core::position2d<s32>& pos)
 {
+	if (isCompressedFormat(Format))
+	{
+		CImage* decompressed = createDecompressed();
+		decompressed->copyTo(target, pos);
+		decompressed->drop();
+		return;
+	}
 	Blit(BLITTER_TEXTURE, target, 0, &pos, this, 0, 0);
 }
 
@@ -257,6 +291,13 @@ void CImage::copyTo(IImage* target, const core::position2d<s32>& pos)
 //! copies this surface partially into another at given position
 void CImage::copyTo(IImage* target, const core::position2d<s32>& pos, const core::rect<s32>& sourceRect, const core::rect<s32>* clipRect)
 {
+	if (isCompressedFormat(Format))
+	{
+		CImage* decompressed = createDecompressed();
+		decompressed->copyTo(target, pos, sourceRect, clipRect);
+		decompressed->drop();
+		return;
+	}
 	Blit(BLITTER_TEXTURE, target, clipRect, &pos, this, &sourceRect, 0);
 }
 
@@ -264,6 +305,14 @@ void CImage::copyTo(IImage* target, const core::position2d<s32>& pos, const core
 //! copies this surface into another, using the alpha mask, a cliprect and a color to add with
 void CImage::copyToWithAlpha(IImage* target, const core::position2d<s32>& pos, const core::rect<s32>& sourceRect, const SColor &color, const core::rect<s32>* clipRect)
 {
+	if (isCompressedFormat(Format))
+	{
+		CImage* decompressed = createDecompressed();
+		decompressed->copyToWithAlpha(target, pos, sourceRect, color, clipRect);
+		decompressed->drop();
+		return;
+	}
+
 	// color blend only necessary on not full spectrum aka. color.color != 0xFFFFFFFF
 	Blit(color.color == 0xFFFFFFFF ? BLITTER_TEXTURE_ALPHA_BLEND: BLITTER_TEXTURE_ALPHA_COLOR_BLEND,
 			target, clipRect, &pos, this, &sourceRect, color.color);
@@ -271,12 +320,24 @@ void CImage::copyToWithAlpha(IImage* target, const core::position2d<s32>& pos, c
 
 
 //! copies this surface into another, scaling it to the target image size
-// note: this is very very slow.
 void CImage::copyToScaling(void* target, u32 width, u32 height, ECOLOR_FORMAT format, u32 pitch)
 {
 	if (!target || !width || !height)
 		return;
 
+	if (isCompressedFormat(Format))
+	{
+		if (Format==format && Size.Width==width && Size.Height==height)
+		{
+			memcpy(target, Data, getImageDataSizeInBytes());
+			return;
+		}
+		CImage* decompressed = createDecompressed();
+		decompressed->copyToScaling(target, width, height, format, pitch);
+		decompressed->drop();
+		return;
+	}
+
 	const u32 bpp=getBitsPerPixelFromFormat(format)/8;
 	if (0==pitch)
 		pitch = width*bpp;
@@ -307,27 +368,12 @@ void CImage::copyToScaling(void* target, u32 width, u32 height, ECOLOR_FORMAT fo
 		}
 	}
 
-	const f32 sourceXStep = (f32)Size.Width / (f32)width;
-	const f32 sourceYStep = (f32)Size.Height / (f32)height;
-	s32 yval=0, syval=0;
-	f32 sy = 0.0f;
-	for (u32 y=0; y<height; ++y)
-	{
-		f32 sx = 0.0f;
-		for (u32 x=0; x<width; ++x)
-		{
-			CColorConverter::convert_viaFormat(Data+ syval + ((s32)sx)*BytesPerPixel, Format, 1, ((u8*)target)+ yval + (x*bpp), format);
-			sx+=sourceXStep;
-		}
-		sy+=sourceYStep;
-		syval=((s32)sy)*Pitch;
-		yval+=pitch;
-	}
+	CImageResampler::resample(Data, Format, Size, Pitch, target, format,
+			core::dimension2d<u32>(width, height), pitch, ERF_POINT);
 }
 
 
 //! copies this surface into another, scaling it to the target image size
-// note: this is very very slow.
 void CImage::copyToScaling(IImage* target)
 {
 	if (!target)
@@ -349,32 +395,14 @@ void CImage::copyToScaling(IImage* target)
 //! copies this surface into another, scaling it to fit it.
 void CImage::copyToScalingBoxFilter(IImage* target, s32 bias, bool blend)
 {
-	const core::dimension2d<u32> destSize = target->getDimension();
-
-	const f32 sourceXStep = (f32) Size.Width / (f32) destSize.Width;
-	const f32 sourceYStep = (f32) Size.Height / (f32) destSize.Height;
-
-	target->lock();
-
-	s32 fx = core::ceil32( sourceXStep );
-	s32 fy = core::ceil32( sourceYStep );
-	f32 sx;
-	f32 sy;
-
-	sy = 0.f;
-	for ( u32 y = 0; y != destSize.Height; ++y )
+	if (isCompressedFormat(Format))
 	{
-		sx = 0.f;
-		for ( u32 x = 0; x != destSize.Width; ++x )
-		{
-			target->setPixel( x, y,
-				getPixelBox( core::floor32(sx), core::floor32(sy), fx, fy, bias ), blend );
-			sx += sourceXStep;
-		}
-		sy += sourceYStep;
+		CImage* decompressed = createDecompressed();
+		decompressed->copyToScalingBoxFilter(target, bias, blend);
+		decompressed->drop();
+		return;
 	}
-
-	target->unlock();
+	CImageResampler::resample(this, target, ERF_BOX, bias, blend);
 }
 
 
@@ -408,6 +436,11 @@ void CImage::fill(const SColor &color)
 			return;
 		}
 		break;
+		case ECF_DXT1:
+		case ECF_DXT3:
+		case ECF_DXT5:
+			os::Printer::log("Can not fill a compressed image", ELL_ERROR);
+			return;
 		default:
 		// TODO: Handle other formats
 			return;
@@ -416,37 +449,12 @@ void CImage::fill(const SColor &color)
 }
 
 
-//! get a filtered pixel
-inline SColor CImage::getPixelBox( s32 x, s32 y, s32 fx, s32 fy, s32 bias ) const
+//! decodes a compressed image into a new A8R8G8B8 image
+CImage* CImage::createDecompressed() const
 {
-	SColor c;
-	s32 a = 0, r = 0, g = 0, b = 0;
-
-	for ( s32 dx = 0; dx != fx; ++dx )
-	{
-		for ( s32 dy = 0; dy != fy; ++dy )
-		{
-			c = getPixel(	core::s32_min ( x + dx, Size.Width - 1 ) ,
-							core::s32_min ( y + dy, Size.Height - 1 )
-						);
-
-			a += c.getAlpha();
-			r += c.getRed();
-			g += c.getGreen();
-			b += c.getBlue();
-		}
-
-	}
-
-	s32 sdiv = s32_log2_s32(fx * fy);
-
-	a = core::s32_clamp( ( a >> sdiv ) + bias, 0, 255 );
-	r = core::s32_clamp( ( r >> sdiv ) + bias, 0, 255 );
-	g = core::s32_clamp( ( g >> sdiv ) + bias, 0, 255 );
-	b = core::s32_clamp( ( b >> sdiv ) + bias, 0, 255 );
-
-	c.set( a, r, g, b );
-	return c;
+	CImage* image = new CImage(ECF_A8R8G8B8, Size);
+	CBlockCompression::decompress(Data, Format, Size, image->Data, ECF_A8R8G8B8, image->Pitch);
+	return image;
 }
 
 
@@ -493,6 +501,11 @@ void CImage::drawLine(const core::position2d<s32>& from, const core::position2d<
 					RenderLine32_Blend( this, p[0], p[1], color.color, alpha );
 				}
 				break;
+			case ECF_DXT1:
+			case ECF_DXT3:
+			case ECF_DXT5:
+				os::Printer::log("Can not draw into a compressed image", ELL_ERROR);
+				break;
 			default:
 				break;
 		}
@@ -114,7 +114,8 @@ private:
 	//! assumes format and size has been set and creates the rest
 	void initData();
 
-	inline SColor getPixelBox ( s32 x, s32 y, s32 fx, s32 fy, s32 bias ) const;
+	//! decodes a compressed image into a new A8R8G8B8 image
+	CImage* createDecompressed() const;
 
 	u8* Data;
 	core::dimension2d<u32> Size;
@@ -0,0 +1,272 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CImageLoaderDDS.h"
+
+#ifdef _IRR_COMPILE_WITH_DDS_LOADER_
+
+#include "IReadFile.h"
+#include "CColorConverter.h"
+#include "CImage.h"
+#include "os.h"
+#include "irrArray.h"
+#include "irrString.h"
+#include "coreutil.h"
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+	const u32 DDS_MAGIC = 0x20534444; // "DDS "
+
+	const u32 DDSD_PITCH = 0x8;
+
+	const u32 DDPF_ALPHAPIXELS = 0x1;
+	const u32 DDPF_FOURCC = 0x4;
+	const u32 DDPF_RGB = 0x40;
+
+	const u32 FOURCC_DXT1 = 0x31545844;
+	const u32 FOURCC_DXT3 = 0x33545844;
+	const u32 FOURCC_DXT5 = 0x35545844;
+
+	//! multiplies two sizes, returns false if the product does not fit into a u32
+	inline bool multiplySize(u32& result, u32 a, u32 b)
+	{
+		if (a && b > 0xFFFFFFFF / a)
+			return false;
+		result = a * b;
+		return true;
+	}
+}
+
+
+//! returns true if the file maybe is able to be loaded by this class
+//! based on the file extension (e.g. ".tga")
+bool CImageLoaderDDS::isALoadableFileExtension(const io::path& filename) const
+{
+	return core::hasFileExtension ( filename, "dds" );
+}
+
+
+//! returns true if the file maybe is able to be loaded by this class
+bool CImageLoaderDDS::isALoadableFileFormat(io::IReadFile* file) const
+{
+	if (!file)
+		return false;
+
+	u32 magic = 0;
+	file->read(&magic, sizeof(magic));
+#ifdef __BIG_ENDIAN__
+	magic = os::Byteswap::byteswap(magic);
+#endif
+	return magic == DDS_MAGIC;
+}
+
+
+//! creates a surface from the file
+IImage* CImageLoaderDDS::loadImage(io::IReadFile* file) const
+{
+	SDDSHeader header;
+	if (file->read(&header, sizeof(header)) != sizeof(header))
+		return 0;
+
+#ifdef __BIG_ENDIAN__
+	u32* field = (u32*)&header;
+	for (u32 i=0; i<sizeof(header)/sizeof(u32); ++i)
+		field[i] = os::Byteswap::byteswap(field[i]);
+#endif
+
+	if (header.Magic != DDS_MAGIC || header.Size != 124 || header.PixelFormat.Size != 32)
+	{
+		os::Printer::log("DDS file has an invalid header", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	const core::dimension2d<u32> size(header.Width, header.Height);
+	if (!size.Width || !size.Height)
+		return 0;
+
+	const SDDSPixelFormat& pf = header.PixelFormat;
+	const long available = file->getSize() - file->getPos();
+
+	// block compressed images are kept compressed
+	if (pf.Flags & DDPF_FOURCC)
+	{
+		ECOLOR_FORMAT format;
+		switch (pf.FourCC)
+		{
+		case FOURCC_DXT1:
+			format = ECF_DXT1;
+			break;
+		case FOURCC_DXT3:
+			format = ECF_DXT3;
+			break;
+		case FOURCC_DXT5:
+			format = ECF_DXT5;
+			break;
+		default:
+			os::Printer::log("Unsupported DDS compression", file->getFileName(), ELL_ERROR);
+			return 0;
+		}
+
+		// the header sizes are not trusted to fit the size computations of the image
+		const u32 blockSize = (format == ECF_DXT1) ? 8 : 16;
+		u32 rowSize, dataSize;
+		if (!multiplySize(rowSize, (size.Width+3)/4, blockSize) ||
+			!multiplySize(dataSize, rowSize, (size.Height+3)/4))
+		{
+			os::Printer::log("DDS file is too large", file->getFileName(), ELL_ERROR);
+			return 0;
+		}
+
+		if ((unsigned long)available < dataSize)
+		{
+			os::Printer::log("DDS file is truncated", file->getFileName(), ELL_ERROR);
+			return 0;
+		}
+
+		IImage* image = new CImage(format, size);
+		file->read(image->lock(), dataSize);
+		image->unlock();
+		return image;
+	}
+
+	const u32 bpp = pf.RGBBitCount / 8;
+	if (!(pf.Flags & DDPF_RGB) || bpp < 2 || bpp > 4)
+	{
+		os::Printer::log("Unsupported DDS pixel format", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	const bool alpha = (pf.Flags & DDPF_ALPHAPIXELS) && pf.ABitMask;
+	ECOLOR_FORMAT format = ECF_UNKNOWN;
+	bool swapRedBlue = false;
+
+	switch (bpp)
+	{
+	case 2:
+		if (pf.RBitMask == 0xF800 && pf.GBitMask == 0x07E0 && pf.BBitMask == 0x001F)
+			format = ECF_R5G6B5;
+		else if (pf.RBitMask == 0x7C00 && pf.GBitMask == 0x03E0 && pf.BBitMask == 0x001F)
+			format = ECF_A1R5G5B5;
+		break;
+	case 3:
+		if (pf.RBitMask == 0xFF0000 && pf.GBitMask == 0xFF00 && pf.BBitMask == 0xFF)
+			format = ECF_A8R8G8B8;
+		break;
+	case 4:
+		if (pf.GBitMask == 0xFF00)
+		{
+			if (pf.RBitMask == 0xFF0000 && pf.BBitMask == 0xFF)
+				format = ECF_A8R8G8B8;
+			else if (pf.RBitMask == 0xFF && pf.BBitMask == 0xFF0000)
+			{
+				format = ECF_A8R8G8B8;
+				swapRedBlue = true;
+			}
+		}
+		break;
+	}
+
+	if (format == ECF_UNKNOWN)
+	{
+		os::Printer::log("Unsupported DDS color masks", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	// the file rows, the image and the size of the file data must fit into a u32
+	u32 rowSize, imageSize, fileSize;
+	if (!multiplySize(rowSize, size.Width, bpp) ||
+		!multiplySize(imageSize, size.Width, IImage::getBitsPerPixelFromFormat(format) / 8) ||
+		!multiplySize(imageSize, imageSize, size.Height))
+	{
+		os::Printer::log("DDS file is too large", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	u32 pitch = rowSize;
+	if ((header.Flags & DDSD_PITCH) && header.PitchOrLinearSize > pitch)
+		pitch = header.PitchOrLinearSize;
+
+	if (!multiplySize(fileSize, pitch, size.Height - 1) || fileSize > 0xFFFFFFFF - rowSize)
+	{
+		os::Printer::log("DDS file is too large", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+	fileSize += rowSize;
+
+	if ((unsigned long)available < fileSize)
+	{
+		os::Printer::log("DDS file is truncated", file->getFileName(), ELL_ERROR);
+		return 0;
+	}
+
+	IImage* image = new CImage(format, size);
+	u8* target = (u8*)image->lock();
+	core::array<u8> row;
+	row.set_used(pitch);
+
+	for (u32 y=0; y<size.Height; ++y)
+	{
+		file->read(row.pointer(), y+1 < size.Height ? pitch : rowSize);
+		u8* dest = target + y * image->getPitch();
+
+		if (bpp == 3)
+		{
+			CColorConverter::convert_B8G8R8toA8R8G8B8(row.const_pointer(), size.Width, dest);
+			continue;
+		}
+
+		memcpy(dest, row.const_pointer(), rowSize);
+
+		if (bpp == 2)
+		{
+			u16* p = (u16*)dest;
+			for (u32 x=0; x<size.Width; ++x)
+			{
+#ifdef __BIG_ENDIAN__
+				p[x] = os::Byteswap::byteswap(p[x]);
+#endif
+				if (format == ECF_A1R5G5B5 && !alpha)
+					p[x] |= 0x8000;
+			}
+		}
+		else
+		{
+			u32* p = (u32*)dest;
+			for (u32 x=0; x<size.Width; ++x)
+			{
+				u32 c = p[x];
+#ifdef __BIG_ENDIAN__
+				c = os::Byteswap::byteswap(c);
+#endif
+				if (swapRedBlue)
+					c = (c & 0xFF00FF00) | (c & 0x00FF0000) >> 16 | (c & 0x000000FF) << 16;
+				if (!alpha)
+					c |= 0xFF000000;
+				p[x] = c;
+			}
+		}
+	}
+
+	image->unlock();
+	return image;
+}
+
+
+//! creates a loader which is able to load dds images
+IImageLoader* createImageLoaderDDS()
+{
+	return new CImageLoaderDDS();
+}
+
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
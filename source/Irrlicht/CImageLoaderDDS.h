@@ -0,0 +1,96 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_IMAGE_LOADER_DDS_H_INCLUDED__
+#define __C_IMAGE_LOADER_DDS_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_DDS_LOADER_
+
+#include "IImageLoader.h"
+
+namespace irr
+{
+namespace video
+{
+
+	// byte-align structures
+#if defined(_MSC_VER) ||  defined(__BORLANDC__) || defined (__BCPLUSPLUS__)
+#	pragma pack( push, packing )
+#	pragma pack( 1 )
+#	define PACK_STRUCT
+#elif defined( __GNUC__ )
+#	define PACK_STRUCT	__attribute__((packed))
+#else
+#	error compiler not supported
+#endif
+
+	struct SDDSPixelFormat
+	{
+		u32 Size;
+		u32 Flags;			// 0x1 alpha mask valid, 0x4 FourCC, 0x40 RGB masks valid
+		u32 FourCC;
+		u32 RGBBitCount;
+		u32 RBitMask;
+		u32 GBitMask;
+		u32 BBitMask;
+		u32 ABitMask;
+	} PACK_STRUCT;
+
+	struct SDDSHeader
+	{
+		u32 Magic;			// "DDS "
+		u32 Size;			// 124, without the magic
+		u32 Flags;			// 0x8 pitch valid
+		u32 Height;
+		u32 Width;
+		u32 PitchOrLinearSize;
+		u32 Depth;
+		u32 MipMapCount;
+		u32 Reserved1[11];
+		SDDSPixelFormat PixelFormat;
+		u32 Caps;
+		u32 Caps2;
+		u32 Caps3;
+		u32 Caps4;
+		u32 Reserved2;
+	} PACK_STRUCT;
+
+
+// Default alignment
+#if defined(_MSC_VER) ||  defined(__BORLANDC__) || defined (__BCPLUSPLUS__)
+#	pragma pack( pop, packing )
+#endif
+
+#undef PACK_STRUCT
+
+
+/*!
+	Surface Loader for DirectDraw surfaces
+	DXT1, DXT3 and DXT5 images stay compressed, uncompressed 16, 24 and
+	32 bit images are converted. Only the largest mip map level is loaded.
+*/
+class CImageLoaderDDS : public IImageLoader
+{
+public:
+
+	//! returns true if the file maybe is able to be loaded by this class
+	//! based on the file extension (e.g. ".tga")
+	virtual bool isALoadableFileExtension(const io::path& filename) const;
+
+	//! returns true if the file maybe is able to be loaded by this class
+	virtual bool isALoadableFileFormat(io::IReadFile* file) const;
+
+	//! creates a surface from the file
+	virtual IImage* loadImage(io::IReadFile* file) const;
+};
+
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+#endif
+
@@ -131,14 +131,33 @@ bool CImageLoaderJPG::isALoadableFileFormat(io::IReadFile* file) const
 
 //! creates a surface from the file
 IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
+{
+	return loadImage(file, core::dimension2d<u32>(0,0));
+}
+
+
+//! creates a surface from the file, decoded at a reduced scale if possible
+IImage* CImageLoaderJPG::loadImage(io::IReadFile* file, const core::dimension2d<u32>& minSize) const
 {
 	#ifndef _IRR_COMPILE_WITH_LIBJPEG_
 	return 0;
 	#else
 
-	u8 **rowPtr=0;
-	u8* input = new u8[file->getSize()];
-	file->read(input, file->getSize());
+	// mapped files are decoded in place. The copy of other files is
+	// volatile as it is freed after a longjmp
+	u8* volatile input = 0;
+	const u8* data = (const u8*)file->getMappedData();
+	if (!data)
+	{
+		input = new u8[file->getSize()];
+		file->read(input, file->getSize());
+		data = input;
+	}
+
+	// row buffer for cmyk images, other images are decoded into the image.
+	// both are volatile as they change between setjmp and longjmp
+	u8* volatile cmykRow = 0;
+	IImage* volatile image = 0;
 
 	// allocate and initialize JPEG decompression object
 	struct jpeg_decompress_struct cinfo;
@@ -164,9 +183,12 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 		jpeg_destroy_decompress(&cinfo);
 
 		delete [] input;
-		// if the row pointer was created, we delete it.
-		if (rowPtr)
-			delete [] rowPtr;
+		delete [] cmykRow;
+		if (image)
+		{
+			image->unlock();
+			image->drop();
+		}
 
 		// return null pointer
 		return 0;
@@ -180,7 +202,7 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 
 	// Set up data pointer
 	jsrc.bytes_in_buffer = file->getSize();
-	jsrc.next_input_byte = (JOCTET*)input;
+	jsrc.next_input_byte = (const JOCTET*)data;
 	cinfo.src = &jsrc;
 
 	jsrc.init_source = init_source;
@@ -211,70 +233,74 @@ IImage* CImageLoaderJPG::loadImage(io::IReadFile* file) const
 	}
 	cinfo.do_fancy_upsampling=FALSE;
 
+	// the idct can scale by 1/2, 1/4 and 1/8, which skips most of the work
+	if (minSize.Width && minSize.Height)
+	{
+		cinfo.scale_num = 1;
+		cinfo.scale_denom = 1;
+		while (cinfo.scale_denom < 8 &&
+			(cinfo.image_width + cinfo.scale_denom*2 - 1) / (cinfo.scale_denom*2) >= minSize.Width &&
+			(cinfo.image_height + cinfo.scale_denom*2 - 1) / (cinfo.scale_denom*2) >= minSize.Height)
+			cinfo.scale_denom *= 2;
+	}
+
 	// Start decompressor
 	jpeg_start_decompress(&cinfo);
 
 	// Get image data
-	u16 rowspan = cinfo.image_width * cinfo.out_color_components;
-	u32 width = cinfo.image_width;
-	u32 height = cinfo.image_height;
+	const u32 width = cinfo.output_width;
+	const u32 height = cinfo.output_height;
 
-	// Allocate memory for buffer
-	u8* output = new u8[rowspan * height];
+	IImage* target = new CImage(ECF_R8G8B8, core::dimension2d<u32>(width, height));
+	image = target;
+	u8* output = (u8*)target->lock();
+	const u32 pitch = target->getPitch();
+
+	u8* rowBuffer = 0;
+	if (useCMYK)
+	{
+		rowBuffer = new u8[width * 4];
+		cmykRow = rowBuffer;
+	}
 
 	// Here we use the library's state variable cinfo.output_scanline as the
 	// loop counter, so that we don't have to keep track ourselves.
-	// Create array of row pointers for lib
-	rowPtr = new u8* [height];
-
-	for( u32 i = 0; i < height; i++ )
-		rowPtr[i] = &output[ i * rowspan ];
+	while (cinfo.output_scanline < cinfo.output_height)
+	{
+		u8* row = output + cinfo.output_scanline * pitch;
+		if (!useCMYK)
+		{
+			jpeg_read_scanlines(&cinfo, &row, 1);
+			continue;
+		}
 
-	u32 rowsRead = 0;
+		jpeg_read_scanlines(&cinfo, &rowBuffer, 1);
+		for (u32 i=0, j=0; j<width*4; i+=3, j+=4)
+		{
+			// Also works without K, but has more contrast with K multiplied in
+//			row[i+0] = rowBuffer[j+2];
+//			row[i+1] = rowBuffer[j+1];
+//			row[i+2] = rowBuffer[j+0];
+			row[i+0] = (char)(rowBuffer[j+2]*(rowBuffer[j+3]/255.f));
+			row[i+1] = (char)(rowBuffer[j+1]*(rowBuffer[j+3]/255.f));
+			row[i+2] = (char)(rowBuffer[j+0]*(rowBuffer[j+3]/255.f));
+		}
+	}
 
-	while( cinfo.output_scanline < cinfo.output_height )
-		rowsRead += jpeg_read_scanlines( &cinfo, &rowPtr[rowsRead], cinfo.output_height - rowsRead );
+	target->unlock();
+	delete [] rowBuffer;
+	cmykRow = 0;
 
-	delete [] rowPtr;
 	// Finish decompression
-
 	jpeg_finish_decompress(&cinfo);
 
 	// Release JPEG decompression object
 	// This is an important step since it will release a good deal of memory.
 	jpeg_destroy_decompress(&cinfo);
 
-	// convert image
-	IImage* image = 0;
-	if (useCMYK)
-	{
-		image = new CImage(ECF_R8G8B8,
-				core::dimension2d<u32>(width, height));
-		const u32 size = 3*width*height;
-		u8* data = (u8*)image->lock();
-		if (data)
-		{
-			for (u32 i=0,j=0; i<size; i+=3, j+=4)
-			{
-				// Also works without K, but has more contrast with K multiplied in
-//				data[i+0] = output[j+2];
-//				data[i+1] = output[j+1];
-//				data[i+2] = output[j+0];
-				data[i+0] = (char)(output[j+2]*(output[j+3]/255.f));
-				data[i+1] = (char)(output[j+1]*(output[j+3]/255.f));
-				data[i+2] = (char)(output[j+0]*(output[j+3]/255.f));
-			}
-		}
-		image->unlock();
-		delete [] output;
-	}
-	else
-		image = new CImage(ECF_R8G8B8,
-				core::dimension2d<u32>(width, height), output);
-
 	delete [] input;
 
-	return image;
+	return target;
 
 	#endif
 }
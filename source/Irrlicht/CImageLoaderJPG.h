@@ -51,6 +51,9 @@ public:
 	//! creates a surface from the file
 	virtual IImage* loadImage(io::IReadFile* file) const;
 
+	//! creates a surface from the file, decoded at a reduced scale if possible
+	virtual IImage* loadImage(io::IReadFile* file, const core::dimension2d<u32>& minSize) const;
+
 private:
 
     #ifdef _IRR_COMPILE_WITH_LIBJPEG_
@@ -32,7 +32,7 @@ static void png_cpexcept_error(png_structp png_ptr, png_const_charp msg)
 }
 
 // PNG function for file reading
-void PNGAPI user_read_data_fcn(png_structp png_ptr, png_bytep data, png_size_t length)
+static void PNGAPI user_read_data_fcn(png_structp png_ptr, png_bytep data, png_size_t length)
 {
 	png_size_t check;
 
@@ -44,6 +44,24 @@ void PNGAPI user_read_data_fcn(png_structp png_ptr, png_bytep data, png_size_t l
 	if (check != length)
 		png_error(png_ptr, "Read Error");
 }
+
+// PNG function for reading from mapped files
+struct SPNGMappedData
+{
+	const u8* Data;
+	png_size_t Size;
+};
+
+static void PNGAPI user_read_mapped_fcn(png_structp png_ptr, png_bytep data, png_size_t length)
+{
+	SPNGMappedData* mapped=(SPNGMappedData*)png_ptr->io_ptr;
+	if (length > mapped->Size)
+		png_error(png_ptr, "Read Error");
+
+	memcpy(data, mapped->Data, length);
+	mapped->Data += length;
+	mapped->Size -= length;
+}
 #endif // _IRR_COMPILE_WITH_LIBPNG_
 
 
@@ -86,9 +104,10 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
 	if (!file)
 		return 0;
 
-	video::IImage* image = 0;
+	// both are volatile as they change between setjmp and longjmp
+	video::IImage* volatile image = 0;
 	//Used to point to image rows
-	u8** RowPointers = 0;
+	u8** volatile RowPointers = 0;
 
 	png_byte buffer[8];
 	// Read the first few bytes of the PNG file
@@ -127,13 +146,29 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
 	if (setjmp(png_jmpbuf(png_ptr)))
 	{
 		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-		if (RowPointers)
-			delete [] RowPointers;
+		delete [] RowPointers;
+		if (image)
+		{
+			image->unlock();
+			image->drop();
+		}
 		return 0;
 	}
 
-	// changed by zola so we don't need to have public FILE pointers
-	png_set_read_fn(png_ptr, file, user_read_data_fcn);
+	// mapped files are decoded in place, without going through read()
+	SPNGMappedData mapped;
+	mapped.Data = (const u8*)file->getMappedData();
+	if (mapped.Data && file->getSize() >= 8)
+	{
+		mapped.Data += 8;
+		mapped.Size = file->getSize() - 8;
+		png_set_read_fn(png_ptr, &mapped, user_read_mapped_fcn);
+	}
+	else
+	{
+		// changed by zola so we don't need to have public FILE pointers
+		png_set_read_fn(png_ptr, file, user_read_data_fcn);
+	}
 
 	png_set_sig_bytes(png_ptr, 8); // Tell png that we read the signature
 
@@ -213,55 +248,37 @@ IImage* CImageLoaderPng::loadImage(io::IReadFile* file) const
 		Height=h;
 	}
 
-	// Create the image structure to be filled by png data
+	// Create the image structure to be filled by png data, the rows are
+	// decoded straight into it
+	IImage* target;
 	if (ColorType==PNG_COLOR_TYPE_RGB_ALPHA)
-		image = new CImage(ECF_A8R8G8B8, core::dimension2d<u32>(Width, Height));
+		target = new CImage(ECF_A8R8G8B8, core::dimension2d<u32>(Width, Height));
 	else
-		image = new CImage(ECF_R8G8B8, core::dimension2d<u32>(Width, Height));
-	if (!image)
-	{
-		os::Printer::log("LOAD PNG: Internal PNG create image struct failure\n", file->getFileName(), ELL_ERROR);
-		png_destroy_read_struct(&png_ptr, NULL, NULL);
-		return 0;
-	}
+		target = new CImage(ECF_R8G8B8, core::dimension2d<u32>(Width, Height));
+	image = target;
 
 	// Create array of pointers to rows in image data
-	RowPointers = new png_bytep[Height];
-	if (!RowPointers)
-	{
-		os::Printer::log("LOAD PNG: Internal PNG create row pointers failure\n", file->getFileName(), ELL_ERROR);
-		png_destroy_read_struct(&png_ptr, NULL, NULL);
-		delete image;
-		return 0;
-	}
+	png_bytep* rows = new png_bytep[Height];
+	RowPointers = rows;
 
 	// Fill array of pointers to rows in image data
-	unsigned char* data = (unsigned char*)image->lock();
+	unsigned char* data = (unsigned char*)target->lock();
 	for (u32 i=0; i<Height; ++i)
 	{
-		RowPointers[i]=data;
-		data += image->getPitch();
-	}
-
-	// for proper error handling
-	if (setjmp(png_jmpbuf(png_ptr)))
-	{
-		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-		delete [] RowPointers;
-		image->unlock();
-		delete [] image;
-		return 0;
+		rows[i]=data;
+		data += target->getPitch();
 	}
 
 	// Read data using the library function that handles all transformations including interlacing
-	png_read_image(png_ptr, RowPointers);
+	png_read_image(png_ptr, rows);
 
 	png_read_end(png_ptr, NULL);
-	delete [] RowPointers;
-	image->unlock();
+	RowPointers = 0;
+	delete [] rows;
+	target->unlock();
 	png_destroy_read_struct(&png_ptr,&info_ptr, 0); // Clean up memory
 
-	return image;
+	return target;
 #else
 	return 0;
 #endif // _IRR_COMPILE_WITH_LIBPNG_
@@ -0,0 +1,568 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#include "CImageResampler.h"
+#include "CColorConverter.h"
+#include "CThreadPool.h"
+#include "SoftwareDriver2_helper.h"
+#include "irrArray.h"
+#include "irrMath.h"
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+#include <emmintrin.h>
+#endif
+
+namespace irr
+{
+namespace video
+{
+
+namespace
+{
+
+// weights are fixed point numbers with this many fraction bits
+const s32 RESAMPLE_WEIGHT_BITS = 14;
+
+// horizontally filtered channels keep this many fraction bits
+const s32 RESAMPLE_ROW_BITS = 6;
+
+// bands of target rows on the thread pool have at least this many pixels
+const u32 RESAMPLE_BAND_PIXELS = 16384;
+
+// shift of the channel which is stored at byte i of an A8R8G8B8 pixel
+#ifdef __BIG_ENDIAN__
+inline u32 channelShift(u32 i) { return 24 - 8*i; }
+#else
+inline u32 channelShift(u32 i) { return 8*i; }
+#endif
+
+
+//! source pixels and fixed point weights of all target pixels along one axis
+struct SResampleAxis
+{
+	core::array<u32> First;
+	core::array<u32> Count;
+	core::array<u32> Offset;
+	core::array<s16> Weights;
+};
+
+
+f64 sinc(f64 x)
+{
+	if (fabs(x) < 1e-6)
+		return 1.0;
+	x *= core::PI64;
+	return sin(x) / x;
+}
+
+
+// modified bessel function of the first kind and order 0
+f64 bessel0(f64 x)
+{
+	const f64 q = x*x*0.25;
+	f64 sum = 1.0;
+	f64 term = 1.0;
+	for (u32 k=1; k<32 && term > sum*1e-12; ++k)
+	{
+		term *= q / ((f64)k*(f64)k);
+		sum += term;
+	}
+	return sum;
+}
+
+
+f64 getFilterRadius(E_RESAMPLE_FILTER filter)
+{
+	switch (filter)
+	{
+	case ERF_BILINEAR:
+		return 1.0;
+	case ERF_LANCZOS3:
+	case ERF_KAISER:
+		return 3.0;
+	default:
+		return 0.5;
+	}
+}
+
+
+f64 getFilterWeight(E_RESAMPLE_FILTER filter, f64 x)
+{
+	x = fabs(x);
+	switch (filter)
+	{
+	case ERF_BILINEAR:
+		return x < 1.0 ? 1.0 - x : 0.0;
+	case ERF_LANCZOS3:
+		return x < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+	case ERF_KAISER:
+		{
+			// width 3 and alpha 4, the usual choice for mip maps
+			if (x >= 3.0)
+				return 0.0;
+			const f64 t = x / 3.0;
+			return sinc(x) * bessel0(4.0 * sqrt(1.0 - t*t)) / bessel0(4.0);
+		}
+	default:
+		return 1.0;
+	}
+}
+
+
+//! computes which source pixels contribute to each target pixel
+void buildAxis(SResampleAxis& axis, u32 sourceSize, u32 targetSize, E_RESAMPLE_FILTER filter)
+{
+	const f64 scale = (f64)sourceSize / (f64)targetSize;
+	// filters are widened when scaling down, so every source pixel is used
+	const f64 stretch = core::max_(scale, 1.0);
+
+	axis.First.set_used(targetSize);
+	axis.Count.set_used(targetSize);
+	axis.Offset.set_used(targetSize);
+	axis.Weights.set_used(0);
+
+	core::array<f64> weights;
+
+	for (u32 x=0; x<targetSize; ++x)
+	{
+		axis.Offset[x] = axis.Weights.size();
+
+		if (filter == ERF_POINT)
+		{
+			axis.First[x] = core::min_((u32)(x*scale), sourceSize-1);
+			axis.Count[x] = 1;
+			axis.Weights.push_back(1 << RESAMPLE_WEIGHT_BITS);
+			continue;
+		}
+
+		const f64 center = (x + 0.5) * scale;
+		const f64 support = (filter == ERF_BOX) ? 0.5*stretch : getFilterRadius(filter)*stretch;
+		const s32 lo = (s32)floor(center - support);
+		const s32 hi = (s32)ceil(center + support);
+
+		// pixels outside of the image are clamped to the border
+		const s32 first = core::s32_clamp(lo, 0, sourceSize-1);
+		const s32 last = core::s32_clamp(hi, 0, sourceSize-1);
+		weights.set_used(last - first + 1);
+		for (u32 i=0; i<weights.size(); ++i)
+			weights[i] = 0.0;
+
+		f64 sum = 0.0;
+		for (s32 s=lo; s<=hi; ++s)
+		{
+			f64 w;
+			if (filter == ERF_BOX)
+				w = core::max_(0.0, core::min_(s + 1.0, center + support) - core::max_((f64)s, center - support));
+			else
+				w = getFilterWeight(filter, (s + 0.5 - center) / stretch);
+			weights[core::s32_clamp(s, 0, sourceSize-1) - first] += w;
+			sum += w;
+		}
+
+		// drop unused pixels at both ends
+		u32 begin = 0;
+		u32 end = weights.size();
+		while (begin < end && weights[begin] == 0.0)
+			++begin;
+		while (end > begin && weights[end-1] == 0.0)
+			--end;
+
+		if (begin == end || sum == 0.0)
+		{
+			axis.First[x] = core::s32_clamp((s32)center, 0, sourceSize-1);
+			axis.Count[x] = 1;
+			axis.Weights.push_back(1 << RESAMPLE_WEIGHT_BITS);
+			continue;
+		}
+
+		// normalize to fixed point, the rounding error goes to the largest weight
+		s32 total = 0;
+		u32 largest = axis.Weights.size();
+		for (u32 i=begin; i<end; ++i)
+		{
+			const s16 w = (s16)core::round32((f32)(weights[i] / sum * (1 << RESAMPLE_WEIGHT_BITS)));
+			axis.Weights.push_back(w);
+			if (w > axis.Weights[largest])
+				largest = axis.Weights.size() - 1;
+			total += w;
+		}
+		axis.Weights[largest] += (s16)((1 << RESAMPLE_WEIGHT_BITS) - total);
+
+		axis.First[x] = first + begin;
+		axis.Count[x] = end - begin;
+	}
+}
+
+
+//! information for resampling bands of target rows in parallel
+struct SResampleTask
+{
+	const u8* Source;
+	ECOLOR_FORMAT SourceFormat;
+	u32 SourceWidth;
+	u32 SourcePitch;
+	u8* Target;
+	ECOLOR_FORMAT TargetFormat;
+	u32 TargetWidth;
+	u32 TargetPitch;
+	const SResampleAxis* Horizontal;
+	const SResampleAxis* Vertical;
+	s32 Bias;
+	bool Blend;
+};
+
+
+//! filters a row of A8R8G8B8 pixels into fixed point channels
+void filterRowHorizontal(const u32* source, const SResampleAxis& axis, u32 width, s16* out)
+{
+	const s32 shift = RESAMPLE_WEIGHT_BITS - RESAMPLE_ROW_BITS;
+	const s32 round = 1 << (shift - 1);
+	const u32 s0 = channelShift(0);
+	const u32 s1 = channelShift(1);
+	const u32 s2 = channelShift(2);
+	const u32 s3 = channelShift(3);
+
+	for (u32 x=0; x<width; ++x)
+	{
+		const u32* p = source + axis.First[x];
+		const s16* w = axis.Weights.const_pointer() + axis.Offset[x];
+		const u32 count = axis.Count[x];
+
+		s32 c0 = round;
+		s32 c1 = round;
+		s32 c2 = round;
+		s32 c3 = round;
+		for (u32 k=0; k<count; ++k)
+		{
+			const u32 pixel = p[k];
+			const s32 weight = w[k];
+			c0 += weight * (s32)((pixel >> s0) & 0xff);
+			c1 += weight * (s32)((pixel >> s1) & 0xff);
+			c2 += weight * (s32)((pixel >> s2) & 0xff);
+			c3 += weight * (s32)((pixel >> s3) & 0xff);
+		}
+
+		out[0] = (s16)(c0 >> shift);
+		out[1] = (s16)(c1 >> shift);
+		out[2] = (s16)(c2 >> shift);
+		out[3] = (s16)(c3 >> shift);
+		out += 4;
+	}
+}
+
+
+//! combines filtered rows into a row of A8R8G8B8 pixels
+void filterRowsVertical(const s16* const* rows, const s16* weights, u32 count,
+		u32 values, s32 bias, u32* out)
+{
+	const s32 shift = RESAMPLE_WEIGHT_BITS + RESAMPLE_ROW_BITS;
+	// the bias is added together with the rounding
+	const s32 round = (1 << (shift - 1)) + bias * (1 << shift);
+	u8* dst = (u8*)out;
+	u32 i = 0;
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+	// two rows at once are multiplied and added by madd, 8 channels per step
+	const __m128i start = _mm_set1_epi32(round);
+	const __m128i zero = _mm_setzero_si128();
+	for (; i+8 <= values; i+=8)
+	{
+		__m128i lo = start;
+		__m128i hi = start;
+		u32 k = 0;
+		for (; k+1 < count; k+=2)
+		{
+			const __m128i w = _mm_set1_epi32((u16)weights[k] | ((u32)(u16)weights[k+1] << 16));
+			const __m128i a = _mm_loadu_si128((const __m128i*)(rows[k] + i));
+			const __m128i b = _mm_loadu_si128((const __m128i*)(rows[k+1] + i));
+			lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), w));
+			hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), w));
+		}
+		if (k < count)
+		{
+			const __m128i w = _mm_set1_epi32((u16)weights[k]);
+			const __m128i a = _mm_loadu_si128((const __m128i*)(rows[k] + i));
+			lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, zero), w));
+			hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, zero), w));
+		}
+
+		// the packs clamp to [0,255]
+		const __m128i v = _mm_packs_epi32(_mm_srai_epi32(lo, shift), _mm_srai_epi32(hi, shift));
+		_mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(v, v));
+	}
+#endif
+
+	for (; i<values; ++i)
+	{
+		s32 sum = round;
+		for (u32 k=0; k<count; ++k)
+			sum += weights[k] * rows[k][i];
+		dst[i] = (u8)core::s32_clamp(sum >> shift, 0, 255);
+	}
+}
+
+
+//! resamples the target rows [begin,end)
+void resampleBand(void* data, u32 begin, u32 end)
+{
+	const SResampleTask& task = *(const SResampleTask*)data;
+	const SResampleAxis& horizontal = *task.Horizontal;
+	const SResampleAxis& vertical = *task.Vertical;
+	const u32 rowValues = task.TargetWidth * 4;
+
+	// source rows needed by this band, the first rows never decrease
+	const u32 firstRow = vertical.First[begin];
+	u32 lastRow = firstRow;
+	u32 maxCount = 0;
+	for (u32 y=begin; y<end; ++y)
+	{
+		lastRow = core::max_(lastRow, vertical.First[y] + vertical.Count[y]);
+		maxCount = core::max_(maxCount, vertical.Count[y]);
+	}
+
+	core::array<s16> rows;
+	rows.set_used((lastRow - firstRow) * rowValues);
+
+	core::array<u32> line;
+	line.set_used(core::max_(task.SourceWidth, task.TargetWidth));
+
+	for (u32 r=firstRow; r<lastRow; ++r)
+	{
+		const u8* source = task.Source + r * task.SourcePitch;
+		const u32* pixels = (const u32*)source;
+		if (task.SourceFormat != ECF_A8R8G8B8)
+		{
+			CColorConverter::convert_viaFormat(source, task.SourceFormat,
+					task.SourceWidth, line.pointer(), ECF_A8R8G8B8);
+			pixels = line.const_pointer();
+		}
+		filterRowHorizontal(pixels, horizontal, task.TargetWidth,
+				rows.pointer() + (r - firstRow) * rowValues);
+	}
+
+	core::array<const s16*> rowPointers;
+	rowPointers.set_used(maxCount);
+
+	for (u32 y=begin; y<end; ++y)
+	{
+		const u32 count = vertical.Count[y];
+		for (u32 k=0; k<count; ++k)
+			rowPointers[k] = rows.const_pointer() + (vertical.First[y] - firstRow + k) * rowValues;
+
+		const s16* weights = vertical.Weights.const_pointer() + vertical.Offset[y];
+		u8* target = task.Target + y * task.TargetPitch;
+
+		if (task.TargetFormat == ECF_A8R8G8B8 && !task.Blend)
+		{
+			filterRowsVertical(rowPointers.const_pointer(), weights, count,
+					rowValues, task.Bias, (u32*)target);
+			continue;
+		}
+
+		filterRowsVertical(rowPointers.const_pointer(), weights, count,
+				rowValues, task.Bias, line.pointer());
+
+		if (task.Blend && task.TargetFormat == ECF_A8R8G8B8)
+		{
+			u32* dst = (u32*)target;
+			for (u32 x=0; x<task.TargetWidth; ++x)
+				dst[x] = PixelBlend32(dst[x], line[x]);
+		}
+		else
+			CColorConverter::convert_viaFormat(line.const_pointer(), ECF_A8R8G8B8,
+					task.TargetWidth, target, task.TargetFormat);
+	}
+}
+
+
+//! 2x2 box filter kernels of the formats used for mip maps
+template <ECOLOR_FORMAT F>
+struct SHalvePixel;
+
+template <>
+struct SHalvePixel<ECF_A8R8G8B8>
+{
+	typedef u32 Pixel;
+
+	static inline u32 average(u32 a, u32 b, u32 c, u32 d)
+	{
+		const u32 rb = (a & 0x00ff00ff) + (b & 0x00ff00ff) +
+			(c & 0x00ff00ff) + (d & 0x00ff00ff) + 0x00020002;
+		const u32 ag = ((a >> 8) & 0x00ff00ff) + ((b >> 8) & 0x00ff00ff) +
+			((c >> 8) & 0x00ff00ff) + ((d >> 8) & 0x00ff00ff) + 0x00020002;
+		return ((rb >> 2) & 0x00ff00ff) | (((ag >> 2) & 0x00ff00ff) << 8);
+	}
+};
+
+template <>
+struct SHalvePixel<ECF_A1R5G5B5>
+{
+	typedef u16 Pixel;
+
+	static inline u16 average(u32 a, u32 b, u32 c, u32 d)
+	{
+		const u32 rb = (a & 0x7c1f) + (b & 0x7c1f) + (c & 0x7c1f) + (d & 0x7c1f) + 0x0802;
+		const u32 g = (a & 0x03e0) + (b & 0x03e0) + (c & 0x03e0) + (d & 0x03e0) + 0x0040;
+		// the alpha bit is set if the average alpha reaches one half
+		const u32 alpha = (a >> 15) + (b >> 15) + (c >> 15) + (d >> 15);
+		return (u16)(((rb >> 2) & 0x7c1f) | ((g >> 2) & 0x03e0) | (alpha > 2 ? 0x8000 : 0));
+	}
+};
+
+
+//! vectorized part of a row, returns the number of target pixels done
+/** Formats without a vectorized path do all pixels in the scalar loop. */
+template <class Pixel>
+inline u32 halveRowSIMD(const Pixel*, const Pixel*, Pixel*, u32)
+{
+	return 0;
+}
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+inline u32 halveRowSIMD(const u32* a, const u32* b, u32* out, u32 width)
+{
+	u32 x = 0;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i two = _mm_set1_epi16(2);
+	for (; x+2 <= width; x+=2)
+	{
+		const __m128i p = _mm_loadu_si128((const __m128i*)(a + 2*x));
+		const __m128i q = _mm_loadu_si128((const __m128i*)(b + 2*x));
+		// vertical sums of four source columns
+		const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(p, zero), _mm_unpacklo_epi8(q, zero));
+		const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(p, zero), _mm_unpackhi_epi8(q, zero));
+		// add the columns pairwise
+		const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+		const __m128i avg = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+		_mm_storel_epi64((__m128i*)(out + x), _mm_packus_epi16(avg, avg));
+	}
+	return x;
+}
+#endif
+
+
+template <ECOLOR_FORMAT F>
+void halveBand(void* data, u32 begin, u32 end)
+{
+	typedef typename SHalvePixel<F>::Pixel Pixel;
+	const SResampleTask& task = *(const SResampleTask*)data;
+
+	for (u32 y=begin; y<end; ++y)
+	{
+		const Pixel* a = (const Pixel*)(task.Source + 2 * y * task.SourcePitch);
+		const Pixel* b = (const Pixel*)(task.Source + (2 * y + 1) * task.SourcePitch);
+		Pixel* out = (Pixel*)(task.Target + y * task.TargetPitch);
+
+		for (u32 x=halveRowSIMD(a, b, out, task.TargetWidth); x<task.TargetWidth; ++x)
+			out[x] = SHalvePixel<F>::average(a[2*x], a[2*x+1], b[2*x], b[2*x+1]);
+	}
+}
+
+
+bool isSupportedFormat(ECOLOR_FORMAT format)
+{
+	return format == ECF_A1R5G5B5 || format == ECF_R5G6B5 ||
+		format == ECF_R8G8B8 || format == ECF_A8R8G8B8;
+}
+
+} // end anonymous namespace
+
+
+//! scales the source image into the target, converting the color format
+bool CImageResampler::resample(const void* source, ECOLOR_FORMAT sourceFormat,
+		const core::dimension2d<u32>& sourceSize, u32 sourcePitch,
+		void* target, ECOLOR_FORMAT targetFormat,
+		const core::dimension2d<u32>& targetSize, u32 targetPitch,
+		E_RESAMPLE_FILTER filter, s32 bias, bool blend)
+{
+	if (!source || !target || !isSupportedFormat(sourceFormat) || !isSupportedFormat(targetFormat))
+		return false;
+
+	if (!sourceSize.Width || !sourceSize.Height || !targetSize.Width || !targetSize.Height)
+		return true;
+
+	SResampleTask task;
+	task.Source = (const u8*)source;
+	task.SourceFormat = sourceFormat;
+	task.SourceWidth = sourceSize.Width;
+	task.SourcePitch = sourcePitch;
+	task.Target = (u8*)target;
+	task.TargetFormat = targetFormat;
+	task.TargetWidth = targetSize.Width;
+	task.TargetPitch = targetPitch;
+	task.Horizontal = 0;
+	task.Vertical = 0;
+	task.Bias = bias;
+	task.Blend = blend && targetFormat == ECF_A8R8G8B8;
+
+	const bool plain = sourceFormat == targetFormat && !bias && !task.Blend;
+
+	// same size, only a conversion
+	if (sourceSize == targetSize && !bias && !task.Blend)
+	{
+		if (plain)
+		{
+			const u32 rowSize = targetSize.Width * IImage::getBitsPerPixelFromFormat(targetFormat) / 8;
+			for (u32 y=0; y<targetSize.Height; ++y)
+				memcpy(task.Target + y * targetPitch, task.Source + y * sourcePitch, rowSize);
+		}
+		else
+			CColorConverter::convert_viaFormat(task.Source, sourceFormat, sourcePitch,
+					task.Target, targetFormat, targetPitch, targetSize.Width, targetSize.Height);
+		return true;
+	}
+
+	const u32 bandSize = core::max_(1u, RESAMPLE_BAND_PIXELS / targetSize.Width);
+
+	// mip map step
+	if (plain && filter == ERF_BOX && targetSize.Width * 2 == sourceSize.Width &&
+		targetSize.Height * 2 == sourceSize.Height)
+	{
+		if (sourceFormat == ECF_A8R8G8B8)
+		{
+			CThreadPool::getSharedPool()->parallelFor(targetSize.Height, bandSize, halveBand<ECF_A8R8G8B8>, &task);
+			return true;
+		}
+		else if (sourceFormat == ECF_A1R5G5B5)
+		{
+			CThreadPool::getSharedPool()->parallelFor(targetSize.Height, bandSize, halveBand<ECF_A1R5G5B5>, &task);
+			return true;
+		}
+	}
+
+	SResampleAxis horizontal;
+	SResampleAxis vertical;
+	buildAxis(horizontal, sourceSize.Width, targetSize.Width, filter);
+	buildAxis(vertical, sourceSize.Height, targetSize.Height, filter);
+	task.Horizontal = &horizontal;
+	task.Vertical = &vertical;
+
+	CThreadPool::getSharedPool()->parallelFor(targetSize.Height, bandSize, resampleBand, &task);
+	return true;
+}
+
+
+//! scales an image into another one
+bool CImageResampler::resample(IImage* source, IImage* target,
+		E_RESAMPLE_FILTER filter, s32 bias, bool blend)
+{
+	if (!source || !target)
+		return false;
+
+	const bool result = resample(source->lock(), source->getColorFormat(),
+			source->getDimension(), source->getPitch(),
+			target->lock(), target->getColorFormat(),
+			target->getDimension(), target->getPitch(),
+			filter, bias, blend);
+
+	target->unlock();
+	source->unlock();
+	return result;
+}
+
+
+} // end namespace video
+} // end namespace irr
+
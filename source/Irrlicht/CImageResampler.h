@@ -0,0 +1,63 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_IMAGE_RESAMPLER_H_INCLUDED__
+#define __C_IMAGE_RESAMPLER_H_INCLUDED__
+
+#include "IImage.h"
+
+namespace irr
+{
+namespace video
+{
+
+//! Filters used by CImageResampler
+enum E_RESAMPLE_FILTER
+{
+	//! nearest source pixel, no filtering
+	ERF_POINT = 0,
+
+	//! average of the source pixels covered by a target pixel
+	ERF_BOX,
+
+	//! linear interpolation, a tent filter when scaling down
+	ERF_BILINEAR,
+
+	//! Lanczos windowed sinc with 3 lobes, sharp but may ring
+	ERF_LANCZOS3,
+
+	//! Kaiser windowed sinc, sharper mip maps than the box filter
+	ERF_KAISER
+};
+
+//! Scales images between all formats CColorConverter supports
+/** The filters are separable. Source rows are filtered horizontally into
+fixed point rows, which are then combined vertically, using SSE2 if
+_IRR_COMPILE_WITH_SSE2_ is defined. Bands of target rows are processed
+on the shared thread pool. Halving an A8R8G8B8 or A1R5G5B5 image with the
+box filter, the usual mip map step, has its own kernels. */
+class CImageResampler
+{
+public:
+
+	//! scales the source image into the target, converting the color format
+	/** \param bias Added to all channels of the result.
+	\param blend Blend the result onto A8R8G8B8 targets using its alpha.
+	\return False if a color format is not supported. */
+	static bool resample(const void* source, ECOLOR_FORMAT sourceFormat,
+			const core::dimension2d<u32>& sourceSize, u32 sourcePitch,
+			void* target, ECOLOR_FORMAT targetFormat,
+			const core::dimension2d<u32>& targetSize, u32 targetPitch,
+			E_RESAMPLE_FILTER filter, s32 bias=0, bool blend=false);
+
+	//! scales an image into another one
+	static bool resample(IImage* source, IImage* target,
+			E_RESAMPLE_FILTER filter, s32 bias=0, bool blend=false);
+};
+
+} // end namespace video
+} // end namespace irr
+
+#endif
+
@@ -0,0 +1,430 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CInstancedMeshSceneNode.h"
+#include "IVideoDriver.h"
+#include "ISceneManager.h"
+#include "ICameraSceneNode.h"
+#include "IMeshCache.h"
+#include "IAnimatedMesh.h"
+#include "IMaterialRenderer.h"
+#include "SViewFrustum.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! constructor
+CInstancedMeshSceneNode::CInstancedMeshSceneNode(IMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position, const core::vector3df& rotation,
+			const core::vector3df& scale)
+: IInstancedMeshSceneNode(parent, mgr, id, position, rotation, scale), Mesh(0),
+	PassCount(0), ReadOnlyMaterials(false), BoxDirty(true)
+{
+	#ifdef _DEBUG
+	setDebugName("CInstancedMeshSceneNode");
+	#endif
+
+	setMesh(mesh);
+}
+
+
+//! destructor
+CInstancedMeshSceneNode::~CInstancedMeshSceneNode()
+{
+	if (Mesh)
+		Mesh->drop();
+}
+
+
+//! Adds an instance of the mesh.
+u32 CInstancedMeshSceneNode::addInstance(const core::matrix4& transform, video::SColor color)
+{
+	Transforms.push_back(transform);
+	Colors.push_back(color);
+	BoxDirty = true;
+	return Transforms.size()-1;
+}
+
+
+//! Removes an instance.
+void CInstancedMeshSceneNode::removeInstance(u32 index)
+{
+	if (index >= Transforms.size())
+		return;
+
+	// move the last instance into the gap instead of shifting all others
+	Transforms[index] = Transforms.getLast();
+	Colors[index] = Colors.getLast();
+	Transforms.erase(Transforms.size()-1);
+	Colors.erase(Colors.size()-1);
+	BoxDirty = true;
+}
+
+
+//! Removes all instances.
+void CInstancedMeshSceneNode::removeAllInstances()
+{
+	Transforms.clear();
+	Colors.clear();
+	VisibleTransforms.clear();
+	VisibleColors.clear();
+	BoxDirty = true;
+}
+
+
+//! Sets the transformation of an instance, relative to the node.
+void CInstancedMeshSceneNode::setInstanceTransformation(u32 index, const core::matrix4& transform)
+{
+	if (index >= Transforms.size())
+		return;
+
+	Transforms[index] = transform;
+	BoxDirty = true;
+}
+
+
+//! Get the transformation of an instance, relative to the node.
+const core::matrix4& CInstancedMeshSceneNode::getInstanceTransformation(u32 index) const
+{
+	if (index >= Transforms.size())
+		return core::IdentityMatrix;
+
+	return Transforms[index];
+}
+
+
+//! Sets the color of an instance.
+void CInstancedMeshSceneNode::setInstanceColor(u32 index, video::SColor color)
+{
+	if (index < Colors.size())
+		Colors[index] = color;
+}
+
+
+//! Get the color of an instance.
+video::SColor CInstancedMeshSceneNode::getInstanceColor(u32 index) const
+{
+	if (index >= Colors.size())
+		return video::SColor(255,255,255,255);
+
+	return Colors[index];
+}
+
+
+//! recalculates the box around all instances
+void CInstancedMeshSceneNode::recalculateBoundingBox() const
+{
+	BoxDirty = false;
+
+	if (!Mesh || !Transforms.size())
+	{
+		Box.reset(0.f,0.f,0.f);
+		return;
+	}
+
+	for (u32 i=0; i<Transforms.size(); ++i)
+	{
+		core::aabbox3df box = Mesh->getBoundingBox();
+		Transforms[i].transformBoxEx(box);
+
+		if (i)
+			Box.addInternalBox(box);
+		else
+			Box = box;
+	}
+}
+
+
+//! returns the axis aligned bounding box of all instances
+const core::aabbox3d<f32>& CInstancedMeshSceneNode::getBoundingBox() const
+{
+	if (BoxDirty)
+		recalculateBoundingBox();
+
+	return Box;
+}
+
+
+//! collects the world matrices and colors of the instances in the view frustum
+void CInstancedMeshSceneNode::collectVisibleInstances()
+{
+	VisibleTransforms.set_used(0);
+	VisibleColors.set_used(0);
+
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	const SViewFrustum* frustum = camera ? camera->getViewFrustum() : 0;
+	const core::aabbox3df& meshBox = Mesh->getBoundingBox();
+
+	for (u32 i=0; i<Transforms.size(); ++i)
+	{
+		const core::matrix4 world = AbsoluteTransformation * Transforms[i];
+
+		if (frustum)
+		{
+			core::aabbox3df box = meshBox;
+			world.transformBoxEx(box);
+			if (!frustum->intersectsBox(box))
+				continue;
+		}
+
+		VisibleTransforms.push_back(world);
+		VisibleColors.push_back(Colors[i]);
+	}
+}
+
+
+//! frame
+void CInstancedMeshSceneNode::OnRegisterSceneNode()
+{
+	if (IsVisible && Mesh && Transforms.size())
+	{
+		collectVisibleInstances();
+
+		if (VisibleTransforms.size())
+		{
+			// register for the passes of the materials, like CMeshSceneNode
+			video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+			PassCount = 0;
+			int transparentCount = 0;
+			int solidCount = 0;
+
+			for (u32 i=0; i<Mesh->getMeshBufferCount(); ++i)
+			{
+				const IMeshBuffer* mb = Mesh->getMeshBuffer(i);
+				if (!mb)
+					continue;
+
+				const video::SMaterial& material = ReadOnlyMaterials ? mb->getMaterial() : Materials[i];
+				video::IMaterialRenderer* rnd = driver->getMaterialRenderer(material.MaterialType);
+
+				if (rnd && rnd->isTransparent())
+					++transparentCount;
+				else
+					++solidCount;
+
+				if (solidCount && transparentCount)
+					break;
+			}
+
+			if (solidCount)
+				SceneManager->registerNodeForRendering(this, scene::ESNRP_SOLID);
+
+			if (transparentCount)
+				SceneManager->registerNodeForRendering(this, scene::ESNRP_TRANSPARENT);
+		}
+	}
+
+	ISceneNode::OnRegisterSceneNode();
+}
+
+
+//! renders the node.
+void CInstancedMeshSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+	if (!Mesh || !driver || !VisibleTransforms.size())
+		return;
+
+	const bool isTransparentPass =
+		SceneManager->getSceneNodeRenderPass() == scene::ESNRP_TRANSPARENT;
+
+	++PassCount;
+
+	for (u32 i=0; i<Mesh->getMeshBufferCount(); ++i)
+	{
+		const IMeshBuffer* mb = Mesh->getMeshBuffer(i);
+		if (!mb)
+			continue;
+
+		const video::SMaterial& material = ReadOnlyMaterials ? mb->getMaterial() : Materials[i];
+
+		video::IMaterialRenderer* rnd = driver->getMaterialRenderer(material.MaterialType);
+		const bool transparent = (rnd && rnd->isTransparent());
+
+		if (transparent == isTransparentPass)
+		{
+			driver->setMaterial(material);
+			driver->drawMeshBufferInstanced(mb, VisibleTransforms.const_pointer(),
+				VisibleColors.const_pointer(), VisibleTransforms.size());
+		}
+	}
+
+	// for debug purposes only:
+	if (DebugDataVisible && PassCount==1)
+	{
+		driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+
+		video::SMaterial m;
+		m.Lighting = false;
+		m.AntiAliasing=0;
+		driver->setMaterial(m);
+
+		if (DebugDataVisible & scene::EDS_BBOX)
+			driver->draw3DBox(getBoundingBox(), video::SColor(255,255,255,255));
+
+		if (DebugDataVisible & scene::EDS_BBOX_BUFFERS)
+		{
+			for (u32 i=0; i<VisibleTransforms.size(); ++i)
+			{
+				driver->setTransform(video::ETS_WORLD, VisibleTransforms[i]);
+				driver->draw3DBox(Mesh->getBoundingBox(), video::SColor(255,190,128,128));
+			}
+		}
+	}
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CInstancedMeshSceneNode::getMaterial(u32 i)
+{
+	if (Mesh && ReadOnlyMaterials && i<Mesh->getMeshBufferCount())
+	{
+		ReadOnlyMaterial = Mesh->getMeshBuffer(i)->getMaterial();
+		return ReadOnlyMaterial;
+	}
+
+	if (i >= Materials.size())
+		return ISceneNode::getMaterial(i);
+
+	return Materials[i];
+}
+
+
+//! returns amount of materials used by this scene node.
+u32 CInstancedMeshSceneNode::getMaterialCount() const
+{
+	if (Mesh && ReadOnlyMaterials)
+		return Mesh->getMeshBufferCount();
+
+	return Materials.size();
+}
+
+
+//! Sets a new mesh
+void CInstancedMeshSceneNode::setMesh(IMesh* mesh)
+{
+	if (mesh)
+	{
+		mesh->grab();
+		if (Mesh)
+			Mesh->drop();
+
+		Mesh = mesh;
+		copyMaterials();
+		BoxDirty = true;
+	}
+}
+
+
+void CInstancedMeshSceneNode::copyMaterials()
+{
+	Materials.clear();
+
+	if (Mesh)
+	{
+		video::SMaterial mat;
+
+		for (u32 i=0; i<Mesh->getMeshBufferCount(); ++i)
+		{
+			IMeshBuffer* mb = Mesh->getMeshBuffer(i);
+			if (mb)
+				mat = mb->getMaterial();
+
+			Materials.push_back(mat);
+		}
+	}
+}
+
+
+//! Writes attributes of the scene node.
+void CInstancedMeshSceneNode::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
+{
+	IInstancedMeshSceneNode::serializeAttributes(out, options);
+
+	out->addString("Mesh", SceneManager->getMeshCache()->getMeshName(Mesh).getPath().c_str());
+	out->addBool("ReadOnlyMaterials", ReadOnlyMaterials);
+	out->addInt("InstanceCount", Transforms.size());
+
+	for (u32 i=0; i<Transforms.size(); ++i)
+	{
+		core::stringc name("Instance");
+		name += (int)i;
+		out->addMatrix(name.c_str(), Transforms[i]);
+
+		name += "Color";
+		out->addColor(name.c_str(), Colors[i]);
+	}
+}
+
+
+//! Reads attributes of the scene node.
+void CInstancedMeshSceneNode::deserializeAttributes(io::IAttributes* in, io::SAttributeReadWriteOptions* options)
+{
+	io::path oldMeshStr = SceneManager->getMeshCache()->getMeshName(Mesh);
+	io::path newMeshStr = in->getAttributeAsString("Mesh");
+	ReadOnlyMaterials = in->getAttributeAsBool("ReadOnlyMaterials");
+
+	if (newMeshStr != "" && oldMeshStr != newMeshStr)
+	{
+		IMesh* newMesh = 0;
+		IAnimatedMesh* newAnimatedMesh = SceneManager->getMesh(newMeshStr.c_str());
+
+		if (newAnimatedMesh)
+			newMesh = newAnimatedMesh->getMesh(0);
+
+		if (newMesh)
+			setMesh(newMesh);
+	}
+
+	if (in->existsAttribute("InstanceCount"))
+	{
+		removeAllInstances();
+
+		const s32 count = in->getAttributeAsInt("InstanceCount");
+		for (s32 i=0; i<count; ++i)
+		{
+			core::stringc name("Instance");
+			name += i;
+			const core::matrix4 transform = in->getAttributeAsMatrix(name.c_str());
+
+			name += "Color";
+			addInstance(transform, in->existsAttribute(name.c_str()) ?
+				in->getAttributeAsColor(name.c_str()) : video::SColor(255,255,255,255));
+		}
+	}
+
+	IInstancedMeshSceneNode::deserializeAttributes(in, options);
+}
+
+
+//! Creates a clone of this scene node and its children.
+ISceneNode* CInstancedMeshSceneNode::clone(ISceneNode* newParent, ISceneManager* newManager)
+{
+	if (!newParent)
+		newParent = Parent;
+	if (!newManager)
+		newManager = SceneManager;
+
+	CInstancedMeshSceneNode* nb = new CInstancedMeshSceneNode(Mesh, newParent,
+		newManager, ID, RelativeTranslation, RelativeRotation, RelativeScale);
+
+	nb->cloneMembers(this, newManager);
+	nb->ReadOnlyMaterials = ReadOnlyMaterials;
+	nb->Materials = Materials;
+	nb->Transforms = Transforms;
+	nb->Colors = Colors;
+
+	if (newParent)
+		nb->drop();
+	return nb;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
@@ -264,10 +264,16 @@ void CIrrMeshFileLoader::readIndices(io::IXMLReader* reader, int indexCount, IIn
 	core::stringc data = reader->getNodeData();
 	const c8* p = &data[0];
 
-	for (int i=0; i<indexCount && *p; ++i)
+	// convert the indices in chunks
+	s32 numbers[256];
+	while (indexCount > 0)
 	{
-		findNextNoneWhiteSpace(&p);
-		indices.push_back(readInt(&p));
+		const u32 count = core::strtol10_array(p, numbers, core::min_(indexCount, 256), &p);
+		if (!count)
+			break;
+		for (u32 i=0; i<count; ++i)
+			indices.push_back(numbers[i]);
+		indexCount -= count;
 	}
 }
 
@@ -473,19 +479,11 @@ void CIrrMeshFileLoader::skipSection(io::IXMLReader* reader, bool reportSkipping
 inline f32 CIrrMeshFileLoader::readFloat(const c8** p)
 {
 	f32 ftmp;
-	*p = core::fast_atof_move(*p, ftmp);
+	*p = core::fast_atof_exact_move(*p, ftmp);
 	return ftmp;
 }
 
 
-//! parses an int from a char pointer and moves the pointer to
-//! the end of the parsed float
-inline s32 CIrrMeshFileLoader::readInt(const c8** p)
-{
-	return (s32)readFloat(p);
-}
-
-
 //! places pointer to next begin of a token
 void CIrrMeshFileLoader::skipCurrentNoneWhiteSpace(const c8** start)
 {
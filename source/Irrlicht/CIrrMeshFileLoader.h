@@ -56,10 +56,6 @@ private:
 	//! the end of the parsed float
 	inline f32 readFloat(const c8** p);
 
-	//! parses an int from a char pointer and moves the pointer to
-	//! the end of the parsed float
-	inline s32 readInt(const c8** p);
-
 	//! places pointer to next begin of a token
 	void findNextNoneWhiteSpace(const c8** p);
 
@@ -0,0 +1,433 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CLODMeshSceneNode.h"
+#include "IVideoDriver.h"
+#include "ISceneManager.h"
+#include "S3DVertex.h"
+#include "ICameraSceneNode.h"
+#include "IMeshCache.h"
+#include "IMeshManipulator.h"
+#include "IAnimatedMesh.h"
+#include "IMaterialRenderer.h"
+#include "os.h"
+
+namespace irr
+{
+namespace scene
+{
+
+//! a coarser level is only switched to if its error is this much below the maximum
+static const f32 LOD_HYSTERESIS = 0.8f;
+
+
+//! constructor
+CLODMeshSceneNode::CLODMeshSceneNode(IMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position, const core::vector3df& rotation,
+			const core::vector3df& scale)
+: ILODMeshSceneNode(parent, mgr, id, position, rotation, scale),
+	MaxScreenError(1.f), GenerateRatio(0.5f), CurrentLevel(0), PassCount(0),
+	ReadOnlyMaterials(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CLODMeshSceneNode");
+	#endif
+
+	setMesh(mesh);
+}
+
+
+//! destructor
+CLODMeshSceneNode::~CLODMeshSceneNode()
+{
+	for (u32 i=0; i<Levels.size(); ++i)
+		Levels[i]->drop();
+}
+
+
+//! removes all levels but the first one
+void CLODMeshSceneNode::clearLevels()
+{
+	for (u32 i=1; i<Levels.size(); ++i)
+		Levels[i]->drop();
+
+	if (Levels.size() > 1)
+	{
+		Levels.set_used(1);
+		LevelErrors.set_used(1);
+	}
+	CurrentLevel = 0;
+}
+
+
+//! Sets a new mesh as the first level and removes all others
+void CLODMeshSceneNode::setMesh(IMesh* mesh)
+{
+	if (!mesh)
+		return;
+
+	mesh->grab();
+	clearLevels();
+
+	if (Levels.size())
+	{
+		Levels[0]->drop();
+		Levels[0] = mesh;
+	}
+	else
+	{
+		Levels.push_back(mesh);
+		LevelErrors.push_back(0.f);
+	}
+
+	copyMaterials();
+}
+
+
+//! Appends a coarser level.
+void CLODMeshSceneNode::addLevel(IMesh* mesh, f32 error)
+{
+	if (!mesh || !Levels.size())
+		return;
+
+	if (mesh->getMeshBufferCount() != Levels[0]->getMeshBufferCount())
+	{
+		os::Printer::log("LOD level has a different number of mesh buffers, ignoring it.", ELL_WARNING);
+		return;
+	}
+
+	mesh->grab();
+	Levels.push_back(mesh);
+	// the selection relies on the errors growing with the level
+	LevelErrors.push_back(core::max_(error, LevelErrors.getLast()));
+}
+
+
+//! Replaces all coarser levels by simplified versions of the first level.
+void CLODMeshSceneNode::generateLevels(u32 levelCount, f32 ratio)
+{
+	clearLevels();
+
+	if (!Levels.size() || ratio <= 0.f || ratio >= 1.f)
+		return;
+
+	GenerateRatio = ratio;
+
+	const IMeshManipulator* manipulator = SceneManager->getMeshManipulator();
+	u32 lastPolyCount = manipulator->getPolyCount(Levels[0]);
+	f32 keep = 1.f;
+
+	for (u32 l=1; l<levelCount; ++l)
+	{
+		keep *= ratio;
+
+		f32 error = 0.f;
+		IMesh* mesh = manipulator->createMeshSimplified(Levels[0], keep, FLT_MAX, &error);
+		if (!mesh)
+			break;
+
+		// stop once the mesh can't be simplified any further
+		const u32 polyCount = manipulator->getPolyCount(mesh);
+		if (polyCount >= lastPolyCount)
+		{
+			mesh->drop();
+			break;
+		}
+		lastPolyCount = polyCount;
+
+		addLevel(mesh, error);
+		mesh->drop();
+	}
+}
+
+
+//! returns the level to draw for the active camera
+u32 CLODMeshSceneNode::selectLevel() const
+{
+	const ICameraSceneNode* camera = SceneManager->getActiveCamera();
+	if (!camera || Levels.size() < 2)
+		return 0;
+
+	// distance of the camera to the bounding sphere of the node
+	core::aabbox3df box = Levels[0]->getBoundingBox();
+	AbsoluteTransformation.transformBoxEx(box);
+	const f32 radius = box.getExtent().getLength() * 0.5f;
+	f32 distance = camera->getAbsolutePosition().getDistanceFrom(box.getCenter()) - radius;
+	distance = core::max_(distance, camera->getNearValue());
+
+	// errors are given in object space
+	const core::vector3df scale = AbsoluteTransformation.getScale();
+	const f32 maxScale = core::max_(fabsf(scale.X), fabsf(scale.Y), fabsf(scale.Z));
+
+	const f32 screenHeight = (f32)SceneManager->getVideoDriver()->getViewPort().getHeight();
+	const f32 pixelsPerUnit = screenHeight /
+		(2.f * tanf(camera->getFOV() * 0.5f) * distance);
+	const f32 toPixels = pixelsPerUnit * maxScale;
+
+	u32 level = core::min_(CurrentLevel, Levels.size()-1);
+	while (level > 0 && LevelErrors[level] * toPixels > MaxScreenError)
+		--level;
+	while (level+1 < Levels.size() &&
+		LevelErrors[level+1] * toPixels <= MaxScreenError * LOD_HYSTERESIS)
+		++level;
+
+	return level;
+}
+
+
+//! chooses the level and registers the node
+void CLODMeshSceneNode::OnRegisterSceneNode()
+{
+	if (IsVisible && Levels.size())
+	{
+		CurrentLevel = selectLevel();
+
+		// register according to the material types, like CMeshSceneNode
+		video::IVideoDriver* driver = SceneManager->getVideoDriver();
+		const IMesh* mesh = Levels[CurrentLevel];
+
+		PassCount = 0;
+		int transparentCount = 0;
+		int solidCount = 0;
+
+		const u32 count = ReadOnlyMaterials ? mesh->getMeshBufferCount() : Materials.size();
+		for (u32 i=0; i<count; ++i)
+		{
+			video::E_MATERIAL_TYPE type;
+			if (ReadOnlyMaterials)
+			{
+				const scene::IMeshBuffer* mb = mesh->getMeshBuffer(i);
+				if (!mb)
+					continue;
+				type = mb->getMaterial().MaterialType;
+			}
+			else
+				type = Materials[i].MaterialType;
+
+			video::IMaterialRenderer* rnd = driver->getMaterialRenderer(type);
+
+			if (rnd && rnd->isTransparent())
+				++transparentCount;
+			else
+				++solidCount;
+
+			if (solidCount && transparentCount)
+				break;
+		}
+
+		if (solidCount)
+			SceneManager->registerNodeForRendering(this, scene::ESNRP_SOLID);
+
+		if (transparentCount)
+			SceneManager->registerNodeForRendering(this, scene::ESNRP_TRANSPARENT);
+	}
+
+	ISceneNode::OnRegisterSceneNode();
+}
+
+
+//! renders the node.
+void CLODMeshSceneNode::render()
+{
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+	if (!Levels.size() || !driver)
+		return;
+
+	const IMesh* mesh = Levels[core::min_(CurrentLevel, Levels.size()-1)];
+
+	const bool isTransparentPass =
+		SceneManager->getSceneNodeRenderPass() == scene::ESNRP_TRANSPARENT;
+
+	++PassCount;
+
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+	Box = mesh->getBoundingBox();
+
+	for (u32 i=0; i<mesh->getMeshBufferCount(); ++i)
+	{
+		scene::IMeshBuffer* mb = mesh->getMeshBuffer(i);
+		if (!mb)
+			continue;
+
+		const video::SMaterial& material = ReadOnlyMaterials ? mb->getMaterial() : Materials[i];
+
+		video::IMaterialRenderer* rnd = driver->getMaterialRenderer(material.MaterialType);
+		const bool transparent = (rnd && rnd->isTransparent());
+
+		// only render transparent buffer if this is the transparent render pass
+		// and solid only in solid pass
+		if (transparent == isTransparentPass)
+		{
+			driver->setMaterial(material);
+			driver->drawMeshBuffer(mb);
+		}
+	}
+
+	// for debug purposes only:
+	if (DebugDataVisible && PassCount==1)
+	{
+		video::SMaterial m;
+		m.Lighting = false;
+		m.AntiAliasing=0;
+		driver->setMaterial(m);
+
+		if (DebugDataVisible & scene::EDS_BBOX)
+			driver->draw3DBox(Box, video::SColor(255,255,255,255));
+
+		if (DebugDataVisible & scene::EDS_BBOX_BUFFERS)
+		{
+			for (u32 g=0; g<mesh->getMeshBufferCount(); ++g)
+			{
+				driver->draw3DBox(
+					mesh->getMeshBuffer(g)->getBoundingBox(),
+					video::SColor(255,190,128,128));
+			}
+		}
+
+		if (DebugDataVisible & scene::EDS_MESH_WIRE_OVERLAY)
+		{
+			m.Wireframe = true;
+			driver->setMaterial(m);
+
+			for (u32 g=0; g<mesh->getMeshBufferCount(); ++g)
+				driver->drawMeshBuffer(mesh->getMeshBuffer(g));
+		}
+	}
+}
+
+
+//! returns the axis aligned bounding box of this node
+const core::aabbox3d<f32>& CLODMeshSceneNode::getBoundingBox() const
+{
+	// the first level encloses all others, so culling doesn't depend on the level
+	return Levels.size() ? Levels[0]->getBoundingBox() : Box;
+}
+
+
+//! returns the material based on the zero based index i.
+video::SMaterial& CLODMeshSceneNode::getMaterial(u32 i)
+{
+	if (Levels.size() && ReadOnlyMaterials && i<Levels[0]->getMeshBufferCount())
+	{
+		ReadOnlyMaterial = Levels[0]->getMeshBuffer(i)->getMaterial();
+		return ReadOnlyMaterial;
+	}
+
+	if (i >= Materials.size())
+		return ISceneNode::getMaterial(i);
+
+	return Materials[i];
+}
+
+
+//! returns amount of materials used by this scene node.
+u32 CLODMeshSceneNode::getMaterialCount() const
+{
+	if (Levels.size() && ReadOnlyMaterials)
+		return Levels[0]->getMeshBufferCount();
+
+	return Materials.size();
+}
+
+
+void CLODMeshSceneNode::copyMaterials()
+{
+	Materials.clear();
+
+	if (Levels.size())
+	{
+		video::SMaterial mat;
+
+		for (u32 i=0; i<Levels[0]->getMeshBufferCount(); ++i)
+		{
+			IMeshBuffer* mb = Levels[0]->getMeshBuffer(i);
+			if (mb)
+				mat = mb->getMaterial();
+
+			Materials.push_back(mat);
+		}
+	}
+}
+
+
+//! Writes attributes of the scene node.
+void CLODMeshSceneNode::serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options) const
+{
+	ILODMeshSceneNode::serializeAttributes(out, options);
+
+	out->addString("Mesh", Levels.size() ?
+		SceneManager->getMeshCache()->getMeshName(Levels[0]).getPath().c_str() : "");
+	out->addBool("ReadOnlyMaterials", ReadOnlyMaterials);
+	out->addInt("LODLevels", Levels.size());
+	out->addFloat("LODRatio", GenerateRatio);
+	out->addFloat("MaxScreenError", MaxScreenError);
+}
+
+
+//! Reads attributes of the scene node.
+void CLODMeshSceneNode::deserializeAttributes(io::IAttributes* in, io::SAttributeReadWriteOptions* options)
+{
+	io::path oldMeshStr = Levels.size() ? SceneManager->getMeshCache()->getMeshName(Levels[0]).getPath() : io::path();
+	io::path newMeshStr = in->getAttributeAsString("Mesh");
+	ReadOnlyMaterials = in->getAttributeAsBool("ReadOnlyMaterials");
+	MaxScreenError = in->getAttributeAsFloat("MaxScreenError");
+
+	bool regenerate = false;
+
+	if (newMeshStr != "" && oldMeshStr != newMeshStr)
+	{
+		IMesh* newMesh = 0;
+		IAnimatedMesh* newAnimatedMesh = SceneManager->getMesh(newMeshStr.c_str());
+
+		if (newAnimatedMesh)
+			newMesh = newAnimatedMesh->getMesh(0);
+
+		if (newMesh)
+		{
+			setMesh(newMesh);
+			regenerate = true;
+		}
+	}
+
+	const u32 levelCount = (u32)core::max_(in->getAttributeAsInt("LODLevels"), 1);
+	f32 ratio = in->getAttributeAsFloat("LODRatio");
+	if (ratio <= 0.f)
+		ratio = GenerateRatio;
+	if (regenerate || levelCount != Levels.size() || ratio != GenerateRatio)
+		generateLevels(levelCount, ratio);
+
+	ILODMeshSceneNode::deserializeAttributes(in, options);
+}
+
+
+//! Creates a clone of this scene node and its children.
+ISceneNode* CLODMeshSceneNode::clone(ISceneNode* newParent, ISceneManager* newManager)
+{
+	if (!newParent)
+		newParent = Parent;
+	if (!newManager)
+		newManager = SceneManager;
+
+	CLODMeshSceneNode* nb = new CLODMeshSceneNode(getMesh(), newParent,
+		newManager, ID, RelativeTranslation, RelativeRotation, RelativeScale);
+
+	nb->cloneMembers(this, newManager);
+	// the levels are shared, they are never modified
+	for (u32 i=1; i<Levels.size(); ++i)
+		nb->addLevel(Levels[i], LevelErrors[i]);
+	nb->ReadOnlyMaterials = ReadOnlyMaterials;
+	nb->Materials = Materials;
+	nb->MaxScreenError = MaxScreenError;
+	nb->GenerateRatio = GenerateRatio;
+
+	if (newParent)
+		nb->drop();
+	return nb;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,118 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_LOD_MESH_SCENE_NODE_H_INCLUDED__
+#define __C_LOD_MESH_SCENE_NODE_H_INCLUDED__
+
+#include "ILODMeshSceneNode.h"
+#include "IMesh.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Mesh scene node switching between levels of detail by screen space error
+	/** Renders like CMeshSceneNode. Since all levels share the mesh buffer
+	layout and the materials of the first level, the copied materials stay
+	valid when the displayed level changes. */
+	class CLODMeshSceneNode : public ILODMeshSceneNode
+	{
+	public:
+
+		//! constructor
+		CLODMeshSceneNode(IMesh* mesh, ISceneNode* parent, ISceneManager* mgr, s32 id,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f));
+
+		//! destructor
+		virtual ~CLODMeshSceneNode();
+
+		//! chooses the level and registers the node
+		virtual void OnRegisterSceneNode();
+
+		//! renders the node.
+		virtual void render();
+
+		//! returns the axis aligned bounding box of this node
+		virtual const core::aabbox3d<f32>& getBoundingBox() const;
+
+		//! returns the material based on the zero based index i.
+		virtual video::SMaterial& getMaterial(u32 i);
+
+		//! returns amount of materials used by this scene node.
+		virtual u32 getMaterialCount() const;
+
+		//! Sets a new mesh as the first level and removes all others
+		virtual void setMesh(IMesh* mesh);
+
+		//! Returns the first level
+		virtual IMesh* getMesh(void) { return Levels.size() ? Levels[0] : 0; }
+
+		//! Sets if the scene node should not copy the materials of the mesh but use them in a read only style.
+		virtual void setReadOnlyMaterials(bool readonly) { ReadOnlyMaterials = readonly; }
+
+		//! Returns if the scene node should not copy the materials of the mesh but use them in a read only style
+		virtual bool isReadOnlyMaterials() const { return ReadOnlyMaterials; }
+
+		//! Replaces all coarser levels by simplified versions of the first level.
+		virtual void generateLevels(u32 levelCount, f32 ratio=0.5f);
+
+		//! Appends a coarser level.
+		virtual void addLevel(IMesh* mesh, f32 error);
+
+		//! Get the number of levels, including the first one.
+		virtual u32 getLevelCount() const { return Levels.size(); }
+
+		//! Get the level used for the last frame.
+		virtual u32 getCurrentLevel() const { return CurrentLevel; }
+
+		//! Sets the screen space error up to which coarser levels are used.
+		virtual void setMaxScreenError(f32 pixels) { MaxScreenError = pixels; }
+
+		//! Get the screen space error up to which coarser levels are used.
+		virtual f32 getMaxScreenError() const { return MaxScreenError; }
+
+		//! Writes attributes of the scene node.
+		virtual void serializeAttributes(io::IAttributes* out, io::SAttributeReadWriteOptions* options=0) const;
+
+		//! Reads attributes of the scene node.
+		virtual void deserializeAttributes(io::IAttributes* in, io::SAttributeReadWriteOptions* options=0);
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const { return ESNT_LOD_MESH; }
+
+		//! Creates a clone of this scene node and its children.
+		virtual ISceneNode* clone(ISceneNode* newParent=0, ISceneManager* newManager=0);
+
+	private:
+
+		//! removes all levels but the first one
+		void clearLevels();
+
+		//! returns the level to draw for the active camera
+		u32 selectLevel() const;
+
+		void copyMaterials();
+
+		core::array<IMesh*> Levels;
+		core::array<f32> LevelErrors;
+
+		core::array<video::SMaterial> Materials;
+		core::aabbox3d<f32> Box;
+		video::SMaterial ReadOnlyMaterial;
+
+		f32 MaxScreenError;
+		f32 GenerateRatio;
+		u32 CurrentLevel;
+		s32 PassCount;
+		bool ReadOnlyMaterials;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
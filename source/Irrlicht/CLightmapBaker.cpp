@@ -0,0 +1,911 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CLightmapBaker.h"
+#include "CDynamicMeshBuffer.h"
+#include "SMesh.h"
+#include "CThreadPool.h"
+#include "CMeshManipulator.h"
+#include "os.h"
+
+namespace irr
+{
+namespace scene
+{
+
+namespace
+{
+	//! marks a missing vertex copy
+	const u32 NoCopy = 0xffffffff;
+
+	//! leaf size of the occluder hierarchy
+	const u32 OccludersPerLeaf = 4;
+
+	//! deepest level of the occluder hierarchy, bounds the traversal stack
+	const u32 MaxDepth = 48;
+
+	//! returns one coordinate of a vector
+	inline f32 axisValue(const core::vector3df& v, u32 axis)
+	{
+		return (&v.X)[axis];
+	}
+
+	//! sorts charts by decreasing height for packing them into rows
+	struct SChartOrder
+	{
+		u32 Height;
+		u32 Chart;
+
+		bool operator<(const SChartOrder& other) const
+		{
+			return Height > other.Height;
+		}
+	};
+
+	//! copy of a vertex for one chart, vertices on chart borders get several
+	struct SVertexCopy
+	{
+		u32 Chart;
+		u32 Index;
+		u32 Next;
+	};
+
+	inline u32 findRoot(core::array<u32>& parent, u32 i)
+	{
+		while (parent[i] != i)
+		{
+			parent[i] = parent[parent[i]];
+			i = parent[i];
+		}
+		return i;
+	}
+
+	//! returns a well distributed number in [0,1) for a texel and a ray, the same on every run
+	inline f32 hashToUnit(u32 x)
+	{
+		x ^= x >> 16;
+		x *= 0x7feb352d;
+		x ^= x >> 15;
+		x *= 0x846ca68b;
+		x ^= x >> 16;
+		return (x >> 8) * (1.f / 16777216.f);
+	}
+
+	//! twice the signed area of the triangle a, b, c
+	inline f32 edgeFunction(const core::vector2df& a, const core::vector2df& b, const core::vector2df& c)
+	{
+		return (b.X - a.X) * (c.Y - a.Y) - (b.Y - a.Y) * (c.X - a.X);
+	}
+}
+
+
+//! constructor
+CLightmapBaker::CLightmapBaker(video::IVideoDriver* driver, const SLightmapBakeParameters& parameters)
+: Driver(driver), Parameters(parameters), TexelsPerUnit(parameters.TexelsPerUnit),
+	AtlasHeight(0), RayOffset(0.f), OcclusionDistance(0.f), Scale(0.f)
+{
+	Parameters.AtlasSize = core::dimension2du(core::max_(Parameters.AtlasSize, 16u), 1).getOptimalSize().Width;
+	if (Parameters.TexelsPerUnit <= 0.f)
+		Parameters.TexelsPerUnit = 1.f;
+}
+
+
+//! bakes the mesh, returns the new mesh or 0
+IMesh* CLightmapBaker::bake(IMesh* mesh, const core::matrix4& transform,
+	const core::array<video::SLight>& lights, ITriangleSelector* occluders)
+{
+	collectTriangles(mesh, transform);
+	if (Triangles.empty())
+		return 0;
+
+	// the ambient parts of the lights are not shadowed
+	Lights = lights;
+	for (u32 i=0; i<Lights.size(); ++i)
+	{
+		Lights[i].Direction.normalize();
+		Parameters.AmbientColor.r += Lights[i].AmbientColor.r;
+		Parameters.AmbientColor.g += Lights[i].AmbientColor.g;
+		Parameters.AmbientColor.b += Lights[i].AmbientColor.b;
+	}
+
+	buildHierarchy(occluders);
+	buildCharts();
+
+	// estimate the density at which the charts fit, then shrink until they do
+	TexelsPerUnit = Parameters.TexelsPerUnit;
+	f64 area = 0.0;
+	for (u32 i=0; i<Charts.size(); ++i)
+	{
+		const SChart& chart = Charts[i];
+		area += ((chart.MaxU - chart.MinU) * TexelsPerUnit + 1.f + Parameters.Padding) *
+			((chart.MaxV - chart.MinV) * TexelsPerUnit + 1.f + Parameters.Padding);
+	}
+	const f64 atlasArea = (f64)Parameters.AtlasSize * Parameters.AtlasSize;
+	if (area > atlasArea)
+		TexelsPerUnit *= (f32)sqrt(atlasArea / area);
+
+	while (!packCharts(TexelsPerUnit))
+	{
+		TexelsPerUnit *= 0.9f;
+		if (TexelsPerUnit * Scale < 1.f)
+		{
+			os::Printer::log("Lightmap baker: Too many charts for the atlas size.", ELL_ERROR);
+			return 0;
+		}
+	}
+
+	if (TexelsPerUnit < Parameters.TexelsPerUnit)
+	{
+		char buf[128];
+		snprintf(buf, 128, "Lightmap baker: Reduced to %g texels per unit to fit the atlas.", TexelsPerUnit);
+		os::Printer::log(buf, ELL_WARNING);
+	}
+
+	createSamples();
+
+	CThreadPool::getSharedPool()->parallelFor(Samples.size(), 64, lightSamples, this);
+
+	dilate();
+
+	video::IImage* image = Driver->createImage(video::ECF_A8R8G8B8,
+		core::dimension2du(Parameters.AtlasSize, AtlasHeight));
+	if (!image)
+		return 0;
+
+	u8* dst = (u8*)image->lock();
+	for (u32 y=0; y<AtlasHeight; ++y)
+		memcpy(dst + y * image->getPitch(), &Texels[y * Parameters.AtlasSize], Parameters.AtlasSize * 4);
+	image->unlock();
+
+	video::ITexture* lightmap = Driver->addTexture(Parameters.TextureName, image);
+	image->drop();
+
+	return createMesh(mesh, lightmap);
+}
+
+
+//! gathers the triangles and their vertices in world space
+void CLightmapBaker::collectTriangles(IMesh* mesh, const core::matrix4& transform)
+{
+	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(b);
+		const u32 start = Positions.size();
+		const u32 vertexCount = mb->getVertexCount();
+		BufferStart.push_back(start);
+
+		for (u32 i=0; i<vertexCount; ++i)
+		{
+			core::vector3df pos = mb->getPosition(i);
+			transform.transformVect(pos);
+			Positions.push_back(pos);
+
+			core::vector3df normal = mb->getNormal(i);
+			transform.rotateVect(normal);
+			Normals.push_back(normal.normalize());
+		}
+
+		const u32 indexCount = mb->getIndexCount() / 3 * 3;
+		const u16* indices16 = mb->getIndices();
+		const u32* indices32 = (const u32*)mb->getIndices();
+		const bool is32 = mb->getIndexType() == video::EIT_32BIT;
+
+		for (u32 i=0; i<indexCount; i+=3)
+		{
+			STriangle tri;
+			tri.Buffer = b;
+			tri.Chart = 0;
+
+			bool valid = true;
+			for (u32 k=0; k<3; ++k)
+			{
+				const u32 index = is32 ? indices32[i+k] : indices16[i+k];
+				valid &= index < vertexCount;
+				tri.Index[k] = start + index;
+			}
+
+			if (valid)
+				Triangles.push_back(tri);
+		}
+	}
+}
+
+
+//! groups connected triangles facing the same axis into charts
+void CLightmapBaker::buildCharts()
+{
+	const u32 triangleCount = Triangles.size();
+
+	// dominant axis and direction of each triangle
+	core::array<u32> group;
+	group.set_used(triangleCount);
+	for (u32 t=0; t<triangleCount; ++t)
+	{
+		const u32* idx = Triangles[t].Index;
+		const core::vector3df n = (Positions[idx[1]] - Positions[idx[0]]).crossProduct(
+				Positions[idx[2]] - Positions[idx[0]]);
+
+		u32 axis = 0;
+		if (fabsf(n.Y) > fabsf(axisValue(n, axis)))
+			axis = 1;
+		if (fabsf(n.Z) > fabsf(axisValue(n, axis)))
+			axis = 2;
+		group[t] = axis * 2 + (axisValue(n, axis) < 0.f ? 1 : 0);
+	}
+
+	// weld vertices by position, so texture seams do not split charts
+	core::array<u32> welded;
+	CMeshManipulator::weldPositions(Positions, welded);
+
+	// join triangles of the same group sharing an edge
+	core::array<u32> parent;
+	parent.set_used(triangleCount);
+	for (u32 t=0; t<triangleCount; ++t)
+		parent[t] = t;
+
+	{
+		core::array<u32> indices;
+		indices.set_used(triangleCount * 3);
+		for (u32 t=0; t<triangleCount; ++t)
+			for (u32 k=0; k<3; ++k)
+				indices[t*3+k] = Triangles[t].Index[k];
+
+		core::array<CMeshManipulator::SEdgeRef> edges;
+		CMeshManipulator::getSortedEdges(indices.const_pointer(), triangleCount,
+				welded.const_pointer(), edges);
+
+		for (u32 i=1; i<edges.size(); ++i)
+		{
+			const CMeshManipulator::SEdgeRef& e = edges[i];
+			for (u32 j=i; j>0 && edges[j-1].A == e.A && edges[j-1].B == e.B; --j)
+			{
+				const u32 other = edges[j-1].Triangle;
+				if (group[other] != group[e.Triangle])
+					continue;
+
+				const u32 ra = findRoot(parent, other);
+				const u32 rb = findRoot(parent, e.Triangle);
+				if (ra != rb)
+					parent[rb] = ra;
+				break;
+			}
+		}
+	}
+
+	// one chart per connected group
+	core::array<u32> chartOfRoot;
+	chartOfRoot.set_used(triangleCount);
+	for (u32 t=0; t<triangleCount; ++t)
+		chartOfRoot[t] = NoCopy;
+
+	for (u32 t=0; t<triangleCount; ++t)
+	{
+		const u32 root = findRoot(parent, t);
+		if (chartOfRoot[root] == NoCopy)
+		{
+			chartOfRoot[root] = Charts.size();
+			Charts.push_back(SChart());
+			SChart& chart = Charts.getLast();
+			chart.Axis = group[t] / 2;
+			chart.MinU = chart.MinV = FLT_MAX;
+			chart.MaxU = chart.MaxV = -FLT_MAX;
+			chart.X = chart.Y = chart.Width = chart.Height = 0;
+		}
+
+		const u32 c = chartOfRoot[root];
+		SChart& chart = Charts[c];
+		chart.Triangles.push_back(t);
+		Triangles[t].Chart = c;
+
+		const u32 axisU = (chart.Axis + 1) % 3;
+		const u32 axisV = (chart.Axis + 2) % 3;
+		for (u32 k=0; k<3; ++k)
+		{
+			const core::vector3df& p = Positions[Triangles[t].Index[k]];
+			chart.MinU = core::min_(chart.MinU, axisValue(p, axisU));
+			chart.MaxU = core::max_(chart.MaxU, axisValue(p, axisU));
+			chart.MinV = core::min_(chart.MinV, axisValue(p, axisV));
+			chart.MaxV = core::max_(chart.MaxV, axisValue(p, axisV));
+		}
+	}
+}
+
+
+//! places the charts in rows, returns false if they do not fit
+bool CLightmapBaker::packCharts(f32 texelsPerUnit)
+{
+	const u32 size = Parameters.AtlasSize;
+	const u32 padding = Parameters.Padding;
+
+	core::array<SChartOrder> order;
+	order.set_used(Charts.size());
+	for (u32 i=0; i<Charts.size(); ++i)
+	{
+		SChart& chart = Charts[i];
+		chart.Width = (u32)ceilf((chart.MaxU - chart.MinU) * texelsPerUnit) + 1;
+		chart.Height = (u32)ceilf((chart.MaxV - chart.MinV) * texelsPerUnit) + 1;
+		if (chart.Width + 2 * padding > size || chart.Height + 2 * padding > size)
+			return false;
+
+		order[i].Height = chart.Height;
+		order[i].Chart = i;
+	}
+	order.set_sorted(false);
+	order.sort();
+
+	u32 x = padding;
+	u32 y = padding;
+	u32 rowHeight = 0;
+	for (u32 i=0; i<order.size(); ++i)
+	{
+		SChart& chart = Charts[order[i].Chart];
+		if (x + chart.Width + padding > size)
+		{
+			x = padding;
+			y += rowHeight + padding;
+			rowHeight = 0;
+		}
+		if (y + chart.Height + padding > size)
+			return false;
+
+		chart.X = x;
+		chart.Y = y;
+		x += chart.Width + padding;
+		rowHeight = core::max_(rowHeight, chart.Height);
+	}
+
+	AtlasHeight = core::dimension2du(1, y + rowHeight + padding).getOptimalSize().Height;
+	AtlasHeight = core::min_(AtlasHeight, size);
+	return true;
+}
+
+
+//! returns the texel coordinates of a vertex in its chart
+core::vector2df CLightmapBaker::getTexelPos(const SChart& chart, u32 vertex) const
+{
+	const core::vector3df& p = Positions[vertex];
+	return core::vector2df(
+		chart.X + 0.5f + (axisValue(p, (chart.Axis + 1) % 3) - chart.MinU) * TexelsPerUnit,
+		chart.Y + 0.5f + (axisValue(p, (chart.Axis + 2) % 3) - chart.MinV) * TexelsPerUnit);
+}
+
+
+//! finds the point on the surface for each texel covered by a triangle
+void CLightmapBaker::createSamples()
+{
+	const u32 texelCount = Parameters.AtlasSize * AtlasHeight;
+	Texels.set_used(texelCount);
+	Covered.set_used(texelCount);
+	for (u32 i=0; i<texelCount; ++i)
+	{
+		Texels[i] = 0;
+		Covered[i] = false;
+	}
+
+	for (u32 c=0; c<Charts.size(); ++c)
+	{
+		const SChart& chart = Charts[c];
+		for (u32 i=0; i<chart.Triangles.size(); ++i)
+		{
+			const STriangle& tri = Triangles[chart.Triangles[i]];
+			const core::vector3df& p0 = Positions[tri.Index[0]];
+			const core::vector3df& p1 = Positions[tri.Index[1]];
+			const core::vector3df& p2 = Positions[tri.Index[2]];
+			core::vector3df faceNormal = (p1 - p0).crossProduct(p2 - p0);
+			faceNormal.normalize();
+
+			const core::vector2df t0 = getTexelPos(chart, tri.Index[0]);
+			const core::vector2df t1 = getTexelPos(chart, tri.Index[1]);
+			const core::vector2df t2 = getTexelPos(chart, tri.Index[2]);
+			const f32 area = edgeFunction(t0, t1, t2);
+
+			// texels whose centers are inside the triangle
+			u32 found = 0;
+			if (fabsf(area) > 1e-8f)
+			{
+				const f32 invArea = 1.f / area;
+				const s32 x0 = core::max_(core::floor32(core::min_(t0.X, t1.X, t2.X)), (s32)chart.X);
+				const s32 y0 = core::max_(core::floor32(core::min_(t0.Y, t1.Y, t2.Y)), (s32)chart.Y);
+				const s32 x1 = core::min_(core::ceil32(core::max_(t0.X, t1.X, t2.X)), (s32)(chart.X + chart.Width - 1));
+				const s32 y1 = core::min_(core::ceil32(core::max_(t0.Y, t1.Y, t2.Y)), (s32)(chart.Y + chart.Height - 1));
+
+				for (s32 y=y0; y<=y1; ++y)
+				{
+					for (s32 x=x0; x<=x1; ++x)
+					{
+						const u32 texel = y * Parameters.AtlasSize + x;
+						if (Covered[texel])
+							continue;
+
+						const core::vector2df center(x + 0.5f, y + 0.5f);
+						const f32 w0 = edgeFunction(t1, t2, center) * invArea;
+						const f32 w1 = edgeFunction(t2, t0, center) * invArea;
+						const f32 w2 = 1.f - w0 - w1;
+						if (w0 < -1e-4f || w1 < -1e-4f || w2 < -1e-4f)
+							continue;
+
+						SSample sample;
+						sample.Pos = p0 * w0 + p1 * w1 + p2 * w2;
+						sample.Normal = Normals[tri.Index[0]] * w0 + Normals[tri.Index[1]] * w1 +
+							Normals[tri.Index[2]] * w2;
+						if (sample.Normal.getLengthSQ() < 1e-8f)
+							sample.Normal = faceNormal;
+						sample.Normal.normalize();
+						sample.FaceNormal = faceNormal;
+						sample.Texel = texel;
+						Samples.push_back(sample);
+						Covered[texel] = true;
+						++found;
+					}
+				}
+			}
+
+			// triangles smaller than a texel still get lit
+			if (!found)
+			{
+				const core::vector2df center = (t0 + t1 + t2) / 3.f;
+				const u32 x = core::clamp<s32>(core::floor32(center.X), chart.X, chart.X + chart.Width - 1);
+				const u32 y = core::clamp<s32>(core::floor32(center.Y), chart.Y, chart.Y + chart.Height - 1);
+				const u32 texel = y * Parameters.AtlasSize + x;
+				if (!Covered[texel])
+				{
+					SSample sample;
+					sample.Pos = (p0 + p1 + p2) / 3.f;
+					sample.Normal = Normals[tri.Index[0]] + Normals[tri.Index[1]] + Normals[tri.Index[2]];
+					if (sample.Normal.getLengthSQ() < 1e-8f)
+						sample.Normal = faceNormal;
+					sample.Normal.normalize();
+					sample.FaceNormal = faceNormal;
+					sample.Texel = texel;
+					Samples.push_back(sample);
+					Covered[texel] = true;
+				}
+			}
+		}
+	}
+}
+
+
+//! lights the samples [begin,end), called on the thread pool
+void CLightmapBaker::lightSamples(void* baker, u32 begin, u32 end)
+{
+	CLightmapBaker* self = (CLightmapBaker*)baker;
+
+	// the _M2 and _M4 types brighten the lightmap again
+	f32 scale = 255.f;
+	if (self->Parameters.MaterialType == video::EMT_LIGHTMAP_M2 ||
+		self->Parameters.MaterialType == video::EMT_LIGHTMAP_LIGHTING_M2)
+		scale *= 0.5f;
+	else if (self->Parameters.MaterialType == video::EMT_LIGHTMAP_M4 ||
+		self->Parameters.MaterialType == video::EMT_LIGHTMAP_LIGHTING_M4)
+		scale *= 0.25f;
+
+	for (u32 i=begin; i<end; ++i)
+	{
+		const SSample& sample = self->Samples[i];
+		const video::SColorf color = self->lightSample(sample, i);
+		self->Texels[sample.Texel] = video::SColor(255,
+			core::clamp(core::round32(color.r * scale), 0, 255),
+			core::clamp(core::round32(color.g * scale), 0, 255),
+			core::clamp(core::round32(color.b * scale), 0, 255)).color;
+	}
+}
+
+
+//! returns the light arriving at a sample
+video::SColorf CLightmapBaker::lightSample(const SSample& sample, u32 index) const
+{
+	const core::vector3df start = sample.Pos + sample.FaceNormal * RayOffset;
+	const core::vector3df& n = sample.Normal;
+
+	// ambient light, darkened by the geometry around the sample
+	video::SColorf color = Parameters.AmbientColor;
+	if (Parameters.AmbientOcclusionSamples && !Occluders.empty())
+	{
+		core::vector3df tangent = (fabsf(n.X) > 0.9f ? core::vector3df(0.f, 1.f, 0.f) :
+			core::vector3df(1.f, 0.f, 0.f)).crossProduct(n);
+		tangent.normalize();
+		const core::vector3df bitangent = n.crossProduct(tangent);
+
+		u32 open = 0;
+		for (u32 s=0; s<Parameters.AmbientOcclusionSamples; ++s)
+		{
+			// cosine weighted directions over the hemisphere
+			const u32 seed = index * 0x9e3779b9 + s * 0x85ebca6b;
+			const f32 u1 = hashToUnit(seed);
+			const f32 u2 = hashToUnit(seed ^ 0x68bc21eb);
+			const f32 r = sqrtf(u1);
+			const f32 phi = 2.f * core::PI * u2;
+			const core::vector3df dir = tangent * (r * cosf(phi)) + bitangent * (r * sinf(phi)) +
+				n * sqrtf(core::max_(0.f, 1.f - u1));
+
+			if (!isOccluded(start, dir, OcclusionDistance))
+				++open;
+		}
+
+		const f32 visible = (f32)open / Parameters.AmbientOcclusionSamples;
+		color.r *= visible;
+		color.g *= visible;
+		color.b *= visible;
+	}
+
+	// direct light
+	for (u32 i=0; i<Lights.size(); ++i)
+	{
+		const video::SLight& light = Lights[i];
+
+		core::vector3df dir;
+		f32 distance;
+		f32 attenuation = 1.f;
+
+		if (light.Type == video::ELT_DIRECTIONAL)
+		{
+			dir = -light.Direction;
+			distance = Scale;
+		}
+		else
+		{
+			dir = light.Position - sample.Pos;
+			distance = dir.getLength();
+			if (distance > light.Radius || distance < 1e-6f)
+				continue;
+			dir /= distance;
+
+			const f32 d = light.Attenuation.X + light.Attenuation.Y * distance +
+				light.Attenuation.Z * distance * distance;
+			if (d > 0.f)
+				attenuation = 1.f / d;
+
+			if (light.Type == video::ELT_SPOT)
+			{
+				// the cones are half angles, like for the hardware drivers
+				const f32 cosAngle = -dir.dotProduct(light.Direction);
+				const f32 cosOuter = cosf(light.OuterCone * core::DEGTORAD);
+				const f32 cosInner = cosf(light.InnerCone * core::DEGTORAD);
+				if (cosAngle <= cosOuter)
+					continue;
+				if (cosAngle < cosInner)
+					attenuation *= powf((cosAngle - cosOuter) / (cosInner - cosOuter), light.Falloff);
+			}
+		}
+
+		const f32 lambert = n.dotProduct(dir);
+		if (lambert <= 0.f || sample.FaceNormal.dotProduct(dir) <= 0.f)
+			continue;
+
+		if (Parameters.CastShadows && light.CastShadows &&
+			isOccluded(start, dir, distance - RayOffset))
+			continue;
+
+		const f32 f = lambert * attenuation;
+		color.r += light.DiffuseColor.r * f;
+		color.g += light.DiffuseColor.g * f;
+		color.b += light.DiffuseColor.b * f;
+	}
+
+	return color;
+}
+
+
+//! fills the texels around the charts with the average of their lit neighbours
+void CLightmapBaker::dilate()
+{
+	const s32 width = Parameters.AtlasSize;
+	const s32 height = AtlasHeight;
+	core::array<bool> filled;
+
+	for (u32 pass=0; pass<core::max_(Parameters.Padding, 1u); ++pass)
+	{
+		filled = Covered;
+		for (s32 y=0; y<height; ++y)
+		{
+			for (s32 x=0; x<width; ++x)
+			{
+				const u32 texel = y * width + x;
+				if (Covered[texel])
+					continue;
+
+				u32 r = 0, g = 0, b = 0, count = 0;
+				for (s32 ny=core::max_(y-1, 0); ny<=core::min_(y+1, height-1); ++ny)
+				{
+					for (s32 nx=core::max_(x-1, 0); nx<=core::min_(x+1, width-1); ++nx)
+					{
+						const u32 n = ny * width + nx;
+						if (!Covered[n])
+							continue;
+
+						const video::SColor c(Texels[n]);
+						r += c.getRed();
+						g += c.getGreen();
+						b += c.getBlue();
+						++count;
+					}
+				}
+
+				if (count)
+				{
+					Texels[texel] = video::SColor(255, r / count, g / count, b / count).color;
+					filled[texel] = true;
+				}
+			}
+		}
+		Covered = filled;
+	}
+}
+
+
+//! copies the mesh with the lightmap coordinates as second texture coordinates
+IMesh* CLightmapBaker::createMesh(IMesh* mesh, video::ITexture* lightmap) const
+{
+	SMesh* result = new SMesh();
+
+	core::array<u32> firstCopy;
+	firstCopy.set_used(Positions.size());
+	for (u32 i=0; i<firstCopy.size(); ++i)
+		firstCopy[i] = NoCopy;
+	core::array<SVertexCopy> copies;
+
+	const core::vector2df atlasScale(1.f / Parameters.AtlasSize, 1.f / AtlasHeight);
+
+	u32 t = 0;
+	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(b);
+		const u8* vertices = (const u8*)mb->getVertices();
+		const u32 pitch = video::getVertexPitchFromType(mb->getVertexType());
+
+		core::array<video::S3DVertex2TCoords> newVertices;
+		core::array<u32> newIndices;
+
+		for (; t<Triangles.size() && Triangles[t].Buffer == b; ++t)
+		{
+			const STriangle& tri = Triangles[t];
+			for (u32 k=0; k<3; ++k)
+			{
+				const u32 vertex = tri.Index[k];
+
+				u32 copy = firstCopy[vertex];
+				while (copy != NoCopy && copies[copy].Chart != tri.Chart)
+					copy = copies[copy].Next;
+
+				if (copy == NoCopy)
+				{
+					// all vertex types start with the members of S3DVertex
+					const video::S3DVertex& v = *(const video::S3DVertex*)(vertices +
+						(vertex - BufferStart[b]) * pitch);
+					const core::vector2df texel = getTexelPos(Charts[tri.Chart], vertex);
+
+					SVertexCopy c;
+					c.Chart = tri.Chart;
+					c.Index = newVertices.size();
+					c.Next = firstCopy[vertex];
+					copy = copies.size();
+					copies.push_back(c);
+					firstCopy[vertex] = copy;
+
+					newVertices.push_back(video::S3DVertex2TCoords(v.Pos, v.Normal, v.Color,
+						v.TCoords, core::vector2df(texel.X * atlasScale.X, texel.Y * atlasScale.Y)));
+				}
+
+				newIndices.push_back(copies[copy].Index);
+			}
+		}
+
+		CDynamicMeshBuffer* buffer = new CDynamicMeshBuffer(video::EVT_2TCOORDS,
+			newVertices.size() > 65535 ? video::EIT_32BIT : video::EIT_16BIT);
+		buffer->getVertexBuffer().reallocate(newVertices.size());
+		for (u32 i=0; i<newVertices.size(); ++i)
+			buffer->getVertexBuffer().push_back(newVertices[i]);
+		buffer->getIndexBuffer().reallocate(newIndices.size());
+		for (u32 i=0; i<newIndices.size(); ++i)
+			buffer->getIndexBuffer().push_back(newIndices[i]);
+
+		buffer->Material = mb->getMaterial();
+		buffer->Material.MaterialType = Parameters.MaterialType;
+		buffer->Material.Lighting = false;
+		buffer->Material.setTexture(1, lightmap);
+		buffer->recalculateBoundingBox();
+
+		result->addMeshBuffer(buffer);
+		buffer->drop();
+	}
+
+	result->recalculateBoundingBox();
+	return result;
+}
+
+
+//! puts the occluders into a bounding volume hierarchy
+void CLightmapBaker::buildHierarchy(ITriangleSelector* occluders)
+{
+	core::array<core::triangle3df> triangles;
+	if (occluders)
+	{
+		const s32 count = occluders->getTriangleCount();
+		s32 written = 0;
+		triangles.set_used(count);
+		occluders->getTriangles(triangles.pointer(), count, written, 0);
+		triangles.set_used(written);
+	}
+	else
+	{
+		triangles.set_used(Triangles.size());
+		for (u32 t=0; t<Triangles.size(); ++t)
+			triangles[t].set(Positions[Triangles[t].Index[0]],
+				Positions[Triangles[t].Index[1]], Positions[Triangles[t].Index[2]]);
+	}
+
+	// size of the scene, for ray lengths and offsets
+	core::aabbox3df bounds(Positions[0]);
+	for (u32 i=1; i<Positions.size(); ++i)
+		bounds.addInternalPoint(Positions[i]);
+
+	core::array<core::vector3df> centers;
+	Occluders.reallocate(triangles.size());
+	centers.reallocate(triangles.size());
+	for (u32 i=0; i<triangles.size(); ++i)
+	{
+		const core::triangle3df& tri = triangles[i];
+		SOccluder o;
+		o.A = tri.pointA;
+		o.EdgeB = tri.pointB - tri.pointA;
+		o.EdgeC = tri.pointC - tri.pointA;
+		if (o.EdgeB.crossProduct(o.EdgeC).getLengthSQ() <= 0.f)
+			continue;
+
+		Occluders.push_back(o);
+		centers.push_back((tri.pointA + tri.pointB + tri.pointC) / 3.f);
+		bounds.addInternalPoint(tri.pointA);
+		bounds.addInternalPoint(tri.pointB);
+		bounds.addInternalPoint(tri.pointC);
+	}
+
+	Scale = core::max_(bounds.getExtent().getLength(), 1e-3f);
+	RayOffset = Scale * 1e-4f;
+	OcclusionDistance = Parameters.AmbientOcclusionDistance > 0.f ?
+		Parameters.AmbientOcclusionDistance : Scale * 0.1f;
+
+	if (Occluders.empty())
+		return;
+
+	Nodes.reallocate(Occluders.size() / OccludersPerLeaf * 2 + 1);
+	Nodes.push_back(SNode());
+	buildNode(0, 0, Occluders.size(), 0, centers);
+}
+
+
+//! fills a node of the hierarchy, splitting the occluders at the middle of their centers
+void CLightmapBaker::buildNode(u32 node, u32 first, u32 count, u32 depth,
+	core::array<core::vector3df>& centers)
+{
+	const u32 end = first + count;
+	core::aabbox3df box(Occluders[first].A);
+	core::aabbox3df centerBox(centers[first]);
+	for (u32 i=first; i<end; ++i)
+	{
+		const SOccluder& o = Occluders[i];
+		box.addInternalPoint(o.A);
+		box.addInternalPoint(o.A + o.EdgeB);
+		box.addInternalPoint(o.A + o.EdgeC);
+		centerBox.addInternalPoint(centers[i]);
+	}
+	Nodes[node].Box = box;
+
+	if (count <= OccludersPerLeaf || depth >= MaxDepth)
+	{
+		Nodes[node].First = first;
+		Nodes[node].Count = count;
+		return;
+	}
+
+	const core::vector3df extent = centerBox.getExtent();
+	u32 axis = 0;
+	if (extent.Y > axisValue(extent, axis))
+		axis = 1;
+	if (extent.Z > axisValue(extent, axis))
+		axis = 2;
+	const f32 split = axisValue(centerBox.getCenter(), axis);
+
+	u32 mid = first;
+	for (u32 i=first; i<end; ++i)
+	{
+		if (axisValue(centers[i], axis) < split)
+		{
+			core::swap(Occluders[i], Occluders[mid]);
+			core::swap(centers[i], centers[mid]);
+			++mid;
+		}
+	}
+
+	// all centers in one place
+	if (mid == first || mid == end)
+		mid = first + count / 2;
+
+	const u32 child = Nodes.size();
+	Nodes.push_back(SNode());
+	Nodes.push_back(SNode());
+	Nodes[node].First = child;
+	Nodes[node].Count = 0;
+
+	buildNode(child, first, mid - first, depth + 1, centers);
+	buildNode(child + 1, mid, end - mid, depth + 1, centers);
+}
+
+
+//! returns if a ray hits any occluder before length
+bool CLightmapBaker::isOccluded(const core::vector3df& start, const core::vector3df& dir, f32 length) const
+{
+	if (Nodes.empty())
+		return false;
+
+	const core::vector3df invDir(
+		fabsf(dir.X) > 1e-20f ? 1.f / dir.X : 1e30f,
+		fabsf(dir.Y) > 1e-20f ? 1.f / dir.Y : 1e30f,
+		fabsf(dir.Z) > 1e-20f ? 1.f / dir.Z : 1e30f);
+
+	u32 stack[MaxDepth + 2];
+	u32 top = 0;
+	stack[top++] = 0;
+
+	while (top)
+	{
+		const SNode& node = Nodes[stack[--top]];
+
+		// slab test
+		f32 tNear = 0.f;
+		f32 tFar = length;
+		for (u32 a=0; a<3; ++a)
+		{
+			const f32 o = axisValue(start, a);
+			const f32 inv = axisValue(invDir, a);
+			f32 t0 = (axisValue(node.Box.MinEdge, a) - o) * inv;
+			f32 t1 = (axisValue(node.Box.MaxEdge, a) - o) * inv;
+			if (t0 > t1)
+				core::swap(t0, t1);
+			tNear = core::max_(tNear, t0);
+			tFar = core::min_(tFar, t1);
+		}
+		if (tNear > tFar)
+			continue;
+
+		if (!node.Count)
+		{
+			stack[top++] = node.First;
+			stack[top++] = node.First + 1;
+			continue;
+		}
+
+		// Moeller-Trumbore, any hit is enough
+		for (u32 i=node.First; i<node.First + node.Count; ++i)
+		{
+			const SOccluder& o = Occluders[i];
+			const core::vector3df p = dir.crossProduct(o.EdgeC);
+			const f32 det = o.EdgeB.dotProduct(p);
+			if (fabsf(det) < 1e-12f)
+				continue;
+
+			const f32 invDet = 1.f / det;
+			const core::vector3df s = start - o.A;
+			const f32 u = s.dotProduct(p) * invDet;
+			if (u < 0.f || u > 1.f)
+				continue;
+
+			const core::vector3df q = s.crossProduct(o.EdgeB);
+			const f32 v = dir.dotProduct(q) * invDet;
+			if (v < 0.f || u + v > 1.f)
+				continue;
+
+			const f32 t = o.EdgeC.dotProduct(q) * invDet;
+			if (t > 0.f && t < length)
+				return true;
+		}
+	}
+
+	return false;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,123 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_LIGHTMAP_BAKER_H_INCLUDED__
+#define __C_LIGHTMAP_BAKER_H_INCLUDED__
+
+#include "IMesh.h"
+#include "ITriangleSelector.h"
+#include "IVideoDriver.h"
+#include "SLight.h"
+#include "SLightmapBakeParameters.h"
+#include "irrArray.h"
+#include "aabbox3d.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! Bakes direct light and ambient occlusion of a mesh into a lightmap atlas
+	/** Used by ISceneManager::createLightmappedMesh(). The occluders are
+	put into a bounding volume hierarchy once, and the texels are lit on
+	the shared thread pool, which only reads the baker. */
+	class CLightmapBaker
+	{
+	public:
+
+		//! constructor
+		CLightmapBaker(video::IVideoDriver* driver, const SLightmapBakeParameters& parameters);
+
+		//! bakes the mesh, returns the new mesh or 0
+		IMesh* bake(IMesh* mesh, const core::matrix4& transform,
+			const core::array<video::SLight>& lights, ITriangleSelector* occluders);
+
+	private:
+
+		//! triangle of the mesh, the indices point into Positions and Normals
+		struct STriangle
+		{
+			u32 Buffer;
+			u32 Index[3];
+			u32 Chart;
+		};
+
+		//! connected triangles projected along one axis into the atlas
+		struct SChart
+		{
+			core::array<u32> Triangles;
+			u32 Axis;
+			f32 MinU, MinV, MaxU, MaxV;
+			u32 X, Y, Width, Height;
+		};
+
+		//! point on the surface lit for one texel
+		struct SSample
+		{
+			core::vector3df Pos;
+			core::vector3df Normal;
+			core::vector3df FaceNormal;
+			u32 Texel;
+		};
+
+		//! occluder prepared for ray tests
+		struct SOccluder
+		{
+			core::vector3df A, EdgeB, EdgeC;
+		};
+
+		//! node of the bounding volume hierarchy, leafs have a Count
+		struct SNode
+		{
+			core::aabbox3df Box;
+			u32 First;
+			u32 Count;
+		};
+
+		void collectTriangles(IMesh* mesh, const core::matrix4& transform);
+		void buildCharts();
+		bool packCharts(f32 texelsPerUnit);
+		void createSamples();
+		void dilate();
+		IMesh* createMesh(IMesh* mesh, video::ITexture* lightmap) const;
+
+		void buildHierarchy(ITriangleSelector* occluders);
+		void buildNode(u32 node, u32 first, u32 count, u32 depth, core::array<core::vector3df>& centers);
+		bool isOccluded(const core::vector3df& start, const core::vector3df& dir, f32 length) const;
+
+		//! returns the texel coordinates of a vertex in its chart
+		core::vector2df getTexelPos(const SChart& chart, u32 vertex) const;
+
+		//! lights the samples [begin,end), called on the thread pool
+		static void lightSamples(void* baker, u32 begin, u32 end);
+		video::SColorf lightSample(const SSample& sample, u32 index) const;
+
+		video::IVideoDriver* Driver;
+		SLightmapBakeParameters Parameters;
+		core::array<video::SLight> Lights;
+
+		core::array<core::vector3df> Positions;
+		core::array<core::vector3df> Normals;
+		core::array<u32> BufferStart;
+		core::array<STriangle> Triangles;
+		core::array<SChart> Charts;
+
+		core::array<SSample> Samples;
+		core::array<u32> Texels;
+		core::array<bool> Covered;
+		f32 TexelsPerUnit;
+		u32 AtlasHeight;
+
+		core::array<SOccluder> Occluders;
+		core::array<SNode> Nodes;
+		f32 RayOffset;
+		f32 OcclusionDistance;
+		f32 Scale;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -23,8 +23,12 @@ CLimitReadFile::CLimitReadFile(IReadFile* alreadyOpenedFile, long pos,
 	if (File)
 	{
 		File->grab();
-		AreaStart = pos;
-		AreaEnd = AreaStart + areaSize;
+
+		// truncated archives must not make the area reach past the file,
+		// reads and mapped data rely on it
+		const long fileSize = File->getSize();
+		AreaStart = core::clamp(pos, 0L, fileSize);
+		AreaEnd = core::clamp(pos + areaSize, AreaStart, fileSize);
 	}
 }
 
@@ -47,6 +51,16 @@ s32 CLimitReadFile::read(void* buffer, u32 sizeToRead)
 	s32 toRead = core::s32_min(AreaEnd, r + sizeToRead) - core::s32_max(AreaStart, r);
 	if (toRead < 0)
 		return 0;
+
+	// mapped files are copied directly, without moving the shared file position
+	const c8* data = (const c8*)File->getMappedData();
+	if (data)
+	{
+		memcpy(buffer, data + r, toRead);
+		Pos += toRead;
+		return toRead;
+	}
+
 	File->seek(r);
 	r = File->read(buffer, toRead);
 	Pos += r;
@@ -116,6 +130,14 @@ const io::path& CLimitReadFile::getFileName() const
 }
 
 
+//! returns the area of the file if the file is in memory
+const void* CLimitReadFile::getMappedData() const
+{
+	const c8* data = File ? (const c8*)File->getMappedData() : 0;
+	return data ? data + AreaStart : 0;
+}
+
+
 IReadFile* createLimitReadFile(const io::path& fileName, IReadFile* alreadyOpenedFile, long pos, long areaSize)
 {
 	return new CLimitReadFile(alreadyOpenedFile, pos, areaSize, fileName);
@@ -46,6 +46,9 @@ namespace io
 		//! returns name of file
 		virtual const io::path& getFileName() const;
 
+		//! returns the area of the file if the file is in memory
+		virtual const void* getMappedData() const;
+
 	private:
 
 		io::path Filename;
@@ -0,0 +1,190 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CMappedReadFile.h"
+
+#ifdef _IRR_COMPILE_WITH_MAPPED_FILES_
+
+#if defined(_IRR_WINDOWS_API_)
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace irr
+{
+namespace io
+{
+
+
+CMappedReadFile::CMappedReadFile(const io::path& fileName)
+: Data(0), FileSize(0), Pos(0), Filename(fileName)
+#ifdef _IRR_WINDOWS_API_
+, MappingHandle(0)
+#endif
+{
+	#ifdef _DEBUG
+	setDebugName("CMappedReadFile");
+	#endif
+
+	mapFile();
+}
+
+
+CMappedReadFile::~CMappedReadFile()
+{
+	if (!Data)
+		return;
+
+#ifdef _IRR_WINDOWS_API_
+	UnmapViewOfFile(Data);
+	CloseHandle((HANDLE)MappingHandle);
+#else
+	munmap((void*)Data, FileSize);
+#endif
+}
+
+
+//! returns how much was read
+s32 CMappedReadFile::read(void* buffer, u32 sizeToRead)
+{
+	if (!isOpen() || Pos >= FileSize)
+		return 0;
+
+	if ((long)sizeToRead > FileSize - Pos)
+		sizeToRead = (u32)(FileSize - Pos);
+
+	memcpy(buffer, Data + Pos, sizeToRead);
+	Pos += sizeToRead;
+	return (s32)sizeToRead;
+}
+
+
+//! changes position in file, returns true if successful
+//! if relativeMovement==true, the pos is changed relative to current pos,
+//! otherwise from begin of file
+bool CMappedReadFile::seek(long finalPos, bool relativeMovement)
+{
+	if (!isOpen())
+		return false;
+
+	if (relativeMovement)
+		finalPos += Pos;
+
+	// like fseek, positions behind the end are allowed
+	if (finalPos < 0)
+		return false;
+
+	Pos = finalPos;
+	return true;
+}
+
+
+//! returns size of file
+long CMappedReadFile::getSize() const
+{
+	return FileSize;
+}
+
+
+//! returns where in the file we are.
+long CMappedReadFile::getPos() const
+{
+	return Pos;
+}
+
+
+//! maps the file
+void CMappedReadFile::mapFile()
+{
+	if (Filename.size() == 0)
+		return;
+
+#if defined(_IRR_WINDOWS_API_)
+
+#if defined ( _IRR_WCHAR_FILESYSTEM )
+	HANDLE file = CreateFileW(Filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+#else
+	HANDLE file = CreateFileA(Filename.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+#endif
+	if (file == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER size;
+	// empty files can't be mapped, and larger files than long can't be addressed
+	if (GetFileSizeEx(file, &size) && size.QuadPart > 0 && size.QuadPart <= 0x7fffffff)
+	{
+		HANDLE mapping = CreateFileMapping(file, 0, PAGE_READONLY, 0, 0, 0);
+		if (mapping)
+		{
+			Data = (const c8*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if (Data)
+			{
+				FileSize = (long)size.QuadPart;
+				MappingHandle = mapping;
+			}
+			else
+				CloseHandle(mapping);
+		}
+	}
+
+	// the mapping keeps the file open
+	CloseHandle(file);
+
+#else
+
+	const int file = open(Filename.c_str(), O_RDONLY);
+	if (file < 0)
+		return;
+
+	struct stat info;
+	// empty files can't be mapped, directories neither
+	if (fstat(file, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0 &&
+		(long)info.st_size == info.st_size)
+	{
+		void* data = mmap(0, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (data != MAP_FAILED)
+		{
+			Data = (const c8*)data;
+			FileSize = (long)info.st_size;
+		}
+	}
+
+	// the mapping keeps the file open
+	close(file);
+
+#endif
+}
+
+
+//! returns name of file
+const io::path& CMappedReadFile::getFileName() const
+{
+	return Filename;
+}
+
+
+IReadFile* createMappedReadFile(const io::path& fileName)
+{
+	CMappedReadFile* file = new CMappedReadFile(fileName);
+	if (file->isOpen())
+		return file;
+
+	file->drop();
+	return 0;
+}
+
+
+} // end namespace io
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_MAPPED_FILES_
+
@@ -0,0 +1,84 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_MAPPED_READ_FILE_H_INCLUDED__
+#define __C_MAPPED_READ_FILE_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+
+#ifdef _IRR_COMPILE_WITH_MAPPED_FILES_
+
+#include "IReadFile.h"
+#include "irrString.h"
+
+namespace irr
+{
+
+namespace io
+{
+
+	/*!
+		Class for reading a real file from disk which is mapped into memory.
+		read() is a memcpy, and getMappedData() gives loaders and archives
+		direct access to the bytes.
+	*/
+	class CMappedReadFile : public IReadFile
+	{
+	public:
+
+		CMappedReadFile(const io::path& fileName);
+
+		virtual ~CMappedReadFile();
+
+		//! returns how much was read
+		virtual s32 read(void* buffer, u32 sizeToRead);
+
+		//! changes position in file, returns true if successful
+		virtual bool seek(long finalPos, bool relativeMovement = false);
+
+		//! returns size of file
+		virtual long getSize() const;
+
+		//! returns if the file is mapped
+		bool isOpen() const
+		{
+			return Data != 0;
+		}
+
+		//! returns where in the file we are.
+		virtual long getPos() const;
+
+		//! returns name of file
+		virtual const io::path& getFileName() const;
+
+		//! returns the mapped content of the file
+		virtual const void* getMappedData() const
+		{
+			return Data;
+		}
+
+	private:
+
+		//! maps the file
+		void mapFile();
+
+		const c8* Data;
+		long FileSize;
+		long Pos;
+		io::path Filename;
+#ifdef _IRR_WINDOWS_API_
+		void* MappingHandle;
+#endif
+	};
+
+	//! Internal function, returns 0 if the file can't be mapped
+	IReadFile* createMappedReadFile(const io::path& fileName);
+
+} // end namespace io
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_MAPPED_FILES_
+
+#endif
+
@@ -6,6 +6,7 @@
 #include "SMesh.h"
 #include "CMeshBuffer.h"
 #include "SAnimatedMesh.h"
+#include "CDynamicMeshBuffer.h"
 #include "os.h"
 #include "irrMap.h"
 
@@ -1074,6 +1075,503 @@ void CMeshManipulator::calculateTangents(
 
 
 
+//! Sum of squared distances to a set of planes, as symmetric 4x4 matrix
+struct SErrorQuadric
+{
+	SErrorQuadric() : Weight(0.0)
+	{
+		for (u32 i=0; i<10; ++i)
+			M[i] = 0.0;
+	}
+
+	void addPlane(f64 a, f64 b, f64 c, f64 d, f64 weight)
+	{
+		M[0] += weight*a*a; M[1] += weight*a*b; M[2] += weight*a*c; M[3] += weight*a*d;
+		M[4] += weight*b*b; M[5] += weight*b*c; M[6] += weight*b*d;
+		M[7] += weight*c*c; M[8] += weight*c*d;
+		M[9] += weight*d*d;
+		Weight += weight;
+	}
+
+	void add(const SErrorQuadric& other)
+	{
+		for (u32 i=0; i<10; ++i)
+			M[i] += other.M[i];
+		Weight += other.Weight;
+	}
+
+	f64 evaluate(const core::vector3df& p) const
+	{
+		const f64 x = p.X;
+		const f64 y = p.Y;
+		const f64 z = p.Z;
+		return M[0]*x*x + 2.0*M[1]*x*y + 2.0*M[2]*x*z + 2.0*M[3]*x +
+			M[4]*y*y + 2.0*M[5]*y*z + 2.0*M[6]*y +
+			M[7]*z*z + 2.0*M[8]*z + M[9];
+	}
+
+	f64 M[10];
+	//! sum of the weights of all planes
+	f64 Weight;
+};
+
+
+//! Moving vertex From onto vertex To
+struct SEdgeCollapse
+{
+	//! sum of the squared distances to the planes of both vertices
+	f64 Cost;
+	//! mean squared distance to these planes
+	f64 Error;
+	u32 From;
+	u32 To;
+	u32 FromStamp;
+	u32 ToStamp;
+};
+
+
+//! Vertex index sortable by position, to find vertices sharing a position
+struct SPositionRef
+{
+	core::vector3df Pos;
+	u32 Index;
+
+	bool operator<(const SPositionRef& other) const
+	{
+		if (Pos.X != other.Pos.X)
+			return Pos.X < other.Pos.X;
+		if (Pos.Y != other.Pos.Y)
+			return Pos.Y < other.Pos.Y;
+		if (Pos.Z != other.Pos.Z)
+			return Pos.Z < other.Pos.Z;
+		return Index < other.Index;
+	}
+};
+
+
+//! Finds vertices at exactly the same position
+void CMeshManipulator::weldPositions(const core::array<core::vector3df>& positions,
+		core::array<u32>& welded)
+{
+	core::array<SPositionRef> refs;
+	refs.set_used(positions.size());
+	for (u32 i=0; i<refs.size(); ++i)
+	{
+		refs[i].Pos = positions[i];
+		refs[i].Index = i;
+	}
+	// filled through set_used(), which keeps the array marked as sorted
+	refs.set_sorted(false);
+	refs.sort();
+
+	// equal positions are sorted by index, so the first of each run is the smallest
+	welded.set_used(positions.size());
+	for (u32 i=0; i<refs.size(); ++i)
+	{
+		if (i && refs[i].Pos == refs[i-1].Pos)
+			welded[refs[i].Index] = welded[refs[i-1].Index];
+		else
+			welded[refs[i].Index] = refs[i].Index;
+	}
+}
+
+
+//! Collects the edges of triangles, sorted so shared edges are next to each other
+void CMeshManipulator::getSortedEdges(const u32* triangles, u32 triangleCount,
+		const u32* remap, core::array<SEdgeRef>& edges)
+{
+	edges.set_used(triangleCount * 3);
+	for (u32 t=0; t<triangleCount; ++t)
+	{
+		for (u32 k=0; k<3; ++k)
+		{
+			u32 a = triangles[t*3+k];
+			u32 b = triangles[t*3+(k+1)%3];
+			if (remap)
+			{
+				a = remap[a];
+				b = remap[b];
+			}
+
+			SEdgeRef& e = edges[t*3+k];
+			e.A = core::min_(a, b);
+			e.B = core::max_(a, b);
+			e.Triangle = t;
+		}
+	}
+	edges.set_sorted(false);
+	edges.sort();
+}
+
+
+//! adds a collapse to a binary min heap
+static void pushCollapse(core::array<SEdgeCollapse>& heap, const SEdgeCollapse& c)
+{
+	heap.push_back(c);
+	u32 i = heap.size() - 1;
+	while (i)
+	{
+		const u32 parent = (i - 1) / 2;
+		if (heap[parent].Cost <= heap[i].Cost)
+			break;
+		core::swap(heap[parent], heap[i]);
+		i = parent;
+	}
+}
+
+
+//! removes the cheapest collapse from a binary min heap
+static SEdgeCollapse popCollapse(core::array<SEdgeCollapse>& heap)
+{
+	const SEdgeCollapse top = heap[0];
+	heap[0] = heap.getLast();
+	heap.erase(heap.size() - 1);
+
+	u32 i = 0;
+	const u32 size = heap.size();
+	while (true)
+	{
+		const u32 left = i * 2 + 1;
+		const u32 right = left + 1;
+		u32 smallest = i;
+		if (left < size && heap[left].Cost < heap[smallest].Cost)
+			smallest = left;
+		if (right < size && heap[right].Cost < heap[smallest].Cost)
+			smallest = right;
+		if (smallest == i)
+			break;
+		core::swap(heap[smallest], heap[i]);
+		i = smallest;
+	}
+	return top;
+}
+
+
+//! calculates the cost of a collapse from the quadrics of both vertices
+static void setCollapseCost(SEdgeCollapse& c, const SErrorQuadric& from,
+		const SErrorQuadric& to, const core::vector3df& pos)
+{
+	c.Cost = core::max_(0.0, from.evaluate(pos) + to.evaluate(pos));
+	c.Error = c.Cost / core::max_(from.Weight + to.Weight, 1.0);
+}
+
+
+//! Simplifies a single mesh buffer, returns the largest squared error of all collapses
+static f64 simplifyMeshBuffer(const IMeshBuffer* in, CDynamicMeshBuffer* out, f32 ratio, f64 maxErrorSQ)
+{
+	// weight of the planes keeping open borders in place
+	const f64 borderWeight = 10.0;
+
+	const u32 vertexCount = in->getVertexCount();
+	const u32 triangleCount = in->getIndexCount() / 3;
+
+	core::array<u32> triangles;
+	triangles.set_used(triangleCount * 3);
+	if (in->getIndexType() == video::EIT_16BIT)
+	{
+		const u16* indices = in->getIndices();
+		for (u32 i=0; i<triangles.size(); ++i)
+			triangles[i] = indices[i];
+	}
+	else
+	{
+		const u32* indices = (const u32*)in->getIndices();
+		for (u32 i=0; i<triangles.size(); ++i)
+			triangles[i] = indices[i];
+	}
+
+	core::array<core::vector3df> positions;
+	positions.set_used(vertexCount);
+	for (u32 i=0; i<vertexCount; ++i)
+		positions[i] = in->getPosition(i);
+
+	// vertices sharing their position with others must not move, or seams would open
+	core::array<bool> locked;
+	locked.set_used(vertexCount);
+	{
+		core::array<u32> welded;
+		CMeshManipulator::weldPositions(positions, welded);
+		for (u32 i=0; i<vertexCount; ++i)
+			locked[i] = false;
+		for (u32 i=0; i<vertexCount; ++i)
+		{
+			if (welded[i] != i)
+				locked[i] = locked[welded[i]] = true;
+		}
+	}
+
+	// quadrics of the triangle planes, and the triangles around each vertex
+	core::array<SErrorQuadric> quadrics;
+	quadrics.set_used(vertexCount);
+	for (u32 i=0; i<vertexCount; ++i)
+		quadrics[i] = SErrorQuadric();
+
+	core::array<core::array<u32> > vertexTriangles;
+	vertexTriangles.reallocate(vertexCount);
+	for (u32 i=0; i<vertexCount; ++i)
+		vertexTriangles.push_back(core::array<u32>());
+
+	core::array<bool> deadTriangle;
+	deadTriangle.set_used(triangleCount);
+
+	core::array<core::vector3df> faceNormals;
+	faceNormals.set_used(triangleCount);
+
+	for (u32 t=0; t<triangleCount; ++t)
+	{
+		const u32* tri = &triangles[t*3];
+		deadTriangle[t] = false;
+
+		core::vector3df normal = (positions[tri[1]] - positions[tri[0]]).crossProduct(
+			positions[tri[2]] - positions[tri[0]]);
+		normal.normalize();
+		faceNormals[t] = normal;
+		const f64 d = -normal.dotProduct(positions[tri[0]]);
+
+		for (u32 k=0; k<3; ++k)
+		{
+			quadrics[tri[k]].addPlane(normal.X, normal.Y, normal.Z, d, 1.0);
+			vertexTriangles[tri[k]].push_back(t);
+		}
+	}
+
+	// edges used by a single triangle are borders, add planes perpendicular to them
+	{
+		core::array<CMeshManipulator::SEdgeRef> edges;
+		CMeshManipulator::getSortedEdges(triangles.const_pointer(), triangleCount, 0, edges);
+
+		for (u32 i=0; i<edges.size(); ++i)
+		{
+			const bool shared = (i > 0 && edges[i].A == edges[i-1].A && edges[i].B == edges[i-1].B) ||
+				(i+1 < edges.size() && edges[i].A == edges[i+1].A && edges[i].B == edges[i+1].B);
+			if (shared)
+				continue;
+
+			core::vector3df normal = (positions[edges[i].B] - positions[edges[i].A]).crossProduct(
+				faceNormals[edges[i].Triangle]);
+			normal.normalize();
+			const f64 d = -normal.dotProduct(positions[edges[i].A]);
+			quadrics[edges[i].A].addPlane(normal.X, normal.Y, normal.Z, d, borderWeight);
+			quadrics[edges[i].B].addPlane(normal.X, normal.Y, normal.Z, d, borderWeight);
+		}
+	}
+
+	core::array<u32> stamps;
+	stamps.set_used(vertexCount);
+	core::array<bool> removed;
+	removed.set_used(vertexCount);
+	for (u32 i=0; i<vertexCount; ++i)
+	{
+		stamps[i] = 0;
+		removed[i] = false;
+	}
+
+	// all possible collapses along the edges
+	core::array<SEdgeCollapse> heap;
+	heap.reallocate(triangleCount * 6);
+	for (u32 t=0; t<triangleCount; ++t)
+	{
+		for (u32 k=0; k<3; ++k)
+		{
+			const u32 a = triangles[t*3+k];
+			const u32 b = triangles[t*3+(k+1)%3];
+			for (u32 dir=0; dir<2; ++dir)
+			{
+				SEdgeCollapse c;
+				c.From = dir ? b : a;
+				c.To = dir ? a : b;
+				if (locked[c.From])
+					continue;
+				setCollapseCost(c, quadrics[c.From], quadrics[c.To], positions[c.To]);
+				c.FromStamp = c.ToStamp = 0;
+				pushCollapse(heap, c);
+			}
+		}
+	}
+
+	const u32 targetCount = core::min_(triangleCount,
+		(u32)core::round32(triangleCount * core::clamp(ratio, 0.f, 1.f)));
+	u32 liveCount = triangleCount;
+	f64 maxError = 0.0;
+
+	while (liveCount > targetCount && !heap.empty())
+	{
+		const SEdgeCollapse c = popCollapse(heap);
+
+		if (removed[c.From] || removed[c.To] ||
+			stamps[c.From] != c.FromStamp || stamps[c.To] != c.ToStamp)
+			continue;
+
+		if (c.Error > maxErrorSQ)
+			continue;
+
+		// the triangles which stay must not flip or degenerate
+		const core::array<u32>& fromTriangles = vertexTriangles[c.From];
+		bool valid = true;
+		for (u32 i=0; i<fromTriangles.size() && valid; ++i)
+		{
+			const u32 t = fromTriangles[i];
+			if (deadTriangle[t])
+				continue;
+
+			const u32* tri = &triangles[t*3];
+			if (tri[0] == c.To || tri[1] == c.To || tri[2] == c.To)
+				continue;
+
+			core::vector3df p[3];
+			for (u32 k=0; k<3; ++k)
+				p[k] = positions[tri[k]];
+			const core::vector3df before = (p[1] - p[0]).crossProduct(p[2] - p[0]);
+
+			for (u32 k=0; k<3; ++k)
+				if (tri[k] == c.From)
+					p[k] = positions[c.To];
+			const core::vector3df after = (p[1] - p[0]).crossProduct(p[2] - p[0]);
+
+			if (after.dotProduct(before) <= 0.f || after.getLengthSQ() <= before.getLengthSQ() * 1e-6f)
+				valid = false;
+		}
+
+		if (!valid)
+			continue;
+
+		// move the triangles over to the remaining vertex
+		core::array<u32>& toTriangles = vertexTriangles[c.To];
+		for (u32 i=0; i<fromTriangles.size(); ++i)
+		{
+			const u32 t = fromTriangles[i];
+			if (deadTriangle[t])
+				continue;
+
+			u32* tri = &triangles[t*3];
+			if (tri[0] == c.To || tri[1] == c.To || tri[2] == c.To)
+			{
+				deadTriangle[t] = true;
+				--liveCount;
+				continue;
+			}
+
+			for (u32 k=0; k<3; ++k)
+				if (tri[k] == c.From)
+					tri[k] = c.To;
+			toTriangles.push_back(t);
+		}
+
+		vertexTriangles[c.From].clear();
+		removed[c.From] = true;
+		quadrics[c.To].add(quadrics[c.From]);
+		++stamps[c.To];
+		maxError = core::max_(maxError, c.Error);
+
+		// drop the dead triangles and requeue the collapses around the remaining vertex
+		u32 kept = 0;
+		for (u32 i=0; i<toTriangles.size(); ++i)
+		{
+			const u32 t = toTriangles[i];
+			if (deadTriangle[t])
+				continue;
+			toTriangles[kept++] = t;
+
+			for (u32 k=0; k<3; ++k)
+			{
+				const u32 other = triangles[t*3+k];
+				if (other == c.To)
+					continue;
+
+				for (u32 dir=0; dir<2; ++dir)
+				{
+					SEdgeCollapse n;
+					n.From = dir ? other : c.To;
+					n.To = dir ? c.To : other;
+					if (locked[n.From])
+						continue;
+					setCollapseCost(n, quadrics[n.From], quadrics[n.To], positions[n.To]);
+					n.FromStamp = stamps[n.From];
+					n.ToStamp = stamps[n.To];
+					pushCollapse(heap, n);
+				}
+			}
+		}
+		toTriangles.set_used(kept);
+	}
+
+	// copy the used vertices in their original order
+	core::array<u32> remap;
+	remap.set_used(vertexCount);
+	for (u32 i=0; i<vertexCount; ++i)
+		remap[i] = 0xFFFFFFFF;
+
+	u32 usedCount = 0;
+	for (u32 t=0; t<triangleCount; ++t)
+	{
+		if (deadTriangle[t])
+			continue;
+		for (u32 k=0; k<3; ++k)
+			remap[triangles[t*3+k]] = 0;
+	}
+	for (u32 i=0; i<vertexCount; ++i)
+		if (remap[i] == 0)
+			remap[i] = usedCount++;
+
+	out->getIndexBuffer().setType(usedCount > 65536 ? video::EIT_32BIT : video::EIT_16BIT);
+	out->getVertexBuffer().set_used(usedCount);
+
+	const u32 pitch = video::getVertexPitchFromType(in->getVertexType());
+	const u8* source = (const u8*)in->getVertices();
+	u8* target = (u8*)out->getVertexBuffer().pointer();
+	for (u32 i=0; i<vertexCount; ++i)
+	{
+		if (remap[i] != 0xFFFFFFFF)
+			memcpy(target + remap[i] * pitch, source + i * pitch, pitch);
+	}
+
+	out->getIndexBuffer().set_used(liveCount * 3);
+	u32 index = 0;
+	for (u32 t=0; t<triangleCount; ++t)
+	{
+		if (deadTriangle[t])
+			continue;
+		for (u32 k=0; k<3; ++k)
+			out->getIndexBuffer().setValue(index++, remap[triangles[t*3+k]]);
+	}
+
+	out->getMaterial() = in->getMaterial();
+	out->setHardwareMappingHint(in->getHardwareMappingHint_Vertex(), EBT_VERTEX);
+	out->setHardwareMappingHint(in->getHardwareMappingHint_Index(), EBT_INDEX);
+	out->recalculateBoundingBox();
+
+	return maxError;
+}
+
+
+//! Creates a copy of a mesh with fewer triangles, using quadric error metrics
+IMesh* CMeshManipulator::createMeshSimplified(IMesh* mesh, f32 ratio, f32 maxError, f32* error) const
+{
+	if (!mesh)
+		return 0;
+
+	SMesh* clone = new SMesh();
+	const f64 maxErrorSQ = maxError < FLT_MAX ? (f64)maxError * maxError : 1e300;
+	f64 largestError = 0.0;
+
+	for (u32 b=0; b<mesh->getMeshBufferCount(); ++b)
+	{
+		const IMeshBuffer* mb = mesh->getMeshBuffer(b);
+		CDynamicMeshBuffer* buffer = new CDynamicMeshBuffer(mb->getVertexType(), video::EIT_16BIT);
+		largestError = core::max_(largestError, simplifyMeshBuffer(mb, buffer, ratio, maxErrorSQ));
+		clone->addMeshBuffer(buffer);
+		buffer->drop();
+	}
+
+	clone->recalculateBoundingBox();
+
+	if (error)
+		*error = (f32)sqrt(largestError);
+
+	return clone;
+}
+
+
 //! Returns amount of polygons in mesh.
 s32 CMeshManipulator::getPolyCount(scene::IMesh* mesh) const
 {
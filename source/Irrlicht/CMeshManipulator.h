@@ -69,6 +69,10 @@ public:
 	//! Creates a copy of the mesh, which will have all duplicated vertices removed, i.e. maximal amount of vertices are shared via indexing.
 	virtual IMesh* createMeshWelded(IMesh *mesh, f32 tolerance=core::ROUNDING_ERROR_f32) const;
 
+	//! Creates a copy of a mesh with fewer triangles, using quadric error metrics
+	virtual IMesh* createMeshSimplified(IMesh* mesh, f32 ratio,
+		f32 maxError=FLT_MAX, f32* error=0) const;
+
 	//! Returns amount of polygons in mesh.
 	virtual s32 getPolyCount(scene::IMesh* mesh) const;
 
@@ -78,6 +82,39 @@ public:
 	//! create a new AnimatedMesh and adds the mesh to it
 	virtual IAnimatedMesh * createAnimatedMesh(scene::IMesh* mesh,scene::E_ANIMATED_MESH_TYPE type) const;
 
+	//! Undirected edge of a triangle, sortable by its vertices
+	struct SEdgeRef
+	{
+		//! smaller and larger vertex index
+		u32 A, B;
+		u32 Triangle;
+
+		bool operator<(const SEdgeRef& other) const
+		{
+			if (A != other.A)
+				return A < other.A;
+			if (B != other.B)
+				return B < other.B;
+			return Triangle < other.Triangle;
+		}
+	};
+
+	//! Finds vertices at exactly the same position
+	/** \param positions Positions of the vertices.
+	\param welded Receives for each vertex the smallest index of all
+	vertices at its position. */
+	static void weldPositions(const core::array<core::vector3df>& positions,
+		core::array<u32>& welded);
+
+	//! Collects the edges of triangles, sorted so shared edges are next to each other
+	/** \param triangles Three vertex indices per triangle.
+	\param triangleCount Amount of triangles.
+	\param remap Optional replacement for each vertex index, e.g. the
+	result of weldPositions(), or 0.
+	\param edges Receives three edges per triangle. */
+	static void getSortedEdges(const u32* triangles, u32 triangleCount,
+		const u32* remap, core::array<SEdgeRef>& edges);
+
 private:
 
 	static void calculateTangents(core::vector3df& normal, 
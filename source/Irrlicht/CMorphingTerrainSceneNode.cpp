@@ -0,0 +1,487 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CMorphingTerrainSceneNode.h"
+#include "IVideoDriver.h"
+#include "ISceneManager.h"
+#include "ICameraSceneNode.h"
+#include "SViewFrustum.h"
+#include "IAttributes.h"
+#include "SMesh.h"
+#include "CDynamicMeshBuffer.h"
+#include "irrMath.h"
+
+namespace irr
+{
+namespace scene
+{
+
+	//! vertices start to morph after this part of the range of their level
+	static const f32 MORPH_START_RATIO = 0.66f;
+
+
+	//! returns the squared distance of a point to a box, 0 if it is inside
+	static f32 getDistanceSQ(const core::aabbox3df& box, const core::vector3df& p)
+	{
+		const f32 dx = core::max_(box.MinEdge.X - p.X, 0.f, p.X - box.MaxEdge.X);
+		const f32 dy = core::max_(box.MinEdge.Y - p.Y, 0.f, p.Y - box.MaxEdge.Y);
+		const f32 dz = core::max_(box.MinEdge.Z - p.Z, 0.f, p.Z - box.MaxEdge.Z);
+		return dx*dx + dy*dy + dz*dz;
+	}
+
+
+	//! constructor
+	CMorphingTerrainSceneNode::CMorphingTerrainSceneNode(ISceneNode* parent, ISceneManager* mgr,
+			io::IFileSystem* fs, s32 id, E_TERRAIN_PATCH_SIZE patchSize, f32 screenSpaceError,
+			const core::vector3df& position,
+			const core::vector3df& rotation,
+			const core::vector3df& scale)
+	: CTerrainSceneNode(parent, mgr, fs, id, 4, patchSize, position, rotation, scale),
+	MorphBuffer(0), MorphIndicesToRender(0), ScreenSpaceError(1.f), QuadtreeRevision(0),
+	LastCameraFOV(0.f), Rebuild(true)
+	{
+		#ifdef _DEBUG
+		setDebugName("CMorphingTerrainSceneNode");
+		#endif
+
+		setScreenSpaceError(screenSpaceError);
+
+		// the geometry changes whenever the camera moves
+		MorphBuffer = new CDynamicMeshBuffer(video::EVT_2TCOORDS, video::EIT_32BIT);
+		MorphBuffer->setHardwareMappingHint(scene::EHM_STREAM);
+	}
+
+
+	//! destructor
+	CMorphingTerrainSceneNode::~CMorphingTerrainSceneNode()
+	{
+		if (MorphBuffer)
+			MorphBuffer->drop();
+	}
+
+
+	//! Sets the length of a grid edge in pixels at which the next coarser level is used.
+	void CMorphingTerrainSceneNode::setScreenSpaceError(f32 pixels)
+	{
+		ScreenSpaceError = core::max_(pixels, 0.1f);
+		Rebuild = true;
+	}
+
+
+	//! Selects the chunks and morphs their vertices if the camera moved
+	void CMorphingTerrainSceneNode::OnRegisterSceneNode()
+	{
+		ICameraSceneNode* camera = SceneManager->getActiveCamera();
+		if (!IsVisible || !camera)
+			return;
+
+		if (Paging)
+			updatePaging();
+
+		if (TerrainData.Size < 2)
+			return;
+
+		SceneManager->registerNodeForRendering(this);
+
+		if (NodeBoxes.empty() || QuadtreeRevision != GeometryRevision)
+		{
+			buildQuadtree();
+			QuadtreeRevision = GeometryRevision;
+			Rebuild = true;
+		}
+
+		const core::vector3df cameraPosition = camera->getAbsolutePosition();
+		const core::vector3df cameraTarget = camera->getTarget();
+		const f32 cameraFOV = camera->getFOV();
+
+		// the morphing is continuous, so every movement of the camera counts
+		if (Rebuild || ForceRecalculation ||
+			cameraPosition != LastCameraPosition ||
+			cameraTarget != LastCameraTarget ||
+			cameraFOV != LastCameraFOV)
+		{
+			LastCameraPosition = cameraPosition;
+			LastCameraTarget = cameraTarget;
+			LastCameraFOV = cameraFOV;
+			Rebuild = false;
+
+			calculateRanges(camera);
+
+			Chunks.set_used(0);
+			const s32 top = NodeCount.size() - 1;
+			for (s32 x = 0; x < NodeCount[top]; ++x)
+				for (s32 z = 0; z < NodeCount[top]; ++z)
+					selectNode(top, x, z, *camera->getViewFrustum(), cameraPosition);
+
+			buildGeometry(cameraPosition);
+		}
+
+		ISceneNode::OnRegisterSceneNode();
+		ForceRecalculation = false;
+	}
+
+
+	//! Render the scene node
+	void CMorphingTerrainSceneNode::render()
+	{
+		if (!IsVisible || !SceneManager->getActiveCamera())
+			return;
+
+		if (!Mesh->getMeshBufferCount() || !MorphIndicesToRender)
+			return;
+
+		video::IVideoDriver* driver = SceneManager->getVideoDriver();
+
+		driver->setTransform(video::ETS_WORLD, core::IdentityMatrix);
+		driver->setMaterial(Mesh->getMeshBuffer(0)->getMaterial());
+
+		driver->drawMeshBuffer(MorphBuffer);
+
+		// for debug purposes only:
+		if (DebugDataVisible)
+		{
+			video::SMaterial m;
+			m.Lighting = false;
+			driver->setMaterial(m);
+			if (DebugDataVisible & scene::EDS_BBOX)
+				driver->draw3DBox(TerrainData.BoundingBox, video::SColor(255,255,255,255));
+
+			if (DebugDataVisible & scene::EDS_BBOX_BUFFERS)
+			{
+				// a chunk covers the area of a node of its level, or of one of its children
+				for (u32 i = 0; i < Chunks.size(); ++i)
+				{
+					const SChunk& chunk = Chunks[i];
+					const s32 level = chunk.Quads < TerrainData.CalcPatchSize ? chunk.Level - 1 : chunk.Level;
+					const s32 size = TerrainData.CalcPatchSize << level;
+					driver->draw3DBox(getNodeBox(level, chunk.X / size, chunk.Z / size),
+						video::SColor(255, 255, 0, 0));
+				}
+			}
+		}
+	}
+
+
+	//! calculates the bounding boxes of all quadtree nodes
+	void CMorphingTerrainSceneNode::buildQuadtree()
+	{
+		const s32 size = TerrainData.Size;
+		const s32 quads = size - 1;
+		const s32 chunkQuads = TerrainData.CalcPatchSize;
+		const video::S3DVertex2TCoords* vertices =
+			static_cast<const video::S3DVertex2TCoords*>(RenderBuffer->getVertices());
+
+		NodeBoxes.clear();
+		NodeCount.clear();
+		NodeDiagonal.clear();
+
+		// level 0 is made of chunks of the patch size
+		s32 count = (quads + chunkQuads - 1) / chunkQuads;
+		NodeCount.push_back(count);
+		NodeBoxes.push_back(core::array<core::aabbox3df>());
+		NodeBoxes[0].reallocate(count * count);
+		f32 diagonal = 0.f;
+
+		for (s32 nx = 0; nx < count; ++nx)
+		{
+			for (s32 nz = 0; nz < count; ++nz)
+			{
+				const s32 endX = core::min_(nx * chunkQuads + chunkQuads, quads);
+				const s32 endZ = core::min_(nz * chunkQuads + chunkQuads, quads);
+
+				core::aabbox3df box(vertices[nx * chunkQuads * size + nz * chunkQuads].Pos);
+				for (s32 x = nx * chunkQuads; x <= endX; ++x)
+					for (s32 z = nz * chunkQuads; z <= endZ; ++z)
+						box.addInternalPoint(vertices[x * size + z].Pos);
+
+				NodeBoxes[0].push_back(box);
+				diagonal = core::max_(diagonal, box.getExtent().getLength());
+			}
+		}
+		NodeDiagonal.push_back(diagonal);
+
+		// each coarser level merges four nodes, until one node covers the terrain
+		for (s32 level = 1; count > 1; ++level)
+		{
+			const s32 childCount = count;
+			count = (count + 1) / 2;
+			NodeCount.push_back(count);
+			NodeBoxes.push_back(core::array<core::aabbox3df>());
+			NodeBoxes[level].reallocate(count * count);
+			diagonal = 0.f;
+
+			for (s32 nx = 0; nx < count; ++nx)
+			{
+				for (s32 nz = 0; nz < count; ++nz)
+				{
+					core::aabbox3df box = getNodeBox(level - 1, nx * 2, nz * 2);
+					if (nx * 2 + 1 < childCount)
+						box.addInternalBox(getNodeBox(level - 1, nx * 2 + 1, nz * 2));
+					if (nz * 2 + 1 < childCount)
+						box.addInternalBox(getNodeBox(level - 1, nx * 2, nz * 2 + 1));
+					if (nx * 2 + 1 < childCount && nz * 2 + 1 < childCount)
+						box.addInternalBox(getNodeBox(level - 1, nx * 2 + 1, nz * 2 + 1));
+
+					NodeBoxes[level].push_back(box);
+					diagonal = core::max_(diagonal, box.getExtent().getLength());
+				}
+			}
+			NodeDiagonal.push_back(diagonal);
+		}
+
+		Ranges.set_used(NodeCount.size());
+		MorphStart.set_used(NodeCount.size());
+	}
+
+
+	//! calculates the distance ranges of the levels for the camera
+	void CMorphingTerrainSceneNode::calculateRanges(const ICameraSceneNode* camera)
+	{
+		const s32 size = TerrainData.Size;
+		const video::S3DVertex2TCoords* vertices =
+			static_cast<const video::S3DVertex2TCoords*>(RenderBuffer->getVertices());
+
+		// horizontal distance between two samples in world space
+		core::vector3df stepX = vertices[size].Pos - vertices[0].Pos;
+		core::vector3df stepZ = vertices[1].Pos - vertices[0].Pos;
+		stepX.Y = stepZ.Y = 0.f;
+		const f32 spacing = core::max_(stepX.getLength(), stepZ.getLength());
+
+		// a grid edge of level 0 appears ScreenSpaceError pixels long at this distance
+		const f32 screenHeight = (f32)SceneManager->getVideoDriver()->getCurrentRenderTargetSize().Height;
+		const f32 range0 = spacing * screenHeight /
+			(2.f * tanf(camera->getFOV() * 0.5f) * ScreenSpaceError);
+
+		const u32 levels = Ranges.size();
+		for (u32 level = 0; level < levels; ++level)
+		{
+			f32 range = range0 * (f32)(1 << level);
+			f32 previous = 0.f;
+
+			// The chunks of a level have to be fully morphed where the next
+			// coarser level starts, and must not morph yet where the next
+			// finer level ends. Both hold if the ranges at least double and
+			// the morph zone is longer than a chunk of the finer level.
+			if (level > 0)
+			{
+				previous = Ranges[level - 1];
+				range = core::max_(range, previous * 2.f,
+					previous + NodeDiagonal[level - 1] / MORPH_START_RATIO);
+			}
+
+			if (level == levels - 1)
+			{
+				// the root is used everywhere else and never morphs
+				Ranges[level] = FLT_MAX;
+				MorphStart[level] = FLT_MAX;
+			}
+			else
+			{
+				Ranges[level] = range;
+				MorphStart[level] = previous + (range - previous) * MORPH_START_RATIO;
+			}
+		}
+	}
+
+
+	//! selects the chunks of a quadtree node and its children
+	void CMorphingTerrainSceneNode::selectNode(s32 level, s32 nodeX, s32 nodeZ,
+			const SViewFrustum& frustum, const core::vector3df& cameraPosition)
+	{
+		const core::aabbox3df& box = getNodeBox(level, nodeX, nodeZ);
+		if (!frustum.intersectsBox(box))
+			return;
+
+		const s32 size = TerrainData.CalcPatchSize << level;
+
+		// the whole node is drawn at this level if no part of it is close enough for the finer one
+		if (level == 0 || getDistanceSQ(box, cameraPosition) > Ranges[level - 1] * Ranges[level - 1])
+		{
+			addChunk(nodeX * size, nodeZ * size, TerrainData.CalcPatchSize, level);
+			return;
+		}
+
+		// otherwise the children decide, those out of range are drawn as quarters of this node
+		const s32 childCount = NodeCount[level - 1];
+		const f32 childRangeSQ = Ranges[level - 1] * Ranges[level - 1];
+		for (s32 x = nodeX * 2; x < core::min_(nodeX * 2 + 2, childCount); ++x)
+		{
+			for (s32 z = nodeZ * 2; z < core::min_(nodeZ * 2 + 2, childCount); ++z)
+			{
+				const core::aabbox3df& childBox = getNodeBox(level - 1, x, z);
+				if (getDistanceSQ(childBox, cameraPosition) > childRangeSQ)
+				{
+					if (frustum.intersectsBox(childBox))
+						addChunk(x * (size / 2), z * (size / 2), TerrainData.CalcPatchSize / 2, level);
+				}
+				else
+					selectNode(level - 1, x, z, frustum, cameraPosition);
+			}
+		}
+	}
+
+
+	//! adds a chunk covering quads*quads grid cells of a level
+	void CMorphingTerrainSceneNode::addChunk(s32 x, s32 z, s32 quads, s32 level)
+	{
+		if (x >= TerrainData.Size - 1 || z >= TerrainData.Size - 1)
+			return;
+
+		SChunk chunk;
+		chunk.X = x;
+		chunk.Z = z;
+		chunk.Quads = quads;
+		chunk.Level = level;
+		Chunks.push_back(chunk);
+	}
+
+
+	//! writes the morphed vertices and the indices of all selected chunks
+	void CMorphingTerrainSceneNode::buildGeometry(const core::vector3df& cameraPosition)
+	{
+		const s32 size = TerrainData.Size;
+		const s32 last = size - 1;
+		const s32 topLevel = NodeCount.size() - 1;
+		const video::S3DVertex2TCoords* source =
+			static_cast<const video::S3DVertex2TCoords*>(RenderBuffer->getVertices());
+
+		// chunks at the far borders may be cut off
+		u32 vertexCount = 0;
+		u32 indexCount = 0;
+		for (u32 i = 0; i < Chunks.size(); ++i)
+		{
+			const s32 step = 1 << Chunks[i].Level;
+			const s32 quadsX = core::min_(Chunks[i].Quads, (last - Chunks[i].X + step - 1) / step);
+			const s32 quadsZ = core::min_(Chunks[i].Quads, (last - Chunks[i].Z + step - 1) / step);
+			vertexCount += (quadsX + 1) * (quadsZ + 1);
+			indexCount += quadsX * quadsZ * 6;
+		}
+
+		MorphBuffer->getVertexBuffer().set_used(vertexCount);
+		MorphBuffer->getIndexBuffer().set_used(indexCount);
+		video::S3DVertex2TCoords* vertices =
+			static_cast<video::S3DVertex2TCoords*>(MorphBuffer->getVertexBuffer().pointer());
+		u32* indices = static_cast<u32*>(MorphBuffer->getIndexBuffer().pointer());
+
+		u32 base = 0;
+		for (u32 c = 0; c < Chunks.size(); ++c)
+		{
+			const SChunk& chunk = Chunks[c];
+			const s32 step = 1 << chunk.Level;
+			const s32 quadsX = core::min_(chunk.Quads, (last - chunk.X + step - 1) / step);
+			const s32 quadsZ = core::min_(chunk.Quads, (last - chunk.Z + step - 1) / step);
+			const bool morph = chunk.Level < topLevel;
+			const f32 morphStart = MorphStart[chunk.Level];
+			const f32 morphScale = morph ? 1.f / (Ranges[chunk.Level] - morphStart) : 0.f;
+
+			// Vertices on odd positions of the grid of this level move onto
+			// the edges of the next coarser grid. Its quads are split along
+			// the same diagonal, so a fully morphed chunk matches the coarser
+			// level exactly.
+			video::S3DVertex2TCoords* out = vertices + base;
+			for (s32 i = 0; i <= quadsX; ++i)
+			{
+				const s32 gx = core::min_(chunk.X + i * step, last);
+				const bool oddX = ((gx / step) & 1) && gx + step <= last;
+
+				for (s32 j = 0; j <= quadsZ; ++j, ++out)
+				{
+					const s32 gz = core::min_(chunk.Z + j * step, last);
+					const video::S3DVertex2TCoords& v = source[gx * size + gz];
+					*out = v;
+
+					if (!morph)
+						continue;
+
+					const bool oddZ = ((gz / step) & 1) && gz + step <= last;
+					if (!oddX && !oddZ)
+						continue;
+
+					const f32 distance = v.Pos.getDistanceFrom(cameraPosition);
+					if (distance <= morphStart)
+						continue;
+
+					const f32 k = core::min_((distance - morphStart) * morphScale, 1.f);
+					const video::S3DVertex2TCoords& a = source[(oddX ? gx - step : gx) * size + (oddZ ? gz - step : gz)];
+					const video::S3DVertex2TCoords& b = source[(oddX ? gx + step : gx) * size + (oddZ ? gz + step : gz)];
+
+					out->Pos += ((a.Pos + b.Pos) * 0.5f - v.Pos) * k;
+					out->Normal += ((a.Normal + b.Normal) * 0.5f - v.Normal) * k;
+					out->TCoords += ((a.TCoords + b.TCoords) * 0.5f - v.TCoords) * k;
+					out->TCoords2 += ((a.TCoords2 + b.TCoords2) * 0.5f - v.TCoords2) * k;
+				}
+			}
+
+			// same triangle layout as the patches of CTerrainSceneNode
+			const u32 row = quadsZ + 1;
+			for (s32 i = 0; i < quadsX; ++i)
+			{
+				for (s32 j = 0; j < quadsZ; ++j)
+				{
+					const u32 index11 = base + i * row + j;
+					const u32 index21 = index11 + 1;
+					const u32 index12 = index11 + row;
+					const u32 index22 = index12 + 1;
+
+					*indices++ = index12;
+					*indices++ = index11;
+					*indices++ = index22;
+					*indices++ = index22;
+					*indices++ = index11;
+					*indices++ = index21;
+				}
+			}
+
+			base += (quadsX + 1) * row;
+		}
+
+		MorphIndicesToRender = indexCount;
+		MorphBuffer->setDirty();
+	}
+
+
+	//! Writes attributes of the scene node.
+	void CMorphingTerrainSceneNode::serializeAttributes(io::IAttributes* out,
+				io::SAttributeReadWriteOptions* options) const
+	{
+		CTerrainSceneNode::serializeAttributes(out, options);
+
+		out->addFloat("ScreenSpaceError", ScreenSpaceError);
+	}
+
+
+	//! Reads attributes of the scene node.
+	void CMorphingTerrainSceneNode::deserializeAttributes(io::IAttributes* in,
+			io::SAttributeReadWriteOptions* options)
+	{
+		if (in->existsAttribute("ScreenSpaceError"))
+			setScreenSpaceError(in->getAttributeAsFloat("ScreenSpaceError"));
+
+		CTerrainSceneNode::deserializeAttributes(in, options);
+	}
+
+
+	//! Creates a clone of this scene node and its children.
+	ISceneNode* CMorphingTerrainSceneNode::clone(ISceneNode* newParent, ISceneManager* newManager)
+	{
+		if (!newParent)
+			newParent = Parent;
+		if (!newManager)
+			newManager = SceneManager;
+
+		CMorphingTerrainSceneNode* nb = new CMorphingTerrainSceneNode(
+			newParent, newManager, FileSystem, ID,
+			(E_TERRAIN_PATCH_SIZE)TerrainData.PatchSize, ScreenSpaceError,
+			getPosition(), getRotation(), getScale());
+
+		nb->cloneTerrain(this, newManager);
+
+		if ( newParent )
+			nb->drop();
+		return nb;
+	}
+
+} // end namespace scene
+} // end namespace irr
+
@@ -0,0 +1,131 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_MORPHING_TERRAIN_SCENE_NODE_H__
+#define __C_MORPHING_TERRAIN_SCENE_NODE_H__
+
+#include "CTerrainSceneNode.h"
+
+namespace irr
+{
+namespace scene
+{
+	class ICameraSceneNode;
+
+	//! A terrain scene node using continuous distance dependent LOD (CDLOD) with vertex morphing.
+	/** The heightmap is loaded just like in CTerrainSceneNode, but it is
+	rendered from a quadtree of chunks with the patch size as resolution.
+	Each level of the quadtree is used within a distance range derived
+	from the allowed screen space error, and vertices morph smoothly into
+	the next coarser level before the switch, so there is no popping and
+	no stitching. The morphing is done on the CPU each time the camera
+	moves, so it works on all drivers. Since the ranges double with each
+	level, the number of triangles only depends on the error and the
+	number of levels, not on the size of the terrain. */
+	class CMorphingTerrainSceneNode : public CTerrainSceneNode
+	{
+	public:
+
+		//! constructor
+		//! \param screenSpaceError: Length of a grid edge in pixels at which the next coarser level is used.
+		CMorphingTerrainSceneNode(ISceneNode* parent, ISceneManager* mgr, io::IFileSystem* fs, s32 id,
+			E_TERRAIN_PATCH_SIZE patchSize = ETPS_17, f32 screenSpaceError = 4.f,
+			const core::vector3df& position = core::vector3df(0.0f, 0.0f, 0.0f),
+			const core::vector3df& rotation = core::vector3df(0.0f, 0.0f, 0.0f),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f));
+
+		virtual ~CMorphingTerrainSceneNode();
+
+		//! Selects the chunks and morphs their vertices if the camera moved
+		virtual void OnRegisterSceneNode();
+
+		//! Render the scene node
+		virtual void render();
+
+		//! Return the number of indices currently used to draw the scene node.
+		virtual u32 getIndexCount() const { return MorphIndicesToRender; }
+
+		//! Sets the length of a grid edge in pixels at which the next coarser level is used.
+		void setScreenSpaceError(f32 pixels);
+
+		//! Returns type of the scene node
+		virtual ESCENE_NODE_TYPE getType() const {return ESNT_MORPHING_TERRAIN;}
+
+		//! Writes attributes of the scene node.
+		virtual void serializeAttributes(io::IAttributes* out,
+				io::SAttributeReadWriteOptions* options=0) const;
+
+		//! Reads attributes of the scene node.
+		virtual void deserializeAttributes(io::IAttributes* in,
+				io::SAttributeReadWriteOptions* options=0);
+
+		//! Creates a clone of this scene node and its children.
+		virtual ISceneNode* clone(ISceneNode* newParent,
+				ISceneManager* newManager);
+
+	private:
+
+		//! part of the grid drawn at one level
+		struct SChunk
+		{
+			s32 X;
+			s32 Z;
+			s32 Quads;
+			s32 Level;
+		};
+
+		//! calculates the bounding boxes of all quadtree nodes
+		void buildQuadtree();
+
+		//! calculates the distance ranges of the levels for the camera
+		void calculateRanges(const ICameraSceneNode* camera);
+
+		//! selects the chunks of a quadtree node and its children
+		void selectNode(s32 level, s32 nodeX, s32 nodeZ, const SViewFrustum& frustum,
+			const core::vector3df& cameraPosition);
+
+		//! adds a chunk covering quads*quads grid cells of a level
+		void addChunk(s32 x, s32 z, s32 quads, s32 level);
+
+		//! writes the morphed vertices and the indices of all selected chunks
+		void buildGeometry(const core::vector3df& cameraPosition);
+
+		//! returns the bounding box of a quadtree node
+		const core::aabbox3df& getNodeBox(s32 level, s32 nodeX, s32 nodeZ) const
+		{
+			return NodeBoxes[level][nodeX * NodeCount[level] + nodeZ];
+		}
+
+		//! bounding boxes of the nodes, per level
+		core::array<core::array<core::aabbox3df> > NodeBoxes;
+		//! nodes along each side, per level
+		core::array<s32> NodeCount;
+		//! largest diagonal of the node boxes, per level
+		core::array<f32> NodeDiagonal;
+		//! distance up to which a level is used, per level
+		core::array<f32> Ranges;
+		//! distance at which the vertices of a level start to morph, per level
+		core::array<f32> MorphStart;
+
+		core::array<SChunk> Chunks;
+
+		//! holds the morphed geometry of the current frame
+		IDynamicMeshBuffer* MorphBuffer;
+		u32 MorphIndicesToRender;
+
+		f32 ScreenSpaceError;
+		u32 QuadtreeRevision;
+
+		core::vector3df	LastCameraPosition;
+		core::vector3df	LastCameraTarget;
+		f32 LastCameraFOV;
+		bool Rebuild;
+	};
+
+
+} // end namespace scene
+} // end namespace irr
+
+#endif // __C_MORPHING_TERRAIN_SCENE_NODE_H__
+
@@ -13,6 +13,7 @@
 #include "IMaterialRenderer.h"
 #include "CMeshManipulator.h"
 #include "CColorConverter.h"
+#include "CThreadPool.h"
 
 
 namespace irr
@@ -47,6 +48,9 @@ IImageLoader* createImageLoaderPPM();
 //! creates a loader which is able to load rgb images
 IImageLoader* createImageLoaderRGB();
 
+//! creates a loader which is able to load dds images
+IImageLoader* createImageLoaderDDS();
+
 
 //! creates a writer which is able to save bmp images
 IImageWriter* createImageWriterBMP();
@@ -70,10 +74,101 @@ IImageWriter* createImageWriterPNG();
 IImageWriter* createImageWriterPPM();
 
 
+namespace
+{
+	// streamed textures which get finer mip levels per frame
+	const u32 TEXTURE_STREAMING_LOADS_PER_FRAME = 2;
+
+	// images decoded by CNullDriver::createImagesFromFiles
+	struct SImageDecodeTask
+	{
+		IVideoDriver* Driver;
+		io::IReadFile** Files;
+		IImage** Images;
+		core::dimension2d<u32> MinSize;
+	};
+
+	void decodeImages(void* data, u32 begin, u32 end)
+	{
+		SImageDecodeTask& task = *(SImageDecodeTask*)data;
+		for (u32 i=begin; i<end; ++i)
+		{
+			if (task.Files[i])
+				task.Images[i] = task.Driver->createImageFromFile(task.Files[i], task.MinSize);
+		}
+	}
+
+	// collects the log messages of the decoding threads. The logger may pass
+	// them to the event receiver of the user, so they are logged afterwards
+	// on the thread which called createImagesFromFiles.
+	class CDeferredLogger : public ILogger
+	{
+	public:
+		CDeferredLogger(ILogger* logger) : Logger(logger) {}
+
+		virtual ELOG_LEVEL getLogLevel() const { return Logger->getLogLevel(); }
+		virtual void setLogLevel(ELOG_LEVEL ll) { Logger->setLogLevel(ll); }
+
+		virtual void log(const c8* text, ELOG_LEVEL ll) { add(text, ll); }
+		virtual void log(const wchar_t* text, ELOG_LEVEL ll) { add(core::stringc(text), ll); }
+
+		virtual void log(const c8* text, const c8* hint, ELOG_LEVEL ll)
+		{
+			add(core::stringc(text) + ": " + hint, ll);
+		}
+
+		virtual void log(const c8* text, const wchar_t* hint, ELOG_LEVEL ll)
+		{
+			add(core::stringc(text) + ": " + core::stringc(hint), ll);
+		}
+
+		virtual void log(const wchar_t* text, const wchar_t* hint, ELOG_LEVEL ll)
+		{
+			add(core::stringc(text) + ": " + core::stringc(hint), ll);
+		}
+
+		//! logs the collected messages with the original logger
+		void flush()
+		{
+			for (u32 i=0; i<Messages.size(); ++i)
+				Logger->log(Messages[i].Text.c_str(), Messages[i].Level);
+			Messages.clear();
+		}
+
+		ILogger* Logger;
+
+	private:
+
+		struct SMessage
+		{
+			core::stringc Text;
+			ELOG_LEVEL Level;
+		};
+
+		void add(const core::stringc& text, ELOG_LEVEL ll)
+		{
+			if (ll < Logger->getLogLevel())
+				return;
+
+			SMessage message;
+			message.Text = text;
+			message.Level = ll;
+
+			CMutexLock lock(Mutex);
+			Messages.push_back(message);
+		}
+
+		core::array<SMessage> Messages;
+		CMutex Mutex;
+	};
+}
+
+
 //! constructor
 CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& screenSize)
 : FileSystem(io), MeshManipulator(0), ViewPort(0,0,0,0), ScreenSize(screenSize),
 	PrimitivesDrawn(0), MinVertexCountForVBO(500), TextureCreationFlags(0),
+	TextureMemoryBudget(0), TextureMemoryUsed(0), TextureStreamingFrame(0),
 	OverrideMaterial2DEnabled(false), AllowZWriteOnTransparent(false)
 {
 	#ifdef _DEBUG
@@ -122,6 +217,9 @@ CNullDriver::CNullDriver(io::IFileSystem* io, const core::dimension2d<u32>& scre
 #ifdef _IRR_COMPILE_WITH_RGB_LOADER_
 	SurfaceLoader.push_back(video::createImageLoaderRGB());
 #endif
+#ifdef _IRR_COMPILE_WITH_DDS_LOADER_
+	SurfaceLoader.push_back(video::createImageLoaderDDS());
+#endif
 
 
 #ifdef _IRR_COMPILE_WITH_BMP_WRITER_
@@ -274,6 +372,7 @@ bool CNullDriver::endScene()
 {
 	FPSCounter.registerFrame(os::Timer::getRealTime(), PrimitivesDrawn);
 	updateAllHardwareBuffers();
+	updateTextureStreaming();
 	return true;
 }
 
@@ -329,6 +428,221 @@ void CNullDriver::removeTexture(ITexture* texture)
 }
 
 
+//! Sets the memory budget for streamed textures
+void CNullDriver::setTextureMemoryBudget(u32 bytes)
+{
+	TextureMemoryBudget = bytes;
+}
+
+
+//! Returns the memory budget for streamed textures
+u32 CNullDriver::getTextureMemoryBudget() const
+{
+	return TextureMemoryBudget;
+}
+
+
+//! Returns the memory used by the resident mip levels of streamed textures
+u32 CNullDriver::getTextureMemoryUsed() const
+{
+	return TextureMemoryUsed;
+}
+
+
+//! loads all mip levels of a streamed texture from its file
+void CNullDriver::makeTextureResident(ITexture* texture)
+{
+	SSurface s;
+	s.Surface = texture;
+
+	const s32 index = Textures.binary_search(s);
+	if (index != -1 && Textures[index].SourceFile.size() &&
+		streamTextureLevels(Textures[index], 0))
+		Textures[index].Pinned = true;
+}
+
+
+//! releases and loads mip levels of the streamed textures, called once per frame
+void CNullDriver::updateTextureStreaming()
+{
+	++TextureStreamingFrame;
+
+	core::array<STextureStream> streams;
+	TextureMemoryUsed = 0;
+	for (u32 i=0; i<Textures.size(); ++i)
+	{
+		SSurface& s = Textures[i];
+		if (!s.SourceFile.size())
+			continue;
+
+		STextureStream stream;
+		stream.Index = i;
+		if (!getTextureResidency(s.Surface, stream.Residency))
+		{
+			// modified or not streamable by this driver, never try again
+			s.SourceFile = "";
+			continue;
+		}
+
+		if (stream.Residency.RequestedLevel < stream.Residency.LevelCount)
+			s.LastUsed = TextureStreamingFrame;
+		TextureMemoryUsed += stream.Residency.ResidentSize;
+		streams.push_back(stream);
+	}
+
+	// loading means decoding the whole file again, so only a few textures
+	// get finer levels per frame, those missing the most levels first
+	for (u32 loads=0; loads<TEXTURE_STREAMING_LOADS_PER_FRAME; ++loads)
+	{
+		s32 best = -1;
+		u32 bestGap = 0;
+		for (u32 i=0; i<streams.size(); ++i)
+		{
+			const STextureResidency& r = streams[i].Residency;
+			if (r.RequestedLevel < r.ResidentLevel && r.ResidentLevel - r.RequestedLevel > bestGap)
+			{
+				best = i;
+				bestGap = r.ResidentLevel - r.RequestedLevel;
+			}
+		}
+		if (best == -1)
+			break;
+
+		STextureStream& stream = streams[best];
+		STextureResidency& r = stream.Residency;
+		ITexture* texture = Textures[stream.Index].Surface;
+
+		// the finest requested level which fits into the budget after
+		// releasing levels of textures which weren't sampled in this frame
+		u32 available = 0xFFFFFFFF;
+		if (TextureMemoryBudget)
+		{
+			u32 releasable = 0;
+			for (u32 i=0; i<streams.size(); ++i)
+			{
+				const STextureResidency& other = streams[i].Residency;
+				if (Textures[streams[i].Index].LastUsed != TextureStreamingFrame)
+					releasable += other.ResidentSize - getTextureLevelSize(Textures[streams[i].Index].Surface, other.LevelCount - 1);
+			}
+			available = TextureMemoryBudget + releasable > TextureMemoryUsed ?
+				TextureMemoryBudget + releasable - TextureMemoryUsed : 0;
+		}
+
+		u32 level = r.ResidentLevel;
+		u32 needed = 0;
+		while (level > r.RequestedLevel)
+		{
+			const u32 size = getTextureLevelSize(texture, level - 1);
+			if (needed + size > available)
+				break;
+			needed += size;
+			--level;
+		}
+
+		const u32 residentLevel = r.ResidentLevel;
+		r.RequestedLevel = residentLevel;
+		if (level == residentLevel)
+			continue;
+
+		releaseTextureMemory(streams, needed, true);
+		if (streamTextureLevels(Textures[stream.Index], level))
+		{
+			r.ResidentLevel = level;
+			r.ResidentSize += needed;
+			TextureMemoryUsed += needed;
+		}
+	}
+
+	// in case textures were loaded or sampled at finer levels than fit
+	releaseTextureMemory(streams, 0, false);
+}
+
+
+//! loads level and the coarser mip levels of a streamed texture from its file
+bool CNullDriver::streamTextureLevels(SSurface& surface, u32 level)
+{
+	// jpeg files are decoded at a reduced scale for the coarse levels
+	IImage* image = createImageFromFile(surface.SourceFile,
+			getTextureLevelDimension(surface.Surface, level));
+	if (!image)
+	{
+		os::Printer::log("Could not stream texture", surface.SourceFile, ELL_WARNING);
+		surface.SourceFile = "";
+		return false;
+	}
+
+	loadTextureLevels(surface.Surface, image, level);
+	image->drop();
+	return true;
+}
+
+
+//! releases mip levels of a newly loaded texture until it fits into the budget
+void CNullDriver::fitTextureToBudget(ITexture* texture)
+{
+	SSurface s;
+	s.Surface = texture;
+
+	const s32 index = Textures.binary_search(s);
+	if (!TextureMemoryBudget || index == -1 || !Textures[index].SourceFile.size())
+		return;
+
+	// the finer levels are streamed in again once the texture is sampled
+	core::array<STextureStream> streams;
+	STextureStream stream;
+	stream.Index = index;
+	if (!getTextureResidency(texture, stream.Residency))
+		return;
+
+	TextureMemoryUsed += stream.Residency.ResidentSize;
+	streams.push_back(stream);
+	releaseTextureMemory(streams, 0, false);
+}
+
+
+//! releases mip levels of the least recently used textures until needed bytes fit into the budget
+bool CNullDriver::releaseTextureMemory(core::array<STextureStream>& streams, u32 needed, bool unusedOnly)
+{
+	if (!TextureMemoryBudget)
+		return true;
+
+	while (TextureMemoryUsed + needed > TextureMemoryBudget)
+	{
+		// the least recently used texture, the largest of those
+		s32 best = -1;
+		for (u32 i=0; i<streams.size(); ++i)
+		{
+			const STextureResidency& r = streams[i].Residency;
+			const SSurface& s = Textures[streams[i].Index];
+			if (r.ResidentLevel + 1 >= r.LevelCount || s.Pinned ||
+				(unusedOnly && s.LastUsed == TextureStreamingFrame))
+				continue;
+
+			if (best == -1)
+				best = i;
+			else
+			{
+				const u32 bestUsed = Textures[streams[best].Index].LastUsed;
+				if (s.LastUsed < bestUsed ||
+					(s.LastUsed == bestUsed && r.ResidentSize > streams[best].Residency.ResidentSize))
+					best = i;
+			}
+		}
+		if (best == -1)
+			return false;
+
+		STextureResidency& r = streams[best].Residency;
+		ITexture* texture = Textures[streams[best].Index].Surface;
+		const u32 size = getTextureLevelSize(texture, r.ResidentLevel);
+		releaseTextureLevels(texture, r.ResidentLevel + 1);
+		++r.ResidentLevel;
+		r.ResidentSize -= size;
+		TextureMemoryUsed -= size;
+	}
+	return true;
+}
+
+
 //! Removes all texture from the texture cache and deletes them, freeing lot of
 //! memory.
 void CNullDriver::removeAllTextures()
@@ -404,11 +718,13 @@ ITexture* CNullDriver::getTexture(const io::path& filename)
 		}
 
 		texture = loadTextureFromFile(file);
+		const io::path sourceFile = file->getFileName();
 		file->drop();
 
 		if (texture)
 		{
-			addTexture(texture);
+			addTexture(texture, sourceFile);
+			fitTextureToBudget(texture);
 			texture->drop(); // drop it because we created it, one grab too much
 		}
 		else
@@ -470,12 +786,15 @@ video::ITexture* CNullDriver::loadTextureFromFile(io::IReadFile* file, const io:
 
 
 //! adds a surface, not loaded or created by the Irrlicht Engine
-void CNullDriver::addTexture(video::ITexture* texture)
+void CNullDriver::addTexture(video::ITexture* texture, const io::path& sourceFile)
 {
 	if (texture)
 	{
 		SSurface s;
 		s.Surface = texture;
+		s.SourceFile = sourceFile;
+		s.LastUsed = 0;
+		s.Pinned = false;
 		texture->grab();
 
 		Textures.push_back(s);
@@ -828,6 +1147,13 @@ const core::dimension2d<u32>& CNullDriver::getCurrentRenderTargetSize() const
 }
 
 
+//! returns the current render target texture, or 0 for the screen
+ITexture* CNullDriver::getCurrentRenderTarget() const
+{
+	return 0;
+}
+
+
 // returns current frames per second value
 s32 CNullDriver::getFPS() const
 {
@@ -881,6 +1207,13 @@ void CNullDriver::drawStencilShadow(bool clearStencilBuffer,
 }
 
 
+//! Sets a depth texture which shadows the geometry drawn afterwards
+void CNullDriver::setShadowMap(ITexture* depth, const core::matrix4& lightViewProjection,
+		SColor shadowColor, f32 bias)
+{
+}
+
+
 //! deletes all dynamic lights there are
 void CNullDriver::deleteAllDynamicLights()
 {
@@ -1242,7 +1575,7 @@ bool CNullDriver::getTextureCreationFlag(E_TEXTURE_CREATION_FLAG flag) const
 
 
 //! Creates a software image from a file.
-IImage* CNullDriver::createImageFromFile(const io::path& filename)
+IImage* CNullDriver::createImageFromFile(const io::path& filename, const core::dimension2d<u32>& minSize)
 {
 	if (!filename.size())
 		return 0;
@@ -1252,7 +1585,7 @@ IImage* CNullDriver::createImageFromFile(const io::path& filename)
 
 	if (file)
 	{
-		image = createImageFromFile(file);
+		image = createImageFromFile(file, minSize);
 		file->drop();
 	}
 	else
@@ -1263,7 +1596,7 @@ IImage* CNullDriver::createImageFromFile(const io::path& filename)
 
 
 //! Creates a software image from a file.
-IImage* CNullDriver::createImageFromFile(io::IReadFile* file)
+IImage* CNullDriver::createImageFromFile(io::IReadFile* file, const core::dimension2d<u32>& minSize)
 {
 	if (!file)
 		return 0;
@@ -1279,7 +1612,7 @@ IImage* CNullDriver::createImageFromFile(io::IReadFile* file)
 		{
 			// reset file position which might have changed due to previous loadImage calls
 			file->seek(0);
-			image = SurfaceLoader[i]->loadImage(file);
+			image = SurfaceLoader[i]->loadImage(file, minSize);
 			if (image)
 				return image;
 		}
@@ -1293,7 +1626,7 @@ IImage* CNullDriver::createImageFromFile(io::IReadFile* file)
 		if (SurfaceLoader[i]->isALoadableFileFormat(file))
 		{
 			file->seek(0);
-			image = SurfaceLoader[i]->loadImage(file);
+			image = SurfaceLoader[i]->loadImage(file, minSize);
 			if (image)
 				return image;
 		}
@@ -1303,6 +1636,77 @@ IImage* CNullDriver::createImageFromFile(io::IReadFile* file)
 }
 
 
+//! Creates software images from many files, decoded on the thread pool.
+u32 CNullDriver::createImagesFromFiles(const core::array<io::path>& filenames,
+		core::array<IImage*>& images, const core::dimension2d<u32>& minSize)
+{
+	const u32 count = filenames.size();
+	images.set_used(count);
+
+	// the file system is not thread safe, and archives share one file
+	// position, so the files are read here and only decoded in parallel
+	core::array<io::IReadFile*> files(count);
+	for (u32 i=0; i<count; ++i)
+	{
+		images[i] = 0;
+		io::IReadFile* file = filenames[i].size() ? FileSystem->createAndOpenFile(filenames[i]) : 0;
+		if (!file)
+		{
+			os::Printer::log("Could not open file of image", filenames[i], ELL_WARNING);
+			files.push_back(0);
+			continue;
+		}
+
+		if (!file->getMappedData())
+		{
+			const long size = file->getSize();
+			u8* memory = new u8[size];
+			if (file->read(memory, size) == size)
+			{
+				io::IReadFile* memoryFile = FileSystem->createMemoryReadFile(memory, (s32)size, file->getFileName(), true);
+				file->drop();
+				file = memoryFile;
+			}
+			else
+			{
+				os::Printer::log("Could not read file of image", filenames[i], ELL_WARNING);
+				delete [] memory;
+				file->drop();
+				file = 0;
+			}
+		}
+		files.push_back(file);
+	}
+
+	SImageDecodeTask task;
+	task.Driver = this;
+	task.Files = files.pointer();
+	task.Images = images.pointer();
+	task.MinSize = minSize;
+
+	if (os::Printer::Logger)
+	{
+		CDeferredLogger logger(os::Printer::Logger);
+		os::Printer::Logger = &logger;
+		CThreadPool::getSharedPool()->parallelFor(count, 1, decodeImages, &task);
+		os::Printer::Logger = logger.Logger;
+		logger.flush();
+	}
+	else
+		CThreadPool::getSharedPool()->parallelFor(count, 1, decodeImages, &task);
+
+	u32 loaded = 0;
+	for (u32 i=0; i<count; ++i)
+	{
+		if (files[i])
+			files[i]->drop();
+		if (images[i])
+			++loaded;
+	}
+	return loaded;
+}
+
+
 //! Writes the provided image to disk file
 bool CNullDriver::writeImageToFile(IImage* image, const io::path& filename,u32 param)
 {
@@ -1416,12 +1820,8 @@ IImage* CNullDriver::createImage(ITexture* texture, const core::position2d<s32>&
 		IImage* image = new CImage(texture->getColorFormat(), clamped.getSize());
 		u8* dst = static_cast<u8*>(image->lock());
 		src += clamped.UpperLeftCorner.Y * texture->getPitch() + image->getBytesPerPixel() * clamped.UpperLeftCorner.X;
-		for (u32 i=0; i<clamped.getHeight(); ++i)
-		{
-			video::CColorConverter::convert_viaFormat(src, texture->getColorFormat(), clamped.getWidth(), dst, image->getColorFormat());
-			src += texture->getPitch();
-			dst += image->getPitch();
-		}
+		video::CColorConverter::convert_viaFormat(src, texture->getColorFormat(), texture->getPitch(),
+				dst, image->getColorFormat(), image->getPitch(), clamped.getWidth(), clamped.getHeight());
 		image->unlock();
 		texture->unlock();
 		return image;
@@ -1471,6 +1871,52 @@ void CNullDriver::drawMeshBuffer(const scene::IMeshBuffer* mb)
 }
 
 
+//! Draws many instances of a mesh buffer, one after the other
+void CNullDriver::drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+		const core::matrix4* transforms, const SColor* colors, u32 instanceCount)
+{
+	if (!mb || !transforms || !instanceCount)
+		return;
+
+	const core::matrix4 world = getTransform(ETS_WORLD);
+	const u32 pitch = getVertexPitchFromType(mb->getVertexType());
+	core::array<u8> vertices;
+
+	for (u32 i=0; i<instanceCount; ++i)
+	{
+		setTransform(ETS_WORLD, transforms[i]);
+
+		if (!colors || colors[i].color == 0xFFFFFFFF)
+		{
+			drawMeshBuffer(mb);
+			continue;
+		}
+
+		// all vertex types start with S3DVertex, so the colors of a copy
+		// of the vertices are multiplied with the instance color
+		const u32 vertexCount = mb->getVertexCount();
+		vertices.set_used(vertexCount * pitch);
+		memcpy(vertices.pointer(), mb->getVertices(), vertexCount * pitch);
+
+		const SColor& c = colors[i];
+		for (u32 v=0; v<vertexCount; ++v)
+		{
+			SColor& vc = ((S3DVertex*)(vertices.pointer() + v * pitch))->Color;
+			vc.set(vc.getAlpha() * c.getAlpha() / 255,
+				vc.getRed() * c.getRed() / 255,
+				vc.getGreen() * c.getGreen() / 255,
+				vc.getBlue() * c.getBlue() / 255);
+		}
+
+		drawVertexPrimitiveList(vertices.const_pointer(), vertexCount,
+			mb->getIndices(), mb->getIndexCount()/3, mb->getVertexType(),
+			scene::EPT_TRIANGLES, mb->getIndexType());
+	}
+
+	setTransform(ETS_WORLD, world);
+}
+
+
 CNullDriver::SHWBufferLink *CNullDriver::getBufferLink(const scene::IMeshBuffer* mb)
 {
 	if (!mb || !isHardwareBufferRecommend(mb))
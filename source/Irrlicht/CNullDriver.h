@@ -234,6 +234,9 @@ namespace video
 		//! get render target size
 		virtual const core::dimension2d<u32>& getCurrentRenderTargetSize() const;
 
+		//! returns the current render target texture, or 0 for the screen
+		virtual ITexture* getCurrentRenderTarget() const;
+
 		// get current frames per second value
 		virtual s32 getFPS() const;
 
@@ -286,6 +289,10 @@ namespace video
 			video::SColor leftDownEdge = video::SColor(0,0,0,0),
 			video::SColor rightDownEdge = video::SColor(0,0,0,0));
 
+		//! Sets a depth texture which shadows the geometry drawn afterwards
+		virtual void setShadowMap(ITexture* depth, const core::matrix4& lightViewProjection,
+			SColor shadowColor=SColor(150,0,0,0), f32 bias=0.002f);
+
 		//! Returns current amount of dynamic lights set
 		//! \return Current amount of dynamic lights set
 		virtual u32 getDynamicLightCount() const;
@@ -300,6 +307,15 @@ namespace video
 		//! memory.
 		virtual void removeTexture(ITexture* texture);
 
+		//! Sets the memory budget for streamed textures
+		virtual void setTextureMemoryBudget(u32 bytes);
+
+		//! Returns the memory budget for streamed textures
+		virtual u32 getTextureMemoryBudget() const;
+
+		//! Returns the memory used by the resident mip levels of streamed textures
+		virtual u32 getTextureMemoryUsed() const;
+
 		//! Removes all texture from the texture cache and deletes them, freeing lot of
 		//! memory.
 		virtual void removeAllTextures();
@@ -330,10 +346,17 @@ namespace video
 		virtual bool getTextureCreationFlag(E_TEXTURE_CREATION_FLAG flag) const;
 
 		//! Creates a software image from a file.
-		virtual IImage* createImageFromFile(const io::path& filename);
+		virtual IImage* createImageFromFile(const io::path& filename,
+				const core::dimension2d<u32>& minSize=core::dimension2d<u32>(0,0));
 
 		//! Creates a software image from a file.
-		virtual IImage* createImageFromFile(io::IReadFile* file);
+		virtual IImage* createImageFromFile(io::IReadFile* file,
+				const core::dimension2d<u32>& minSize=core::dimension2d<u32>(0,0));
+
+		//! Creates software images from many files, decoded on the thread pool.
+		virtual u32 createImagesFromFiles(const core::array<io::path>& filenames,
+				core::array<IImage*>& images,
+				const core::dimension2d<u32>& minSize=core::dimension2d<u32>(0,0));
 
 		//! Creates a software image from a byte array.
 		/** \param useForeignMemory: If true, the image will use the data pointer
@@ -363,6 +386,11 @@ namespace video
 		//! Draws a mesh buffer
 		virtual void drawMeshBuffer(const scene::IMeshBuffer* mb);
 
+		//! Draws many instances of a mesh buffer, one after the other
+		virtual void drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+				const core::matrix4* transforms, const SColor* colors,
+				u32 instanceCount);
+
 	protected:
 		struct SHWBufferLink
 		{
@@ -607,7 +635,9 @@ namespace video
 		video::ITexture* loadTextureFromFile(io::IReadFile* file, const io::path& hashName = "");
 
 		//! adds a surface, not loaded or created by the Irrlicht Engine
-		void addTexture(video::ITexture* surface);
+		/** \param sourceFile File the texture can be loaded from again for
+		streaming, empty if it can't. */
+		void addTexture(video::ITexture* surface, const io::path& sourceFile="");
 
 		//! Creates a texture from a loaded IImage.
 		virtual ITexture* addTexture(const io::path& name, IImage* image, void* mipmapData=0);
@@ -649,12 +679,78 @@ namespace video
 		{
 			video::ITexture* Surface;
 
+			//! file of a streamed texture, empty if the texture isn't streamed
+			io::path SourceFile;
+
+			//! frame the texture was sampled last, for streaming
+			u32 LastUsed;
+
+			//! pinned textures keep all their mip levels
+			bool Pinned;
+
 			bool operator < (const SSurface& other) const
 			{
 				return Surface->getName() < other.Surface->getName();
 			}
 		};
 
+		//! mip level residency of a streamed texture
+		struct STextureResidency
+		{
+			//! finest mip level in memory
+			u32 ResidentLevel;
+			//! finest mip level sampled since the last query, LevelCount if none
+			u32 RequestedLevel;
+			//! number of mip levels
+			u32 LevelCount;
+			//! bytes of the resident mip levels
+			u32 ResidentSize;
+		};
+
+		//! gets the residency of a texture and resets its requested level
+		/** Drivers which can stream textures override this and the
+		other texture level methods.
+		\return False if the texture can't be streamed. */
+		virtual bool getTextureResidency(ITexture* /*texture*/, STextureResidency& /*residency*/) { return false; }
+
+		//! returns the size in bytes of a mip level
+		virtual u32 getTextureLevelSize(ITexture* /*texture*/, u32 /*level*/) const { return 0; }
+
+		//! returns the dimension of a mip level
+		virtual core::dimension2d<u32> getTextureLevelDimension(ITexture* texture, u32 /*level*/) const { return texture->getSize(); }
+
+		//! releases the mip levels finer than level
+		virtual void releaseTextureLevels(ITexture* /*texture*/, u32 /*level*/) {}
+
+		//! makes level and the coarser mip levels resident, image holds the whole texture
+		virtual void loadTextureLevels(ITexture* /*texture*/, IImage* /*image*/, u32 /*level*/) {}
+
+		//! loads all mip levels of a streamed texture from its file and pins them
+		/** Used by drivers before they access the largest level directly,
+		e.g. to draw 2d images. Pinned levels are never released again. */
+		void makeTextureResident(ITexture* texture);
+
+		//! releases and loads mip levels of the streamed textures, called once per frame
+		void updateTextureStreaming();
+
+		//! a streamed texture during updateTextureStreaming()
+		struct STextureStream
+		{
+			u32 Index;
+			STextureResidency Residency;
+		};
+
+		//! loads level and the coarser mip levels of a streamed texture from its file
+		bool streamTextureLevels(SSurface& surface, u32 level);
+
+		//! releases mip levels of a newly loaded texture until it fits into the budget
+		void fitTextureToBudget(ITexture* texture);
+
+		//! releases mip levels of the least recently used textures until needed bytes fit into the budget
+		/** \param unusedOnly Don't release levels of textures sampled in this frame.
+		\return True if needed bytes fit into the budget. */
+		bool releaseTextureMemory(core::array<STextureStream>& streams, u32 needed, bool unusedOnly);
+
 		struct SMaterialRenderer
 		{
 			core::stringc Name;
@@ -701,6 +797,10 @@ namespace video
 
 		u32 TextureCreationFlags;
 
+		u32 TextureMemoryBudget;
+		u32 TextureMemoryUsed;
+		u32 TextureStreamingFrame;
+
 		f32 FogStart;
 		f32 FogEnd;
 		f32 FogDensity;
@@ -80,9 +80,17 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 	const io::path fullName = file->getFileName();
 	const io::path relPath = FileSystem->getFileDir(fullName)+"/";
 
-	c8* buf = new c8[filesize];
-	memset(buf, 0, filesize);
-	file->read((void*)buf, filesize);
+	// mapped files are parsed in place. A trailing white space stops all
+	// numbers in the file, otherwise an extra zero byte is needed
+	const c8* buf = (const c8*)file->getMappedData();
+	c8* bufCopy = 0;
+	if (!buf || !core::isspace(buf[filesize-1]))
+	{
+		bufCopy = new c8[filesize+1];
+		memset(bufCopy, 0, filesize+1);
+		file->read((void*)bufCopy, filesize);
+		buf = bufCopy;
+	}
 	const c8* const bufEnd = buf+filesize;
 
 	// Process obj information
@@ -310,7 +318,7 @@ IAnimatedMesh* COBJMeshFileLoader::createMesh(io::IReadFile* file)
 	}
 
 	// Clean up the allocate obj file contents
-	delete [] buf;
+	delete [] bufCopy;
 	// more cleaning up
 	cleanUp();
 	mesh->drop();
@@ -505,8 +513,16 @@ void COBJMeshFileLoader::readMTL(const c8* fileName, const io::path& relPath)
 		return;
 	}
 
-	c8* buf = new c8[filesize];
-	mtlReader->read((void*)buf, filesize);
+	// mapped files are parsed in place if a trailing white space keeps
+	// the parser inside of the file
+	const c8* buf = (const c8*)mtlReader->getMappedData();
+	c8* bufCopy = 0;
+	if (!buf || !core::isspace(buf[filesize-1]))
+	{
+		bufCopy = new c8[filesize];
+		mtlReader->read((void*)bufCopy, filesize);
+		buf = bufCopy;
+	}
 	const c8* bufEnd = buf+filesize;
 
 	SObjMtl* currMaterial = 0;
@@ -653,7 +669,7 @@ void COBJMeshFileLoader::readMTL(const c8* fileName, const io::path& relPath)
 	if ( currMaterial )
 		Materials.push_back( currMaterial );
 
-	delete [] buf;
+	delete [] bufCopy;
 	mtlReader->drop();
 }
 
@@ -675,18 +691,30 @@ const c8* COBJMeshFileLoader::readColor(const c8* bufPtr, video::SColor& color,
 }
 
 
+//! Read up to count floats following the current word, stops at the end of the line
+/** The numbers are parsed in place, without copying the words first. */
+const c8* COBJMeshFileLoader::readFloats(const c8* bufPtr, f32* values, u32 count, const c8* const bufEnd)
+{
+	for (u32 i=0; i<count; ++i)
+	{
+		bufPtr = goNextWord(bufPtr, bufEnd, false);
+		if (bufPtr == bufEnd)
+			break;
+		const c8* next = core::fast_atof_exact_move(bufPtr, values[i]);
+		if (next == bufPtr)
+			break;
+		bufPtr = next;
+	}
+	return bufPtr;
+}
+
+
 //! Read 3d vector of floats
 const c8* COBJMeshFileLoader::readVec3(const c8* bufPtr, core::vector3df& vec, const c8* const bufEnd)
 {
-	const u32 WORD_BUFFER_LENGTH = 256;
-	c8 wordBuffer[WORD_BUFFER_LENGTH];
-
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.X=-core::fast_atof(wordBuffer); // change handedness
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.Y=core::fast_atof(wordBuffer);
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.Z=core::fast_atof(wordBuffer);
+	f32 values[3] = { 0.f, 0.f, 0.f };
+	bufPtr = readFloats(bufPtr, values, 3, bufEnd);
+	vec.set(-values[0], values[1], values[2]); // change handedness
 	return bufPtr;
 }
 
@@ -694,13 +722,9 @@ const c8* COBJMeshFileLoader::readVec3(const c8* bufPtr, core::vector3df& vec, c
 //! Read 2d vector of floats
 const c8* COBJMeshFileLoader::readUV(const c8* bufPtr, core::vector2df& vec, const c8* const bufEnd)
 {
-	const u32 WORD_BUFFER_LENGTH = 256;
-	c8 wordBuffer[WORD_BUFFER_LENGTH];
-
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.X=core::fast_atof(wordBuffer);
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	vec.Y=1-core::fast_atof(wordBuffer); // change handedness
+	f32 values[2] = { 0.f, 0.f };
+	bufPtr = readFloats(bufPtr, values, 2, bufEnd);
+	vec.set(values[0], 1-values[1]); // change handedness
 	return bufPtr;
 }
 
@@ -95,6 +95,8 @@ private:
 
 	//! Read RGB color
 	const c8* readColor(const c8* bufPtr, video::SColor& color, const c8* const pBufEnd);
+	//! Read up to count floats following the current word
+	const c8* readFloats(const c8* bufPtr, f32* values, u32 count, const c8* const pBufEnd);
 	//! Read 3d vector of floats
 	const c8* readVec3(const c8* bufPtr, core::vector3df& vec, const c8* const pBufEnd);
 	//! Read 2d vector of floats
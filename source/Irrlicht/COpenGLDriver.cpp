@@ -3828,6 +3828,13 @@ const core::dimension2d<u32>& COpenGLDriver::getCurrentRenderTargetSize() const
 }
 
 
+//! returns the current render target texture, or 0 for the screen
+ITexture* COpenGLDriver::getCurrentRenderTarget() const
+{
+	return RenderTargetTexture;
+}
+
+
 //! Clears the ZBuffer.
 void COpenGLDriver::clearZBuffer()
 {
@@ -388,6 +388,9 @@ namespace video
 		// returns the current size of the screen or rendertarget
 		virtual const core::dimension2d<u32>& getCurrentRenderTargetSize() const;
 
+		//! returns the current render target texture, or 0 for the screen
+		virtual ITexture* getCurrentRenderTarget() const;
+
 		void createMaterialRenderers();
 
 		//! Assign a hardware light to the specified requested light, if any
@@ -12,6 +12,7 @@
 #include "os.h"
 #include "CImage.h"
 #include "CColorConverter.h"
+#include "CImageResampler.h"
 
 #include "irrString.h"
 
@@ -533,8 +534,16 @@ void COpenGLTexture::regenerateMipMapLevels(void* mipmapData)
 	// Manually create mipmaps or use prepared version
 	u32 width=Image->getDimension().Width;
 	u32 height=Image->getDimension().Height;
+	const u32 bpp=Image->getBytesPerPixel();
 	u32 i=0;
 	u8* target = static_cast<u8*>(mipmapData);
+
+	// generated levels are filtered from the previous level, alternating
+	// between two buffers. Both are allocated for the largest levels.
+	u8* buffers[2] = { 0, 0 };
+	const u8* source = static_cast<const u8*>(Image->lock());
+	core::dimension2d<u32> sourceSize = Image->getDimension();
+	u32 sourcePitch = Image->getPitch();
 	do
 	{
 		if (width>1)
@@ -542,24 +551,33 @@ void COpenGLTexture::regenerateMipMapLevels(void* mipmapData)
 		if (height>1)
 			height>>=1;
 		++i;
-		if (!target)
-			target = new u8[width*height*Image->getBytesPerPixel()];
 		// create scaled version if no mipdata available
 		if (!mipmapData)
-			Image->copyToScaling(target, width, height, Image->getColorFormat());
+		{
+			if (!buffers[i&1])
+				buffers[i&1] = new u8[width*height*bpp];
+			target = buffers[i&1];
+			CImageResampler::resample(source, Image->getColorFormat(), sourceSize, sourcePitch,
+					target, Image->getColorFormat(), core::dimension2d<u32>(width, height), width*bpp,
+					ERF_BOX);
+			source = target;
+			sourceSize.set(width, height);
+			sourcePitch = width*bpp;
+		}
 		glTexImage2D(GL_TEXTURE_2D, i, InternalFormat, width, height,
 				0, PixelFormat, PixelType, target);
 		// get next prepared mipmap data if available
 		if (mipmapData)
 		{
-			mipmapData = static_cast<u8*>(mipmapData)+width*height*Image->getBytesPerPixel();
+			mipmapData = static_cast<u8*>(mipmapData)+width*height*bpp;
 			target = static_cast<u8*>(mipmapData);
 		}
 	}
 	while (width!=1 || height!=1);
+	Image->unlock();
 	// cleanup
-	if (!mipmapData)
-		delete [] target;
+	delete [] buffers[0];
+	delete [] buffers[1];
 }
 
 
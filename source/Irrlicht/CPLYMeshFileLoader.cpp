@@ -12,6 +12,7 @@
 #include "SAnimatedMesh.h"
 #include "IReadFile.h"
 #include "fast_atof.h"
+#include "CThreadPool.h"
 #include "os.h"
 
 namespace irr
@@ -22,6 +23,9 @@ namespace scene
 // input buffer must be at least twice as long as the longest line in the file
 #define PLY_INPUT_BUFFER_SIZE 51200 // file is loaded in 50k chunks
 
+// number of elements parsed by one task of the thread pool
+#define PLY_ELEMENTS_PER_CHUNK 16384
+
 // constructor
 CPLYMeshFileLoader::CPLYMeshFileLoader()
 : File(0), Buffer(0)
@@ -183,6 +187,9 @@ IAnimatedMesh* CPLYMeshFileLoader::createMesh(io::IReadFile* file)
 					}
 
 					prop.Name = getNextWord();
+					prop.Semantic = getSemantic(el->Name, prop.Name);
+					if ((prop.Type == EPLYPT_LIST) != (prop.Semantic == EPLYS_VERTEX_INDICES))
+						prop.Semantic = EPLYS_SKIP;
 
 					// add property to element
 					el->Properties.push_back(prop);
@@ -229,35 +236,47 @@ IAnimatedMesh* CPLYMeshFileLoader::createMesh(io::IReadFile* file)
 		// now to read the actual data from the file
 		if (continueReading)
 		{
+			// the data section is needed in memory as a whole
+			const c8* headerEnd = LineEndPointer + 1;
+			const u32 buffered = (headerEnd < EndPointer) ? (u32)(EndPointer - headerEnd) : 0;
+			const long remaining = File->getSize() - File->getPos();
+			const u32 dataSize = buffered + (remaining > 0 ? (u32)remaining : 0);
+
+			// mapped files are parsed in place. Ascii numbers need a trailing
+			// white space or a zero byte to stop at the end of the file.
+			const c8* data = (const c8*)File->getMappedData();
+			c8* dataCopy = 0;
+			const c8* dataEnd = 0;
+			if (data && dataSize && (IsBinaryFile || core::isspace(data[File->getSize()-1])))
+			{
+				data += File->getPos() - buffered;
+				dataEnd = data + dataSize;
+			}
+			else
+			{
+				// the rest of the header buffer comes first
+				dataCopy = new c8[dataSize + 1];
+				if (buffered)
+					memcpy(dataCopy, headerEnd, buffered);
+				const u32 readSize = (dataSize > buffered) ? File->read(dataCopy + buffered, dataSize - buffered) : 0;
+				dataCopy[buffered + readSize] = 0;
+				data = dataCopy;
+				dataEnd = data + buffered + readSize;
+			}
+
 			// create a mesh buffer
-			CDynamicMeshBuffer *mb = new CDynamicMeshBuffer(video::EVT_STANDARD, vertCount > 65565 ? video::EIT_32BIT : video::EIT_16BIT);
+			CDynamicMeshBuffer *mb = new CDynamicMeshBuffer(video::EVT_STANDARD, vertCount > 65535 ? video::EIT_32BIT : video::EIT_16BIT);
 			mb->getVertexBuffer().reallocate(vertCount);
 			mb->getIndexBuffer().reallocate(vertCount);
 			mb->setHardwareMappingHint(EHM_STATIC);
 
 			// loop through each of the elements
+			const c8* p = data;
 			for (u32 i=0; i<ElementList.size(); ++i)
-			{
-				// do we want this element type?
-				if (ElementList[i]->Name == "vertex")
-				{
-					// loop through vertex properties
-					for (u32 j=0; j < ElementList[i]->Count; ++j)
-						readVertex(*ElementList[i], mb);
-				}
-				else if (ElementList[i]->Name == "face")
-				{
-					// read faces
-					for (u32 j=0; j < ElementList[i]->Count; ++j)
-						readFace(*ElementList[i], mb);
-				}
-				else
-				{
-					// skip these elements
-					for (u32 j=0; j < ElementList[i]->Count; ++j)
-						skipElement(*ElementList[i]);
-				}
-			}
+				p = readElements(*ElementList[i], p, dataEnd, mb);
+
+			delete [] dataCopy;
+
 			mb->recalculateBoundingBox();
 			SMesh* m = new SMesh();
 			m->addMeshBuffer(mb);
@@ -282,144 +301,6 @@ IAnimatedMesh* CPLYMeshFileLoader::createMesh(io::IReadFile* file)
 }
 
 
-bool CPLYMeshFileLoader::readVertex(const SPLYElement &Element, scene::CDynamicMeshBuffer* mb)
-{
-	if (!IsBinaryFile)
-		getNextLine();
-
-	video::S3DVertex vert;
-	vert.Color.set(255,255,255,255);
-	vert.TCoords.X = 0.0f;
-	vert.TCoords.Y = 0.0f;
-	vert.Normal.X = 0.0f;
-	vert.Normal.Y = 1.0f;
-	vert.Normal.Z = 0.0f;
-
-	for (u32 i=0; i < Element.Properties.size(); ++i)
-	{
-		E_PLY_PROPERTY_TYPE t = Element.Properties[i].Type;
-
-		if (Element.Properties[i].Name == "x")
-			vert.Pos.X = getFloat(t);
-		else if (Element.Properties[i].Name == "y")
-			vert.Pos.Z = getFloat(t);
-		else if (Element.Properties[i].Name == "z")
-			vert.Pos.Y = getFloat(t);
-		else if (Element.Properties[i].Name == "nx")
-			vert.Normal.X = getFloat(t);
-		else if (Element.Properties[i].Name == "ny")
-			vert.Normal.Z = getFloat(t);
-		else if (Element.Properties[i].Name == "nz")
-			vert.Normal.Y = getFloat(t);
-		else if (Element.Properties[i].Name == "u")
-			vert.TCoords.X = getFloat(t);
-		else if (Element.Properties[i].Name == "v")
-			vert.TCoords.Y = getFloat(t);
-		else if (Element.Properties[i].Name == "red")
-		{
-			u32 value = Element.Properties[i].isFloat() ? (u32)(getFloat(t)*255.0f) : getInt(t);
-			vert.Color.setRed(value);
-		}
-		else if (Element.Properties[i].Name == "green")
-		{
-			u32 value = Element.Properties[i].isFloat() ? (u32)(getFloat(t)*255.0f) : getInt(t);
-			vert.Color.setGreen(value);
-		}
-		else if (Element.Properties[i].Name == "blue")
-		{
-			u32 value = Element.Properties[i].isFloat() ? (u32)(getFloat(t)*255.0f) : getInt(t);
-			vert.Color.setBlue(value);
-		}
-		else if (Element.Properties[i].Name == "alpha")
-		{
-			u32 value = Element.Properties[i].isFloat() ? (u32)(getFloat(t)*255.0f) : getInt(t);
-			vert.Color.setAlpha(value);
-		}
-		else
-			skipProperty(Element.Properties[i]);
-	}
-
-	mb->getVertexBuffer().push_back(vert);
-
-	return true;
-}
-
-
-bool CPLYMeshFileLoader::readFace(const SPLYElement &Element, scene::CDynamicMeshBuffer* mb)
-{
-	if (!IsBinaryFile)
-		getNextLine();
-
-	for (u32 i=0; i < Element.Properties.size(); ++i)
-	{
-		if ( (Element.Properties[i].Name == "vertex_indices" ||
-			Element.Properties[i].Name == "vertex_index") && Element.Properties[i].Type == EPLYPT_LIST)
-		{
-			// get count
-			s32 count = getInt(Element.Properties[i].Data.List.CountType);
-			u32 a = getInt(Element.Properties[i].Data.List.ItemType),
-				b = getInt(Element.Properties[i].Data.List.ItemType),
-				c = getInt(Element.Properties[i].Data.List.ItemType);
-			s32 j = 3;
-
-			mb->getIndexBuffer().push_back(a);
-			mb->getIndexBuffer().push_back(c);
-			mb->getIndexBuffer().push_back(b);
-
-			for (; j < count; ++j)
-			{
-				b = c;
-				c = getInt(Element.Properties[i].Data.List.ItemType);
-				mb->getIndexBuffer().push_back(a);
-				mb->getIndexBuffer().push_back(c);
-				mb->getIndexBuffer().push_back(b);
-			}
-		}
-		else if (Element.Properties[i].Name == "intensity")
-		{
-			// todo: face intensity
-			skipProperty(Element.Properties[i]);
-		}
-		else
-			skipProperty(Element.Properties[i]);
-	}
-	return true;
-}
-
-
-// skips an element and all properties. return false on EOF
-void CPLYMeshFileLoader::skipElement(const SPLYElement &Element)
-{
-	if (IsBinaryFile)
-		if (Element.IsFixedWidth)
-			moveForward(Element.KnownSize);
-		else
-			for (u32 i=0; i < Element.Properties.size(); ++i)
-				skipProperty(Element.Properties[i]);
-	else
-		getNextLine();
-}
-
-
-void CPLYMeshFileLoader::skipProperty(const SPLYProperty &Property)
-{
-	if (Property.Type == EPLYPT_LIST)
-	{
-		s32 count = getInt(Property.Data.List.CountType);
-
-		for (s32 i=0; i < count; ++i)
-			getInt(Property.Data.List.CountType);
-	}
-	else
-	{
-		if (IsBinaryFile)
-			moveForward(Property.size());
-		else
-			getNextWord();
-	}
-}
-
-
 bool CPLYMeshFileLoader::allocateBuffer()
 {
 	// Destroy the element list if it exists
@@ -491,18 +372,6 @@ void CPLYMeshFileLoader::fillBuffer()
 }
 
 
-// skips x bytes in the file, getting more data if required
-void CPLYMeshFileLoader::moveForward(u32 bytes)
-{
-	if (StartPointer + bytes >= EndPointer)
-		fillBuffer();
-	if (StartPointer + bytes < EndPointer)
-		StartPointer += bytes;
-	else
-		StartPointer = EndPointer;
-}
-
-
 E_PLY_PROPERTY_TYPE CPLYMeshFileLoader::getPropertyType(const c8* typeString) const
 {
 	if (strcmp(typeString, "char") == 0 ||
@@ -512,8 +381,7 @@ E_PLY_PROPERTY_TYPE CPLYMeshFileLoader::getPropertyType(const c8* typeString) co
 	{
 		return EPLYPT_INT8;
 	}
-	else if (strcmp(typeString, "uint") == 0 ||
-		strcmp(typeString, "int16") == 0 ||
+	else if (strcmp(typeString, "int16") == 0 ||
 		strcmp(typeString, "uint16") == 0 ||
 		strcmp(typeString, "short") == 0 ||
 		strcmp(typeString, "ushort") == 0)
@@ -521,6 +389,7 @@ E_PLY_PROPERTY_TYPE CPLYMeshFileLoader::getPropertyType(const c8* typeString) co
 		return EPLYPT_INT16;
 	}
 	else if (strcmp(typeString, "int") == 0 ||
+		strcmp(typeString, "uint") == 0 ||
 		strcmp(typeString, "long") == 0 ||
 		strcmp(typeString, "ulong") == 0 ||
 		strcmp(typeString, "int32") == 0 ||
@@ -569,7 +438,8 @@ c8* CPLYMeshFileLoader::getNextLine()
 	while (pos < EndPointer && *pos && *pos != '\r' && *pos != '\n')
 		++pos;
 
-	if ( pos < EndPointer && ( *(pos+1) == '\r' || *(pos+1) == '\n') )
+	// only a crlf pair belongs together, the first byte of binary data may be a line feed
+	if ( pos < EndPointer && *pos == '\r' && *(pos+1) == '\n' )
 	{
 		*pos = '\0';
 		++pos;
@@ -640,156 +510,510 @@ c8* CPLYMeshFileLoader::getNextWord()
 }
 
 
-// read the next float from the file and move the start pointer along
-f32 CPLYMeshFileLoader::getFloat(E_PLY_PROPERTY_TYPE t)
+E_PLY_SEMANTIC CPLYMeshFileLoader::getSemantic(const core::stringc& element, const core::stringc& property) const
 {
-	f32 retVal = 0.0f;
+	if (element == "vertex")
+	{
+		if (property == "x")
+			return EPLYS_X;
+		else if (property == "y")
+			return EPLYS_Y;
+		else if (property == "z")
+			return EPLYS_Z;
+		else if (property == "nx")
+			return EPLYS_NX;
+		else if (property == "ny")
+			return EPLYS_NY;
+		else if (property == "nz")
+			return EPLYS_NZ;
+		else if (property == "u")
+			return EPLYS_U;
+		else if (property == "v")
+			return EPLYS_V;
+		else if (property == "red")
+			return EPLYS_RED;
+		else if (property == "green")
+			return EPLYS_GREEN;
+		else if (property == "blue")
+			return EPLYS_BLUE;
+		else if (property == "alpha")
+			return EPLYS_ALPHA;
+	}
+	else if (element == "face")
+	{
+		if (property == "vertex_indices" || property == "vertex_index")
+			return EPLYS_VERTEX_INDICES;
+	}
+	return EPLYS_SKIP;
+}
 
-	if (IsBinaryFile)
+
+namespace
+{
+
+// size of a binary value, 0 if unknown
+inline u32 getPLYTypeSize(E_PLY_PROPERTY_TYPE t)
+{
+	switch (t)
 	{
-		if (EndPointer - StartPointer < 8)
-			fillBuffer();
+	case EPLYPT_INT8:
+		return 1;
+	case EPLYPT_INT16:
+		return 2;
+	case EPLYPT_INT32:
+	case EPLYPT_FLOAT32:
+		return 4;
+	case EPLYPT_FLOAT64:
+		return 8;
+	default:
+		return 0;
+	}
+}
+
+// copies a binary value, reversing the bytes for files of the other byte order
+inline void readPLYBytes(void* out, const c8* p, u32 size, bool swap)
+{
+	if (swap)
+	{
+		for (u32 i=0; i<size; ++i)
+			((c8*)out)[i] = p[size-1-i];
+	}
+	else
+		memcpy(out, p, size);
+}
+
+// skips spaces up to the next value in an ascii line
+inline const c8* skipPLYBlanks(const c8* p, const c8* end)
+{
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+		++p;
+	return p;
+}
+
+// skips a value in an ascii line, also if it's no number
+inline const c8* skipPLYToken(const c8* p, const c8* end)
+{
+	while (p < end && !core::isspace(*p))
+		++p;
+	return p;
+}
+
+// moves to the first value of the next ascii element, blank lines are skipped
+inline const c8* startPLYLine(const c8* p, const c8* end)
+{
+	while (p < end && core::isspace(*p))
+		++p;
+	return p;
+}
+
+// moves behind the end of the current ascii line
+inline const c8* endPLYLine(const c8* p, const c8* end)
+{
+	const c8* lineEnd = (const c8*)memchr(p, '\n', end-p);
+	return lineEnd ? lineEnd+1 : end;
+}
+
+} // end anonymous namespace
+
+
+const c8* CPLYMeshFileLoader::readElements(const SPLYElement &Element, const c8* p, const c8* end, scene::CDynamicMeshBuffer* mb) const
+{
+	const bool isVertex = (Element.Name == "vertex");
+	if (!Element.Count || (!isVertex && Element.Name != "face"))
+	{
+		// skip these elements
+		return skipElements(Element, p, end, Element.Count);
+	}
+
+	SPLYReadTask task;
+	task.Loader = this;
+	task.Element = &Element;
+	task.End = end;
+	task.Vertices = 0;
+	task.VertexCount = mb->getVertexBuffer().size();
+
+	// find the start of each chunk. This is the only sequential pass over the
+	// data, and simple arithmetic for fixed width binary elements.
+	const u32 chunkCount = (Element.Count + PLY_ELEMENTS_PER_CHUNK - 1) / PLY_ELEMENTS_PER_CHUNK;
+	task.ChunkStarts.reallocate(chunkCount);
+	for (u32 c=0; c<chunkCount; ++c)
+	{
+		task.ChunkStarts.push_back(p);
+		p = skipElements(Element, p, end, core::min_<u32>(PLY_ELEMENTS_PER_CHUNK, Element.Count - c*PLY_ELEMENTS_PER_CHUNK));
+	}
+
+	if (isVertex)
+	{
+		// vertices are written straight into the buffer
+		scene::IVertexBuffer& vertices = mb->getVertexBuffer();
+		const u32 first = vertices.size();
+		vertices.set_used(first + Element.Count);
+		task.Vertices = vertices.pointer() + first;
+	}
+	else
+	{
+		// faces can have any number of triangles, so each chunk collects its own
+		task.ChunkIndices.reallocate(chunkCount);
+		for (u32 c=0; c<chunkCount; ++c)
+			task.ChunkIndices.push_back(core::array<u32>());
+	}
+
+	CThreadPool::getSharedPool()->parallelFor(chunkCount, 1, readChunks, &task);
+
+	if (!isVertex)
+	{
+		// stitch the triangles of all chunks together
+		scene::IIndexBuffer& indices = mb->getIndexBuffer();
+		u32 pos = indices.size();
+		u32 total = pos;
+		for (u32 c=0; c<chunkCount; ++c)
+			total += task.ChunkIndices[c].size();
+		indices.set_used(total);
+
+		for (u32 c=0; c<chunkCount; ++c)
+		{
+			const core::array<u32>& chunk = task.ChunkIndices[c];
+			if (indices.getType() == video::EIT_32BIT)
+			{
+				if (chunk.size())
+					memcpy((u32*)indices.pointer() + pos, chunk.const_pointer(), chunk.size()*sizeof(u32));
+			}
+			else
+			{
+				u16* dst = (u16*)indices.pointer() + pos;
+				for (u32 i=0; i<chunk.size(); ++i)
+					dst[i] = (u16)chunk[i];
+			}
+			pos += chunk.size();
+		}
+	}
+
+	return p;
+}
+
+
+void CPLYMeshFileLoader::readChunks(void* data, u32 begin, u32 end)
+{
+	SPLYReadTask& task = *(SPLYReadTask*)data;
+	const SPLYElement& element = *task.Element;
+
+	for (u32 c=begin; c<end; ++c)
+	{
+		const u32 first = c*PLY_ELEMENTS_PER_CHUNK;
+		const u32 count = core::min_<u32>(PLY_ELEMENTS_PER_CHUNK, element.Count - first);
+
+		if (task.Vertices)
+			task.Loader->readVertices(element, task.ChunkStarts[c], task.End, task.Vertices + first, count);
+		else
+			task.Loader->readFaces(element, task.ChunkStarts[c], task.End, count, task.VertexCount, task.ChunkIndices[c]);
+	}
+}
+
 
-		if (EndPointer - StartPointer > 0)
+const c8* CPLYMeshFileLoader::readVertices(const SPLYElement &Element, const c8* p, const c8* end, video::S3DVertex* vertices, u32 count) const
+{
+	for (u32 v=0; v<count; ++v)
+	{
+		video::S3DVertex& vert = vertices[v];
+		vert.Pos.set(0.0f, 0.0f, 0.0f);
+		vert.Normal.set(0.0f, 1.0f, 0.0f);
+		vert.Color.set(255,255,255,255);
+		vert.TCoords.set(0.0f, 0.0f);
+
+		if (!IsBinaryFile)
+			p = startPLYLine(p, end);
+
+		for (u32 i=0; i < Element.Properties.size(); ++i)
 		{
-			switch (t)
+			const SPLYProperty& prop = Element.Properties[i];
+			const E_PLY_PROPERTY_TYPE t = prop.Type;
+
+			switch (prop.Semantic)
 			{
-			case EPLYPT_INT8:
-				retVal = *StartPointer;
-				StartPointer++;
+			case EPLYS_X:
+				vert.Pos.X = getFloat(t, p, end);
 				break;
-			case EPLYPT_INT16:
-				if (IsWrongEndian)
-					retVal = os::Byteswap::byteswap(*(reinterpret_cast<s16*>(StartPointer)));
-				else
-					retVal = *(reinterpret_cast<s16*>(StartPointer));
-				StartPointer += 2;
+			case EPLYS_Y:
+				vert.Pos.Z = getFloat(t, p, end);
 				break;
-			case EPLYPT_INT32:
-				if (IsWrongEndian)
-					retVal = f32(os::Byteswap::byteswap(*(reinterpret_cast<s32*>(StartPointer))));
-				else
-					retVal = f32(*(reinterpret_cast<s32*>(StartPointer)));
-				StartPointer += 4;
+			case EPLYS_Z:
+				vert.Pos.Y = getFloat(t, p, end);
 				break;
-			case EPLYPT_FLOAT32:
-				if (IsWrongEndian)
-					retVal = os::Byteswap::byteswap(*(reinterpret_cast<f32*>(StartPointer)));
-				else
-					retVal = *(reinterpret_cast<f32*>(StartPointer));
-				StartPointer += 4;
+			case EPLYS_NX:
+				vert.Normal.X = getFloat(t, p, end);
+				break;
+			case EPLYS_NY:
+				vert.Normal.Z = getFloat(t, p, end);
+				break;
+			case EPLYS_NZ:
+				vert.Normal.Y = getFloat(t, p, end);
+				break;
+			case EPLYS_U:
+				vert.TCoords.X = getFloat(t, p, end);
 				break;
-			case EPLYPT_FLOAT64:
-				// todo: byteswap 64-bit
-				retVal = f32(*(reinterpret_cast<f64*>(StartPointer)));
-				StartPointer += 8;
+			case EPLYS_V:
+				vert.TCoords.Y = getFloat(t, p, end);
+				break;
+			case EPLYS_RED:
+				vert.Color.setRed(prop.isFloat() ? (u32)(getFloat(t, p, end)*255.0f) : getInt(t, p, end));
+				break;
+			case EPLYS_GREEN:
+				vert.Color.setGreen(prop.isFloat() ? (u32)(getFloat(t, p, end)*255.0f) : getInt(t, p, end));
+				break;
+			case EPLYS_BLUE:
+				vert.Color.setBlue(prop.isFloat() ? (u32)(getFloat(t, p, end)*255.0f) : getInt(t, p, end));
+				break;
+			case EPLYS_ALPHA:
+				vert.Color.setAlpha(prop.isFloat() ? (u32)(getFloat(t, p, end)*255.0f) : getInt(t, p, end));
 				break;
-			case EPLYPT_LIST:
-			case EPLYPT_UNKNOWN:
 			default:
-				retVal = 0.0f;
-				StartPointer++; // ouch!
+				skipProperty(prop, p, end);
 			}
 		}
+
+		if (!IsBinaryFile)
+			p = endPLYLine(p, end);
+	}
+
+	return p;
+}
+
+
+const c8* CPLYMeshFileLoader::readFaces(const SPLYElement &Element, const c8* p, const c8* end, u32 count, u32 vertexCount, core::array<u32>& indices) const
+{
+	indices.reallocate(count*3);
+
+	for (u32 f=0; f<count; ++f)
+	{
+		if (!IsBinaryFile)
+			p = startPLYLine(p, end);
+
+		for (u32 i=0; i < Element.Properties.size(); ++i)
+		{
+			const SPLYProperty& prop = Element.Properties[i];
+			if (prop.Semantic != EPLYS_VERTEX_INDICES)
+			{
+				skipProperty(prop, p, end);
+				continue;
+			}
+
+			const E_PLY_PROPERTY_TYPE t = prop.Data.List.ItemType;
+			const u32 cornerCount = getInt(prop.Data.List.CountType, p, end);
+
+			// every value takes at least one byte, don't trust broken counts
+			if (cornerCount > (u32)(end-p))
+			{
+				p = end;
+				break;
+			}
+			if (cornerCount < 3)
+			{
+				for (u32 j=0; j<cornerCount; ++j)
+					getInt(t, p, end);
+				continue;
+			}
+
+			// triangulate as fan, triangles with invalid vertices are dropped
+			const u32 a = getInt(t, p, end);
+			u32 b;
+			u32 c = getInt(t, p, end);
+
+			for (u32 j=2; j<cornerCount; ++j)
+			{
+				b = c;
+				c = getInt(t, p, end);
+				if (a < vertexCount && b < vertexCount && c < vertexCount)
+				{
+					indices.push_back(a);
+					indices.push_back(c);
+					indices.push_back(b);
+				}
+			}
+		}
+
+		if (!IsBinaryFile)
+			p = endPLYLine(p, end);
+	}
+
+	return p;
+}
+
+
+// skips elements and all their properties
+const c8* CPLYMeshFileLoader::skipElements(const SPLYElement &Element, const c8* p, const c8* end, u32 count) const
+{
+	if (IsBinaryFile)
+	{
+		if (Element.IsFixedWidth)
+		{
+			if (Element.KnownSize && (u32)(end-p) / Element.KnownSize < count)
+				return end;
+			return p + Element.KnownSize*count;
+		}
+
+		for (u32 e=0; e<count && p<end; ++e)
+			for (u32 i=0; i < Element.Properties.size(); ++i)
+				skipProperty(Element.Properties[i], p, end);
+	}
+	else
+	{
+		for (u32 e=0; e<count && p<end; ++e)
+			p = endPLYLine(startPLYLine(p, end), end);
+	}
+	return p;
+}
+
+
+void CPLYMeshFileLoader::skipProperty(const SPLYProperty &Property, const c8*& p, const c8* end) const
+{
+	if (Property.Type == EPLYPT_LIST)
+	{
+		const u32 count = getInt(Property.Data.List.CountType, p, end);
+
+		if (IsBinaryFile)
+		{
+			const u32 size = getPLYTypeSize(Property.Data.List.ItemType);
+			if (size && (u32)(end-p) / size >= count)
+				p += size*count;
+			else
+				p = end;
+		}
 		else
-			retVal = 0.0f;
+		{
+			for (u32 i=0; i < count && p < end; ++i)
+				getInt(Property.Data.List.ItemType, p, end);
+		}
 	}
 	else
 	{
-		c8* word = getNextWord();
+		if (IsBinaryFile)
+			p += core::min_(Property.size(), (u32)(end-p));
+		else
+			p = skipPLYToken(skipPLYBlanks(p, end), end);
+	}
+}
+
+
+// read the next float and move the pointer along
+f32 CPLYMeshFileLoader::getFloat(E_PLY_PROPERTY_TYPE t, const c8*& p, const c8* end) const
+{
+	f32 retVal = 0.0f;
+
+	if (IsBinaryFile)
+	{
+		const u32 size = getPLYTypeSize(t);
+		if (!size || p + size > end)
+		{
+			p = end;
+			return 0.0f;
+		}
+
 		switch (t)
 		{
 		case EPLYPT_INT8:
+			retVal = (f32)(s8)*p;
+			break;
 		case EPLYPT_INT16:
+			{
+				s16 value;
+				readPLYBytes(&value, p, 2, IsWrongEndian);
+				retVal = value;
+			}
+			break;
 		case EPLYPT_INT32:
-			retVal = f32(atoi(word));
+			{
+				s32 value;
+				readPLYBytes(&value, p, 4, IsWrongEndian);
+				retVal = f32(value);
+			}
 			break;
 		case EPLYPT_FLOAT32:
+			readPLYBytes(&retVal, p, 4, IsWrongEndian);
+			break;
 		case EPLYPT_FLOAT64:
-			retVal = f32(atof(word));
+			{
+				f64 value;
+				readPLYBytes(&value, p, 8, IsWrongEndian);
+				retVal = f32(value);
+			}
 			break;
-		case EPLYPT_LIST:
-		case EPLYPT_UNKNOWN:
 		default:
-			retVal = 0.0f;
+			break;
 		}
+		p += size;
+	}
+	else
+	{
+		p = skipPLYBlanks(p, end);
+		if (p < end && *p != '\n')
+			p = skipPLYToken(core::fast_atof_exact_move(p, retVal), end);
 	}
 	return retVal;
 }
 
 
-// read the next int from the file and move the start pointer along
-u32 CPLYMeshFileLoader::getInt(E_PLY_PROPERTY_TYPE t)
+// read the next int and move the pointer along
+u32 CPLYMeshFileLoader::getInt(E_PLY_PROPERTY_TYPE t, const c8*& p, const c8* end) const
 {
 	u32 retVal = 0;
 
 	if (IsBinaryFile)
 	{
-		if (!EndOfFile && EndPointer - StartPointer < 8)
-			fillBuffer();
-
-		if (EndPointer - StartPointer)
+		const u32 size = getPLYTypeSize(t);
+		if (!size || p + size > end)
 		{
-			switch (t)
-			{
-			case EPLYPT_INT8:
-				retVal = *StartPointer;
-				StartPointer++;
-				break;
-			case EPLYPT_INT16:
-				if (IsWrongEndian)
-					retVal = os::Byteswap::byteswap(*(reinterpret_cast<u16*>(StartPointer)));
-				else
-					retVal = *(reinterpret_cast<u16*>(StartPointer));
-				StartPointer += 2;
-				break;
-			case EPLYPT_INT32:
-				if (IsWrongEndian)
-					retVal = os::Byteswap::byteswap(*(reinterpret_cast<s32*>(StartPointer)));
-				else
-					retVal = *(reinterpret_cast<s32*>(StartPointer));
-				StartPointer += 4;
-				break;
-			case EPLYPT_FLOAT32:
-				if (IsWrongEndian)
-					retVal = (u32)os::Byteswap::byteswap(*(reinterpret_cast<f32*>(StartPointer)));
-				else
-					retVal = (u32)(*(reinterpret_cast<f32*>(StartPointer)));
-				StartPointer += 4;
-				break;
-			case EPLYPT_FLOAT64:
-				// todo: byteswap 64-bit
-				retVal = (u32)(*(reinterpret_cast<f64*>(StartPointer)));
-				StartPointer += 8;
-				break;
-			case EPLYPT_LIST:
-			case EPLYPT_UNKNOWN:
-			default:
-				retVal = 0;
-				StartPointer++; // ouch!
-			}
+			p = end;
+			return 0;
 		}
-		else
-			retVal = 0;
-	}
-	else
-	{
-		c8* word = getNextWord();
+
 		switch (t)
 		{
 		case EPLYPT_INT8:
+			retVal = (u8)*p;
+			break;
 		case EPLYPT_INT16:
+			{
+				u16 value;
+				readPLYBytes(&value, p, 2, IsWrongEndian);
+				retVal = value;
+			}
+			break;
 		case EPLYPT_INT32:
-			retVal = atoi(word);
+			readPLYBytes(&retVal, p, 4, IsWrongEndian);
 			break;
 		case EPLYPT_FLOAT32:
+			{
+				f32 value;
+				readPLYBytes(&value, p, 4, IsWrongEndian);
+				retVal = (u32)value;
+			}
+			break;
 		case EPLYPT_FLOAT64:
-			retVal = u32(atof(word));
+			{
+				f64 value;
+				readPLYBytes(&value, p, 8, IsWrongEndian);
+				retVal = (u32)value;
+			}
 			break;
-		case EPLYPT_LIST:
-		case EPLYPT_UNKNOWN:
 		default:
-			retVal = 0;
+			break;
+		}
+		p += size;
+	}
+	else
+	{
+		p = skipPLYBlanks(p, end);
+		if (p < end && *p != '\n')
+		{
+			if (t == EPLYPT_FLOAT32 || t == EPLYPT_FLOAT64)
+			{
+				f32 value;
+				p = core::fast_atof_exact_move(p, value);
+				retVal = (u32)value;
+			}
+			else
+				retVal = core::strtol10(p, &p);
+			p = skipPLYToken(p, end);
 		}
 	}
 	return retVal;
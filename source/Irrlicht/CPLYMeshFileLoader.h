@@ -24,6 +24,25 @@ enum E_PLY_PROPERTY_TYPE
 	EPLYPT_UNKNOWN
 };
 
+//! what the value of a property is used for
+enum E_PLY_SEMANTIC
+{
+	EPLYS_SKIP = 0,
+	EPLYS_X,
+	EPLYS_Y,
+	EPLYS_Z,
+	EPLYS_NX,
+	EPLYS_NY,
+	EPLYS_NZ,
+	EPLYS_U,
+	EPLYS_V,
+	EPLYS_RED,
+	EPLYS_GREEN,
+	EPLYS_BLUE,
+	EPLYS_ALPHA,
+	EPLYS_VERTEX_INDICES
+};
+
 //! Meshloader capable of loading obj meshes.
 class CPLYMeshFileLoader : public IMeshLoader
 {
@@ -48,6 +67,8 @@ private:
 	{
 		core::stringc Name;
 		E_PLY_PROPERTY_TYPE Type;
+		// resolved from the element and property name, so data is read without string compares
+		E_PLY_SEMANTIC Semantic;
 		union
 		{
 			u8  Int8;
@@ -122,13 +143,37 @@ private:
 	void fillBuffer();
 	E_PLY_PROPERTY_TYPE getPropertyType(const c8* typeString) const;
 
-	bool readVertex(const SPLYElement &Element, scene::CDynamicMeshBuffer* mb);
-	bool readFace(const SPLYElement &Element, scene::CDynamicMeshBuffer* mb);
-	void skipElement(const SPLYElement &Element);
-	void skipProperty(const SPLYProperty &Property);
-	f32 getFloat(E_PLY_PROPERTY_TYPE t);
-	u32 getInt(E_PLY_PROPERTY_TYPE t);
-	void moveForward(u32 bytes);
+	E_PLY_SEMANTIC getSemantic(const core::stringc& element, const core::stringc& property) const;
+
+	// the data section is read into memory as a whole and parsed in chunks of
+	// elements on the thread pool. These functions only read members, so they
+	// may run in parallel.
+
+	//! information for reading the chunks of one element in parallel
+	struct SPLYReadTask
+	{
+		const CPLYMeshFileLoader* Loader;
+		const SPLYElement* Element;
+		const c8* End;
+		// start of every chunk of PLY_ELEMENTS_PER_CHUNK elements
+		core::array<const c8*> ChunkStarts;
+		// vertex element: destination of the vertices
+		video::S3DVertex* Vertices;
+		// face element: triangle indices of each chunk
+		core::array<core::array<u32> > ChunkIndices;
+		// face element: number of vertices the indices may refer to
+		u32 VertexCount;
+	};
+
+	//! reads the elements of an element type, returns the first byte after them
+	const c8* readElements(const SPLYElement &Element, const c8* p, const c8* end, scene::CDynamicMeshBuffer* mb) const;
+	static void readChunks(void* task, u32 begin, u32 end);
+	const c8* readVertices(const SPLYElement &Element, const c8* p, const c8* end, video::S3DVertex* vertices, u32 count) const;
+	const c8* readFaces(const SPLYElement &Element, const c8* p, const c8* end, u32 count, u32 vertexCount, core::array<u32>& indices) const;
+	const c8* skipElements(const SPLYElement &Element, const c8* p, const c8* end, u32 count) const;
+	void skipProperty(const SPLYProperty &Property, const c8*& p, const c8* end) const;
+	f32 getFloat(E_PLY_PROPERTY_TYPE t, const c8*& p, const c8* end) const;
+	u32 getInt(E_PLY_PROPERTY_TYPE t, const c8*& p, const c8* end) const;
 
 	core::array<SPLYElement*> ElementList;
 
@@ -3,6 +3,7 @@
 // For conditions of distribution and use, see copyright notice in irrlicht.h
 
 #include "CReadFile.h"
+#include "CMappedReadFile.h"
 
 namespace irr
 {
@@ -100,6 +101,13 @@ const io::path& CReadFile::getFileName() const
 
 IReadFile* createReadFile(const io::path& fileName)
 {
+#ifdef _IRR_COMPILE_WITH_MAPPED_FILES_
+	// prefer mapping the file, stdio is the fallback for files which can't be mapped
+	IReadFile* mapped = createMappedReadFile(fileName);
+	if (mapped)
+		return mapped;
+#endif
+
 	CReadFile* file = new CReadFile(fileName);
 	if (file->isOpen())
 		return file;
@@ -11,8 +11,10 @@
 #include "SMeshBuffer.h"
 #include "SAnimatedMesh.h"
 #include "IReadFile.h"
+#include "CDynamicMeshBuffer.h"
 #include "fast_atof.h"
 #include "coreutil.h"
+#include "CThreadPool.h"
 #include "os.h"
 
 namespace irr
@@ -20,6 +22,29 @@ namespace irr
 namespace scene
 {
 
+// size of a triangle in binary files: normal, three vertices and attribute
+#define STL_BINARY_TRIANGLE_SIZE 50
+
+// ascii files are split into ranges of about this size which are parsed in parallel
+#define STL_ASCII_RANGE_SIZE 262144
+
+namespace
+{
+
+// reads a vector from binary data
+inline core::vector3df getBinaryVector(const c8* p)
+{
+	f32 v[3];
+	memcpy(v, p, 12);
+#ifdef __BIG_ENDIAN__
+	for (u32 i=0; i<3; ++i)
+		v[i] = os::Byteswap::byteswap(v[i]);
+#endif
+	return core::vector3df(-v[0], v[1], v[2]);
+}
+
+} // end anonymous namespace
+
 
 //! returns true if the file maybe is able to be loaded by this class
 //! based on the file extension (e.g. ".bsp")
@@ -40,117 +65,143 @@ IAnimatedMesh* CSTLMeshFileLoader::createMesh(io::IReadFile* file)
 	if (filesize < 6) // we need a header
 		return 0;
 
-	const u32 WORD_BUFFER_LENGTH = 512;
-
-	SMesh* mesh = new SMesh();
-	SMeshBuffer* meshBuffer = new SMeshBuffer();
-	mesh->addMeshBuffer(meshBuffer);
-	meshBuffer->drop();
-
-	core::vector3df vertex[3];
-	core::vector3df normal;
-
-	c8 buffer[WORD_BUFFER_LENGTH];
+	// mapped files are decoded in place, others are read with a single call
+	const c8* data = (const c8*)file->getMappedData();
+	c8* dataCopy = 0;
+	u32 dataSize = (u32)filesize;
+	if (!data)
+	{
+		dataCopy = new c8[filesize+1];
+		file->seek(0);
+		dataSize = file->read(dataCopy, filesize);
+		dataCopy[dataSize] = 0;
+		data = dataCopy;
+	}
+	const c8* dataEnd = data + dataSize;
 
-	bool binary = false;
-	core::stringc token;
-	if (getNextToken(file, token) != "solid")
-		binary = true;
-	// read/skip header
+	// binary files may start with "solid" as well, but have a fixed size
 	u32 binFaceCount = 0;
-	if (binary)
+	if (dataSize >= 84)
 	{
-		file->seek(80);
-		file->read(&binFaceCount, 4);
+		memcpy(&binFaceCount, data+80, 4);
 #ifdef __BIG_ENDIAN__
 		binFaceCount = os::Byteswap::byteswap(binFaceCount);
 #endif
 	}
-	else
-		goNextLine(file);
+	const c8* p = data;
+	const bool binary = !readToken(p, dataEnd, "solid") ||
+		(dataSize >= 84 && (dataSize - 84) / STL_BINARY_TRIANGLE_SIZE == binFaceCount &&
+			(dataSize - 84) % STL_BINARY_TRIANGLE_SIZE == 0);
+
+	// ascii numbers need a trailing white space or a zero byte to stop at the end of the file
+	if (!binary && !dataCopy && !core::isspace(dataEnd[-1]))
+	{
+		dataCopy = new c8[dataSize+1];
+		memcpy(dataCopy, data, dataSize);
+		dataCopy[dataSize] = 0;
+		data = dataCopy;
+		dataEnd = data + dataSize;
+	}
 
-	u16 attrib=0;
-	token.reserve(32);
+	SSTLReadTask task;
+	task.Loader = this;
+	task.Data = data;
+	task.End = dataEnd;
+	task.Vertices = 0;
 
-	while (file->getPos() < filesize)
+	u32 vertexCount = 0;
+	u32 rangeCount = 0;
+
+	if (binary)
 	{
-		if (!binary)
-		{
-			if (getNextToken(file, token) != "facet")
-			{
-				if (token=="endsolid")
-					break;
-				mesh->drop();
-				return 0;
-			}
-			if (getNextToken(file, token) != "normal")
-			{
-				mesh->drop();
-				return 0;
-			}
-		}
-		getNextVector(file, normal, binary);
-		if (!binary)
-		{
-			if (getNextToken(file, token) != "outer")
-			{
-				mesh->drop();
-				return 0;
-			}
-			if (getNextToken(file, token) != "loop")
-			{
-				mesh->drop();
-				return 0;
-			}
-		}
-		for (u32 i=0; i<3; ++i)
+		// all triangles are read, no matter what the header says
+		const u32 triangleCount = (dataSize < 84) ? 0 : (dataSize - 84) / STL_BINARY_TRIANGLE_SIZE;
+		vertexCount = triangleCount*3;
+		task.Data = data + 84;
+	}
+	else
+	{
+		// skip header line
+		p = goNextLine(data, dataEnd);
+
+		// split into ranges which all start with a facet
+		p = findFacet(p, dataEnd);
+		while (p < dataEnd)
 		{
-			if (!binary)
-			{
-				if (getNextToken(file, token) != "vertex")
-				{
-					mesh->drop();
-					return 0;
-				}
-			}
-			getNextVector(file, vertex[i], binary);
+			task.RangeStarts.push_back(p);
+			task.RangeVertices.push_back(core::array<video::S3DVertex>());
+			task.RangeFailed.push_back(false);
+			task.RangeEndsSolid.push_back(false);
+			if ((u32)(dataEnd - p) <= STL_ASCII_RANGE_SIZE)
+				break;
+			p = findFacet(p + STL_ASCII_RANGE_SIZE, dataEnd);
 		}
-		if (!binary)
+
+		CThreadPool::getSharedPool()->parallelFor(task.RangeStarts.size(), 1, readAsciiRanges, &task);
+
+		// stitch the ranges together, the file ends with the first solid
+		for (; rangeCount < task.RangeStarts.size(); ++rangeCount)
 		{
-			if (getNextToken(file, token) != "endloop")
+			if (task.RangeFailed[rangeCount])
 			{
-				mesh->drop();
+				delete [] dataCopy;
 				return 0;
 			}
-			if (getNextToken(file, token) != "endfacet")
+			vertexCount += task.RangeVertices[rangeCount].size();
+			if (task.RangeEndsSolid[rangeCount])
 			{
-				mesh->drop();
-				return 0;
+				++rangeCount;
+				break;
 			}
 		}
-		else
+	}
+
+	// 16 bit indices are enough for most files, larger ones get 32 bit indices
+	IMeshBuffer* buffer = 0;
+	video::S3DVertex* vertices = 0;
+	if (vertexCount <= 65535)
+	{
+		SMeshBuffer* mb = new SMeshBuffer();
+		mb->Vertices.set_used(vertexCount);
+		mb->Indices.set_used(vertexCount);
+		for (u32 i=0; i<vertexCount; ++i)
+			mb->Indices[i] = (u16)i;
+		vertices = mb->Vertices.pointer();
+		buffer = mb;
+	}
+	else
+	{
+		CDynamicMeshBuffer* mb = new CDynamicMeshBuffer(video::EVT_STANDARD, video::EIT_32BIT);
+		mb->getVertexBuffer().set_used(vertexCount);
+		mb->getIndexBuffer().set_used(vertexCount);
+		u32* indices = (u32*)mb->getIndexBuffer().pointer();
+		for (u32 i=0; i<vertexCount; ++i)
+			indices[i] = i;
+		vertices = mb->getVertexBuffer().pointer();
+		buffer = mb;
+	}
+
+	if (binary)
+	{
+		task.Vertices = vertices;
+		CThreadPool::getSharedPool()->parallelFor(vertexCount/3, 4096, readBinaryTriangles, &task);
+	}
+	else
+	{
+		for (u32 i=0; i<rangeCount; ++i)
 		{
-			file->read(&attrib, 2);
-#ifdef __BIG_ENDIAN__
-			attrib = os::Byteswap::byteswap(attrib);
-#endif
+			const core::array<video::S3DVertex>& range = task.RangeVertices[i];
+			for (u32 j=0; j<range.size(); ++j)
+				*vertices++ = range[j];
 		}
+	}
+
+	delete [] dataCopy;
 
-		SMeshBuffer* mb = reinterpret_cast<SMeshBuffer*>(mesh->getMeshBuffer(mesh->getMeshBufferCount()-1));
-		u32 vCount = mb->getVertexCount();
-		video::SColor color(0xffffffff);
-		if (attrib & 0x8000)
-			color = video::A1R5G5B5toA8R8G8B8(attrib);
-		if (normal==core::vector3df())
-			normal=core::plane3df(vertex[2],vertex[1],vertex[0]).Normal;
-		mb->Vertices.push_back(video::S3DVertex(vertex[2],normal,color, core::vector2df()));
-		mb->Vertices.push_back(video::S3DVertex(vertex[1],normal,color, core::vector2df()));
-		mb->Vertices.push_back(video::S3DVertex(vertex[0],normal,color, core::vector2df()));
-		mb->Indices.push_back(vCount);
-		mb->Indices.push_back(vCount+1);
-		mb->Indices.push_back(vCount+2);
-	}	// end while (file->getPos() < filesize)
-	mesh->getMeshBuffer(0)->recalculateBoundingBox();
+	SMesh* mesh = new SMesh();
+	mesh->addMeshBuffer(buffer);
+	buffer->drop();
+	buffer->recalculateBoundingBox();
 
 	// Create the Animated mesh if there's anything in the mesh
 	SAnimatedMesh* pAM = 0;
@@ -169,83 +220,154 @@ IAnimatedMesh* CSTLMeshFileLoader::createMesh(io::IReadFile* file)
 }
 
 
-//! Read 3d vector of floats
-void CSTLMeshFileLoader::getNextVector(io::IReadFile* file, core::vector3df& vec, bool binary) const
+//! decodes the binary triangles [begin,end)
+void CSTLMeshFileLoader::readBinaryTriangles(void* data, u32 begin, u32 end)
 {
-	if (binary)
+	const SSTLReadTask& task = *(const SSTLReadTask*)data;
+
+	for (u32 i=begin; i<end; ++i)
 	{
-		file->read(&vec.X, 4);
-		file->read(&vec.Y, 4);
-		file->read(&vec.Z, 4);
+		const c8* p = task.Data + i*STL_BINARY_TRIANGLE_SIZE;
+
+		core::vector3df vertex[3];
+		const core::vector3df normal = getBinaryVector(p);
+		for (u32 j=0; j<3; ++j)
+			vertex[j] = getBinaryVector(p + 12 + j*12);
+
+		u16 attrib;
+		memcpy(&attrib, p + 48, 2);
 #ifdef __BIG_ENDIAN__
-		vec.X = os::Byteswap::byteswap(vec.X);
-		vec.Y = os::Byteswap::byteswap(vec.Y);
-		vec.Z = os::Byteswap::byteswap(vec.Z);
+		attrib = os::Byteswap::byteswap(attrib);
 #endif
+		task.Loader->addTriangle(task.Vertices + i*3, vertex, normal, attrib);
 	}
-	else
-	{
-		goNextWord(file);
-		core::stringc tmp;
-
-		getNextToken(file, tmp);
-		core::fast_atof_move(tmp.c_str(), vec.X);
-		getNextToken(file, tmp);
-		core::fast_atof_move(tmp.c_str(), vec.Y);
-		getNextToken(file, tmp);
-		core::fast_atof_move(tmp.c_str(), vec.Z);
-	}
-	vec.X=-vec.X;
 }
 
 
-//! Read next word
-const core::stringc& CSTLMeshFileLoader::getNextToken(io::IReadFile* file, core::stringc& token) const
+//! parses the ascii ranges [begin,end)
+void CSTLMeshFileLoader::readAsciiRanges(void* data, u32 begin, u32 end)
 {
-	goNextWord(file);
-	u8 c;
-	token = "";
-	while(file->getPos() != file->getSize())
+	SSTLReadTask& task = *(SSTLReadTask*)data;
+
+	for (u32 i=begin; i<end; ++i)
 	{
-		file->read(&c, 1);
-		// found it, so leave
-		if (core::isspace(c))
-			break;
-		token.append(c);
+		const c8* rangeEnd = (i+1 < task.RangeStarts.size()) ? task.RangeStarts[i+1] : task.End;
+		bool endOfSolid = false;
+		task.RangeFailed[i] = !task.Loader->readAsciiFacets(task.RangeStarts[i], rangeEnd,
+				task.End, task.RangeVertices[i], endOfSolid);
+		task.RangeEndsSolid[i] = endOfSolid;
 	}
-	return token;
 }
 
 
-//! skip to next word
-void CSTLMeshFileLoader::goNextWord(io::IReadFile* file) const
+bool CSTLMeshFileLoader::readAsciiFacets(const c8* p, const c8* end, const c8* dataEnd,
+		core::array<video::S3DVertex>& vertices, bool& endOfSolid) const
 {
-	u8 c;
-	while(file->getPos() != file->getSize())
+	// a facet takes about 250 characters
+	vertices.reallocate((end - p) / 80 + 3);
+
+	core::vector3df vertex[3];
+	core::vector3df normal;
+
+	while ((p = goNextWord(p, dataEnd)) < end)
 	{
-		file->read(&c, 1);
-		// found it, so leave
-		if (!core::isspace(c))
+		if (!readToken(p, dataEnd, "facet"))
+		{
+			endOfSolid = readToken(p, dataEnd, "endsolid");
+			return endOfSolid;
+		}
+		if (!readToken(p, dataEnd, "normal") || !getNextVector(p, dataEnd, normal))
+			return false;
+		if (!readToken(p, dataEnd, "outer") || !readToken(p, dataEnd, "loop"))
+			return false;
+		for (u32 i=0; i<3; ++i)
 		{
-			file->seek(-1, true);
-			break;
+			if (!readToken(p, dataEnd, "vertex") || !getNextVector(p, dataEnd, vertex[i]))
+				return false;
 		}
+		if (!readToken(p, dataEnd, "endloop") || !readToken(p, dataEnd, "endfacet"))
+			return false;
+
+		const u32 vCount = vertices.size();
+		vertices.set_used(vCount+3);
+		addTriangle(&vertices[vCount], vertex, normal, 0);
 	}
+	return true;
+}
+
+
+void CSTLMeshFileLoader::addTriangle(video::S3DVertex* out, core::vector3df* vertex,
+		core::vector3df normal, u16 attrib) const
+{
+	video::SColor color(0xffffffff);
+	if (attrib & 0x8000)
+		color = video::A1R5G5B5toA8R8G8B8(attrib);
+	if (normal==core::vector3df())
+		normal=core::plane3df(vertex[2],vertex[1],vertex[0]).Normal;
+	out[0] = video::S3DVertex(vertex[2],normal,color, core::vector2df());
+	out[1] = video::S3DVertex(vertex[1],normal,color, core::vector2df());
+	out[2] = video::S3DVertex(vertex[0],normal,color, core::vector2df());
+}
+
+
+//! Read 3d vector of floats
+bool CSTLMeshFileLoader::getNextVector(const c8*& p, const c8* end, core::vector3df& vec) const
+{
+	f32 v[3];
+	const c8* next = p;
+	if (core::fast_atof_array(p, v, 3, &next) != 3 || next > end)
+		return false;
+	p = next;
+	vec.set(-v[0], v[1], v[2]);
+	return true;
 }
 
 
-//! Read until line break is reached and stop at the next non-space character
-void CSTLMeshFileLoader::goNextLine(io::IReadFile* file) const
+//! Read next word and compare it
+bool CSTLMeshFileLoader::readToken(const c8*& p, const c8* end, const c8* token) const
+{
+	const c8* word = goNextWord(p, end);
+	const c8* wordEnd = word;
+	while (wordEnd < end && !core::isspace(*wordEnd))
+		++wordEnd;
+
+	const u32 length = (u32)strlen(token);
+	if ((u32)(wordEnd - word) != length || strncmp(word, token, length))
+		return false;
+	p = wordEnd;
+	return true;
+}
+
+
+//! skip to next word
+const c8* CSTLMeshFileLoader::goNextWord(const c8* p, const c8* end) const
+{
+	while (p < end && core::isspace(*p))
+		++p;
+	return p;
+}
+
+
+//! Read until line break is reached and stop behind it
+const c8* CSTLMeshFileLoader::goNextLine(const c8* p, const c8* end) const
 {
-	u8 c;
 	// look for newline characters
-	while(file->getPos() != file->getSize())
+	while (p < end && *p != '\n' && *p != '\r')
+		++p;
+	return (p < end) ? p+1 : end;
+}
+
+
+//! find the next word "facet"
+const c8* CSTLMeshFileLoader::findFacet(const c8* p, const c8* end) const
+{
+	for (; p + 5 <= end; ++p)
 	{
-		file->read(&c, 1);
-		// found it, so leave
-		if (c=='\n' || c=='\r')
-			break;
+		if (*p == 'f' && !strncmp(p, "facet", 5) &&
+			(p + 5 == end || core::isspace(p[5])) && core::isspace(p[-1]))
+			return p;
 	}
+	return end;
 }
 
 
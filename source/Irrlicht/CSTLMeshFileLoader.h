@@ -8,6 +8,8 @@
 #include "IMeshLoader.h"
 #include "irrString.h"
 #include "vector3d.h"
+#include "irrArray.h"
+#include "S3DVertex.h"
 
 namespace irr
 {
@@ -31,15 +33,46 @@ public:
 
 private:
 
-	// skips to the first non-space character available
-	void goNextWord(io::IReadFile* file) const;
-	// returns the next word
-	const core::stringc& getNextToken(io::IReadFile* file, core::stringc& token) const;
-	// skip to next printable character after the first line break
-	void goNextLine(io::IReadFile* file) const;
+	//! information for decoding the triangles of a file in parallel
+	struct SSTLReadTask
+	{
+		const CSTLMeshFileLoader* Loader;
+		const c8* Data;
+		const c8* End;
+		// binary files: destination of the vertices
+		video::S3DVertex* Vertices;
+		// ascii files: start of each range, every range starts with a facet
+		core::array<const c8*> RangeStarts;
+		// ascii files: vertices of each range
+		core::array<core::array<video::S3DVertex> > RangeVertices;
+		// ascii files: the range contained an error
+		core::array<bool> RangeFailed;
+		// ascii files: the range ended with the end of the solid
+		core::array<bool> RangeEndsSolid;
+	};
+
+	static void readBinaryTriangles(void* task, u32 begin, u32 end);
+	static void readAsciiRanges(void* task, u32 begin, u32 end);
+
+	//! reads the facets starting in [p,end), returns false on errors
+	bool readAsciiFacets(const c8* p, const c8* end, const c8* dataEnd,
+			core::array<video::S3DVertex>& vertices, bool& endOfSolid) const;
+
+	//! adds the vertices of a triangle in the order of the mesh buffers
+	void addTriangle(video::S3DVertex* out, core::vector3df* vertex,
+			core::vector3df normal, u16 attrib) const;
+
+	// returns the first character of the next word
+	const c8* goNextWord(const c8* p, const c8* end) const;
+	// reads the next word and compares it to token, moves the pointer behind it
+	bool readToken(const c8*& p, const c8* end, const c8* token) const;
+	// returns the first character after the next line break
+	const c8* goNextLine(const c8* p, const c8* end) const;
+	// returns the start of the next facet keyword
+	const c8* findFacet(const c8* p, const c8* end) const;
 
 	//! Read 3d vector of floats
-	void getNextVector(io::IReadFile* file, core::vector3df& vec, bool binary) const;
+	bool getNextVector(const c8*& p, const c8* end, core::vector3df& vec) const;
 };
 
 } // end namespace scene
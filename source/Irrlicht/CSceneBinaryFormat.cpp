@@ -0,0 +1,748 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CSceneBinaryFormat.h"
+#include "ISceneManager.h"
+#include "ISceneNode.h"
+#include "ISceneNodeFactory.h"
+#include "ISceneNodeAnimatorFactory.h"
+#include "ISceneUserDataSerializer.h"
+#include "IAttributes.h"
+#include "IFileSystem.h"
+#include "IReadFile.h"
+#include "IWriteFile.h"
+#include "IVideoDriver.h"
+#include "os.h"
+
+namespace irr
+{
+namespace scene
+{
+
+using namespace binaryscene;
+
+
+//! constructor
+CSceneBinaryWriter::CSceneBinaryWriter(ISceneManager* smgr)
+: SceneManager(smgr)
+{
+}
+
+
+//! writes the scene below root into the file
+bool CSceneBinaryWriter::write(io::IWriteFile* file, ISceneNode* root,
+		ISceneUserDataSerializer* userDataSerializer)
+{
+	if (!file || !root)
+		return false;
+
+	Nodes.clear();
+	Strings.clear();
+	StringMap.clear();
+	Data.clear();
+
+	writeNode(root, root, -1, userDataSerializer);
+
+	const u32 header[5] = { BYTE_ORDER_MARK, VERSION, Strings.size(), Nodes.size(), Data.size() };
+
+	bool ok = file->write(MAGIC, 4) == 4;
+	ok = ok && file->write(header, sizeof(header)) == sizeof(header);
+
+	// the string table is assembled in memory to write it at once
+	core::array<u16> table;
+	for (u32 i=0; i<Strings.size(); ++i)
+	{
+		const u32 length = core::min_(Strings[i].size(), (u32)0xFFFF);
+		table.push_back((u16)length);
+		for (u32 c=0; c<length; ++c)
+			table.push_back((u16)Strings[i][c]);
+	}
+
+	const u32 tableSize = table.size() * sizeof(u16);
+	ok = ok && file->write(&tableSize, sizeof(u32)) == sizeof(u32);
+	if (tableSize)
+		ok = ok && file->write(table.const_pointer(), tableSize) == (s32)tableSize;
+
+	for (u32 i=0; ok && i<Nodes.size(); ++i)
+	{
+		const SNodeRecord& n = Nodes[i];
+		const u32 record[6] = { (u32)n.Parent, n.Type, n.DataOffset,
+			n.MaterialCount, n.AnimatorCount, n.HasUserData };
+		ok = file->write(record, sizeof(record)) == sizeof(record);
+	}
+
+	if (Data.size())
+		ok = ok && file->write(Data.const_pointer(), Data.size()) == (s32)Data.size();
+
+	if (!ok)
+		os::Printer::log("Could not write binary scene file", file->getFileName(), ELL_ERROR);
+
+	return ok;
+}
+
+
+//! writes a node and its children
+void CSceneBinaryWriter::writeNode(ISceneNode* node, ISceneNode* root, s32 parent,
+		ISceneUserDataSerializer* userDataSerializer)
+{
+	if (node->isDebugObject())
+		return;
+
+	const s32 index = Nodes.size();
+	Nodes.push_back(SNodeRecord());
+
+	SNodeRecord record;
+	record.Parent = parent;
+	record.DataOffset = Data.size();
+	record.MaterialCount = 0;
+	record.AnimatorCount = 0;
+	record.HasUserData = 0;
+
+	if (node == root)
+		record.Type = addString(core::stringw());
+	else
+	{
+		const c8* typeName = SceneManager->getSceneNodeTypeName(node->getType());
+		record.Type = addString(core::stringw(typeName ? typeName : ""));
+	}
+
+	// properties
+	io::IAttributes* attr = SceneManager->getFileSystem()->createEmptyAttributes(SceneManager->getVideoDriver());
+	node->serializeAttributes(attr);
+	writeAttributes(attr);
+
+	// materials
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	if (driver)
+	{
+		record.MaterialCount = node->getMaterialCount();
+		for (u32 i=0; i<record.MaterialCount; ++i)
+		{
+			io::IAttributes* tmp = driver->createAttributesFromMaterial(node->getMaterial(i));
+			writeAttributes(tmp);
+			tmp->drop();
+		}
+	}
+
+	// animators
+	ISceneNodeAnimatorList::ConstIterator ait = node->getAnimators().begin();
+	for (; ait != node->getAnimators().end(); ++ait)
+	{
+		attr->clear();
+		attr->addString("Type", SceneManager->getAnimatorTypeName((*ait)->getType()));
+		(*ait)->serializeAttributes(attr);
+		writeAttributes(attr);
+		++record.AnimatorCount;
+	}
+
+	attr->drop();
+
+	// user data
+	if (userDataSerializer)
+	{
+		io::IAttributes* userData = userDataSerializer->createUserData(node);
+		if (userData)
+		{
+			writeAttributes(userData);
+			record.HasUserData = 1;
+			userData->drop();
+		}
+	}
+
+	Nodes[index] = record;
+
+	// children
+	ISceneNodeList::ConstIterator it = node->getChildren().begin();
+	for (; it != node->getChildren().end(); ++it)
+		writeNode(*it, root, index, userDataSerializer);
+}
+
+
+//! writes an attribute block
+void CSceneBinaryWriter::writeAttributes(io::IAttributes* attr)
+{
+	// the count is patched after the block is written
+	const u32 countOffset = Data.size();
+	u32 count = 0;
+	put(count);
+
+	for (u32 i=0; i<attr->getAttributeCount(); ++i)
+	{
+		const io::E_ATTRIBUTE_TYPE type = attr->getAttributeType(i);
+
+		// pointers can not be stored
+		if (type == io::EAT_USER_POINTER || type == io::EAT_UNKNOWN)
+			continue;
+
+		put((u8)type);
+		put(addString(core::stringw(attr->getAttributeName(i))));
+
+		switch (type)
+		{
+		case io::EAT_INT:
+			put(attr->getAttributeAsInt(i));
+			break;
+		case io::EAT_FLOAT:
+			put(attr->getAttributeAsFloat(i));
+			break;
+		case io::EAT_BOOL:
+			put((u8)(attr->getAttributeAsBool(i) ? 1 : 0));
+			break;
+		case io::EAT_COLOR:
+			put(attr->getAttributeAsColor(i).color);
+			break;
+		case io::EAT_COLORF:
+			{
+				const video::SColorf c = attr->getAttributeAsColorf(i);
+				put(c.r); put(c.g); put(c.b); put(c.a);
+			}
+			break;
+		case io::EAT_VECTOR3D:
+			{
+				const core::vector3df v = attr->getAttributeAsVector3d(i);
+				put(v.X); put(v.Y); put(v.Z);
+			}
+			break;
+		case io::EAT_POSITION2D:
+			{
+				const core::position2di p = attr->getAttributeAsPosition2d(i);
+				put(p.X); put(p.Y);
+			}
+			break;
+		case io::EAT_RECT:
+			{
+				const core::rect<s32> r = attr->getAttributeAsRect(i);
+				put(r.UpperLeftCorner.X); put(r.UpperLeftCorner.Y);
+				put(r.LowerRightCorner.X); put(r.LowerRightCorner.Y);
+			}
+			break;
+		case io::EAT_MATRIX:
+			{
+				const core::matrix4 m = attr->getAttributeAsMatrix(i);
+				putData(m.pointer(), 16*sizeof(f32));
+			}
+			break;
+		case io::EAT_QUATERNION:
+			{
+				const core::quaternion q = attr->getAttributeAsQuaternion(i);
+				put(q.X); put(q.Y); put(q.Z); put(q.W);
+			}
+			break;
+		case io::EAT_BBOX:
+			{
+				const core::aabbox3df b = attr->getAttributeAsBox3d(i);
+				put(b.MinEdge.X); put(b.MinEdge.Y); put(b.MinEdge.Z);
+				put(b.MaxEdge.X); put(b.MaxEdge.Y); put(b.MaxEdge.Z);
+			}
+			break;
+		case io::EAT_PLANE:
+			{
+				const core::plane3df p = attr->getAttributeAsPlane3d(i);
+				put(p.Normal.X); put(p.Normal.Y); put(p.Normal.Z); put(p.D);
+			}
+			break;
+		case io::EAT_TRIANGLE3D:
+			{
+				const core::triangle3df t = attr->getAttributeAsTriangle3d(i);
+				put(t.pointA.X); put(t.pointA.Y); put(t.pointA.Z);
+				put(t.pointB.X); put(t.pointB.Y); put(t.pointB.Z);
+				put(t.pointC.X); put(t.pointC.Y); put(t.pointC.Z);
+			}
+			break;
+		case io::EAT_LINE2D:
+			{
+				const core::line2df l = attr->getAttributeAsLine2d(i);
+				put(l.start.X); put(l.start.Y); put(l.end.X); put(l.end.Y);
+			}
+			break;
+		case io::EAT_LINE3D:
+			{
+				const core::line3df l = attr->getAttributeAsLine3d(i);
+				put(l.start.X); put(l.start.Y); put(l.start.Z);
+				put(l.end.X); put(l.end.Y); put(l.end.Z);
+			}
+			break;
+		case io::EAT_STRINGWARRAY:
+			{
+				const core::array<core::stringw> a = attr->getAttributeAsArray(i);
+				put(a.size());
+				for (u32 j=0; j<a.size(); ++j)
+					put(addString(a[j]));
+			}
+			break;
+		default:
+			// strings, enumerations, textures, binary data and all
+			// other types are stored in their string form, as in .irr files
+			put(addString(attr->getAttributeAsStringW(i)));
+			break;
+		}
+
+		++count;
+	}
+
+	memcpy(&Data[countOffset], &count, sizeof(u32));
+}
+
+
+//! returns the index of a string in the string table, adds it if needed
+u32 CSceneBinaryWriter::addString(const core::stringw& str)
+{
+	core::map<core::stringw, u32>::Node* n = StringMap.find(str);
+	if (n)
+		return n->getValue();
+
+	const u32 index = Strings.size();
+	Strings.push_back(str);
+	StringMap.insert(str, index);
+	return index;
+}
+
+
+void CSceneBinaryWriter::putData(const void* data, u32 size)
+{
+	const u32 offset = Data.size();
+	Data.set_used(offset + size);
+	memcpy(&Data[offset], data, size);
+}
+
+
+//! constructor
+CSceneBinaryReader::CSceneBinaryReader(ISceneManager* smgr)
+: SceneManager(smgr), Pos(0), End(0)
+{
+}
+
+
+//! returns true if the file starts with the binary scene magic
+bool CSceneBinaryReader::isBinaryScene(io::IReadFile* file)
+{
+	if (!file)
+		return false;
+
+	const long pos = file->getPos();
+	c8 magic[4];
+	const bool ret = file->read(magic, 4) == 4 && !memcmp(magic, MAGIC, 4);
+	file->seek(pos);
+	return ret;
+}
+
+
+//! reads the file with one bulk read and adds its nodes below root
+bool CSceneBinaryReader::read(io::IReadFile* file, ISceneNode* root,
+		ISceneUserDataSerializer* userDataSerializer)
+{
+	if (!file || !root)
+		return false;
+
+	const long size = file->getSize() - file->getPos();
+	if (size < (long)(4 + 6*sizeof(u32)))
+	{
+		os::Printer::log("Binary scene file is too small", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	core::array<u8> buffer;
+	buffer.set_used(size);
+	if (file->read(buffer.pointer(), size) != size)
+	{
+		os::Printer::log("Could not read binary scene file", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	Pos = buffer.const_pointer() + 4;
+	End = buffer.const_pointer() + size;
+
+	u32 header[6];
+	if (!getData(header, sizeof(header)))
+	{
+		os::Printer::log("Binary scene file is truncated", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	if (header[0] != BYTE_ORDER_MARK)
+	{
+		os::Printer::log("Binary scene file was written with a different byte order", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+	if (header[1] != VERSION)
+	{
+		os::Printer::log("Unsupported binary scene file version", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	const u32 stringCount = header[2];
+	const u32 nodeCount = header[3];
+	const u32 dataSize = header[4];
+	const u32 tableSize = header[5];
+
+	// string table, each string takes at least its u16 length
+	if ((u32)(End - Pos) < tableSize || stringCount > tableSize / sizeof(u16))
+	{
+		os::Printer::log("Binary scene file is truncated", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	const u8* tableEnd = Pos + tableSize;
+	Strings.set_used(0);
+	Strings.reallocate(stringCount);
+	Names.set_used(0);
+	Names.reallocate(stringCount);
+	for (u32 i=0; i<stringCount; ++i)
+	{
+		u16 length = 0;
+		if (!get(length) || (u32)(tableEnd - Pos) < length * sizeof(u16))
+		{
+			os::Printer::log("Binary scene file has a broken string table", file->getFileName(), ELL_ERROR);
+			return false;
+		}
+
+		core::stringw str;
+		str.reserve(length + 1);
+		for (u32 c=0; c<length; ++c)
+		{
+			u16 ch = 0;
+			get(ch);
+			str.append((wchar_t)ch);
+		}
+
+		Strings.push_back(str);
+		Names.push_back(core::stringc(str));
+	}
+	Pos = tableEnd;
+
+	// node records, checked without multiplying the counts of the file
+	const u32 recordSize = 6 * sizeof(u32);
+	const u32 remaining = (u32)(End - Pos);
+	if (nodeCount > remaining / recordSize || dataSize > remaining - nodeCount * recordSize)
+	{
+		os::Printer::log("Binary scene file is truncated", file->getFileName(), ELL_ERROR);
+		return false;
+	}
+
+	core::array<SNodeRecord> records;
+	records.set_used(nodeCount);
+	for (u32 i=0; i<nodeCount; ++i)
+	{
+		u32 record[6];
+		if (!getData(record, sizeof(record)))
+		{
+			os::Printer::log("Binary scene file is truncated", file->getFileName(), ELL_ERROR);
+			return false;
+		}
+		records[i].Parent = (s32)record[0];
+		records[i].Type = record[1];
+		records[i].DataOffset = record[2];
+		records[i].MaterialCount = record[3];
+		records[i].AnimatorCount = record[4];
+		records[i].HasUserData = record[5];
+	}
+
+	const u8* data = Pos;
+	End = data + dataSize;
+
+	// create the nodes, parents always come before their children
+	core::array<ISceneNode*> nodes;
+	nodes.set_used(nodeCount);
+
+	io::IFileSystem* fs = SceneManager->getFileSystem();
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	io::IAttributes* attr = fs->createEmptyAttributes(driver);
+	bool ok = true;
+
+	for (u32 i=0; i<nodeCount && ok; ++i)
+	{
+		const SNodeRecord& record = records[i];
+		ISceneNode* node = 0;
+
+		if (record.Parent < 0)
+			node = root;
+		else if ((u32)record.Parent < i && nodes[record.Parent] && record.Type < stringCount)
+		{
+			ISceneNode* parent = nodes[record.Parent];
+			const c8* typeName = Names[record.Type].c_str();
+
+			for (s32 f=(s32)SceneManager->getRegisteredSceneNodeFactoryCount()-1; f>=0 && !node; --f)
+				node = SceneManager->getSceneNodeFactory(f)->addSceneNode(typeName, parent);
+
+			if (!node)
+				os::Printer::log("Could not create scene node of unknown type", typeName);
+		}
+
+		nodes[i] = node;
+		if (!node)
+			continue;
+
+		if (record.DataOffset >= dataSize)
+		{
+			ok = false;
+			break;
+		}
+		Pos = data + record.DataOffset;
+
+		// properties
+		attr->clear();
+		ok = readAttributes(attr);
+		if (ok)
+			node->deserializeAttributes(attr);
+
+		// materials
+		for (u32 m=0; ok && m<record.MaterialCount; ++m)
+		{
+			attr->clear();
+			ok = readAttributes(attr);
+			if (ok && driver && m < node->getMaterialCount())
+				driver->fillMaterialStructureFromAttributes(node->getMaterial(m), attr);
+		}
+
+		// animators
+		for (u32 a=0; ok && a<record.AnimatorCount; ++a)
+		{
+			attr->clear();
+			ok = readAttributes(attr);
+			if (!ok)
+				break;
+
+			const core::stringc typeName = attr->getAttributeAsString("Type");
+			ISceneNodeAnimator* anim = 0;
+
+			for (u32 f=0; f<SceneManager->getRegisteredSceneNodeAnimatorFactoryCount() && !anim; ++f)
+				anim = SceneManager->getSceneNodeAnimatorFactory(f)->createSceneNodeAnimator(typeName.c_str(), node);
+
+			if (anim)
+			{
+				anim->deserializeAttributes(attr);
+				anim->drop();
+			}
+		}
+
+		// user data
+		if (ok && record.HasUserData)
+		{
+			attr->clear();
+			ok = readAttributes(attr);
+			if (ok && userDataSerializer)
+				userDataSerializer->OnReadUserData(node, attr);
+		}
+	}
+
+	attr->drop();
+
+	if (!ok)
+		os::Printer::log("Binary scene file has broken attribute data", file->getFileName(), ELL_ERROR);
+
+	// like the xml loader, report nodes after their children
+	if (userDataSerializer)
+	{
+		for (s32 i=(s32)nodes.size()-1; i>=0; --i)
+			if (nodes[i])
+				userDataSerializer->OnCreateNode(nodes[i]);
+	}
+
+	Strings.clear();
+	Names.clear();
+
+	return ok;
+}
+
+
+//! reads an attribute block at the current position
+bool CSceneBinaryReader::readAttributes(io::IAttributes* attr)
+{
+	u32 count;
+	if (!get(count))
+		return false;
+
+	for (u32 i=0; i<count; ++i)
+	{
+		u8 type;
+		u32 nameIndex;
+		if (!get(type) || !get(nameIndex) || nameIndex >= Names.size())
+			return false;
+
+		const c8* name = Names[nameIndex].c_str();
+		bool ok = true;
+
+		switch (type)
+		{
+		case io::EAT_INT:
+			{
+				s32 v = 0;
+				ok = get(v);
+				attr->addInt(name, v);
+			}
+			break;
+		case io::EAT_FLOAT:
+			{
+				f32 v = 0.f;
+				ok = get(v);
+				attr->addFloat(name, v);
+			}
+			break;
+		case io::EAT_BOOL:
+			{
+				u8 v = 0;
+				ok = get(v);
+				attr->addBool(name, v != 0);
+			}
+			break;
+		case io::EAT_COLOR:
+			{
+				u32 v = 0;
+				ok = get(v);
+				attr->addColor(name, video::SColor(v));
+			}
+			break;
+		case io::EAT_COLORF:
+			{
+				video::SColorf c;
+				ok = get(c.r) && get(c.g) && get(c.b) && get(c.a);
+				attr->addColorf(name, c);
+			}
+			break;
+		case io::EAT_VECTOR3D:
+			{
+				core::vector3df v;
+				ok = get(v.X) && get(v.Y) && get(v.Z);
+				attr->addVector3d(name, v);
+			}
+			break;
+		case io::EAT_POSITION2D:
+			{
+				core::position2di p;
+				ok = get(p.X) && get(p.Y);
+				attr->addPosition2d(name, p);
+			}
+			break;
+		case io::EAT_RECT:
+			{
+				core::rect<s32> r;
+				ok = get(r.UpperLeftCorner.X) && get(r.UpperLeftCorner.Y) &&
+					get(r.LowerRightCorner.X) && get(r.LowerRightCorner.Y);
+				attr->addRect(name, r);
+			}
+			break;
+		case io::EAT_MATRIX:
+			{
+				core::matrix4 m(core::matrix4::EM4CONST_NOTHING);
+				ok = getData(m.pointer(), 16*sizeof(f32));
+				attr->addMatrix(name, m);
+			}
+			break;
+		case io::EAT_QUATERNION:
+			{
+				core::quaternion q;
+				ok = get(q.X) && get(q.Y) && get(q.Z) && get(q.W);
+				attr->addQuaternion(name, q);
+			}
+			break;
+		case io::EAT_BBOX:
+			{
+				core::aabbox3df b;
+				ok = get(b.MinEdge.X) && get(b.MinEdge.Y) && get(b.MinEdge.Z) &&
+					get(b.MaxEdge.X) && get(b.MaxEdge.Y) && get(b.MaxEdge.Z);
+				attr->addBox3d(name, b);
+			}
+			break;
+		case io::EAT_PLANE:
+			{
+				core::plane3df p;
+				ok = get(p.Normal.X) && get(p.Normal.Y) && get(p.Normal.Z) && get(p.D);
+				attr->addPlane3d(name, p);
+			}
+			break;
+		case io::EAT_TRIANGLE3D:
+			{
+				core::triangle3df t;
+				ok = get(t.pointA.X) && get(t.pointA.Y) && get(t.pointA.Z) &&
+					get(t.pointB.X) && get(t.pointB.Y) && get(t.pointB.Z) &&
+					get(t.pointC.X) && get(t.pointC.Y) && get(t.pointC.Z);
+				attr->addTriangle3d(name, t);
+			}
+			break;
+		case io::EAT_LINE2D:
+			{
+				core::line2df l;
+				ok = get(l.start.X) && get(l.start.Y) && get(l.end.X) && get(l.end.Y);
+				attr->addLine2d(name, l);
+			}
+			break;
+		case io::EAT_LINE3D:
+			{
+				core::line3df l;
+				ok = get(l.start.X) && get(l.start.Y) && get(l.start.Z) &&
+					get(l.end.X) && get(l.end.Y) && get(l.end.Z);
+				attr->addLine3d(name, l);
+			}
+			break;
+		case io::EAT_STRINGWARRAY:
+			{
+				// each element takes a string index
+				u32 size = 0;
+				ok = get(size) && size <= (u32)(End - Pos) / sizeof(u32);
+				if (!ok)
+					return false;
+				core::array<core::stringw> a(size);
+				for (u32 j=0; ok && j<size; ++j)
+				{
+					u32 s;
+					ok = get(s) && s < Strings.size();
+					if (ok)
+						a.push_back(Strings[s]);
+				}
+				attr->addArray(name, a);
+			}
+			break;
+		default:
+			{
+				u32 s;
+				if (!get(s) || s >= Strings.size())
+					return false;
+
+				// create an attribute of the stored type and set it from its string form
+				switch (type)
+				{
+				case io::EAT_ENUM:
+					attr->addEnum(name, 0, 0);
+					break;
+				case io::EAT_BINARY:
+					attr->addBinary(name, 0, 0);
+					break;
+				case io::EAT_TEXTURE:
+					attr->addTexture(name, 0);
+					break;
+				default:
+					attr->addString(name, L"");
+					break;
+				}
+
+				attr->setAttribute(attr->getAttributeCount()-1, Strings[s].c_str());
+			}
+			break;
+		}
+
+		if (!ok)
+			return false;
+	}
+
+	return true;
+}
+
+
+bool CSceneBinaryReader::getData(void* data, u32 size)
+{
+	if ((u32)(End - Pos) < size)
+	{
+		Pos = End;
+		return false;
+	}
+
+	memcpy(data, Pos, size);
+	Pos += size;
+	return true;
+}
+
+
+} // end namespace scene
+} // end namespace irr
+
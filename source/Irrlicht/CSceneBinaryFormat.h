@@ -0,0 +1,149 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_SCENE_BINARY_FORMAT_H_INCLUDED__
+#define __C_SCENE_BINARY_FORMAT_H_INCLUDED__
+
+#include "irrArray.h"
+#include "irrMap.h"
+#include "irrString.h"
+
+namespace irr
+{
+namespace io
+{
+	class IAttributes;
+	class IReadFile;
+	class IWriteFile;
+} // end namespace io
+namespace scene
+{
+	class ISceneManager;
+	class ISceneNode;
+	class ISceneUserDataSerializer;
+
+	//! Binary scene files (.irrb), the compact alternative to .irr files
+	/** A file starts with a header, followed by the string table, the node
+	records and the attribute data. Values are stored in the byte order
+	of the machine which wrote the file.
+	- The string table holds every attribute name, node type and string
+	value once, as a u16 length followed by u16 characters.
+	- Node records are stored in depth first order, so parents always
+	come before their children. The first record is the root of the
+	scene.
+	- Each node owns consecutive attribute blocks in the attribute data:
+	the node attributes, one block per material, one per animator and an
+	optional user data block. A block is a u32 attribute count followed
+	by attributes made of a u8 io::E_ATTRIBUTE_TYPE, a u32 name index
+	and the value. */
+	namespace binaryscene
+	{
+		//! first bytes of a binary scene file
+		const c8 MAGIC[4] = { 'I', 'R', 'R', 'B' };
+
+		//! written as u32 to detect files with a different byte order
+		const u32 BYTE_ORDER_MARK = 0x01020304;
+
+		//! current version of the format
+		const u32 VERSION = 1;
+
+		//! node record
+		struct SNodeRecord
+		{
+			//! index of the parent record, -1 for the root
+			s32 Parent;
+
+			//! string index of the node type name
+			u32 Type;
+
+			//! offset of the first attribute block of the node
+			u32 DataOffset;
+
+			u32 MaterialCount;
+			u32 AnimatorCount;
+
+			//! 1 if a user data block follows the animators
+			u32 HasUserData;
+		};
+	}
+
+	//! Writes scenes into the binary scene format
+	class CSceneBinaryWriter
+	{
+	public:
+
+		//! constructor
+		CSceneBinaryWriter(ISceneManager* smgr);
+
+		//! writes the scene below root into the file
+		bool write(io::IWriteFile* file, ISceneNode* root,
+				ISceneUserDataSerializer* userDataSerializer);
+
+	private:
+
+		void writeNode(ISceneNode* node, ISceneNode* root, s32 parent,
+				ISceneUserDataSerializer* userDataSerializer);
+
+		void writeAttributes(io::IAttributes* attr);
+
+		u32 addString(const core::stringw& str);
+
+		void putData(const void* data, u32 size);
+
+		template <class T>
+		void put(const T& value)
+		{
+			putData(&value, sizeof(T));
+		}
+
+		ISceneManager* SceneManager;
+
+		core::array<binaryscene::SNodeRecord> Nodes;
+		core::array<core::stringw> Strings;
+		core::map<core::stringw, u32> StringMap;
+		core::array<u8> Data;
+	};
+
+	//! Reads scenes from the binary scene format
+	class CSceneBinaryReader
+	{
+	public:
+
+		//! constructor
+		CSceneBinaryReader(ISceneManager* smgr);
+
+		//! returns true if the file starts with the binary scene magic, keeps the file position
+		static bool isBinaryScene(io::IReadFile* file);
+
+		//! reads the file with one bulk read and adds its nodes below root
+		bool read(io::IReadFile* file, ISceneNode* root,
+				ISceneUserDataSerializer* userDataSerializer);
+
+	private:
+
+		//! reads an attribute block at the current position
+		bool readAttributes(io::IAttributes* attr);
+
+		bool getData(void* data, u32 size);
+
+		template <class T>
+		bool get(T& value)
+		{
+			return getData(&value, sizeof(T));
+		}
+
+		ISceneManager* SceneManager;
+
+		core::array<core::stringw> Strings;
+		core::array<core::stringc> Names;
+
+		const u8* Pos;
+		const u8* End;
+	};
+
+} // end namespace scene
+} // end namespace irr
+
+#endif
+
@@ -11,6 +11,7 @@
 #include "IWriteFile.h"
 #include "IXMLWriter.h"
 #include "ISceneUserDataSerializer.h"
+#include "CSceneBinaryFormat.h"
 #include "IGUIEnvironment.h"
 #include "IMaterialRenderer.h"
 #include "IReadFile.h"
@@ -122,12 +123,15 @@
 #include "CLightSceneNode.h"
 #include "CBillboardSceneNode.h"
 #include "CMeshSceneNode.h"
+#include "CLODMeshSceneNode.h"
+#include "CInstancedMeshSceneNode.h"
 #include "CSkyBoxSceneNode.h"
 #include "CSkyDomeSceneNode.h"
 #include "CParticleSystemSceneNode.h"
 #include "CDummyTransformationSceneNode.h"
 #include "CWaterSurfaceSceneNode.h"
 #include "CTerrainSceneNode.h"
+#include "CMorphingTerrainSceneNode.h"
 #include "CEmptySceneNode.h"
 #include "CTextSceneNode.h"
 #include "CDefaultSceneNodeFactory.h"
@@ -153,6 +157,7 @@
 #include "CQuake3ShaderSceneNode.h"
 #include "CVolumeLightSceneNode.h"
 #include "CGeometryCreator.h"
+#include "CLightmapBaker.h"
 
 //! Enable debug features
 #define SCENEMANAGER_DEBUG
@@ -180,6 +185,9 @@ CSceneManager::CSceneManager(video::IVideoDriver* driver, io::IFileSystem* fs,
 	// root node's scene manager
 	SceneManager = this;
 
+	for (u32 i=0; i<ESTAT_COUNT; ++i)
+		StatHandles[i] = -1;
+
 	// set scene parameters
 	Parameters.setAttribute( DEBUG_NORMAL_LENGTH, 1.f );
 	Parameters.setAttribute( DEBUG_NORMAL_COLOR, video::SColor(255, 34, 221, 221));
@@ -576,6 +584,48 @@ IMeshSceneNode* CSceneManager::addMeshSceneNode(IMesh* mesh, ISceneNode* parent,
 }
 
 
+//! adds a scene node for rendering a static mesh with several levels of detail
+//! the returned pointer must not be dropped.
+ILODMeshSceneNode* CSceneManager::addLODMeshSceneNode(IMesh* mesh, u32 levelCount,
+	f32 maxScreenError, ISceneNode* parent, s32 id,
+	const core::vector3df& position, const core::vector3df& rotation,
+	const core::vector3df& scale, bool alsoAddIfMeshPointerZero)
+{
+	if (!alsoAddIfMeshPointerZero && !mesh)
+		return 0;
+
+	if (!parent)
+		parent = this;
+
+	ILODMeshSceneNode* node = new CLODMeshSceneNode(mesh, parent, this, id, position, rotation, scale);
+	node->setMaxScreenError(maxScreenError);
+	node->generateLevels(levelCount);
+	node->drop();
+
+	return node;
+}
+
+
+//! adds a scene node for rendering many instances of a static mesh
+//! the returned pointer must not be dropped.
+IInstancedMeshSceneNode* CSceneManager::addInstancedMeshSceneNode(IMesh* mesh,
+	ISceneNode* parent, s32 id,
+	const core::vector3df& position, const core::vector3df& rotation,
+	const core::vector3df& scale, bool alsoAddIfMeshPointerZero)
+{
+	if (!alsoAddIfMeshPointerZero && !mesh)
+		return 0;
+
+	if (!parent)
+		parent = this;
+
+	IInstancedMeshSceneNode* node = new CInstancedMeshSceneNode(mesh, parent, this, id, position, rotation, scale);
+	node->drop();
+
+	return node;
+}
+
+
 //! Adds a scene node for rendering a animated water surface mesh.
 ISceneNode* CSceneManager::addWaterSurfaceSceneNode(IMesh* mesh, f32 waveHeight, f32 waveSpeed, f32 waveLength,
 	ISceneNode* parent, s32 id, const core::vector3df& position,
@@ -876,6 +926,74 @@ ITerrainSceneNode* CSceneManager::addTerrainSceneNode(
 }
 
 
+//! Adds a terrain scene node with continuous level of detail to the scene graph.
+ITerrainSceneNode* CSceneManager::addMorphingTerrainSceneNode(
+	const io::path& heightMapFileName,
+	ISceneNode* parent, s32 id,
+	const core::vector3df& position,
+	const core::vector3df& rotation,
+	const core::vector3df& scale,
+	video::SColor vertexColor,
+	f32 screenSpaceError, E_TERRAIN_PATCH_SIZE patchSize,
+	s32 smoothFactor, bool addAlsoIfHeightmapEmpty)
+{
+	io::IReadFile* file = FileSystem->createAndOpenFile(heightMapFileName);
+
+	if(!file && !addAlsoIfHeightmapEmpty)
+	{
+		os::Printer::log("Could not load terrain, because file could not be opened.",
+		heightMapFileName, ELL_ERROR);
+		return 0;
+	}
+
+	ITerrainSceneNode* terrain = addMorphingTerrainSceneNode(file, parent, id,
+		position, rotation, scale, vertexColor, screenSpaceError, patchSize,
+		smoothFactor, addAlsoIfHeightmapEmpty);
+
+	if (file)
+		file->drop();
+
+	return terrain;
+}
+
+//! Adds a terrain scene node with continuous level of detail to the scene graph.
+ITerrainSceneNode* CSceneManager::addMorphingTerrainSceneNode(
+	io::IReadFile* heightMapFile,
+	ISceneNode* parent, s32 id,
+	const core::vector3df& position,
+	const core::vector3df& rotation,
+	const core::vector3df& scale,
+	video::SColor vertexColor,
+	f32 screenSpaceError, E_TERRAIN_PATCH_SIZE patchSize,
+	s32 smoothFactor, bool addAlsoIfHeightmapEmpty)
+{
+	if (!parent)
+		parent = this;
+
+	if (!heightMapFile && !addAlsoIfHeightmapEmpty)
+	{
+		os::Printer::log("Could not load terrain, because file could not be opened.", ELL_ERROR);
+		return 0;
+	}
+
+	CMorphingTerrainSceneNode* node = new CMorphingTerrainSceneNode(parent, this, FileSystem, id,
+		patchSize, screenSpaceError, position, rotation, scale);
+
+	if (!node->loadHeightMap(heightMapFile, vertexColor, smoothFactor))
+	{
+		if (!addAlsoIfHeightmapEmpty)
+		{
+			node->remove();
+			node->drop();
+			return 0;
+		}
+	}
+
+	node->drop();
+	return node;
+}
+
+
 //! Adds an empty scene node.
 ISceneNode* CSceneManager::addEmptySceneNode(ISceneNode* parent, s32 id)
 {
@@ -1288,12 +1406,12 @@ u32 CSceneManager::registerNodeForRendering(ISceneNode* node, E_SCENE_NODE_RENDE
 	}
 
 #ifdef SCENEMANAGER_DEBUG
-	s32 index = Parameters.findAttribute ( "calls" );
+	s32 index = StatHandles[ESTAT_CALLS];
 	Parameters.setAttribute ( index, Parameters.getAttributeAsInt ( index ) + 1 );
 
 	if ( 0 == taken )
 	{
-		index = Parameters.findAttribute ( "culled" );
+		index = StatHandles[ESTAT_CULLED];
 		Parameters.setAttribute ( index, Parameters.getAttributeAsInt ( index ) + 1 );
 	}
 #endif
@@ -1309,12 +1427,15 @@ void CSceneManager::drawAll()
 	if (!Driver)
 		return;
 
-	// reset attributes
-	Parameters.setAttribute ( "culled", 0 );
-	Parameters.setAttribute ( "calls", 0 );
-	Parameters.setAttribute ( "drawn_solid", 0 );
-	Parameters.setAttribute ( "drawn_transparent", 0 );
-	Parameters.setAttribute ( "drawn_transparent_effect", 0 );
+	// reset attributes, and look up their slots only once per frame
+	static const c8* const statNames[ESTAT_COUNT] =
+		{ "culled", "calls", "drawn_solid", "drawn_transparent", "drawn_transparent_effect" };
+
+	for (u32 s=0; s<ESTAT_COUNT; ++s)
+	{
+		Parameters.setAttribute ( statNames[s], 0 );
+		StatHandles[s] = Parameters.findAttribute ( statNames[s] );
+	}
 
 	u32 i; // new ISO for scoping problem in some compilers
 
@@ -1466,7 +1587,7 @@ void CSceneManager::drawAll()
 				SolidNodeList[i].Node->render();
 		}
 
-		Parameters.setAttribute ( "drawn_solid", (s32) SolidNodeList.size() );
+		Parameters.setAttribute ( StatHandles[ESTAT_DRAWN_SOLID], (s32) SolidNodeList.size() );
 		SolidNodeList.set_used(0);
 
 		if(LightManager)
@@ -1529,7 +1650,7 @@ void CSceneManager::drawAll()
 				TransparentNodeList[i].Node->render();
 		}
 
-		Parameters.setAttribute ( "drawn_transparent", (s32) TransparentNodeList.size() );
+		Parameters.setAttribute ( StatHandles[ESTAT_DRAWN_TRANSPARENT], (s32) TransparentNodeList.size() );
 		TransparentNodeList.set_used(0);
 
 		if(LightManager)
@@ -1561,7 +1682,7 @@ void CSceneManager::drawAll()
 				TransparentEffectNodeList[i].Node->render();
 		}
 
-		Parameters.setAttribute ( "drawn_transparent_effect", (s32) TransparentEffectNodeList.size() );
+		Parameters.setAttribute ( StatHandles[ESTAT_DRAWN_TRANSPARENT_EFFECT], (s32) TransparentEffectNodeList.size() );
 		TransparentEffectNodeList.set_used(0);
 	}
 
@@ -1774,6 +1895,19 @@ ITriangleSelector* CSceneManager::createTerrainTriangleSelector(
 }
 
 
+//! Bakes the lighting of a mesh into a lightmap.
+IMesh* CSceneManager::createLightmappedMesh(IMesh* mesh, const core::matrix4& transform,
+	const core::array<video::SLight>& lights, ITriangleSelector* occluders,
+	const SLightmapBakeParameters& parameters)
+{
+	if (!mesh || !Driver)
+		return 0;
+
+	CLightmapBaker baker(Driver, parameters);
+	return baker.bake(mesh, transform, lights, occluders);
+}
+
+
 
 //! Adds a scene node to the deletion queue.
 void CSceneManager::addToDeletionQueue(ISceneNode* node)
@@ -2035,7 +2169,10 @@ bool CSceneManager::saveScene(const io::path& filename, ISceneUserDataSerializer
 	io::IWriteFile* file = FileSystem->createAndWriteFile(filename);
 	if (file)
 	{
-		ret = saveScene(file, userDataSerializer);
+		if (core::hasFileExtension(filename, "irrb"))
+			ret = saveSceneBinary(file, userDataSerializer);
+		else
+			ret = saveScene(file, userDataSerializer);
 		file->drop();
 	}
 	_IRR_IMPLEMENT_MANAGED_MARSHALLING_BUGFIX;
@@ -2067,6 +2204,16 @@ bool CSceneManager::saveScene(io::IWriteFile* file, ISceneUserDataSerializer* us
 }
 
 
+//! Saves the current scene into a binary file.
+bool CSceneManager::saveSceneBinary(io::IWriteFile* file, ISceneUserDataSerializer* userDataSerializer)
+{
+	CSceneBinaryWriter writer(this);
+	const bool ret = writer.write(file, this, userDataSerializer);
+	_IRR_IMPLEMENT_MANAGED_MARSHALLING_BUGFIX;
+	return ret;
+}
+
+
 //! Loads a scene. Note that the current scene is not cleared before.
 //! \param filename: Name of the file .
 bool CSceneManager::loadScene(const io::path& filename, ISceneUserDataSerializer* userDataSerializer)
@@ -2098,6 +2245,19 @@ bool CSceneManager::loadScene(io::IReadFile* file, ISceneUserDataSerializer* use
 		return false;
 	}
 
+	if (CSceneBinaryReader::isBinaryScene(file))
+	{
+		bool oldColladaSingleMesh = getParameters()->getAttributeAsBool(COLLADA_CREATE_SCENE_INSTANCES);
+		getParameters()->setAttribute(COLLADA_CREATE_SCENE_INSTANCES, false);
+
+		CSceneBinaryReader reader(this);
+		const bool ret = reader.read(file, this, userDataSerializer);
+
+		getParameters()->setAttribute(COLLADA_CREATE_SCENE_INSTANCES, oldColladaSingleMesh);
+		_IRR_IMPLEMENT_MANAGED_MARSHALLING_BUGFIX;
+		return ret;
+	}
+
 	io::IXMLReader* reader = FileSystem->createXMLReader(file);
 	if (!reader)
 	{
@@ -95,6 +95,24 @@ namespace scene
 			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
 			bool alsoAddIfMeshPointerZero=false);
 
+		//! adds a scene node for rendering a static mesh with several levels of detail
+		//! the returned pointer must not be dropped.
+		virtual ILODMeshSceneNode* addLODMeshSceneNode(IMesh* mesh, u32 levelCount=4,
+			f32 maxScreenError=1.f, ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
+			bool alsoAddIfMeshPointerZero=false);
+
+		//! adds a scene node for rendering many instances of a static mesh
+		//! the returned pointer must not be dropped.
+		virtual IInstancedMeshSceneNode* addInstancedMeshSceneNode(IMesh* mesh,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0,0,0),
+			const core::vector3df& rotation = core::vector3df(0,0,0),
+			const core::vector3df& scale = core::vector3df(1.0f, 1.0f, 1.0f),
+			bool alsoAddIfMeshPointerZero=false);
+
 		//! Adds a scene node for rendering a animated water surface mesh.
 		virtual ISceneNode* addWaterSurfaceSceneNode(IMesh* mesh, f32 waveHeight, f32 waveSpeed, f32 wlenght, ISceneNode* parent=0, s32 id=-1,
 			const core::vector3df& position = core::vector3df(0,0,0),
@@ -265,6 +283,28 @@ namespace scene
 			s32 maxLOD=4, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17,s32 smoothFactor=0,
 			bool addAlsoIfHeightmapEmpty=false);
 
+		//! Adds a terrain scene node with continuous level of detail to the scene graph.
+		virtual ITerrainSceneNode* addMorphingTerrainSceneNode(
+			const io::path& heightMapFileName,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0.0f,0.0f,0.0f),
+			const core::vector3df& rotation = core::vector3df(0.0f,0.0f,0.0f),
+			const core::vector3df& scale = core::vector3df(1.0f,1.0f,1.0f),
+			video::SColor vertexColor = video::SColor(255,255,255,255),
+			f32 screenSpaceError=4.f, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17,
+			s32 smoothFactor=0, bool addAlsoIfHeightmapEmpty = false);
+
+		//! Adds a terrain scene node with continuous level of detail to the scene graph.
+		virtual ITerrainSceneNode* addMorphingTerrainSceneNode(
+			io::IReadFile* heightMapFile,
+			ISceneNode* parent=0, s32 id=-1,
+			const core::vector3df& position = core::vector3df(0.0f,0.0f,0.0f),
+			const core::vector3df& rotation = core::vector3df(0.0f,0.0f,0.0f),
+			const core::vector3df& scale = core::vector3df(1.0f,1.0f,1.0f),
+			video::SColor vertexColor = video::SColor(255,255,255,255),
+			f32 screenSpaceError=4.f, E_TERRAIN_PATCH_SIZE patchSize=ETPS_17,
+			s32 smoothFactor=0, bool addAlsoIfHeightmapEmpty = false);
+
 		//! Adds a dummy transformation scene node to the scene graph.
 		virtual IDummyTransformationSceneNode* addDummyTransformationSceneNode(
 			ISceneNode* parent=0, s32 id=-1);
@@ -367,6 +407,11 @@ namespace scene
 		virtual ITriangleSelector* createTerrainTriangleSelector(
 			ITerrainSceneNode* node, s32 LOD=0);
 
+		//! Bakes the lighting of a mesh into a lightmap.
+		virtual IMesh* createLightmappedMesh(IMesh* mesh, const core::matrix4& transform,
+			const core::array<video::SLight>& lights, ITriangleSelector* occluders=0,
+			const SLightmapBakeParameters& parameters=SLightmapBakeParameters());
+
 		//! Adds an external mesh loader.
 		virtual void addExternalMeshLoader(IMeshLoader* externalLoader);
 
@@ -461,6 +506,9 @@ namespace scene
 		//! Saves the current scene into a file.
 		virtual bool saveScene(io::IWriteFile* file, ISceneUserDataSerializer* userDataSerializer=0);
 
+		//! Saves the current scene into a binary file.
+		virtual bool saveSceneBinary(io::IWriteFile* file, ISceneUserDataSerializer* userDataSerializer=0);
+
 		//! Loads a scene. Note that the current scene is not cleared before.
 		//! \param filename: Name of the file .
 		virtual bool loadScene(const io::path& filename, ISceneUserDataSerializer* userDataSerializer=0);
@@ -618,6 +666,20 @@ namespace scene
 		//! String parameters
 		io::CAttributes Parameters;
 
+		//! per frame statistics in Parameters
+		enum E_STAT
+		{
+			ESTAT_CULLED = 0,
+			ESTAT_CALLS,
+			ESTAT_DRAWN_SOLID,
+			ESTAT_DRAWN_TRANSPARENT,
+			ESTAT_DRAWN_TRANSPARENT_EFFECT,
+			ESTAT_COUNT
+		};
+
+		//! attribute indices of the statistics, resolved at the start of drawAll()
+		s32 StatHandles[ESTAT_COUNT];
+
 		//! Mesh cache
 		IMeshCache* MeshCache;
 
@@ -8,11 +8,58 @@
 #include "IVideoDriver.h"
 #include "SLight.h"
 
+#ifdef _IRR_COMPILE_WITH_SSE2_
+#include <emmintrin.h>
+#endif
+
 namespace irr
 {
 namespace scene
 {
 
+namespace
+{
+
+// Adjacency of an edge without a neighbour face
+const u32 NoNeighbour = 0xffffffff;
+
+//! hashes the bits of a position, 0 and -0 give the same hash
+inline u32 hashPosition(const core::vector3df& v)
+{
+	const u32 x = (v.X == 0.f) ? 0 : core::IR(v.X);
+	const u32 y = (v.Y == 0.f) ? 0 : core::IR(v.Y);
+	const u32 z = (v.Z == 0.f) ? 0 : core::IR(v.Z);
+	u32 hash = (x * 0x9E3779B1u) ^ (y * 0x85EBCA77u) ^ (z * 0xC2B2AE3Du);
+	return hash ^ (hash >> 15);
+}
+
+//! hashes an edge between two welded vertices independent of its direction
+inline u32 hashEdge(u32 a, u32 b)
+{
+	if (a > b)
+		core::swap(a, b);
+	u32 hash = (a * 0x9E3779B1u) ^ (b * 0x85EBCA77u);
+	return hash ^ (hash >> 16);
+}
+
+//! returns the power of two bucket count for a hash table with count entries
+inline u32 getBucketCount(u32 count)
+{
+	u32 size = 16;
+	while (size < count*2)
+		size <<= 1;
+	return size;
+}
+
+//! returns the index of the next corner of the face
+inline u32 nextCorner(u32 i)
+{
+	return (i % 3 == 2) ? i - 2 : i + 1;
+}
+
+} // end anonymous namespace
+
+
 
 //! constructor
 CShadowVolumeSceneNode::CShadowVolumeSceneNode(const IMesh* shadowMesh, ISceneNode* parent,
@@ -42,198 +89,174 @@ CShadowVolumeSceneNode::~CShadowVolumeSceneNode()
 
 void CShadowVolumeSceneNode::createShadowVolume(const core::vector3df& light)
 {
-	SShadowVolume* svp = 0;
+	core::vector3df ls = light * Infinity; // light scaled
+	if (ls == core::vector3df(0,0,0))
+		ls = core::vector3df(0.0001f,0.0001f,0.0001f);
 
-	// builds the shadow volume and adds it to the shadow volume list.
+	classifyFaces(ls);
+
+	// The volume is closed by extruding only the silhouette, which are the
+	// edges between a face away from the light and one facing it or none.
+	// Extruding inner edges too would add quads which cancel each other out
+	// in the stencil buffer.
+	const u32 faceCount = IndexCount / 3;
+	u32 capFaces = 0;
+	u32 f;
 
-	if (ShadowVolumes.size() > ShadowVolumesUsed)
+	Edges.set_used(0);
+	for (f=0; f<faceCount; ++f)
 	{
-		// get the next unused buffer
-		svp = &ShadowVolumes[ShadowVolumesUsed];
-		if (svp->size >= IndexCount*5)
-			svp->count = 0;
-		else
+		if (!FaceData[f])
+			continue;
+
+		++capFaces;
+		for (u32 e=0; e<3; ++e)
 		{
-			svp->size = IndexCount*5;
-			svp->count = 0;
-			delete [] svp->vertices;
-			svp->vertices = new core::vector3df[svp->size];
+			const u32 adj = Adjacency[3*f+e];
+			if (adj == NoNeighbour || !FaceData[adj])
+			{
+				Edges.push_back(Indices[3*f+e]);
+				Edges.push_back(Indices[nextCorner(3*f+e)]);
+			}
 		}
-
-		++ShadowVolumesUsed;
 	}
-	else
+
+	const u32 numEdges = Edges.size() / 2;
+	const u32 needed = numEdges*6 + (UseZFailMethod ? capFaces*6 : 0);
+
+	// reuse the buffer of the last update for this light
+	if (ShadowVolumesUsed == ShadowVolumes.size())
 	{
-		// add a buffer
 		SShadowVolume tmp;
-		// lets make a rather large shadowbuffer
-		tmp.size = IndexCount*5;
+		tmp.vertices = 0;
 		tmp.count = 0;
-		tmp.vertices = new core::vector3df[tmp.size];
+		tmp.size = 0;
 		ShadowVolumes.push_back(tmp);
-		svp = &ShadowVolumes[ShadowVolumes.size()-1];
-		++ShadowVolumesUsed;
 	}
 
-	const u32 faceCount = IndexCount / 3;
-
-	if (faceCount * 6 > Edges.size())
-		Edges.set_used(faceCount*6);
-
-	u32 numEdges = 0;
-	const core::vector3df ls = light * Infinity; // light scaled
+	SShadowVolume* svp = &ShadowVolumes[ShadowVolumesUsed++];
+	if (svp->size < needed)
+	{
+		// leave some room, so that animated silhouettes fit next time
+		delete [] svp->vertices;
+		svp->size = needed + needed / 2;
+		svp->vertices = new core::vector3df[svp->size];
+	}
 
-	//if (UseZFailMethod)
-	//	createZFailVolume(faceCount, numEdges, light, svp);
-	//else
-	//	createZPassVolume(faceCount, numEdges, light, svp, false);
+	core::vector3df* out = svp->vertices;
 
-	// the createZFailVolume does currently not work 100% correctly,
-	// so we create createZPassVolume with caps if the zfail method
-	// is used
-	createZPassVolume(faceCount, numEdges, light, svp, UseZFailMethod);
+	// the zfail method needs the volume closed with caps
+	if (UseZFailMethod)
+	{
+		for (f=0; f<faceCount; ++f)
+		{
+			if (!FaceData[f])
+				continue;
+
+			const core::vector3df& v0 = Vertices[Indices[3*f+0]];
+			const core::vector3df& v1 = Vertices[Indices[3*f+1]];
+			const core::vector3df& v2 = Vertices[Indices[3*f+2]];
+
+			// add front cap
+			*out++ = v0;
+			*out++ = v2;
+			*out++ = v1;
+
+			// add back cap
+			*out++ = v0 - ls;
+			*out++ = v1 - ls;
+			*out++ = v2 - ls;
+		}
+	}
 
 	for (u32 i=0; i<numEdges; ++i)
 	{
-		core::vector3df &v1 = Vertices[Edges[2*i+0]];
-		core::vector3df &v2 = Vertices[Edges[2*i+1]];
-		core::vector3df v3(v1 - ls);
-		core::vector3df v4(v2 - ls);
+		const core::vector3df& v1 = Vertices[Edges[2*i+0]];
+		const core::vector3df& v2 = Vertices[Edges[2*i+1]];
+		const core::vector3df v3(v1 - ls);
+		const core::vector3df v4(v2 - ls);
 
 		// Add a quad (two triangles) to the vertex list
-		if (svp->vertices && svp->count < svp->size-5)
-		{
-			svp->vertices[svp->count++] = v1;
-			svp->vertices[svp->count++] = v2;
-			svp->vertices[svp->count++] = v3;
+		*out++ = v1;
+		*out++ = v2;
+		*out++ = v3;
 
-			svp->vertices[svp->count++] = v2;
-			svp->vertices[svp->count++] = v4;
-			svp->vertices[svp->count++] = v3;
-		}
+		*out++ = v2;
+		*out++ = v4;
+		*out++ = v3;
 	}
+
+	svp->count = needed;
 }
 
 
-void CShadowVolumeSceneNode::createZFailVolume(s32 faceCount, u32& numEdges,
-						const core::vector3df& light,
-						SShadowVolume* svp)
+void CShadowVolumeSceneNode::classifyFaces(const core::vector3df& light)
 {
-	s32 i;
-	const core::vector3df ls = light * Infinity;
-
-	// Check every face if it is front or back facing the light.
-	for (i=0; i<faceCount; ++i)
+	const u32 faceCount = IndexCount / 3;
+	u32 f = 0;
+
+#ifdef _IRR_COMPILE_WITH_SSE2_
+	// the normal arrays are padded, so the last group of four can be read whole
+	const __m128 lx = _mm_set1_ps(light.X);
+	const __m128 ly = _mm_set1_ps(light.Y);
+	const __m128 lz = _mm_set1_ps(light.Z);
+	const __m128 zero = _mm_setzero_ps();
+	for (; f<faceCount; f+=4)
 	{
-		const u16 wFace0 = Indices[3*i+0];
-		const u16 wFace1 = Indices[3*i+1];
-		const u16 wFace2 = Indices[3*i+2];
-
-		const core::vector3df v0 = Vertices[wFace0];
-		const core::vector3df v1 = Vertices[wFace1];
-		const core::vector3df v2 = Vertices[wFace2];
-
-		if (core::triangle3df(v0,v1,v2).isFrontFacing(light))
-		{
-			FaceData[i] = false; // it's a back facing face
-
-			if (svp->vertices && svp->count < svp->size-5)
-			{
-				// add front cap
-				svp->vertices[svp->count++] = v0;
-				svp->vertices[svp->count++] = v2;
-				svp->vertices[svp->count++] = v1;
-
-				// add back cap
-				svp->vertices[svp->count++] = v0 - ls;
-				svp->vertices[svp->count++] = v1 - ls;
-				svp->vertices[svp->count++] = v2 - ls;
-			}
-		}
-		else
-			FaceData[i] = true; // it's a front facing face
+		const __m128 d = _mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_loadu_ps(&NormalX[f]), lx),
+				_mm_mul_ps(_mm_loadu_ps(&NormalY[f]), ly)),
+				_mm_mul_ps(_mm_loadu_ps(&NormalZ[f]), lz));
+		const s32 mask = _mm_movemask_ps(_mm_cmple_ps(d, zero));
+		FaceData[f+0] = (u8)(mask & 1);
+		FaceData[f+1] = (u8)((mask >> 1) & 1);
+		FaceData[f+2] = (u8)((mask >> 2) & 1);
+		FaceData[f+3] = (u8)((mask >> 3) & 1);
 	}
+#endif
 
-	for(i=0; i<faceCount; ++i)
-	{
-		if (FaceData[i] == true)
-		{
-			const u16 wFace0 = Indices[3*i+0];
-			const u16 wFace1 = Indices[3*i+1];
-			const u16 wFace2 = Indices[3*i+2];
-
-			const u16 adj0 = Adjacency[3*i+0];
-			const u16 adj1 = Adjacency[3*i+1];
-			const u16 adj2 = Adjacency[3*i+2];
-
-			if (adj0 != (u16)-1 && FaceData[adj0] == false)
-			{
-				// add edge v0-v1
-				Edges[2*numEdges+0] = wFace0;
-				Edges[2*numEdges+1] = wFace1;
-				++numEdges;
-			}
-
-			if (adj1 != (u16)-1 && FaceData[adj1] == false)
-			{
-				// add edge v1-v2
-				Edges[2*numEdges+0] = wFace1;
-				Edges[2*numEdges+1] = wFace2;
-				++numEdges;
-			}
-
-			if (adj2 != (u16)-1 && FaceData[adj2] == false)
-			{
-				// add edge v2-v0
-				Edges[2*numEdges+0] = wFace2;
-				Edges[2*numEdges+1] = wFace0;
-				++numEdges;
-			}
-		}
-	}
+	for (; f<faceCount; ++f)
+		FaceData[f] = (NormalX[f]*light.X + NormalY[f]*light.Y + NormalZ[f]*light.Z) <= 0.f;
 }
 
 
-void CShadowVolumeSceneNode::createZPassVolume(s32 faceCount,
-						u32& numEdges,
-						core::vector3df light,
-						SShadowVolume* svp, bool caps)
+void CShadowVolumeSceneNode::copyPositions(const IMeshBuffer* buf, u32 firstVertex)
 {
-	light *= Infinity;
-	if (light == core::vector3df(0,0,0))
-		light = core::vector3df(0.0001f,0.0001f,0.0001f);
+	const u32 vtxcnt = buf->getVertexCount();
+	const u32 pitch = video::getVertexPitchFromType(buf->getVertexType());
+	const u8* p = (const u8*)buf->getVertices();
 
-	for (s32 i=0; i<faceCount; ++i)
-	{
-		const u16 wFace0 = Indices[3*i+0];
-		const u16 wFace1 = Indices[3*i+1];
-		const u16 wFace2 = Indices[3*i+2];
+	// all vertex types start with the position
+	for (u32 j=0; j<vtxcnt; ++j, p+=pitch)
+		Vertices[firstVertex+j] = *(const core::vector3df*)p;
+}
 
-		if (core::triangle3df(Vertices[wFace0],Vertices[wFace1],Vertices[wFace2]).isFrontFacing(light))
-		{
-			Edges[2*numEdges+0] = wFace0;
-			Edges[2*numEdges+1] = wFace1;
-			++numEdges;
 
-			Edges[2*numEdges+0] = wFace1;
-			Edges[2*numEdges+1] = wFace2;
-			++numEdges;
+void CShadowVolumeSceneNode::calculateFaceNormals()
+{
+	const u32 faceCount = IndexCount / 3;
+	const u32 padded = (faceCount + 3) & ~3;
 
-			Edges[2*numEdges+0] = wFace2;
-			Edges[2*numEdges+1] = wFace0;
-			++numEdges;
+	NormalX.set_used(padded);
+	NormalY.set_used(padded);
+	NormalZ.set_used(padded);
+	FaceData.set_used(padded);
 
-			if (caps && svp->vertices && svp->count < svp->size-5)
-			{
-				svp->vertices[svp->count++] = Vertices[wFace0];
-				svp->vertices[svp->count++] = Vertices[wFace2];
-				svp->vertices[svp->count++] = Vertices[wFace1];
+	u32 f;
+	for (f=0; f<faceCount; ++f)
+	{
+		const core::vector3df& v0 = Vertices[Indices[3*f+0]];
+		const core::vector3df n((Vertices[Indices[3*f+1]] - v0).crossProduct(Vertices[Indices[3*f+2]] - v0));
+		NormalX[f] = n.X;
+		NormalY[f] = n.Y;
+		NormalZ[f] = n.Z;
+	}
 
-				svp->vertices[svp->count++] = Vertices[wFace0] - light;
-				svp->vertices[svp->count++] = Vertices[wFace1] - light;
-				svp->vertices[svp->count++] = Vertices[wFace2] - light;
-			}
-		}
+	for (; f<padded; ++f)
+	{
+		NormalX[f] = 0.f;
+		NormalY[f] = 0.f;
+		NormalZ[f] = 0.f;
 	}
 }
 
@@ -247,68 +270,115 @@ void CShadowVolumeSceneNode::setShadowMesh(const IMesh* mesh)
 	ShadowMesh = mesh;
 	if (ShadowMesh)
 		ShadowMesh->grab();
+
+	// rebuild everything with the next update
+	BufferStates.clear();
 }
 
 
 void CShadowVolumeSceneNode::updateShadowVolumes()
 {
-	const u32 oldIndexCount = IndexCount;
-	const u32 oldVertexCount = VertexCount;
-
-	VertexCount = 0;
-	IndexCount = 0;
 	ShadowVolumesUsed = 0;
 
 	const IMesh* const mesh = ShadowMesh;
 	if (!mesh)
+	{
+		VertexCount = 0;
+		IndexCount = 0;
+		BufferStates.clear();
 		return;
+	}
 
-	// calculate total amount of vertices and indices
+	// find out what changed since the last update, the faces and their
+	// adjacency are only rebuilt if the indices did change
 
 	u32 i;
+	const u32 bufcnt = mesh->getMeshBufferCount();
+	bool topologyChanged = (bufcnt != BufferStates.size());
+	bool positionsChanged = false;
 	u32 totalVertices = 0;
 	u32 totalIndices = 0;
-	const u32 bufcnt = mesh->getMeshBufferCount();
 
 	for (i=0; i<bufcnt; ++i)
 	{
 		const IMeshBuffer* buf = mesh->getMeshBuffer(i);
 		totalIndices += buf->getIndexCount();
 		totalVertices += buf->getVertexCount();
-	}
-
-	// allocate memory if necessary
 
-	if (totalVertices > Vertices.size())
-		Vertices.set_used(totalVertices);
+		if (topologyChanged)
+			continue;
+
+		const SBufferState& state = BufferStates[i];
+		if (state.Buffer != buf ||
+			state.ChangedIDIndex != buf->getChangedID_Index() ||
+			state.IndexCount != buf->getIndexCount() ||
+			state.VertexCount != buf->getVertexCount())
+			topologyChanged = true;
+		else if (state.ChangedIDVertex != buf->getChangedID_Vertex())
+			positionsChanged = true;
+	}
 
-	if (totalIndices > Indices.size())
+	if (topologyChanged)
 	{
+		Vertices.set_used(totalVertices);
 		Indices.set_used(totalIndices);
+		BufferStates.set_used(bufcnt);
 
-		if (UseZFailMethod)
-			FaceData.set_used(totalIndices / 3);
-	}
+		VertexCount = 0;
+		IndexCount = 0;
 
-	// copy mesh
+		for (i=0; i<bufcnt; ++i)
+		{
+			const IMeshBuffer* buf = mesh->getMeshBuffer(i);
+			const u32 vtxcnt = buf->getVertexCount();
+			const u32 idxcnt = buf->getIndexCount() - buf->getIndexCount() % 3;
 
-	for (i=0; i<bufcnt; ++i)
-	{
-		const IMeshBuffer* buf = mesh->getMeshBuffer(i);
+			if (buf->getIndexType() == video::EIT_16BIT)
+			{
+				const u16* idxp = buf->getIndices();
+				for (u32 j=0; j<idxcnt; ++j)
+					Indices[IndexCount+j] = idxp[j] + VertexCount;
+			}
+			else
+			{
+				const u32* idxp = (const u32*)buf->getIndices();
+				for (u32 j=0; j<idxcnt; ++j)
+					Indices[IndexCount+j] = idxp[j] + VertexCount;
+			}
+			IndexCount += idxcnt;
 
-		const u16* idxp = buf->getIndices();
-		const u16* idxpend = idxp + buf->getIndexCount();
-		for (; idxp!=idxpend; ++idxp)
-			Indices[IndexCount++] = *idxp + VertexCount;
+			copyPositions(buf, VertexCount);
+			VertexCount += vtxcnt;
 
-		const u32 vtxcnt = buf->getVertexCount();
-		for (u32 j=0; j<vtxcnt; ++j)
-			Vertices[VertexCount++] = buf->getPosition(j);
-	}
+			SBufferState& state = BufferStates[i];
+			state.Buffer = buf;
+			state.ChangedIDVertex = buf->getChangedID_Vertex();
+			state.ChangedIDIndex = buf->getChangedID_Index();
+			state.VertexCount = vtxcnt;
+			state.IndexCount = buf->getIndexCount();
+		}
 
-	// recalculate adjacency if necessary
-	if (oldVertexCount != VertexCount && oldIndexCount != IndexCount && UseZFailMethod)
 		calculateAdjacency();
+		calculateFaceNormals();
+	}
+	else if (positionsChanged)
+	{
+		// copy only the positions of animated buffers
+		u32 firstVertex = 0;
+		for (i=0; i<bufcnt; ++i)
+		{
+			const IMeshBuffer* buf = mesh->getMeshBuffer(i);
+			SBufferState& state = BufferStates[i];
+			if (state.ChangedIDVertex != buf->getChangedID_Vertex())
+			{
+				copyPositions(buf, firstVertex);
+				state.ChangedIDVertex = buf->getChangedID_Vertex();
+			}
+			firstVertex += state.VertexCount;
+		}
+
+		calculateFaceNormals();
+	}
 
 	// create as much shadow volumes as there are lights but
 	// do not ignore the max light settings.
@@ -383,52 +453,92 @@ const core::aabbox3d<f32>& CShadowVolumeSceneNode::getBoundingBox() const
 
 
 //! Generates adjacency information based on mesh indices.
-void CShadowVolumeSceneNode::calculateAdjacency(f32 epsilon)
+void CShadowVolumeSceneNode::calculateAdjacency()
 {
-	Adjacency.set_used(IndexCount);
+	u32 i;
+	core::array<s32> buckets;
 
-	epsilon *= epsilon;
+	// weld vertices at the same position, so the edges of faces using
+	// different vertices for texture coordinates or normals are shared
+	core::array<u32> welded;
+	welded.set_used(VertexCount);
 
-	// go through all faces and fetch their three neighbours
-	for (u32 f=0; f<IndexCount; f+=3)
+	u32 size = getBucketCount(VertexCount);
+	u32 mask = size - 1;
+	buckets.set_used(size);
+	for (i=0; i<size; ++i)
+		buckets[i] = -1;
+
+	for (i=0; i<VertexCount; ++i)
 	{
-		for (u32 edge = 0; edge<3; ++edge)
+		const core::vector3df& v = Vertices[i];
+		u32 b = hashPosition(v) & mask;
+		for (; buckets[b] != -1; b = (b+1) & mask)
 		{
-			core::vector3df v1 = Vertices[Indices[f+edge]];
-			core::vector3df v2 = Vertices[Indices[f+((edge+1)%3)]];
+			const core::vector3df& o = Vertices[buckets[b]];
+			if (o.X == v.X && o.Y == v.Y && o.Z == v.Z)
+				break;
+		}
 
-			// now we search an_O_ther _F_ace with these two
-			// vertices, which is not the current face.
+		if (buckets[b] == -1)
+			buckets[b] = (s32)i;
+		welded[i] = (u32)buckets[b];
+	}
 
-			u32 of;
+	// drop faces without area after welding and faces with invalid indices
+	u32 count = 0;
+	for (i=0; i<IndexCount; i+=3)
+	{
+		if (Indices[i+0] >= VertexCount || Indices[i+1] >= VertexCount || Indices[i+2] >= VertexCount)
+			continue;
+
+		const u32 a = welded[Indices[i+0]];
+		const u32 b = welded[Indices[i+1]];
+		const u32 c = welded[Indices[i+2]];
+		if (a == b || b == c || c == a)
+			continue;
+
+		Indices[count+0] = Indices[i+0];
+		Indices[count+1] = Indices[i+1];
+		Indices[count+2] = Indices[i+2];
+		count += 3;
+	}
+	IndexCount = count;
+	Indices.set_used(IndexCount);
 
-			for (of=0; of<IndexCount; of+=3)
-			{
-				if (of != f)
-				{
-					s32 cnt1 = 0;
-					s32 cnt2 = 0;
-
-					for (s32 e=0; e<3; ++e)
-					{
-						const f32 t1 = v1.getDistanceFromSQ(Vertices[Indices[of+e]]);
-						if (core::iszero(t1))
-							++cnt1;
-
-						const f32 t2 = v2.getDistanceFromSQ(Vertices[Indices[of+e]]);
-						if (core::iszero(t2))
-							++cnt2;
-					}
-
-					if (cnt1 == 1 && cnt2 == 1)
-						break;
-				}
-			}
+	// pair every edge with the reversed edge of another face, which is
+	// found with a hash table of the edges still waiting for a partner
+	Adjacency.set_used(IndexCount);
+	for (i=0; i<IndexCount; ++i)
+		Adjacency[i] = NoNeighbour;
 
-			if (of == IndexCount)
-				Adjacency[f + edge] = f;
-			else
-				Adjacency[f + edge] = of / 3;
+	size = getBucketCount(IndexCount);
+	mask = size - 1;
+	buckets.set_used(size);
+	for (i=0; i<size; ++i)
+		buckets[i] = -1;
+
+	for (i=0; i<IndexCount; ++i)
+	{
+		const u32 a = welded[Indices[i]];
+		const u32 b = welded[Indices[nextCorner(i)]];
+
+		u32 bucket = hashEdge(a, b) & mask;
+		for (; buckets[bucket] != -1; bucket = (bucket+1) & mask)
+		{
+			const u32 e = (u32)buckets[bucket];
+			if (Adjacency[e] == NoNeighbour &&
+				welded[Indices[e]] == b && welded[Indices[nextCorner(e)]] == a)
+				break;
+		}
+
+		if (buckets[bucket] == -1)
+			buckets[bucket] = (s32)i;
+		else
+		{
+			const u32 e = (u32)buckets[bucket];
+			Adjacency[e] = i / 3;
+			Adjacency[i] = e / 3;
 		}
 	}
 }
@@ -11,6 +11,7 @@ namespace irr
 {
 namespace scene
 {
+	class IMeshBuffer;
 
 	//! Scene node for rendering a shadow volume into a stencil buffer.
 	class CShadowVolumeSceneNode : public IShadowVolumeSceneNode
@@ -53,12 +54,31 @@ namespace scene
 			u32 size;
 		};
 
+		//! state of a mesh buffer when it was last copied
+		struct SBufferState
+		{
+			const IMeshBuffer* Buffer;
+			u32 ChangedIDVertex;
+			u32 ChangedIDIndex;
+			u32 VertexCount;
+			u32 IndexCount;
+		};
+
 		void createShadowVolume(const core::vector3df& pos);
-		void createZPassVolume(s32 faceCount, u32& numEdges, core::vector3df light, SShadowVolume* svp, bool caps);
-		void createZFailVolume(s32 faceCount, u32& numEdges, const core::vector3df& light, SShadowVolume* svp);
+
+		//! Marks every face which faces away from the light in FaceData.
+		void classifyFaces(const core::vector3df& light);
+
+		//! Copies the positions of a mesh buffer into Vertices.
+		void copyPositions(const IMeshBuffer* buf, u32 firstVertex);
+
+		//! Recalculates the unnormalized face normals from Vertices.
+		void calculateFaceNormals();
 
 		//! Generates adjacency information based on mesh indices.
-		void calculateAdjacency(f32 epsilon=0.0001f);
+		/** Vertices at the same position are welded, so faces of
+		different mesh buffers and across texture seams are neighbours. */
+		void calculateAdjacency();
 
 		core::aabbox3d<f32> Box;
 
@@ -66,11 +86,21 @@ namespace scene
 		core::array<SShadowVolume> ShadowVolumes;
 
 		core::array<core::vector3df> Vertices;
-		core::array<u16> Indices;
-		core::array<u16> Adjacency;
-		core::array<u16> Edges;
-		// used for zfail method, if face is front facing
-		core::array<bool> FaceData;
+		// three indices into Vertices per non degenerated face
+		core::array<u32> Indices;
+		// neighbour face for every edge, NoNeighbour at open edges
+		core::array<u32> Adjacency;
+		// silhouette edges of the volume currently created
+		core::array<u32> Edges;
+		// face normals as separate x, y and z arrays, padded to four faces
+		core::array<f32> NormalX;
+		core::array<f32> NormalY;
+		core::array<f32> NormalZ;
+		// 1 if the face faces away from the light
+		core::array<u8> FaceData;
+
+		// mesh buffers the arrays above were built from
+		core::array<SBufferState> BufferStates;
 
 		const scene::IMesh* ShadowMesh;
 
@@ -785,6 +785,13 @@ const core::dimension2d<u32>& CSoftwareDriver::getCurrentRenderTargetSize() cons
 }
 
 
+//! returns the current render target texture, or 0 for the screen
+ITexture* CSoftwareDriver::getCurrentRenderTarget() const
+{
+	return RenderTargetTexture;
+}
+
+
 //! draws an 2d image, using a color (if color is other then Color(255,255,255,255)) and the alpha channel of the texture if wanted.
 void CSoftwareDriver::draw2DImage(const video::ITexture* texture, const core::position2d<s32>& destPos,
 					const core::rect<s32>& sourceRect,
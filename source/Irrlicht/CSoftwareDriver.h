@@ -55,6 +55,9 @@ namespace video
 		//! returns size of the current render target
 		virtual const core::dimension2d<u32>& getCurrentRenderTargetSize() const;
 
+		//! returns the current render target texture, or 0 for the screen
+		virtual ITexture* getCurrentRenderTarget() const;
+
 		//! draws a vertex primitive list
 		void drawVertexPrimitiveList(const void* vertices, u32 vertexCount,
 				const void* indexList, u32 primitiveCount,
@@ -28,7 +28,9 @@ CBurningVideoDriver::CBurningVideoDriver(const core::dimension2d<u32>& windowSiz
 : CNullDriver(io, windowSize), BackBuffer(0), Presenter(presenter),
 	WindowId(0), SceneSourceRect(0),
 	RenderTargetTexture(0), RenderTargetSurface(0), CurrentShader(0),
-	 DepthBuffer(0), CurrentOut ( 12 * 2, 128 ), Temp ( 12 * 2, 128 )
+	 DepthBuffer(0), StencilBuffer(0), ShadowPass(ESP_NONE), ShadowMap(0),
+	ShadowColor(0), ShadowBias(0.f), CurrentOut ( 12 * 2, 128 ), Temp ( 12 * 2, 128 ),
+	UseInstanceColor(false)
 {
 	#ifdef _DEBUG
 	setDebugName("CBurningVideoDriver");
@@ -42,6 +44,9 @@ CBurningVideoDriver::CBurningVideoDriver(const core::dimension2d<u32>& windowSiz
 
 		// create z buffer
 		DepthBuffer = video::createDepthBuffer(BackBuffer->getDimension());
+
+		// create stencil buffer for shadow volumes
+		StencilBuffer = video::createStencilBuffer(BackBuffer->getDimension());
 	}
 
 	// create triangle renderers
@@ -74,6 +79,10 @@ CBurningVideoDriver::CBurningVideoDriver(const core::dimension2d<u32>& windowSiz
 
 	BurningShader[ETR_TEXTURE_BLEND] = createTRTextureBlend( DepthBuffer );
 
+	BurningShader[ETR_STENCIL_SHADOW] = createTRStencilShadow ( DepthBuffer, StencilBuffer );
+	BurningShader[ETR_SHADOW_DEPTH] = createTRShadowDepth ( DepthBuffer );
+	BurningShader[ETR_TEXTURE_GOURAUD_SHADOW] = createTRTextureGouraudShadow2 ( DepthBuffer );
+
 	BurningShader[ETR_REFERENCE] = createTriangleRendererReference ( DepthBuffer );
 
 
@@ -141,11 +150,17 @@ CBurningVideoDriver::~CBurningVideoDriver()
 	if (DepthBuffer)
 		DepthBuffer->drop();
 
+	if (StencilBuffer)
+		StencilBuffer->drop();
+
 	if (RenderTargetTexture)
 		RenderTargetTexture->drop();
 
 	if (RenderTargetSurface)
 		RenderTargetSurface->drop();
+
+	if (ShadowMap)
+		ShadowMap->drop();
 }
 
 
@@ -246,8 +261,24 @@ void CBurningVideoDriver::setCurrentShader()
 
 	//shader = ETR_REFERENCE;
 
+	// depth maps only take what writes depth, shadows fall on solid geometry
+	ShadowPass = ESP_NONE;
+	if ( RenderTargetSurface && RenderTargetSurface->getColorFormat() == ECF_R32F )
+	{
+		ShadowPass = ESP_DEPTH;
+		shader = ETR_SHADOW_DEPTH;
+	}
+	else if ( ShadowMap && ( shader == ETR_TEXTURE_GOURAUD || shader == ETR_GOURAUD ) )
+	{
+		ShadowPass = ESP_RECEIVE;
+		shader = ETR_TEXTURE_GOURAUD_SHADOW;
+	}
+
 	// switchToTriangleRenderer
 	CurrentShader = BurningShader[shader];
+	if ( ShadowPass == ESP_DEPTH && !zMaterialTest )
+		CurrentShader = 0;
+
 	if ( CurrentShader )
 	{
 		CurrentShader->setZCompareFunc ( Material.org.ZBuffer );
@@ -261,6 +292,10 @@ void CBurningVideoDriver::setCurrentShader()
 			case ETR_TEXTURE_BLEND:
 				CurrentShader->setParam ( 0, Material.org.MaterialTypeParam );
 				break;
+			case ETR_TEXTURE_GOURAUD_SHADOW:
+				CurrentShader->setShadowMap ( ((CSoftwareTexture2*)ShadowMap)->getTexture(),
+					ShadowColor, ShadowBias );
+				break;
 			default:
 			break;
 		}
@@ -290,8 +325,15 @@ bool CBurningVideoDriver::queryFeature(E_VIDEO_DRIVER_FEATURE feature) const
 	case EVDF_MULTITEXTURE:
 	case EVDF_HARDWARE_TL:
 	case EVDF_TEXTURE_NSQUARE:
+	case EVDF_INSTANCING:
 		return true;
 
+	case EVDF_STENCIL_BUFFER:
+		return StencilBuffer != 0;
+
+	case EVDF_SHADOW_MAP:
+		return BurningShader[ETR_TEXTURE_GOURAUD_SHADOW] != 0;
+
 	default:
 		return false;
 	}
@@ -328,6 +370,17 @@ void CBurningVideoDriver::setTransform(E_TRANSFORMATION_STATE state, const core:
 				);
 			}
 			TransformationFlag[ETS_CURRENT] = 0;
+
+			if ( ShadowMap )
+			{
+				if ( TransformationFlag[state] & ETF_IDENTITY )
+					Transformation[ETS_SHADOW_CURRENT] = Transformation[ETS_SHADOW];
+				else
+					Transformation[ETS_SHADOW_CURRENT].setbyproduct_nocheck (
+						Transformation[ETS_SHADOW],
+						Transformation[ETS_WORLD]
+					);
+			}
 			break;
 		case ETS_TEXTURE_0:
 		case ETS_TEXTURE_1:
@@ -356,6 +409,9 @@ bool CBurningVideoDriver::beginScene(bool backBuffer, bool zBuffer,
 	if (zBuffer && DepthBuffer)
 		DepthBuffer->clear();
 
+	if (zBuffer && StencilBuffer)
+		StencilBuffer->clear();
+
 	memset ( TransformationFlag, 0, sizeof ( TransformationFlag ) );
 	return true;
 }
@@ -398,12 +454,30 @@ bool CBurningVideoDriver::setRenderTarget(video::ITexture* texture, bool clearBa
 	if (RenderTargetSurface && (clearBackBuffer || clearZBuffer))
 	{
 		if (clearZBuffer)
+		{
 			DepthBuffer->clear();
+			if (StencilBuffer)
+				StencilBuffer->clear();
+		}
 
 		if (clearBackBuffer)
-			RenderTargetSurface->fill( color );
+		{
+			// depth maps start at the far plane
+			if (RenderTargetSurface->getColorFormat() == ECF_R32F)
+			{
+				const f32 farDepth = FLT_MAX;
+				irr::memset32 ( RenderTargetSurface->lock(), IR(farDepth),
+					RenderTargetSurface->getImageDataSizeInBytes() );
+				RenderTargetSurface->unlock();
+			}
+			else
+				RenderTargetSurface->fill( color );
+		}
 	}
 
+	// switch between depth only, shadowed and plain shaders
+	setCurrentShader();
+
 	return true;
 }
 
@@ -428,6 +502,9 @@ void CBurningVideoDriver::setRenderTarget(video::CImage* image)
 
 	if (DepthBuffer)
 		DepthBuffer->setSize(RenderTargetSize);
+
+	if (StencilBuffer)
+		StencilBuffer->setSize(RenderTargetSize);
 }
 
 
@@ -659,9 +736,8 @@ inline void CBurningVideoDriver::ndc_2_dc_and_project ( s4DVertex *dest,s4DVerte
 		dest[g].Pos.x = iw * ( source[g].Pos.x * Transformation [ ETS_CLIPSCALE ][ 0] + w * Transformation [ ETS_CLIPSCALE ][12] );
 		dest[g].Pos.y = iw * ( source[g].Pos.y * Transformation [ ETS_CLIPSCALE ][ 5] + w * Transformation [ ETS_CLIPSCALE ][13] );
 
-#ifndef SOFTWARE_DRIVER_2_USE_WBUFFER
+		// the z buffer and depth maps use it
 		dest[g].Pos.z = iw * source[g].Pos.z;
-#endif
 
 	#ifdef SOFTWARE_DRIVER_2_USE_VERTEX_COLOR
 		#ifdef SOFTWARE_DRIVER_2_PERSPECTIVE_CORRECT
@@ -699,9 +775,8 @@ inline void CBurningVideoDriver::ndc_2_dc_and_project2 ( const s4DVertex **v, co
 		a[1].Pos.x = iw * ( a->Pos.x * p[ 0] + w * p[12] );
 		a[1].Pos.y = iw * ( a->Pos.y * p[ 5] + w * p[13] );
 
-#ifndef SOFTWARE_DRIVER_2_USE_WBUFFER
+		// the z buffer and depth maps use it
 		a[1].Pos.z = a->Pos.z * iw;
-#endif
 
 	#ifdef SOFTWARE_DRIVER_2_USE_VERTEX_COLOR
 		#ifdef SOFTWARE_DRIVER_2_PERSPECTIVE_CORRECT
@@ -814,6 +889,31 @@ inline void CBurningVideoDriver::select_polygon_mipmap2 ( s4DVertex **v, u32 tex
 #endif
 }
 
+/*!
+	projects the position in the shadow map like the texture coordinates
+*/
+inline void CBurningVideoDriver::select_polygon_shadow ( s4DVertex *v, u32 vIn ) const
+{
+	for ( u32 g = 0; g != vIn; g += 2 )
+	{
+#ifdef SOFTWARE_DRIVER_2_PERSPECTIVE_CORRECT
+		const f32 iw = ( v + g + 1 )->Pos.w;
+		(v + g + 1 )->Tex[1].x	= (v + g + 0)->Tex[1].x * iw;
+		(v + g + 1 )->Tex[1].y	= (v + g + 0)->Tex[1].y * iw;
+		(v + g + 1 )->ShadowZ	= (v + g + 0)->ShadowZ * iw;
+#else
+		(v + g + 1 )->Tex[1]	= (v + g + 0)->Tex[1];
+		(v + g + 1 )->ShadowZ	= (v + g + 0)->ShadowZ;
+#endif
+	}
+}
+
+inline void CBurningVideoDriver::select_polygon_shadow2 ( s4DVertex **v ) const
+{
+	for ( u32 g = 0; g != 3; ++g )
+		select_polygon_shadow ( v[g], 2 );
+}
+
 // Vertex Cache
 const SVSize CBurningVideoDriver::vSize[] =
 {
@@ -851,6 +951,16 @@ void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex,
 	const S3DVertex *base = ((S3DVertex*) source );
 	Transformation [ ETS_CURRENT].transformVect ( &dest->Pos.x, base->Pos );
 
+	// depth maps need the position only
+	if ( ShadowPass == ESP_DEPTH )
+	{
+		dest[0].flag = dest[1].flag = 0;
+		dest[0].flag |= clipToFrustumTest ( dest);
+		if ( (dest[0].flag & VERTEX4D_CLIPMASK ) == VERTEX4D_INSIDE )
+			ndc_2_dc_and_project2 ( (const s4DVertex**) &dest, 1 );
+		return;
+	}
+
 
 #if defined (SOFTWARE_DRIVER_2_LIGHTING) || defined ( SOFTWARE_DRIVER_2_TEXTURE_TRANSFORM )
 
@@ -890,6 +1000,14 @@ void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex,
 	#else
 		dest->Color[0].setA8R8G8B8 ( base->Color.color );
 	#endif
+
+	if ( UseInstanceColor )
+	{
+		dest->Color[0].x *= InstanceColor.x;
+		dest->Color[0].y *= InstanceColor.y;
+		dest->Color[0].z *= InstanceColor.z;
+		dest->Color[0].w *= InstanceColor.w;
+	}
 #endif
 
 	// Texture Transform
@@ -1011,6 +1129,20 @@ void CBurningVideoDriver::VertexCache_fill(const u32 sourceIndex,
 
 	dest[0].flag = dest[1].flag = vSize[VertexCache.vType].Format;
 
+	// position in the shadow map replaces the second texture coordinates
+	if ( ShadowPass == ESP_RECEIVE )
+	{
+		sVec4 light;
+		Transformation [ ETS_SHADOW_CURRENT ].transformVect ( &light.x, base->Pos );
+		const f32 iw = core::reciprocal ( light.w );
+		dest->Tex[1].x = light.x * iw;
+		dest->Tex[1].y = light.y * iw;
+		dest->ShadowZ = light.z * iw;
+
+		dest[0].flag = dest[1].flag = ( dest[0].flag & ~VERTEX4D_FORMAT_MASK_TEXTURE ) |
+			VERTEX4D_FORMAT_TEXTURE_2 | VERTEX4D_FORMAT_SHADOW;
+	}
+
 	// test vertex
 	dest[0].flag |= clipToFrustumTest ( dest);
 
@@ -1269,7 +1401,81 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 		return;
 
 	VertexCache_reset ( vertices, vertexCount, indexList, primitiveCount, vType, pType, iType );
+	VertexCache_draw ( primitiveCount, getShaderTextureCount () );
+}
+
+
+//! Draws many instances of a mesh buffer, only transforming the vertices again
+/** The material, the shader and the textures stay set up for all instances,
+only the world matrix and the instance color change, and the vertex cache
+is refilled with the vertices transformed and lit for the next instance. */
+void CBurningVideoDriver::drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+		const core::matrix4* transforms, const SColor* colors, u32 instanceCount)
+{
+	if (!mb || !transforms || !instanceCount)
+		return;
+
+	const u32 primitiveCount = mb->getIndexCount() / 3;
+	if (!checkPrimitiveCount(primitiveCount))
+		return;
+
+	if ( 0 == CurrentShader )
+	{
+		PrimitivesDrawn += primitiveCount * instanceCount;
+		return;
+	}
+
+	const core::matrix4 world = Transformation[ETS_WORLD];
 
+	VertexCache_reset ( mb->getVertices(), mb->getVertexCount(),
+			mb->getIndices(), primitiveCount, mb->getVertexType(),
+			scene::EPT_TRIANGLES, mb->getIndexType() );
+	const u32 texCount = getShaderTextureCount ();
+
+	for ( u32 i = 0; i != instanceCount; ++i )
+	{
+		setTransform ( ETS_WORLD, transforms[i] );
+
+		if ( colors )
+		{
+			InstanceColor.setA8R8G8B8 ( colors[i].color );
+			UseInstanceColor = colors[i].color != 0xFFFFFFFF;
+		}
+
+		// the cached vertices belong to the previous instance
+		VertexCache.indicesIndex = 0;
+		VertexCache.indicesRun = 0;
+		irr::memset32 ( VertexCache.info, VERTEXCACHE_MISS, sizeof ( VertexCache.info ) );
+
+		VertexCache_draw ( primitiveCount, texCount );
+		PrimitivesDrawn += primitiveCount;
+	}
+
+	UseInstanceColor = false;
+	setTransform ( ETS_WORLD, world );
+}
+
+
+//! number of textures used by the shader, set up for the current shadow pass
+u32 CBurningVideoDriver::getShaderTextureCount ()
+{
+	// depth maps are untextured, shadowed geometry keeps the first texture only
+	if ( ShadowPass == ESP_DEPTH )
+		return 0;
+
+	if ( ShadowPass == ESP_RECEIVE )
+	{
+		CurrentShader->setTextureParam(1, 0, 0);
+		return 1;
+	}
+
+	return vSize[VertexCache.vType].TexSize;
+}
+
+
+//! clips, culls and rasterizes the primitives of the vertex cache
+void CBurningVideoDriver::VertexCache_draw ( u32 primitiveCount, u32 texCount )
+{
 	const s4DVertex * face[3];
 
 	f32 dc_area;
@@ -1301,7 +1507,7 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 
 			// select mipmap
 
-			for ( g = 0; g != vSize[VertexCache.vType].TexSize; ++g )
+			for ( g = 0; g != texCount; ++g )
 			//for ( g = 0; g != BURNING_MATERIAL_MAX_TEXTURES; ++g )
 			{
 				if ( 0 == (tex = MAT_TEXTURE ( g )) )
@@ -1316,6 +1522,9 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 
 			}
 
+			if ( ShadowPass == ESP_RECEIVE )
+				select_polygon_shadow2 ( (s4DVertex**) face );
+
 			// rasterize
 			CurrentShader->drawTriangle ( face[0] + 1, face[1] + 1, face[2] + 1 );
 			continue;
@@ -1420,7 +1629,7 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 
 		// select mipmap
 		//for ( g = 0; g != BURNING_MATERIAL_MAX_TEXTURES; ++g )
-		for ( g = 0; g != vSize[VertexCache.vType].TexSize; ++g )
+		for ( g = 0; g != texCount; ++g )
 		{
 			if ( 0 == (tex = MAT_TEXTURE ( g )) )
 			{
@@ -1433,6 +1642,9 @@ void CBurningVideoDriver::drawVertexPrimitiveList(const void* vertices, u32 vert
 			select_polygon_mipmap ( CurrentOut.data, vOut, g, tex->getSize() );
 		}
 
+		if ( ShadowPass == ESP_RECEIVE )
+			select_polygon_shadow ( CurrentOut.data, vOut );
+
 		// re-tesselate ( triangle-fan, 0-1-2,0-2-3.. )
 		for ( g = 0; g <= vOut - 6; g += 2 )
 		{
@@ -1725,11 +1937,21 @@ void CBurningVideoDriver::draw2DImage(const video::ITexture* texture, const core
 			return;
 		}
 
+		// images are drawn from the largest level, which is loaded once and pinned
+		CSoftwareTexture2* tex = (CSoftwareTexture2*)texture;
+		tex->requestLevel(0);
+		if (tex->getResidentLevel())
+		{
+			makeTextureResident(tex);
+			if (tex->getResidentLevel())
+				return;
+		}
+
 		if (useAlphaChannelOfTexture)
-			((CSoftwareTexture2*)texture)->getImage()->copyToWithAlpha(
+			tex->getImage()->copyToWithAlpha(
 				BackBuffer, destPos, sourceRect, color, clipRect);
 		else
-			((CSoftwareTexture2*)texture)->getImage()->copyTo(
+			tex->getImage()->copyTo(
 				BackBuffer, destPos, sourceRect, clipRect);
 	}
 }
@@ -1821,6 +2043,13 @@ const core::dimension2d<u32>& CBurningVideoDriver::getCurrentRenderTargetSize()
 }
 
 
+//! returns the current render target texture, or 0 for the screen
+ITexture* CBurningVideoDriver::getCurrentRenderTarget() const
+{
+	return RenderTargetTexture;
+}
+
+
 //!Draws an 2d rectangle with a gradient.
 void CBurningVideoDriver::draw2DRectangle(const core::rect<s32>& position,
 	SColor colorLeftUp, SColor colorRightUp, SColor colorLeftDown, SColor colorRightDown,
@@ -2029,7 +2258,8 @@ const core::matrix4& CBurningVideoDriver::getTransform(E_TRANSFORMATION_STATE st
 ITexture* CBurningVideoDriver::addRenderTargetTexture(const core::dimension2d<u32>& size,
 		const io::path& name, const ECOLOR_FORMAT format)
 {
-	CImage* img = new CImage(BURNINGSHADER_COLOR_FORMAT, size);
+	// ECF_R32F targets hold the depth of shadow maps
+	CImage* img = new CImage(format == ECF_R32F ? ECF_R32F : BURNINGSHADER_COLOR_FORMAT, size);
 	ITexture* tex = new CSoftwareTexture2(img, name, CSoftwareTexture2::IS_RENDERTARGET );
 	img->drop();
 	addTexture(tex);
@@ -2073,6 +2303,49 @@ ITexture* CBurningVideoDriver::createDeviceDependentTexture(IImage* surface, con
 }
 
 
+//! gets the residency of a texture and resets its requested level
+bool CBurningVideoDriver::getTextureResidency(ITexture* texture, STextureResidency& residency)
+{
+	CSoftwareTexture2* tex = (CSoftwareTexture2*) texture;
+	if (texture->getDriverType() != EDT_BURNINGSVIDEO || !tex->isStreamable())
+		return false;
+
+	residency.ResidentLevel = tex->getResidentLevel();
+	residency.RequestedLevel = tex->takeRequestedLevel();
+	residency.LevelCount = tex->getLevelCount();
+	residency.ResidentSize = tex->getResidentSize();
+	return true;
+}
+
+
+//! returns the size in bytes of a mip level
+u32 CBurningVideoDriver::getTextureLevelSize(ITexture* texture, u32 level) const
+{
+	return ((CSoftwareTexture2*) texture)->getLevelSize(level);
+}
+
+
+//! returns the dimension of a mip level
+core::dimension2d<u32> CBurningVideoDriver::getTextureLevelDimension(ITexture* texture, u32 level) const
+{
+	return ((CSoftwareTexture2*) texture)->getLevelDimension(level);
+}
+
+
+//! releases the mip levels finer than level
+void CBurningVideoDriver::releaseTextureLevels(ITexture* texture, u32 level)
+{
+	((CSoftwareTexture2*) texture)->releaseLevels(level);
+}
+
+
+//! makes level and the coarser mip levels resident, image holds the whole texture
+void CBurningVideoDriver::loadTextureLevels(ITexture* texture, IImage* image, u32 level)
+{
+	((CSoftwareTexture2*) texture)->loadLevels(image, level);
+}
+
+
 //! Returns the maximum amount of primitives (mostly vertices) which
 //! the device is able to render with one drawIndexedTriangleList
 //! call.
@@ -2085,43 +2358,76 @@ u32 CBurningVideoDriver::getMaximalPrimitiveCount() const
 //! Draws a shadow volume into the stencil buffer. To draw a stencil shadow, do
 //! this: First, draw all geometry. Then use this method, to draw the shadow
 //! volume. Then, use IVideoDriver::drawStencilShadow() to visualize the shadow.
+/** Front faces add one and back faces subtract one for every pixel where
+they pass (z-pass) or fail (z-fail) the depth test. Both sides are counted
+in a single pass with wrapping arithmetic, so the result doesn't depend on
+the order of the faces. */
 void CBurningVideoDriver::drawStencilShadowVolume(const core::vector3df* triangles, s32 count, bool zfail)
 {
-/*
-	if (!StencilBuffer || !count)
+	IBurningShader* shader = BurningShader[ETR_STENCIL_SHADOW];
+	if (!StencilBuffer || !shader || count < 3)
 		return;
 
-	setRenderStatesStencilShadowMode(zfail);
+	shader->setRenderTarget(RenderTargetSurface, ViewPort);
+	shader->setParam ( 0, zfail ? 1.f : 0.f );
 
-	if (!zfail)
+	// only positions are clipped and projected
+	u32 g;
+	for ( g = 0; g != CurrentOut.ElementSize; ++g )
 	{
-		// ZPASS Method
+		CurrentOut.data[g].flag = 0;
+		Temp.data[g].flag = 0;
+	}
 
-		// Draw front-side of shadow volume in stencil/z only
-		pID3DDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_CCW );
-		pID3DDevice->SetRenderState(D3DRS_STENCILPASS, D3DSTENCILOP_INCRSAT);
-		pID3DDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, count / 3, triangles, sizeof(core::vector3df));
+	const core::matrix4& m = Transformation [ ETS_CURRENT ];
 
-		// Now reverse cull order so front sides of shadow volume are written.
-		pID3DDevice->SetRenderState( D3DRS_CULLMODE,   D3DCULL_CW );
-		pID3DDevice->SetRenderState( D3DRS_STENCILPASS, D3DSTENCILOP_DECRSAT);
-		pID3DDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, count / 3, triangles, sizeof(core::vector3df));
-	}
-	else
+	for ( s32 i = 0; i + 2 < count; i += 3 )
 	{
-		// ZFAIL Method
+		s4DVertex* v = CurrentOut.data;
+		u32 flagOr = 0;
+		u32 flagAnd = VERTEX4D_CLIPMASK;
+		for ( g = 0; g != 3; ++g )
+		{
+			m.transformVect ( &v[g*2].Pos.x, triangles[i+g] );
+			v[g*2].flag = clipToFrustumTest ( v + g*2 );
+			flagOr |= v[g*2].flag;
+			flagAnd &= v[g*2].flag;
+		}
 
-		// Draw front-side of shadow volume in stencil/z only
-		pID3DDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_CW );
-		pID3DDevice->SetRenderState(D3DRS_STENCILZFAIL, D3DSTENCILOP_INCRSAT );
-		pID3DDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, count / 3, triangles, sizeof(core::vector3df));
+		// if fully outside or outside on same side
+		if ( ( flagOr & VERTEX4D_CLIPMASK ) != VERTEX4D_INSIDE )
+			continue;
 
-		// Now reverse cull order so front sides of shadow volume are written.
-		pID3DDevice->SetRenderState( D3DRS_CULLMODE,   D3DCULL_CCW );
-		pID3DDevice->SetRenderState( D3DRS_STENCILZFAIL,  D3DSTENCILOP_DECRSAT );
-		pID3DDevice->DrawPrimitiveUP(D3DPT_TRIANGLELIST, count / 3, triangles, sizeof(core::vector3df));
+		u32 vOut = 3;
+		if ( flagAnd != VERTEX4D_INSIDE )
+		{
+			vOut = clipToFrustum ( CurrentOut.data, Temp.data, 3 );
+			if ( vOut < 3 )
+				continue;
+		}
+
+		vOut <<= 1;
+		for ( g = 0; g != vOut; g += 2 )
+			CurrentOut.data[g + 1].flag = 0;
+
+		// to DC Space, project homogenous vertex
+		ndc_2_dc_and_project ( CurrentOut.data + 1, CurrentOut.data, vOut );
+
+		// front faces count up, back faces down, swapped for z-fail
+		const f32 dc_area = screenarea ( CurrentOut.data );
+		if ( 0.f == dc_area )
+			continue;
+		const bool front = F32_GREATER_0 ( dc_area );
+		shader->setParam ( 1, front != zfail ? 1.f : 255.f );
+
+		// re-tesselate ( triangle-fan, 0-1-2,0-2-3.. )
+		for ( g = 0; g <= vOut - 6; g += 2 )
+		{
+			shader->drawTriangle ( CurrentOut.data + 0 + 1,
+							CurrentOut.data + g + 3,
+							CurrentOut.data + g + 5);
+		}
 	}
-*/
 }
 
 
@@ -2132,34 +2438,97 @@ void CBurningVideoDriver::drawStencilShadowVolume(const core::vector3df* triangl
 void CBurningVideoDriver::drawStencilShadow(bool clearStencilBuffer, video::SColor leftUpEdge,
 			video::SColor rightUpEdge, video::SColor leftDownEdge, video::SColor rightDownEdge)
 {
-/*
-	if (!StencilBuffer)
+	if (!StencilBuffer || !RenderTargetSurface)
 		return;
 
-	S3DVertex vtx[4];
-	vtx[0] = S3DVertex(1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, leftUpEdge, 0.0f, 0.0f);
-	vtx[1] = S3DVertex(1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, rightUpEdge, 0.0f, 1.0f);
-	vtx[2] = S3DVertex(-1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, leftDownEdge, 1.0f, 0.0f);
-	vtx[3] = S3DVertex(-1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, rightDownEdge, 1.0f, 1.0f);
+	const s32 width = ViewPort.getWidth();
+	const s32 height = ViewPort.getHeight();
+	if ( width <= 0 || height <= 0 )
+		return;
 
-	s16 indices[6] = {0,1,2,1,3,2};
+	const bool flat = leftUpEdge == rightUpEdge && leftUpEdge == leftDownEdge &&
+		leftUpEdge == rightDownEdge;
 
-	setRenderStatesStencilFillMode(
-		leftUpEdge.getAlpha() < 255 ||
-		rightUpEdge.getAlpha() < 255 ||
-		leftDownEdge.getAlpha() < 255 ||
-		rightDownEdge.getAlpha() < 255);
+	const u32 stencilPitch = StencilBuffer->getPitch();
+	const u32 pitch = RenderTargetSurface->getPitch();
+	const u8* stencilRow = (u8*) StencilBuffer->lock() + ViewPort.UpperLeftCorner.Y * stencilPitch + ViewPort.UpperLeftCorner.X;
+	u8* dstRow = (u8*) RenderTargetSurface->lock() + ViewPort.UpperLeftCorner.Y * pitch +
+		ViewPort.UpperLeftCorner.X * sizeof ( tVideoSample );
 
-	setTexture(0,0);
+	const f32 invWidth = core::reciprocal ( (f32) width );
+	const f32 invHeight = core::reciprocal ( (f32) height );
 
-	setVertexShader(EVT_STANDARD);
+	SColor color = leftUpEdge;
+	for ( s32 y = 0; y != height; ++y )
+	{
+		tVideoSample* dst = (tVideoSample*) dstRow;
+
+		// the gradient is only evaluated for shadowed pixels
+		const f32 ty = (f32) y * invHeight;
+		const SColor left = leftDownEdge.getInterpolated ( leftUpEdge, ty );
+		const SColor right = rightDownEdge.getInterpolated ( rightUpEdge, ty );
+
+		for ( s32 x = 0; x != width; ++x )
+		{
+			if ( 0 == stencilRow[x] )
+				continue;
 
-	pID3DDevice->DrawIndexedPrimitiveUP(D3DPT_TRIANGLELIST, 0, 4, 2, &indices[0],
-		D3DFMT_INDEX16, &vtx[0], sizeof(S3DVertex));
+			if ( !flat )
+				color = right.getInterpolated ( left, (f32) x * invWidth );
+
+#ifdef SOFTWARE_DRIVER_2_32BIT
+			dst[x] = PixelBlend32 ( dst[x], color.color );
+#else
+			dst[x] = PixelBlend16 ( dst[x], A8R8G8B8toA1R5G5B5 ( color.color ), color.getAlpha() >> 3 );
+#endif
+		}
+
+		stencilRow += stencilPitch;
+		dstRow += pitch;
+	}
+
+	RenderTargetSurface->unlock();
 
 	if (clearStencilBuffer)
-		pID3DDevice->Clear( 0, NULL, D3DCLEAR_STENCIL,0, 1.0, 0);
-*/
+		StencilBuffer->clear();
+}
+
+
+//! Shadows the following solid geometry with a depth map rendered from the light.
+void CBurningVideoDriver::setShadowMap(ITexture* depth, const core::matrix4& lightViewProjection,
+		SColor shadowColor, f32 bias)
+{
+	if (depth && (depth->getDriverType() != EDT_BURNINGSVIDEO || depth->getColorFormat() != ECF_R32F))
+	{
+		os::Printer::log("Shadow maps need an ECF_R32F render target texture of this driver.", ELL_ERROR);
+		depth = 0;
+	}
+
+	if (depth)
+		depth->grab();
+	if (ShadowMap)
+		ShadowMap->drop();
+
+	ShadowMap = depth;
+	ShadowColor = shadowColor;
+	ShadowBias = bias;
+
+	if (ShadowMap)
+	{
+		// light clip space to texels of the shadow map, like ETS_CLIPSCALE
+		const core::dimension2d<u32>& size = ShadowMap->getSize();
+		core::matrix4 texels;
+		texels.buildNDCToDCMatrix(core::rect<s32>(0, 0, size.Width, size.Height), 1);
+		Transformation[ETS_SHADOW].setbyproduct_nocheck(texels, lightViewProjection);
+
+		if (TransformationFlag[ETS_WORLD] & ETF_IDENTITY)
+			Transformation[ETS_SHADOW_CURRENT] = Transformation[ETS_SHADOW];
+		else
+			Transformation[ETS_SHADOW_CURRENT].setbyproduct_nocheck(
+				Transformation[ETS_SHADOW], Transformation[ETS_WORLD]);
+	}
+
+	setCurrentShader();
 }
 
 
@@ -57,6 +57,9 @@ namespace video
 		//! returns size of the current render target
 		virtual const core::dimension2d<u32>& getCurrentRenderTargetSize() const;
 
+		//! returns the current render target texture, or 0 for the screen
+		virtual ITexture* getCurrentRenderTarget() const;
+
 		//! deletes all dynamic lights there are
 		virtual void deleteAllDynamicLights();
 
@@ -83,6 +86,11 @@ namespace video
 				const void* indexList, u32 primitiveCount,
 				E_VERTEX_TYPE vType, scene::E_PRIMITIVE_TYPE pType, E_INDEX_TYPE iType);
 
+		//! Draws many instances of a mesh buffer, only transforming the vertices again
+		virtual void drawMeshBufferInstanced(const scene::IMeshBuffer* mb,
+				const core::matrix4* transforms, const SColor* colors,
+				u32 instanceCount);
+
 		//! draws an 2d image, using a color (if color is other then Color(255,255,255,255)) and the alpha channel of the texture if wanted.
 		virtual void draw2DImage(const video::ITexture* texture, const core::position2d<s32>& destPos,
 			const core::rect<s32>& sourceRect, const core::rect<s32>* clipRect = 0,
@@ -151,6 +159,10 @@ namespace video
 			video::SColor leftDownEdge = video::SColor(0,0,0,0),
 			video::SColor rightDownEdge = video::SColor(0,0,0,0));
 
+		//! Shadows the following solid geometry with a depth map rendered from the light.
+		virtual void setShadowMap(ITexture* depth, const core::matrix4& lightViewProjection,
+			SColor shadowColor=SColor(150,0,0,0), f32 bias=0.002f);
+
 		//! Returns the graphics card vendor name.
 		virtual core::stringc getVendorInfo();
 
@@ -170,6 +182,21 @@ namespace video
 		//! THIS METHOD HAS TO BE OVERRIDDEN BY DERIVED DRIVERS WITH OWN TEXTURES
 		virtual video::ITexture* createDeviceDependentTexture(IImage* surface, const io::path& name, void* mipmapData=0);
 
+		//! gets the residency of a texture and resets its requested level
+		virtual bool getTextureResidency(ITexture* texture, STextureResidency& residency);
+
+		//! returns the size in bytes of a mip level
+		virtual u32 getTextureLevelSize(ITexture* texture, u32 level) const;
+
+		//! returns the dimension of a mip level
+		virtual core::dimension2d<u32> getTextureLevelDimension(ITexture* texture, u32 level) const;
+
+		//! releases the mip levels finer than level
+		virtual void releaseTextureLevels(ITexture* texture, u32 level);
+
+		//! makes level and the coarser mip levels resident, image holds the whole texture
+		virtual void loadTextureLevels(ITexture* texture, IImage* image, u32 level);
+
 		video::CImage* BackBuffer;
 		video::IImagePresenter* Presenter;
 
@@ -187,6 +214,22 @@ namespace video
 		IBurningShader* BurningShader[ETR2_COUNT];
 
 		IDepthBuffer* DepthBuffer;
+		IStencilBuffer* StencilBuffer;
+
+		//! what the shadow map does to the triangles drawn next
+		enum E_SHADOW_PASS
+		{
+			ESP_NONE = 0,
+			//! only depth is written into an ECF_R32F render target
+			ESP_DEPTH,
+			//! solid geometry is shadowed by ShadowMap
+			ESP_RECEIVE
+		};
+
+		E_SHADOW_PASS ShadowPass;
+		ITexture* ShadowMap;
+		SColor ShadowColor;
+		f32 ShadowBias;
 
 
 		/*
@@ -194,6 +237,7 @@ namespace video
 			-> combined CameraProjection
 			-> combined CameraProjectionWorld
 			-> ClipScale from NDC to DC Space
+			-> light ViewProjection to shadow map texels, with and without World
 		*/
 		enum E_TRANSFORMATION_STATE_BURNING_VIDEO
 		{
@@ -201,6 +245,8 @@ namespace video
 			ETS_CURRENT,
 			ETS_CLIPSCALE,
 			ETS_VIEW_INVERSE,
+			ETS_SHADOW,
+			ETS_SHADOW_CURRENT,
 
 			ETS_COUNT_BURNING
 		};
@@ -230,6 +276,8 @@ namespace video
 		void VertexCache_getbypass ( s4DVertex ** face );
 
 		void VertexCache_fill ( const u32 sourceIndex,const u32 destIndex );
+		void VertexCache_draw ( u32 primitiveCount, u32 texCount );
+		u32 getShaderTextureCount ();
 		s4DVertex * VertexCache_getVertex ( const u32 sourceIndex );
 
 
@@ -263,10 +311,17 @@ namespace video
 		f32 texelarea2 ( const s4DVertex **v, int tex ) const;
 		void select_polygon_mipmap2 ( s4DVertex **source, u32 tex, const core::dimension2du& texSize ) const;
 
+		void select_polygon_shadow ( s4DVertex *source, u32 vIn ) const;
+		void select_polygon_shadow2 ( s4DVertex **source ) const;
+
 
 		SBurningShaderLightSpace LightSpace;
 		SBurningShaderMaterial Material;
 
+		//! color of the instance drawn by drawMeshBufferInstanced, multiplied with the vertex colors
+		sVec4 InstanceColor;
+		bool UseInstanceColor;
+
 		static const sVec4 NDCPlane[6];
 	};
 
@@ -8,6 +8,8 @@
 #include "SoftwareDriver2_compile_config.h"
 #include "SoftwareDriver2_helper.h"
 #include "CSoftwareTexture2.h"
+#include "CImageResampler.h"
+#include "CBlockCompression.h"
 #include "os.h"
 
 namespace irr
@@ -15,10 +17,23 @@ namespace irr
 namespace video
 {
 
+//! compresses an A8R8G8B8 image into a new image of the given block format
+static CImage* createCompressedImage(CImage* image, ECOLOR_FORMAT format)
+{
+	CImage* compressed = new CImage(format, image->getDimension());
+	CBlockCompression::compress(image->lock(), image->getDimension(), image->getPitch(),
+			compressed->lock(), format);
+	compressed->unlock();
+	image->unlock();
+	return compressed;
+}
+
 //! constructor
 CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name,
 		u32 flags, void* mipmapData)
-		: ITexture(name), MipMapLOD(0), Flags ( flags ), OriginalFormat(video::ECF_UNKNOWN)
+		: ITexture(name), MipMapLOD(0), ResidentLevel(0),
+		RequestedLevel(SOFTWARE_DRIVER_2_MIPMAPPING_MAX), Flags ( flags ),
+		ChangeCount(0), OriginalFormat(video::ECF_UNKNOWN)
 {
 	#ifdef _DEBUG
 	setDebugName("CSoftwareTexture2");
@@ -35,9 +50,13 @@ CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name,
 		OrigSize = image->getDimension();
 		OriginalFormat = image->getColorFormat();
 
+		// block compressed textures are sampled directly from their blocks
+		const bool compressed = IImage::isCompressedFormat(OriginalFormat);
+
 		core::setbit_cond(Flags,
 				image->getColorFormat () == video::ECF_A8R8G8B8 ||
-				image->getColorFormat () == video::ECF_A1R5G5B5,
+				image->getColorFormat () == video::ECF_A1R5G5B5 ||
+				compressed,
 				HAS_ALPHA);
 
 		core::dimension2d<u32> optSize(
@@ -48,8 +67,17 @@ CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name,
 
 		if ( OrigSize == optSize )
 		{
-			MipMap[0] = new CImage(BURNINGSHADER_COLOR_FORMAT, image->getDimension());
-			image->copyTo(MipMap[0]);
+			// depth maps keep their floats
+			if (compressed || OriginalFormat == ECF_R32F)
+			{
+				MipMap[0] = new CImage(OriginalFormat, OrigSize, image->lock(), false);
+				image->unlock();
+			}
+			else
+			{
+				MipMap[0] = new CImage(BURNINGSHADER_COLOR_FORMAT, image->getDimension());
+				image->copyTo(MipMap[0]);
+			}
 		}
 		else
 		{
@@ -63,8 +91,18 @@ CSoftwareTexture2::CSoftwareTexture2(IImage* image, const io::path& name,
 
 			OrigSize = optSize;
 			os::Printer::log ( buf, ELL_WARNING );
-			MipMap[0] = new CImage(BURNINGSHADER_COLOR_FORMAT, optSize);
-			image->copyToScalingBoxFilter ( MipMap[0],0, false );
+			if (compressed)
+			{
+				CImage* tmpImage = new CImage(ECF_A8R8G8B8, optSize);
+				image->copyToScalingBoxFilter ( tmpImage,0, false );
+				MipMap[0] = createCompressedImage(tmpImage, OriginalFormat);
+				tmpImage->drop();
+			}
+			else
+			{
+				MipMap[0] = new CImage(BURNINGSHADER_COLOR_FORMAT, optSize);
+				image->copyToScalingBoxFilter ( MipMap[0],0, false );
+			}
 		}
 	}
 
@@ -90,10 +128,18 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* mipmapData)
 	if ( !hasMipMaps () )
 		return;
 
+	++ChangeCount;
+
 	s32 i;
 
+	// streamed textures regenerate the levels below the finest resident one,
+	// mipmapData always starts at level 1
+	const s32 first = ResidentLevel + 1;
+	if (ResidentLevel)
+		mipmapData = 0;
+
 	// release
-	for ( i = 1; i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i )
+	for ( i = first; i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i )
 	{
 		if ( MipMap[i] )
 			MipMap[i]->drop();
@@ -102,7 +148,17 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* mipmapData)
 	core::dimension2d<u32> newSize;
 	core::dimension2d<u32> origSize=OrigSize;
 
-	for (i=1; i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i)
+	// compressed levels are filtered from decoded pixels and compressed again
+	const ECOLOR_FORMAT format = MipMap[ResidentLevel]->getColorFormat();
+	const bool compressed = IImage::isCompressedFormat(format);
+	CImage* decoded = 0;
+	if (compressed && !mipmapData)
+	{
+		decoded = new CImage(ECF_A8R8G8B8, MipMap[ResidentLevel]->getDimension());
+		MipMap[ResidentLevel]->copyTo(decoded);
+	}
+
+	for (i=first; i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i)
 	{
 		newSize = MipMap[i-1]->getDimension();
 		newSize.Width = core::s32_max ( 1, newSize.Width >> SOFTWARE_DRIVER_2_MIPMAPPING_SCALE );
@@ -110,7 +166,22 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* mipmapData)
 		origSize.Width = core::s32_max(1, origSize.Width >> 1);
 		origSize.Height = core::s32_max(1, origSize.Height >> 1);
 
-		if (mipmapData)
+		if (mipmapData && compressed)
+		{
+			if (origSize==newSize)
+				MipMap[i] = new CImage(format, newSize, mipmapData, false);
+			else
+			{
+				IImage* tmpImage = new CImage(OriginalFormat, origSize, mipmapData, true, false);
+				CImage* scaled = new CImage(ECF_A8R8G8B8, newSize);
+				tmpImage->copyToScalingBoxFilter(scaled);
+				MipMap[i] = createCompressedImage(scaled, format);
+				scaled->drop();
+				tmpImage->drop();
+			}
+			mipmapData = (u8*)mipmapData+IImage::getDataSizeFromFormat(OriginalFormat, origSize.Width, origSize.Height);
+		}
+		else if (mipmapData)
 		{
 			if (OriginalFormat != BURNINGSHADER_COLOR_FORMAT)
 			{
@@ -134,15 +205,109 @@ void CSoftwareTexture2::regenerateMipMapLevels(void* mipmapData)
 					tmpImage->drop();
 				}
 			}
-			mipmapData = (u8*)mipmapData+origSize.getArea()*IImage::getBitsPerPixelFromFormat(OriginalFormat)/8;
+			mipmapData = (u8*)mipmapData+IImage::getDataSizeFromFormat(OriginalFormat, origSize.Width, origSize.Height);
+		}
+		else if (compressed)
+		{
+			CImage* scaled = new CImage(ECF_A8R8G8B8, newSize);
+			CImageResampler::resample(decoded, scaled, SOFTWARE_DRIVER_2_MIPMAPPING_FILTER);
+			MipMap[i] = createCompressedImage(scaled, format);
+			decoded->drop();
+			decoded = scaled;
 		}
 		else
 		{
+			// each level is filtered from the previous one, which is
+			// a simple 2x2 box for the usual power of two sizes
 			MipMap[i] = new CImage(BURNINGSHADER_COLOR_FORMAT, newSize);
-			MipMap[i]->fill ( 0 );
-			MipMap[0]->copyToScalingBoxFilter( MipMap[i], 0, false );
+			CImageResampler::resample(MipMap[i-1], MipMap[i], SOFTWARE_DRIVER_2_MIPMAPPING_FILTER);
+		}
+	}
+
+	if (decoded)
+		decoded->drop();
+}
+
+
+//! returns the dimension of a mip level
+core::dimension2d<u32> CSoftwareTexture2::getLevelDimension(u32 level) const
+{
+	const u32 shift = level * SOFTWARE_DRIVER_2_MIPMAPPING_SCALE;
+	return core::dimension2d<u32>(
+		core::max_(1u, shift < 32 ? OrigSize.Width >> shift : 0u),
+		core::max_(1u, shift < 32 ? OrigSize.Height >> shift : 0u));
+}
+
+
+//! returns the size of a mip level in bytes
+u32 CSoftwareTexture2::getLevelSize(u32 level) const
+{
+	const core::dimension2d<u32> size = getLevelDimension(level);
+	return IImage::getDataSizeFromFormat(getColorFormat(), size.Width, size.Height);
+}
+
+
+//! returns the size of the resident mip levels in bytes
+u32 CSoftwareTexture2::getResidentSize() const
+{
+	u32 size = 0;
+	for (u32 i = ResidentLevel; i < SOFTWARE_DRIVER_2_MIPMAPPING_MAX; ++i)
+	{
+		if (MipMap[i])
+			size += MipMap[i]->getImageDataSizeInBytes();
+	}
+	return size;
+}
+
+
+//! releases the mip levels finer than level
+void CSoftwareTexture2::releaseLevels(u32 level)
+{
+	level = core::min_(level, getLevelCount() - 1);
+	for (u32 i = ResidentLevel; i < level; ++i)
+	{
+		MipMap[i]->drop();
+		MipMap[i] = 0;
+	}
+
+	ResidentLevel = core::max_(ResidentLevel, level);
+	MipMapLOD = core::max_(MipMapLOD, ResidentLevel);
+}
+
+
+//! makes level and the coarser mip levels resident, image holds the whole texture
+void CSoftwareTexture2::loadLevels(IImage* image, u32 level)
+{
+	const ECOLOR_FORMAT format = getColorFormat();
+	const bool compressed = IImage::isCompressedFormat(format);
+
+	for (u32 i = level; i < ResidentLevel; ++i)
+	{
+		const core::dimension2d<u32> size = getLevelDimension(i);
+
+		if (image->getColorFormat() == format && image->getDimension() == size)
+		{
+			MipMap[i] = new CImage(format, size, image->lock(), false);
+			image->unlock();
+		}
+		else if (compressed)
+		{
+			CImage* tmpImage = new CImage(ECF_A8R8G8B8, size);
+			image->copyToScalingBoxFilter(tmpImage, 0, false);
+			MipMap[i] = createCompressedImage(tmpImage, format);
+			tmpImage->drop();
+		}
+		else
+		{
+			MipMap[i] = new CImage(format, size);
+			if (image->getDimension() == size)
+				image->copyTo(MipMap[i]);
+			else
+				image->copyToScalingBoxFilter(MipMap[i], 0, false);
 		}
 	}
+
+	ResidentLevel = core::min_(ResidentLevel, level);
 }
 
 
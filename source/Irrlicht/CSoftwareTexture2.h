@@ -28,7 +28,8 @@ public:
 		GEN_MIPMAP	= 1,
 		IS_RENDERTARGET	= 2,
 		NP2_SIZE	= 4,
-		HAS_ALPHA	= 8
+		HAS_ALPHA	= 8,
+		IS_MODIFIED	= 16
 	};
 	CSoftwareTexture2(IImage* surface, const io::path& name, u32 flags, void* mipmapData=0);
 
@@ -38,8 +39,10 @@ public:
 	//! lock function
 	virtual void* lock(bool readOnly = false, u32 mipmapLevel=0)
 	{
+		if (!readOnly)
+			Flags |= IS_MODIFIED;
 		if (Flags & GEN_MIPMAP)
-			MipMapLOD=mipmapLevel;
+			MipMapLOD=core::max_(mipmapLevel, ResidentLevel);
 		return MipMap[MipMapLOD]->lock();
 	}
 
@@ -47,6 +50,15 @@ public:
 	virtual void unlock()
 	{
 		MipMap[MipMapLOD]->unlock();
+
+		// the content may have been changed through the lock
+		++ChangeCount;
+	}
+
+	//! returns a counter which changes whenever the content may have changed
+	u32 getChangeCount() const
+	{
+		return ChangeCount;
 	}
 
 	//! Returns original size of the texture.
@@ -59,7 +71,7 @@ public:
 	//! Returns the size of the largest mipmap.
 	f32 getLODFactor( const f32 texArea ) const
 	{
-		return MipMap[0]->getImageDataSizeInPixels () * texArea;
+		return OrigSize.getArea() * texArea;
 	}
 
 	//! Returns (=size) of the texture.
@@ -69,9 +81,10 @@ public:
 	}
 
 	//! returns unoptimized surface
+	/** This is a smaller mip level if the largest one was released. */
 	virtual CImage* getImage() const
 	{
-		return MipMap[0];
+		return MipMap[ResidentLevel];
 	}
 
 	//! returns texture surface
@@ -88,9 +101,10 @@ public:
 	}
 
 	//! returns color format of texture
+	/** Block compressed textures keep their format. */
 	virtual ECOLOR_FORMAT getColorFormat() const
 	{
-		return BURNINGSHADER_COLOR_FORMAT;
+		return MipMap[ResidentLevel] ? MipMap[ResidentLevel]->getColorFormat() : BURNINGSHADER_COLOR_FORMAT;
 	}
 
 	//! returns pitch of texture (in bytes)
@@ -121,13 +135,64 @@ public:
 		return (Flags & IS_RENDERTARGET) != 0;
 	}
 
+	//! returns the number of mip levels
+	u32 getLevelCount() const
+	{
+		return hasMipMaps() ? SOFTWARE_DRIVER_2_MIPMAPPING_MAX : 1;
+	}
+
+	//! returns the finest mip level in memory
+	u32 getResidentLevel() const
+	{
+		return ResidentLevel;
+	}
+
+	//! can mip levels be released and loaded again
+	bool isStreamable() const
+	{
+		return hasMipMaps() && !(Flags & (IS_RENDERTARGET | IS_MODIFIED));
+	}
+
+	//! notes that the renderer sampled a mip level
+	void requestLevel(u32 level)
+	{
+		if (level < RequestedLevel)
+			RequestedLevel = level;
+	}
+
+	//! returns the finest mip level sampled since the last call, getLevelCount() if none
+	u32 takeRequestedLevel()
+	{
+		const u32 level = RequestedLevel;
+		RequestedLevel = getLevelCount();
+		return level;
+	}
+
+	//! returns the dimension of a mip level
+	core::dimension2d<u32> getLevelDimension(u32 level) const;
+
+	//! returns the size of a mip level in bytes
+	u32 getLevelSize(u32 level) const;
+
+	//! returns the size of the resident mip levels in bytes
+	u32 getResidentSize() const;
+
+	//! releases the mip levels finer than level
+	void releaseLevels(u32 level);
+
+	//! makes level and the coarser mip levels resident, image holds the whole texture
+	void loadLevels(IImage* image, u32 level);
+
 private:
 	core::dimension2d<u32> OrigSize;
 
 	CImage * MipMap[SOFTWARE_DRIVER_2_MIPMAPPING_MAX];
 
 	u32 MipMapLOD;
+	u32 ResidentLevel;
+	u32 RequestedLevel;
 	u32 Flags;
+	u32 ChangeCount;
 	ECOLOR_FORMAT OriginalFormat;
 };
 
@@ -0,0 +1,287 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt / Thomas Alten
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#include "IBurningShader.h"
+
+#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+
+// compile flag for this file
+#undef USE_ZBUFFER
+#undef IPOL_Z
+#undef CMP_Z
+#undef WRITE_Z
+
+#undef IPOL_W
+#undef CMP_W
+#undef WRITE_W
+
+#undef SUBTEXEL
+#undef INVERSE_W
+
+#undef IPOL_C0
+#undef IPOL_T0
+#undef IPOL_T1
+
+// define render case
+#define SUBTEXEL
+
+// apply global override
+#ifndef SOFTWARE_DRIVER_2_SUBTEXEL
+	#undef SUBTEXEL
+#endif
+
+
+namespace irr
+{
+
+namespace video
+{
+
+//! Renders the depth of shadow maps into a float render target
+/** Only the projected depth is interpolated, in the shadow map depth of
+the scanline data. It is linear in screen space for orthographic and
+perspective projections alike. The render target itself is the depth
+buffer of this pass, neither color nor the z buffer are touched. */
+class CTRShadowDepth : public IBurningShader
+{
+public:
+
+	//! constructor
+	CTRShadowDepth(IDepthBuffer* zbuffer);
+
+	//! draws an indexed triangle list
+	virtual void drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4DVertex *c );
+
+private:
+	void scanline ();
+	sScanConvertData scan;
+	sScanLineData line;
+};
+
+//! constructor
+CTRShadowDepth::CTRShadowDepth(IDepthBuffer* zbuffer)
+: IBurningShader(zbuffer)
+{
+	#ifdef _DEBUG
+	setDebugName("CTRShadowDepth");
+	#endif
+}
+
+
+/*!
+*/
+void CTRShadowDepth::scanline ()
+{
+	f32 *dst;
+
+	s32 xStart;
+	s32 xEnd;
+	s32 dx;
+
+#ifdef SUBTEXEL
+	f32 subPixel;
+#endif
+
+	f32 slopeS;
+
+	// apply top-left fill-convention, left
+	xStart = core::ceil32( line.x[0] );
+	xEnd = core::ceil32( line.x[1] ) - 1;
+
+	dx = xEnd - xStart;
+
+	if ( dx < 0 )
+		return;
+
+	// slopes
+	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
+
+	slopeS = (line.s[1] - line.s[0]) * invDeltaX;
+
+#ifdef SUBTEXEL
+	subPixel = ( (f32) xStart ) - line.x[0];
+	line.s[0] += slopeS * subPixel;
+#endif
+
+	dst = (f32*) RenderTarget->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
+
+	for ( s32 i = 0; i <= dx; ++i )
+	{
+		if ( line.s[0] < dst[i] )
+			dst[i] = line.s[0];
+
+		line.s[0] += slopeS;
+	}
+
+}
+
+void CTRShadowDepth::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4DVertex *c )
+{
+	// sort on height, y
+	if ( a->Pos.y > b->Pos.y ) swapVertexPointer(&a, &b);
+	if ( a->Pos.y > c->Pos.y ) swapVertexPointer(&a, &c);
+	if ( b->Pos.y > c->Pos.y ) swapVertexPointer(&b, &c);
+
+	const f32 ca = c->Pos.y - a->Pos.y;
+	const f32 ba = b->Pos.y - a->Pos.y;
+	const f32 cb = c->Pos.y - b->Pos.y;
+	// calculate delta y of the edges
+	scan.invDeltaY[0] = core::reciprocal( ca );
+	scan.invDeltaY[1] = core::reciprocal( ba );
+	scan.invDeltaY[2] = core::reciprocal( cb );
+
+	if ( F32_LOWER_EQUAL_0 ( scan.invDeltaY[0] ) )
+		return;
+
+	// find if the major edge is left or right aligned
+	f32 temp[4];
+
+	temp[0] = a->Pos.x - c->Pos.x;
+	temp[1] = -ca;
+	temp[2] = b->Pos.x - a->Pos.x;
+	temp[3] = ba;
+
+	scan.left = ( temp[0] * temp[3] - temp[1] * temp[2] ) > 0.f ? 0 : 1;
+	scan.right = 1 - scan.left;
+
+	// calculate slopes for the major edge
+	scan.slopeX[0] = (c->Pos.x - a->Pos.x) * scan.invDeltaY[0];
+	scan.x[0] = a->Pos.x;
+
+	scan.slopeS[0] = (c->Pos.z - a->Pos.z) * scan.invDeltaY[0];
+	scan.s[0] = a->Pos.z;
+
+	// top left fill convention y run
+	s32 yStart;
+	s32 yEnd;
+
+#ifdef SUBTEXEL
+	f32 subPixel;
+#endif
+
+	// rasterize upper sub-triangle
+	if ( (f32) 0.0 != scan.invDeltaY[1]  )
+	{
+		// calculate slopes for top edge
+		scan.slopeX[1] = (b->Pos.x - a->Pos.x) * scan.invDeltaY[1];
+		scan.x[1] = a->Pos.x;
+
+		scan.slopeS[1] = (b->Pos.z - a->Pos.z) * scan.invDeltaY[1];
+		scan.s[1] = a->Pos.z;
+
+		// apply top-left fill convention, top part
+		yStart = core::ceil32( a->Pos.y );
+		yEnd = core::ceil32( b->Pos.y ) - 1;
+
+#ifdef SUBTEXEL
+		subPixel = ( (f32) yStart ) - a->Pos.y;
+
+		// correct to pixel center
+		scan.x[0] += scan.slopeX[0] * subPixel;
+		scan.x[1] += scan.slopeX[1] * subPixel;
+
+		scan.s[0] += scan.slopeS[0] * subPixel;
+		scan.s[1] += scan.slopeS[1] * subPixel;
+#endif
+
+		// rasterize the edge scanlines
+		for( line.y = yStart; line.y <= yEnd; ++line.y)
+		{
+			line.x[scan.left] = scan.x[0];
+			line.x[scan.right] = scan.x[1];
+
+			line.s[scan.left] = scan.s[0];
+			line.s[scan.right] = scan.s[1];
+
+			// render a scanline
+			scanline ();
+
+			scan.x[0] += scan.slopeX[0];
+			scan.x[1] += scan.slopeX[1];
+
+			scan.s[0] += scan.slopeS[0];
+			scan.s[1] += scan.slopeS[1];
+		}
+	}
+
+	// rasterize lower sub-triangle
+	if ( (f32) 0.0 != scan.invDeltaY[2] )
+	{
+		// advance to middle point
+		if( (f32) 0.0 != scan.invDeltaY[1] )
+		{
+			temp[0] = b->Pos.y - a->Pos.y;	// dy
+
+			scan.x[0] = a->Pos.x + scan.slopeX[0] * temp[0];
+			scan.s[0] = a->Pos.z + scan.slopeS[0] * temp[0];
+		}
+
+		// calculate slopes for bottom edge
+		scan.slopeX[1] = (c->Pos.x - b->Pos.x) * scan.invDeltaY[2];
+		scan.x[1] = b->Pos.x;
+
+		scan.slopeS[1] = (c->Pos.z - b->Pos.z) * scan.invDeltaY[2];
+		scan.s[1] = b->Pos.z;
+
+		// apply top-left fill convention, top part
+		yStart = core::ceil32( b->Pos.y );
+		yEnd = core::ceil32( c->Pos.y ) - 1;
+
+#ifdef SUBTEXEL
+		subPixel = ( (f32) yStart ) - b->Pos.y;
+
+		// correct to pixel center
+		scan.x[0] += scan.slopeX[0] * subPixel;
+		scan.x[1] += scan.slopeX[1] * subPixel;
+
+		scan.s[0] += scan.slopeS[0] * subPixel;
+		scan.s[1] += scan.slopeS[1] * subPixel;
+#endif
+
+		// rasterize the edge scanlines
+		for( line.y = yStart; line.y <= yEnd; ++line.y)
+		{
+			line.x[scan.left] = scan.x[0];
+			line.x[scan.right] = scan.x[1];
+
+			line.s[scan.left] = scan.s[0];
+			line.s[scan.right] = scan.s[1];
+
+			// render a scanline
+			scanline ();
+
+			scan.x[0] += scan.slopeX[0];
+			scan.x[1] += scan.slopeX[1];
+
+			scan.s[0] += scan.slopeS[0];
+			scan.s[1] += scan.slopeS[1];
+		}
+	}
+
+}
+
+} // end namespace video
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
+
+namespace irr
+{
+namespace video
+{
+
+//! creates a renderer which writes the depth of shadow maps
+IBurningShader* createTRShadowDepth(IDepthBuffer* zbuffer)
+{
+	#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+	return new CTRShadowDepth(zbuffer);
+	#else
+	return 0;
+	#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
+}
+
+} // end namespace video
+} // end namespace irr
+
@@ -0,0 +1,443 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt / Thomas Alten
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "IrrCompileConfig.h"
+#include "IBurningShader.h"
+
+#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+
+// compile flag for this file
+#undef USE_ZBUFFER
+#undef IPOL_Z
+#undef CMP_Z
+#undef WRITE_Z
+
+#undef IPOL_W
+#undef CMP_W
+#undef WRITE_W
+
+#undef SUBTEXEL
+#undef INVERSE_W
+
+#undef IPOL_C0
+#undef IPOL_T0
+#undef IPOL_T1
+
+// define render case
+#define SUBTEXEL
+
+#define USE_ZBUFFER
+#define IPOL_W
+#define CMP_W
+
+// apply global override
+#ifndef SOFTWARE_DRIVER_2_SUBTEXEL
+	#undef SUBTEXEL
+#endif
+
+#if !defined ( SOFTWARE_DRIVER_2_USE_WBUFFER ) && defined ( USE_ZBUFFER )
+	#ifndef SOFTWARE_DRIVER_2_PERSPECTIVE_CORRECT
+		#undef IPOL_W
+	#endif
+	#define IPOL_Z
+
+	#ifdef CMP_W
+		#undef CMP_W
+		#define CMP_Z
+	#endif
+
+#endif
+
+
+namespace irr
+{
+
+namespace video
+{
+
+//! Renders shadow volumes into the stencil buffer only
+/** Only depth is interpolated, neither color nor depth are written. Every
+pixel of a face passing (z-pass) or failing (z-fail) the depth test adds
+the face's delta to the stencil value. The values wrap around, so faces
+can be drawn in any order, and a pixel is in shadow when its value is not
+zero after the whole volume was drawn. */
+class CTRStencilShadow : public IBurningShader
+{
+public:
+
+	//! constructor
+	CTRStencilShadow(IDepthBuffer* zbuffer, IStencilBuffer* stencil);
+
+	//! destructor
+	virtual ~CTRStencilShadow();
+
+	//! draws an indexed triangle list
+	virtual void drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4DVertex *c );
+
+	//! 0: 1 to count depth test failures instead of passes, 1: delta added per pixel
+	virtual void setParam ( u32 index, f32 value);
+
+private:
+	void scanline ();
+	sScanConvertData scan;
+	sScanLineData line;
+
+	IStencilBuffer* Stencil;
+	u8 ZFail;
+	u8 Delta;
+};
+
+//! constructor
+CTRStencilShadow::CTRStencilShadow(IDepthBuffer* zbuffer, IStencilBuffer* stencil)
+: IBurningShader(zbuffer), Stencil(stencil), ZFail(0), Delta(1)
+{
+	#ifdef _DEBUG
+	setDebugName("CTRStencilShadow");
+	#endif
+
+	if (Stencil)
+		Stencil->grab();
+}
+
+
+//! destructor
+CTRStencilShadow::~CTRStencilShadow()
+{
+	if (Stencil)
+		Stencil->drop();
+}
+
+
+//! sets the depth test outcome which is counted and the delta per pixel
+void CTRStencilShadow::setParam ( u32 index, f32 value)
+{
+	if ( 0 == index )
+		ZFail = value != 0.f ? 1 : 0;
+	else
+		Delta = (u8) core::round32 ( value );
+}
+
+
+/*!
+*/
+void CTRStencilShadow::scanline ()
+{
+#ifdef USE_ZBUFFER
+	fp24 *z;
+#endif
+	u8 *stencil;
+
+	s32 xStart;
+	s32 xEnd;
+	s32 dx;
+
+#ifdef SUBTEXEL
+	f32 subPixel;
+#endif
+
+#ifdef IPOL_Z
+	f32 slopeZ;
+#endif
+#ifdef IPOL_W
+	fp24 slopeW;
+#endif
+
+	// apply top-left fill-convention, left
+	xStart = core::ceil32( line.x[0] );
+	xEnd = core::ceil32( line.x[1] ) - 1;
+
+	dx = xEnd - xStart;
+
+	if ( dx < 0 )
+		return;
+
+	// slopes
+	const f32 invDeltaX = core::reciprocal_approxim ( line.x[1] - line.x[0] );
+
+#ifdef IPOL_Z
+	slopeZ = (line.z[1] - line.z[0]) * invDeltaX;
+#endif
+#ifdef IPOL_W
+	slopeW = (line.w[1] - line.w[0]) * invDeltaX;
+#endif
+
+#ifdef SUBTEXEL
+	subPixel = ( (f32) xStart ) - line.x[0];
+#ifdef IPOL_Z
+	line.z[0] += slopeZ * subPixel;
+#endif
+#ifdef IPOL_W
+	line.w[0] += slopeW * subPixel;
+#endif
+#endif
+
+	stencil = (u8*) Stencil->lock() + ( line.y * Stencil->getPitch() ) + xStart;
+
+#ifdef USE_ZBUFFER
+	z = (fp24*) DepthBuffer->lock() + ( line.y * RenderTarget->getDimension().Width ) + xStart;
+#endif
+
+	// the delta is masked instead of branching on the depth test
+	for ( s32 i = 0; i <= dx; ++i )
+	{
+#ifdef CMP_Z
+		const u8 pass = line.z[0] < z[i];
+#endif
+#ifdef CMP_W
+		const u8 pass = line.w[0] >= z[i];
+#endif
+		stencil[i] += Delta & (u8) -(s32) ( pass ^ ZFail );
+
+#ifdef IPOL_Z
+		line.z[0] += slopeZ;
+#endif
+#ifdef IPOL_W
+		line.w[0] += slopeW;
+#endif
+	}
+
+}
+
+void CTRStencilShadow::drawTriangle ( const s4DVertex *a,const s4DVertex *b,const s4DVertex *c )
+{
+	// sort on height, y
+	if ( a->Pos.y > b->Pos.y ) swapVertexPointer(&a, &b);
+	if ( a->Pos.y > c->Pos.y ) swapVertexPointer(&a, &c);
+	if ( b->Pos.y > c->Pos.y ) swapVertexPointer(&b, &c);
+
+	const f32 ca = c->Pos.y - a->Pos.y;
+	const f32 ba = b->Pos.y - a->Pos.y;
+	const f32 cb = c->Pos.y - b->Pos.y;
+	// calculate delta y of the edges
+	scan.invDeltaY[0] = core::reciprocal( ca );
+	scan.invDeltaY[1] = core::reciprocal( ba );
+	scan.invDeltaY[2] = core::reciprocal( cb );
+
+	if ( F32_LOWER_EQUAL_0 ( scan.invDeltaY[0] ) )
+		return;
+
+	// find if the major edge is left or right aligned
+	f32 temp[4];
+
+	temp[0] = a->Pos.x - c->Pos.x;
+	temp[1] = -ca;
+	temp[2] = b->Pos.x - a->Pos.x;
+	temp[3] = ba;
+
+	scan.left = ( temp[0] * temp[3] - temp[1] * temp[2] ) > 0.f ? 0 : 1;
+	scan.right = 1 - scan.left;
+
+	// calculate slopes for the major edge
+	scan.slopeX[0] = (c->Pos.x - a->Pos.x) * scan.invDeltaY[0];
+	scan.x[0] = a->Pos.x;
+
+#ifdef IPOL_Z
+	scan.slopeZ[0] = (c->Pos.z - a->Pos.z) * scan.invDeltaY[0];
+	scan.z[0] = a->Pos.z;
+#endif
+
+#ifdef IPOL_W
+	scan.slopeW[0] = (c->Pos.w - a->Pos.w) * scan.invDeltaY[0];
+	scan.w[0] = a->Pos.w;
+#endif
+
+	// top left fill convention y run
+	s32 yStart;
+	s32 yEnd;
+
+#ifdef SUBTEXEL
+	f32 subPixel;
+#endif
+
+	// rasterize upper sub-triangle
+	if ( (f32) 0.0 != scan.invDeltaY[1]  )
+	{
+		// calculate slopes for top edge
+		scan.slopeX[1] = (b->Pos.x - a->Pos.x) * scan.invDeltaY[1];
+		scan.x[1] = a->Pos.x;
+
+#ifdef IPOL_Z
+		scan.slopeZ[1] = (b->Pos.z - a->Pos.z) * scan.invDeltaY[1];
+		scan.z[1] = a->Pos.z;
+#endif
+
+#ifdef IPOL_W
+		scan.slopeW[1] = (b->Pos.w - a->Pos.w) * scan.invDeltaY[1];
+		scan.w[1] = a->Pos.w;
+#endif
+
+		// apply top-left fill convention, top part
+		yStart = core::ceil32( a->Pos.y );
+		yEnd = core::ceil32( b->Pos.y ) - 1;
+
+#ifdef SUBTEXEL
+		subPixel = ( (f32) yStart ) - a->Pos.y;
+
+		// correct to pixel center
+		scan.x[0] += scan.slopeX[0] * subPixel;
+		scan.x[1] += scan.slopeX[1] * subPixel;		
+
+#ifdef IPOL_Z
+		scan.z[0] += scan.slopeZ[0] * subPixel;
+		scan.z[1] += scan.slopeZ[1] * subPixel;		
+#endif
+
+#ifdef IPOL_W
+		scan.w[0] += scan.slopeW[0] * subPixel;
+		scan.w[1] += scan.slopeW[1] * subPixel;		
+#endif
+
+#endif
+
+		// rasterize the edge scanlines
+		for( line.y = yStart; line.y <= yEnd; ++line.y)
+		{
+			line.x[scan.left] = scan.x[0];
+			line.x[scan.right] = scan.x[1];
+
+#ifdef IPOL_Z
+			line.z[scan.left] = scan.z[0];
+			line.z[scan.right] = scan.z[1];
+#endif
+
+#ifdef IPOL_W
+			line.w[scan.left] = scan.w[0];
+			line.w[scan.right] = scan.w[1];
+#endif
+
+			// render a scanline
+			scanline ();
+
+			scan.x[0] += scan.slopeX[0];
+			scan.x[1] += scan.slopeX[1];
+
+#ifdef IPOL_Z
+			scan.z[0] += scan.slopeZ[0];
+			scan.z[1] += scan.slopeZ[1];
+#endif
+
+#ifdef IPOL_W
+			scan.w[0] += scan.slopeW[0];
+			scan.w[1] += scan.slopeW[1];
+#endif
+
+		}
+	}
+
+	// rasterize lower sub-triangle
+	if ( (f32) 0.0 != scan.invDeltaY[2] )
+	{
+		// advance to middle point
+		if( (f32) 0.0 != scan.invDeltaY[1] )
+		{
+			temp[0] = b->Pos.y - a->Pos.y;	// dy
+
+			scan.x[0] = a->Pos.x + scan.slopeX[0] * temp[0];
+#ifdef IPOL_Z
+			scan.z[0] = a->Pos.z + scan.slopeZ[0] * temp[0];
+#endif
+#ifdef IPOL_W
+			scan.w[0] = a->Pos.w + scan.slopeW[0] * temp[0];
+#endif
+
+		}
+
+		// calculate slopes for bottom edge
+		scan.slopeX[1] = (c->Pos.x - b->Pos.x) * scan.invDeltaY[2];
+		scan.x[1] = b->Pos.x;
+
+#ifdef IPOL_Z
+		scan.slopeZ[1] = (c->Pos.z - b->Pos.z) * scan.invDeltaY[2];
+		scan.z[1] = b->Pos.z;
+#endif
+
+#ifdef IPOL_W
+		scan.slopeW[1] = (c->Pos.w - b->Pos.w) * scan.invDeltaY[2];
+		scan.w[1] = b->Pos.w;
+#endif
+
+		// apply top-left fill convention, top part
+		yStart = core::ceil32( b->Pos.y );
+		yEnd = core::ceil32( c->Pos.y ) - 1;
+
+#ifdef SUBTEXEL
+
+		subPixel = ( (f32) yStart ) - b->Pos.y;
+
+		// correct to pixel center
+		scan.x[0] += scan.slopeX[0] * subPixel;
+		scan.x[1] += scan.slopeX[1] * subPixel;		
+
+#ifdef IPOL_Z
+		scan.z[0] += scan.slopeZ[0] * subPixel;
+		scan.z[1] += scan.slopeZ[1] * subPixel;		
+#endif
+
+#ifdef IPOL_W
+		scan.w[0] += scan.slopeW[0] * subPixel;
+		scan.w[1] += scan.slopeW[1] * subPixel;		
+#endif
+
+#endif
+
+		// rasterize the edge scanlines
+		for( line.y = yStart; line.y <= yEnd; ++line.y)
+		{
+			line.x[scan.left] = scan.x[0];
+			line.x[scan.right] = scan.x[1];
+
+#ifdef IPOL_Z
+			line.z[scan.left] = scan.z[0];
+			line.z[scan.right] = scan.z[1];
+#endif
+
+#ifdef IPOL_W
+			line.w[scan.left] = scan.w[0];
+			line.w[scan.right] = scan.w[1];
+#endif
+
+			// render a scanline
+			scanline ();
+
+			scan.x[0] += scan.slopeX[0];
+			scan.x[1] += scan.slopeX[1];
+
+#ifdef IPOL_Z
+			scan.z[0] += scan.slopeZ[0];
+			scan.z[1] += scan.slopeZ[1];
+#endif
+
+#ifdef IPOL_W
+			scan.w[0] += scan.slopeW[0];
+			scan.w[1] += scan.slopeW[1];
+#endif
+
+		}
+	}
+
+}
+
+} // end namespace video
+} // end namespace irr
+
+#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
+
+namespace irr
+{
+namespace video
+{
+
+//! creates a renderer which counts shadow volume faces in the stencil buffer
+IBurningShader* createTRStencilShadow(IDepthBuffer* zbuffer, IStencilBuffer* stencil)
+{
+	#ifdef _IRR_COMPILE_WITH_BURNINGSVIDEO_
+	return new CTRStencilShadow(zbuffer, stencil);
+	#else
+	return 0;
+	#endif // _IRR_COMPILE_WITH_BURNINGSVIDEO_
+}
+
+} // end namespace video
+} // end namespace irr
+
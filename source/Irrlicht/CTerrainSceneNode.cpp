@@ -22,12 +22,213 @@
 #include "IAnimatedMesh.h"
 #include "SMesh.h"
 #include "CDynamicMeshBuffer.h"
+#include "CThreadPool.h"
+#include "irrMap.h"
 
 namespace irr
 {
 namespace scene
 {
 
+	//! Header of the tiled heightfield files read by loadHeightMapTiled
+	struct STiledHeightfieldHeader
+	{
+		c8 Magic[4];
+		u32 Version;
+		u32 TileSize;
+		u32 TilesX;
+		u32 TilesZ;
+		u32 BitsPerSample;
+	};
+
+
+	//! A square block of heights, loaded by the background thread
+	struct CTerrainSceneNode::STerrainTile : public IThreadJob
+	{
+		enum E_TILE_STATE
+		{
+			ETS_PENDING = 0,
+			ETS_LOADED,
+			ETS_FAILED
+		};
+
+		STerrainTile(SPagedTerrain* paging, s32 x, s32 z)
+			: Paging(paging), X(x), Z(z), LastUsed(0), Heights(0), State(ETS_PENDING)
+		{
+		}
+
+		~STerrainTile()
+		{
+			delete [] Heights;
+		}
+
+		//! reads and decodes the tile, called from the loader thread
+		virtual void run();
+
+		SPagedTerrain* Paging;
+		s32 X;
+		s32 Z;
+		u32 LastUsed;
+		//! (TileSize+1)^2 heights, x major
+		f32* Heights;
+		//! guarded by SPagedTerrain::Mutex
+		E_TILE_STATE State;
+	};
+
+
+	//! Everything needed for the paged mode of the terrain
+	struct CTerrainSceneNode::SPagedTerrain
+	{
+		SPagedTerrain(io::IReadFile* file)
+			: File(file), Loader(0), TileSize(0), TilesX(0), TilesZ(0),
+			BitsPerSample(0), DataStart(0), PageRadius(0), WindowTiles(0),
+			OriginX(-1), OriginZ(-1), MaxResidentTiles(0), Frame(0)
+		{
+			File->grab();
+			Loader = new CThreadPool(1);
+		}
+
+		~SPagedTerrain()
+		{
+			// the loader thread must not touch any tile after this
+			Loader->drop();
+
+			core::map<u32, STerrainTile*>::Iterator it = Tiles.getIterator();
+			for (; !it.atEnd(); it++)
+				delete it->getValue();
+
+			File->drop();
+		}
+
+		u32 getKey(s32 x, s32 z) const
+		{
+			return (u32)(x * TilesZ + z);
+		}
+
+		//! returns the tile if it is loaded
+		STerrainTile* getLoadedTile(s32 x, s32 z)
+		{
+			core::map<u32, STerrainTile*>::Node* node = Tiles.find(getKey(x, z));
+			if (!node)
+				return 0;
+
+			CMutexLock lock(Mutex);
+			return node->getValue()->State != STerrainTile::ETS_PENDING ? node->getValue() : 0;
+		}
+
+		//! returns the unscaled height at a position given in samples, if its tile is loaded
+		bool getHeight(f32 x, f32 z, f32& height)
+		{
+			s32 X = core::floor32(x);
+			s32 Z = core::floor32(z);
+			if (X < 0 || Z < 0 || X >= TilesX * TileSize || Z >= TilesZ * TileSize)
+				return false;
+
+			STerrainTile* tile = getLoadedTile(X / TileSize, Z / TileSize);
+			if (!tile)
+				return false;
+
+			const f32 dx = x - X;
+			const f32 dz = z - Z;
+			X -= tile->X * TileSize;
+			Z -= tile->Z * TileSize;
+
+			const s32 pitch = TileSize + 1;
+			const f32 a = tile->Heights[X * pitch + Z];
+			const f32 b = tile->Heights[(X + 1) * pitch + Z];
+			const f32 c = tile->Heights[X * pitch + Z + 1];
+			const f32 d = tile->Heights[(X + 1) * pitch + Z + 1];
+
+			if (dx > dz)
+				height = a + (d - b)*dz + (b - a)*dx;
+			else
+				height = a + (d - c)*dx + (c - a)*dz;
+
+			return true;
+		}
+
+		io::IReadFile* File;
+		CThreadPool* Loader;
+		//! guards the file and the tile states
+		CMutex Mutex;
+
+		s32 TileSize;
+		s32 TilesX;
+		s32 TilesZ;
+		s32 BitsPerSample;
+		long DataStart;
+
+		s32 PageRadius;
+		s32 WindowTiles;
+		//! first tile of the window in the render buffer
+		s32 OriginX;
+		s32 OriginZ;
+
+		u32 MaxResidentTiles;
+		u32 Frame;
+		video::SColor VertexColor;
+
+		//! all loaded and pending tiles
+		core::map<u32, STerrainTile*> Tiles;
+	};
+
+
+	void CTerrainSceneNode::STerrainTile::run()
+	{
+		const s32 samples = (Paging->TileSize + 1) * (Paging->TileSize + 1);
+		const s32 bytesPerSample = Paging->BitsPerSample / 8;
+		const s32 bytes = samples * bytesPerSample;
+
+		u8* raw = new u8[bytes];
+
+		Paging->Mutex.lock();
+		const long offset = Paging->DataStart + (long)Paging->getKey(X, Z) * bytes;
+		const bool success = Paging->File->seek(offset) && (Paging->File->read(raw, bytes) == bytes);
+		Paging->Mutex.unlock();
+
+		Heights = new f32[samples];
+		if (!success)
+		{
+			memset(Heights, 0, samples * sizeof(f32));
+		}
+		else
+		{
+			switch (bytesPerSample)
+			{
+			case 1:
+				for (s32 i=0; i<samples; ++i)
+					Heights[i] = raw[i];
+				break;
+			case 2:
+				for (s32 i=0; i<samples; ++i)
+				{
+					u16 val = ((u16*)raw)[i];
+#ifdef __BIG_ENDIAN__
+					val = os::Byteswap::byteswap(val);
+#endif
+					Heights[i] = val / 256.f;
+				}
+				break;
+			case 4:
+				for (s32 i=0; i<samples; ++i)
+				{
+					f32 val = ((f32*)raw)[i];
+#ifdef __BIG_ENDIAN__
+					val = os::Byteswap::byteswap(val);
+#endif
+					Heights[i] = val;
+				}
+				break;
+			}
+		}
+
+		delete [] raw;
+
+		CMutexLock lock(Paging->Mutex);
+		State = success ? ETS_LOADED : ETS_FAILED;
+	}
+
+
 	//! constructor
 	CTerrainSceneNode::CTerrainSceneNode(ISceneNode* parent, ISceneManager* mgr,
 			io::IFileSystem* fs, s32 id, s32 maxLOD, E_TERRAIN_PATCH_SIZE patchSize,
@@ -35,9 +236,11 @@ namespace scene
 			const core::vector3df& rotation,
 			const core::vector3df& scale)
 	: ITerrainSceneNode(parent, mgr, id, position, rotation, scale),
-	TerrainData(patchSize, maxLOD, position, rotation, scale), RenderBuffer(0),
+	TerrainData(patchSize, maxLOD, position, rotation, scale), Paging(0),
+	GeometryRevision(0), RenderBuffer(0),
 	VerticesToRender(0), IndicesToRender(0), DynamicSelectorUpdate(false),
 	OverrideDistanceThreshold(false), UseDefaultRotationPivot(true), ForceRecalculation(false),
+	UpdateIndices(true),
 	OldCameraPosition(core::vector3df(-99999.9f, -99999.9f, -99999.9f)),
 	OldCameraRotation(core::vector3df(-99999.9f, -99999.9f, -99999.9f)),
 	OldCameraUp(core::vector3df(-99999.9f, -99999.9f, -99999.9f)),
@@ -63,6 +266,9 @@ namespace scene
 	//! destructor
 	CTerrainSceneNode::~CTerrainSceneNode()
 	{
+		dropPaging();
+		clearIndexBlocks();
+
 		delete [] TerrainData.Patches;
 
 		if (FileSystem)
@@ -83,6 +289,7 @@ namespace scene
 		if (!file)
 			return false;
 
+		dropPaging();
 		Mesh->MeshBuffers.clear();
 		const u32 startTime = os::Timer::getRealTime();
 		video::IImage* heightMap = SceneManager->getVideoDriver()->createImageFromFile(file);
@@ -98,39 +305,7 @@ namespace scene
 		// Get the dimension of the heightmap data
 		TerrainData.Size = heightMap->getDimension().Width;
 
-		switch (TerrainData.PatchSize)
-		{
-			case ETPS_9:
-				if (TerrainData.MaxLOD > 3)
-				{
-					TerrainData.MaxLOD = 3;
-				}
-			break;
-			case ETPS_17:
-				if (TerrainData.MaxLOD > 4)
-				{
-					TerrainData.MaxLOD = 4;
-				}
-			break;
-			case ETPS_33:
-				if (TerrainData.MaxLOD > 5)
-				{
-					TerrainData.MaxLOD = 5;
-				}
-			break;
-			case ETPS_65:
-				if (TerrainData.MaxLOD > 6)
-				{
-					TerrainData.MaxLOD = 6;
-				}
-			break;
-			case ETPS_129:
-				if (TerrainData.MaxLOD > 7)
-				{
-					TerrainData.MaxLOD = 7;
-				}
-			break;
-		}
+		clampMaxLOD();
 
 		// --- Generate vertex data from heightmap ----
 		// resize the vertex array for the mesh buffer one time (makes loading faster)
@@ -225,6 +400,7 @@ namespace scene
 				TerrainData.CalcPatchSize * TerrainData.CalcPatchSize * 6);
 
 		RenderBuffer->setDirty();
+		++GeometryRevision;
 
 		const u32 endTime = os::Timer::getRealTime();
 
@@ -250,6 +426,7 @@ namespace scene
 		// start reading
 		const u32 startTime = os::Timer::getTime();
 
+		dropPaging();
 		Mesh->MeshBuffers.clear();
 
 		const s32 bytesPerPixel = bitsPerPixel / 8;
@@ -268,39 +445,7 @@ namespace scene
 			TerrainData.Size = width;
 		}
 
-		switch (TerrainData.PatchSize)
-		{
-			case ETPS_9:
-				if (TerrainData.MaxLOD > 3)
-				{
-					TerrainData.MaxLOD = 3;
-				}
-			break;
-			case ETPS_17:
-				if (TerrainData.MaxLOD > 4)
-				{
-					TerrainData.MaxLOD = 4;
-				}
-			break;
-			case ETPS_33:
-				if (TerrainData.MaxLOD > 5)
-				{
-					TerrainData.MaxLOD = 5;
-				}
-			break;
-			case ETPS_65:
-				if (TerrainData.MaxLOD > 6)
-				{
-					TerrainData.MaxLOD = 6;
-				}
-			break;
-			case ETPS_129:
-				if (TerrainData.MaxLOD > 7)
-				{
-					TerrainData.MaxLOD = 7;
-				}
-			break;
-		}
+		clampMaxLOD();
 
 		// --- Generate vertex data from heightmap ----
 		// resize the vertex array for the mesh buffer one time (makes loading faster)
@@ -461,6 +606,7 @@ namespace scene
 		RenderBuffer->getIndexBuffer().set_used(
 				TerrainData.PatchCount*TerrainData.PatchCount*
 				TerrainData.CalcPatchSize*TerrainData.CalcPatchSize*6);
+		++GeometryRevision;
 
 		const u32 endTime = os::Timer::getTime();
 
@@ -473,6 +619,358 @@ namespace scene
 	}
 
 
+	//! Initializes the terrain in paged mode from a tiled heightfield file
+	bool CTerrainSceneNode::loadHeightMapTiled(io::IReadFile* file, s32 pageRadius,
+			u32 maxResidentTiles, video::SColor vertexColor)
+	{
+		if (!file)
+			return false;
+
+		const u32 startTime = os::Timer::getRealTime();
+
+		STiledHeightfieldHeader header;
+		if (file->read(&header, sizeof(header)) != sizeof(header) ||
+			header.Magic[0] != 'I' || header.Magic[1] != 'T' ||
+			header.Magic[2] != 'H' || header.Magic[3] != 'F')
+		{
+			os::Printer::log("Not a tiled heightfield file", file->getFileName(), ELL_ERROR);
+			return false;
+		}
+
+#ifdef __BIG_ENDIAN__
+		header.Version = os::Byteswap::byteswap(header.Version);
+		header.TileSize = os::Byteswap::byteswap(header.TileSize);
+		header.TilesX = os::Byteswap::byteswap(header.TilesX);
+		header.TilesZ = os::Byteswap::byteswap(header.TilesZ);
+		header.BitsPerSample = os::Byteswap::byteswap(header.BitsPerSample);
+#endif
+
+		if (header.Version != 1 || !header.TilesX || !header.TilesZ ||
+			(header.BitsPerSample != 8 && header.BitsPerSample != 16 && header.BitsPerSample != 32))
+		{
+			os::Printer::log("Unsupported tiled heightfield file", file->getFileName(), ELL_ERROR);
+			return false;
+		}
+
+		if (!header.TileSize || (header.TileSize % TerrainData.CalcPatchSize) != 0)
+		{
+			os::Printer::log("Tile size of heightfield is no multiple of the patch size", file->getFileName(), ELL_ERROR);
+			return false;
+		}
+
+		// the sizes come from the file, so every product computed from them
+		// later has to fit into a s32, and all tiles have to be in the file
+		const u32 maxValue = 0x7FFFFFFF;
+		const u32 pitch = header.TileSize + 1;
+		bool valid = header.TileSize < maxValue &&
+			header.TilesX <= maxValue / header.TileSize &&
+			header.TilesZ <= maxValue / header.TileSize &&
+			header.TilesX <= maxValue / header.TilesZ &&
+			pitch <= maxValue / pitch &&
+			pitch * pitch <= maxValue / (header.BitsPerSample / 8);
+
+		if (valid)
+		{
+			const u32 tileBytes = pitch * pitch * (header.BitsPerSample / 8);
+			const long available = file->getSize() - file->getPos();
+			valid = available > 0 && header.TilesX * header.TilesZ <= (u32)available / tileBytes;
+		}
+
+		// the vertices of the window are counted in a u32
+		const s32 windowTiles = core::min_(2 * core::clamp(pageRadius, 0, 0x7FFF) + 1,
+			(s32)core::min_(header.TilesX, header.TilesZ));
+		if (valid)
+			valid = (u32)windowTiles <= 0xFFFE / header.TileSize;
+
+		if (!valid)
+		{
+			os::Printer::log("Tiled heightfield file is truncated or too large", file->getFileName(), ELL_ERROR);
+			return false;
+		}
+
+		dropPaging();
+
+		Paging = new SPagedTerrain(file);
+		Paging->TileSize = header.TileSize;
+		Paging->TilesX = header.TilesX;
+		Paging->TilesZ = header.TilesZ;
+		Paging->BitsPerSample = header.BitsPerSample;
+		Paging->DataStart = file->getPos();
+		Paging->PageRadius = core::clamp(pageRadius, 0, 0x7FFF);
+		Paging->WindowTiles = windowTiles;
+		Paging->VertexColor = vertexColor;
+
+		const u32 borderTiles = (Paging->WindowTiles + 2) * (Paging->WindowTiles + 2);
+		Paging->MaxResidentTiles = maxResidentTiles ? core::max_(maxResidentTiles, borderTiles) : 2 * borderTiles;
+
+		HeightmapFile = file->getFileName();
+		clampMaxLOD();
+
+		TerrainData.Size = Paging->WindowTiles * Paging->TileSize + 1;
+
+		// the pivot stays in the center of the world instead of the window
+		if (UseDefaultRotationPivot)
+			TerrainData.RotationPivot = core::vector3df(
+				Paging->TilesX * Paging->TileSize * 0.5f, 0.f,
+				Paging->TilesZ * Paging->TileSize * 0.5f) * TerrainData.Scale + TerrainData.Position;
+
+		Mesh->MeshBuffers.clear();
+		scene::CDynamicMeshBuffer *mb=0;
+		if (TerrainData.Size * TerrainData.Size <= 65536)
+		{
+			//small enough for 16bit buffers
+			mb=new scene::CDynamicMeshBuffer(video::EVT_2TCOORDS, video::EIT_16BIT);
+			RenderBuffer->getIndexBuffer().setType(video::EIT_16BIT);
+		}
+		else
+		{
+			//we need 32bit buffers
+			mb=new scene::CDynamicMeshBuffer(video::EVT_2TCOORDS, video::EIT_32BIT);
+			RenderBuffer->getIndexBuffer().setType(video::EIT_32BIT);
+		}
+		Mesh->addMeshBuffer(mb);
+		mb->drop();
+
+		createPatches();
+
+		// load the first window right away, so the terrain can be used at once
+		const s32 originX = core::clamp(Paging->TilesX / 2 - Paging->PageRadius, 0, Paging->TilesX - Paging->WindowTiles);
+		const s32 originZ = core::clamp(Paging->TilesZ / 2 - Paging->PageRadius, 0, Paging->TilesZ - Paging->WindowTiles);
+		for (s32 x = originX; x < originX + Paging->WindowTiles; ++x)
+		{
+			for (s32 z = originZ; z < originZ + Paging->WindowTiles; ++z)
+			{
+				STerrainTile* tile = new STerrainTile(Paging, x, z);
+				Paging->Tiles.insert(Paging->getKey(x, z), tile);
+				tile->run();
+			}
+		}
+
+		buildPagedWindow(originX, originZ);
+
+		const u32 endTime = os::Timer::getRealTime();
+
+		c8 tmp[255];
+		snprintf(tmp, 255, "Generated paged terrain data (%dx%d tiles of %d) in %.4f seconds",
+			Paging->TilesX, Paging->TilesZ, Paging->TileSize, (endTime - startTime) / 1000.0f);
+		os::Printer::log(tmp);
+
+		return true;
+	}
+
+
+	//! clamps MaxLOD to what the patch size allows
+	void CTerrainSceneNode::clampMaxLOD()
+	{
+		switch (TerrainData.PatchSize)
+		{
+			case ETPS_9:
+				if (TerrainData.MaxLOD > 3)
+				{
+					TerrainData.MaxLOD = 3;
+				}
+			break;
+			case ETPS_17:
+				if (TerrainData.MaxLOD > 4)
+				{
+					TerrainData.MaxLOD = 4;
+				}
+			break;
+			case ETPS_33:
+				if (TerrainData.MaxLOD > 5)
+				{
+					TerrainData.MaxLOD = 5;
+				}
+			break;
+			case ETPS_65:
+				if (TerrainData.MaxLOD > 6)
+				{
+					TerrainData.MaxLOD = 6;
+				}
+			break;
+			case ETPS_129:
+				if (TerrainData.MaxLOD > 7)
+				{
+					TerrainData.MaxLOD = 7;
+				}
+			break;
+		}
+	}
+
+
+	//! requests and releases tiles around the camera, moves the window when possible
+	void CTerrainSceneNode::updatePaging()
+	{
+		SPagedTerrain& p = *Paging;
+		++p.Frame;
+
+		// camera position in heightmap samples, undoing applyTransformation
+		core::vector3df pos = SceneManager->getActiveCamera()->getAbsolutePosition();
+		core::matrix4 rotMatrix;
+		rotMatrix.setRotationDegrees(TerrainData.Rotation);
+		pos -= TerrainData.RotationPivot;
+		rotMatrix.rotateVect(pos);
+		pos += TerrainData.RotationPivot;
+		pos -= TerrainData.Position;
+		pos /= TerrainData.Scale;
+
+		const f32 tileX = pos.X / p.TileSize;
+		const f32 tileZ = pos.Z / p.TileSize;
+
+		// keep the current center while the camera is less than a quarter tile out of it
+		s32 centerX = core::floor32(tileX);
+		s32 centerZ = core::floor32(tileZ);
+		if (p.OriginX >= 0)
+		{
+			const s32 oldCenterX = p.OriginX + p.PageRadius;
+			const s32 oldCenterZ = p.OriginZ + p.PageRadius;
+			if (tileX > oldCenterX - 0.25f && tileX < oldCenterX + 1.25f)
+				centerX = oldCenterX;
+			if (tileZ > oldCenterZ - 0.25f && tileZ < oldCenterZ + 1.25f)
+				centerZ = oldCenterZ;
+		}
+
+		const s32 originX = core::clamp(centerX - p.PageRadius, 0, p.TilesX - p.WindowTiles);
+		const s32 originZ = core::clamp(centerZ - p.PageRadius, 0, p.TilesZ - p.WindowTiles);
+
+		// request the window and a border of one tile around it
+		bool windowReady = true;
+		const s32 minX = core::max_(originX - 1, 0);
+		const s32 maxX = core::min_(originX + p.WindowTiles + 1, p.TilesX);
+		const s32 minZ = core::max_(originZ - 1, 0);
+		const s32 maxZ = core::min_(originZ + p.WindowTiles + 1, p.TilesZ);
+		for (s32 x = minX; x < maxX; ++x)
+		{
+			for (s32 z = minZ; z < maxZ; ++z)
+			{
+				STerrainTile* tile;
+				core::map<u32, STerrainTile*>::Node* node = p.Tiles.find(p.getKey(x, z));
+				if (node)
+				{
+					tile = node->getValue();
+				}
+				else
+				{
+					tile = new STerrainTile(Paging, x, z);
+					p.Tiles.insert(p.getKey(x, z), tile);
+					p.Loader->addJob(tile);
+				}
+				tile->LastUsed = p.Frame;
+
+				if (windowReady &&
+					x >= originX && x < originX + p.WindowTiles &&
+					z >= originZ && z < originZ + p.WindowTiles &&
+					!p.getLoadedTile(x, z))
+				{
+					windowReady = false;
+				}
+			}
+		}
+
+		if (windowReady && (originX != p.OriginX || originZ != p.OriginZ))
+			buildPagedWindow(originX, originZ);
+
+		// release the least recently used tiles which are not needed anymore
+		while (p.Tiles.size() > p.MaxResidentTiles)
+		{
+			STerrainTile* oldest = 0;
+			core::map<u32, STerrainTile*>::Iterator it = p.Tiles.getIterator();
+			for (; !it.atEnd(); it++)
+			{
+				STerrainTile* tile = it->getValue();
+				if (tile->LastUsed != p.Frame &&
+					(!oldest || tile->LastUsed < oldest->LastUsed) &&
+					p.getLoadedTile(tile->X, tile->Z))
+				{
+					oldest = tile;
+				}
+			}
+
+			if (!oldest)
+				break;
+
+			p.Tiles.remove(p.getKey(oldest->X, oldest->Z));
+			delete oldest;
+		}
+	}
+
+
+	//! fills the render buffer with the window of tiles starting at the given tile
+	void CTerrainSceneNode::buildPagedWindow(s32 originX, s32 originZ)
+	{
+		SPagedTerrain& p = *Paging;
+		p.OriginX = originX;
+		p.OriginZ = originZ;
+
+		core::array<STerrainTile*> tiles;
+		tiles.reallocate(p.WindowTiles * p.WindowTiles);
+		for (s32 x = 0; x < p.WindowTiles; ++x)
+			for (s32 z = 0; z < p.WindowTiles; ++z)
+				tiles.push_back(p.getLoadedTile(originX + x, originZ + z));
+
+		IDynamicMeshBuffer* mb = static_cast<IDynamicMeshBuffer*>(Mesh->getMeshBuffer(0));
+		const u32 numVertices = TerrainData.Size * TerrainData.Size;
+		mb->getVertexBuffer().set_used(numVertices);
+		video::S3DVertex2TCoords* vertices = static_cast<video::S3DVertex2TCoords*>(mb->getVertexBuffer().pointer());
+
+		// texture coordinates span the whole world
+		const f32 tdSizeX = 1.0f / (f32)(p.TilesX * p.TileSize);
+		const f32 tdSizeZ = 1.0f / (f32)(p.TilesZ * p.TileSize);
+		const s32 pitch = p.TileSize + 1;
+
+		s32 index = 0;
+		for (s32 x = 0; x < TerrainData.Size; ++x)
+		{
+			const s32 tx = core::min_(x / p.TileSize, p.WindowTiles - 1);
+			const s32 lx = x - tx * p.TileSize;
+			const f32 fx = (f32)(originX * p.TileSize + x);
+
+			for (s32 z = 0; z < TerrainData.Size; ++z)
+			{
+				const s32 tz = core::min_(z / p.TileSize, p.WindowTiles - 1);
+				const s32 lz = z - tz * p.TileSize;
+				const f32 fz = (f32)(originZ * p.TileSize + z);
+
+				video::S3DVertex2TCoords& vertex = vertices[index++];
+				vertex.Normal.set(0.0f, 1.0f, 0.0f);
+				vertex.Color = p.VertexColor;
+				vertex.Pos.X = fx;
+				vertex.Pos.Y = tiles[tx * p.WindowTiles + tz]->Heights[lx * pitch + lz];
+				vertex.Pos.Z = fz;
+
+				vertex.TCoords.X = vertex.TCoords2.X = 1.f - fx * tdSizeX;
+				vertex.TCoords.Y = vertex.TCoords2.Y = fz * tdSizeZ;
+			}
+		}
+
+		calculateNormals(mb);
+
+		RenderBuffer->getVertexBuffer().set_used(numVertices);
+		for (u32 i = 0; i < numVertices; ++i)
+			RenderBuffer->getVertexBuffer()[i] = mb->getVertexBuffer()[i];
+
+		// positions, rotation, patch data and distance thresholds
+		applyTransformation();
+		scaleTexture(TCoordScale1, TCoordScale2);
+
+		RenderBuffer->getIndexBuffer().set_used(
+				TerrainData.PatchCount * TerrainData.PatchCount *
+				TerrainData.CalcPatchSize * TerrainData.CalcPatchSize * 6);
+
+		RenderBuffer->setDirty();
+		ForceRecalculation = true;
+		++GeometryRevision;
+	}
+
+
+	//! releases all data of the paged mode
+	void CTerrainSceneNode::dropPaging()
+	{
+		delete Paging;
+		Paging = 0;
+	}
+
+
 	//! Returns the mesh
 	IMesh* CTerrainSceneNode::getMesh() { return Mesh; }
 
@@ -557,6 +1055,7 @@ namespace scene
 		calculatePatchData();
 
 		RenderBuffer->setDirty(EBT_VERTEX);
+		++GeometryRevision;
 	}
 
 
@@ -570,8 +1069,12 @@ namespace scene
 		if (!IsVisible || !SceneManager->getActiveCamera())
 			return;
 
+		if (Paging)
+			updatePaging();
+
 		preRenderLODCalculations();
-		preRenderIndicesCalculations();
+		if (UpdateIndices)
+			preRenderIndicesCalculations();
 		ISceneNode::OnRegisterSceneNode();
 		ForceRecalculation = false;
 	}
@@ -617,6 +1120,10 @@ namespace scene
 		OldCameraUp = cameraUp;
 		OldCameraFOV = CameraFOV;
 
+		// patch data might have been reset
+		if (ForceRecalculation)
+			UpdateIndices = true;
+
 		const SViewFrustum* frustum = SceneManager->getActiveCamera()->getViewFrustum();
 
 		// Determine each patches LOD based on distance from camera (and whether or not they are in
@@ -624,30 +1131,31 @@ namespace scene
 		const s32 count = TerrainData.PatchCount * TerrainData.PatchCount;
 		for (s32 j = 0; j < count; ++j)
 		{
-			if (frustum->getBoundingBox().intersectsWithBox(TerrainData.Patches[j].BoundingBox))
+			s32 lod = -1;
+
+			if (frustum->intersectsBox(TerrainData.Patches[j].BoundingBox))
 			{
 				const f32 distance = (cameraPosition.X - TerrainData.Patches[j].Center.X) * (cameraPosition.X - TerrainData.Patches[j].Center.X) +
 					(cameraPosition.Y - TerrainData.Patches[j].Center.Y) * (cameraPosition.Y - TerrainData.Patches[j].Center.Y) +
 					(cameraPosition.Z - TerrainData.Patches[j].Center.Z) * (cameraPosition.Z - TerrainData.Patches[j].Center.Z);
 
-				for (s32 i = TerrainData.MaxLOD - 1; i >= 0; --i)
+				// If we've turned off a patch from viewing, because of the frustum, and now we turn around and it's
+				// too close, we need to turn it back on, at the highest LOD.
+				lod = 0;
+				for (s32 i = TerrainData.MaxLOD - 1; i > 0; --i)
 				{
 					if (distance >= TerrainData.LODDistanceThreshold[i])
 					{
-						TerrainData.Patches[j].CurrentLOD = i;
+						lod = i;
 						break;
 					}
-					//else if (i == 0)
-					{
-						// If we've turned off a patch from viewing, because of the frustum, and now we turn around and it's
-						// too close, we need to turn it back on, at the highest LOD. The if above doesn't catch this.
-						TerrainData.Patches[j].CurrentLOD = 0;
-					}
 				}
 			}
-			else
+
+			if (TerrainData.Patches[j].CurrentLOD != lod)
 			{
-				TerrainData.Patches[j].CurrentLOD = -1;
+				TerrainData.Patches[j].CurrentLOD = lod;
+				UpdateIndices = true;
 			}
 		}
 	}
@@ -656,49 +1164,44 @@ namespace scene
 	void CTerrainSceneNode::preRenderIndicesCalculations()
 	{
 		scene::IIndexBuffer& indexBuffer = RenderBuffer->getIndexBuffer();
+		UpdateIndices = false;
+
+		// count the indices of all visible patches first, so we can write them directly
+		const s32 count = TerrainData.PatchCount * TerrainData.PatchCount;
 		IndicesToRender = 0;
-		indexBuffer.set_used(0);
+		for (s32 index = 0; index < count; ++index)
+		{
+			if (TerrainData.Patches[index].CurrentLOD >= 0)
+				IndicesToRender += getIndexBlockForPatch(index, TerrainData.Patches[index].CurrentLOD).size();
+		}
 
+		indexBuffer.set_used(IndicesToRender);
+
+		// Then copy the cached indices of all visible patches, offset to their first vertex.
+		u32 written = 0;
 		s32 index = 0;
-		// Then generate the indices for all patches that are visible.
 		for (s32 i = 0; i < TerrainData.PatchCount; ++i)
 		{
 			for (s32 j = 0; j < TerrainData.PatchCount; ++j)
 			{
 				if (TerrainData.Patches[index].CurrentLOD >= 0)
 				{
-					s32 x = 0;
-					s32 z = 0;
-
-					// calculate the step we take this patch, based on the patches current LOD
-					const s32 step = 1 << TerrainData.Patches[index].CurrentLOD;
+					const core::array<u32>& block = getIndexBlockForPatch(index, TerrainData.Patches[index].CurrentLOD);
+					const u32 base = TerrainData.CalcPatchSize * (i * TerrainData.Size + j);
 
-					// Loop through patch and generate indices
-					while (z < TerrainData.CalcPatchSize)
+					if (indexBuffer.getType() == video::EIT_16BIT)
 					{
-						const s32 index11 = getIndex(j, i, index, x, z);
-						const s32 index21 = getIndex(j, i, index, x + step, z);
-						const s32 index12 = getIndex(j, i, index, x, z + step);
-						const s32 index22 = getIndex(j, i, index, x + step, z + step);
-
-						indexBuffer.push_back(index12);
-						indexBuffer.push_back(index11);
-						indexBuffer.push_back(index22);
-						indexBuffer.push_back(index22);
-						indexBuffer.push_back(index11);
-						indexBuffer.push_back(index21);
-						IndicesToRender+=6;
-
-						// increment index position horizontally
-						x += step;
-
-						// we've hit an edge
-						if (x >= TerrainData.CalcPatchSize)
-						{
-							x = 0;
-							z += step;
-						}
+						u16* dst = (u16*)indexBuffer.pointer() + written;
+						for (u32 k = 0; k < block.size(); ++k)
+							dst[k] = (u16)(base + block[k]);
 					}
+					else
+					{
+						u32* dst = (u32*)indexBuffer.pointer() + written;
+						for (u32 k = 0; k < block.size(); ++k)
+							dst[k] = base + block[k];
+					}
+					written += block.size();
 				}
 				++index;
 			}
@@ -846,43 +1349,18 @@ namespace scene
 
 		mb.getIndexBuffer().setType(RenderBuffer->getIndexBuffer().getType());
 
-		// calculate the step we take for all patches, since LOD is the same
-		const s32 step = 1 << LOD;
+		// all patches share the LOD, so no stitching is needed
+		const core::array<u32>& block = getIndexBlock(LOD, LOD, LOD, LOD, LOD);
+		mb.getIndexBuffer().reallocate(TerrainData.PatchCount * TerrainData.PatchCount * block.size());
 
 		// Generate the indices for all patches at the specified LOD
-		s32 index = 0;
 		for (s32 i=0; i<TerrainData.PatchCount; ++i)
 		{
 			for (s32 j=0; j<TerrainData.PatchCount; ++j)
 			{
-				s32 x = 0;
-				s32 z = 0;
-
-				// Loop through patch and generate indices
-				while (z < TerrainData.CalcPatchSize)
-				{
-					const s32 index11 = getIndex(j, i, index, x, z);
-					const s32 index21 = getIndex(j, i, index, x + step, z);
-					const s32 index12 = getIndex(j, i, index, x, z + step);
-					const s32 index22 = getIndex(j, i, index, x + step, z + step);
-
-					mb.getIndexBuffer().push_back(index12);
-					mb.getIndexBuffer().push_back(index11);
-					mb.getIndexBuffer().push_back(index22);
-					mb.getIndexBuffer().push_back(index22);
-					mb.getIndexBuffer().push_back(index11);
-					mb.getIndexBuffer().push_back(index21);
-
-					// increment index position horizontally
-					x += step;
-
-					if (x >= TerrainData.CalcPatchSize) // we've hit an edge
-					{
-						x = 0;
-						z += step;
-					}
-				}
-				++index;
+				const u32 base = TerrainData.CalcPatchSize * (i * TerrainData.Size + j);
+				for (u32 k=0; k<block.size(); ++k)
+					mb.getIndexBuffer().push_back(base + block[k]);
 			}
 		}
 	}
@@ -905,65 +1383,28 @@ namespace scene
 		if (LOD < -1 || LOD > TerrainData.MaxLOD - 1)
 			return -1;
 
-		core::array<s32> cLODs;
-		bool setLODs = false;
+		const s32 index = patchX * TerrainData.PatchCount + patchZ;
 
-		// If LOD of -1 was passed in, use the CurrentLOD of the patch specified
+		// If LOD of -1 was passed in, use the CurrentLOD of the patch specified,
+		// stitched to its neighbours. A given LOD is applied to all patches.
+		const core::array<u32>* block;
 		if (LOD == -1)
 		{
-			LOD = TerrainData.Patches[patchX * TerrainData.PatchCount + patchZ].CurrentLOD;
+			LOD = TerrainData.Patches[index].CurrentLOD;
+			if (LOD < 0)
+				return -2; // Patch not visible, don't generate indices.
+			block = &getIndexBlockForPatch(index, LOD);
 		}
 		else
-		{
-			getCurrentLODOfPatches(cLODs);
-			setCurrentLODOfPatches(LOD);
-			setLODs = true;
-		}
-
-		if (LOD < 0)
-			return -2; // Patch not visible, don't generate indices.
-
-		// calculate the step we take for this LOD
-		const s32 step = 1 << LOD;
+			block = &getIndexBlock(LOD, LOD, LOD, LOD, LOD);
 
 		// Generate the indices for the specified patch at the specified LOD
-		const s32 index = patchX * TerrainData.PatchCount + patchZ;
-
-		s32 x = 0;
-		s32 z = 0;
-
-		indices.set_used(TerrainData.PatchSize * TerrainData.PatchSize * 6);
-
-		// Loop through patch and generate indices
-		s32 rv=0;
-		while (z<TerrainData.CalcPatchSize)
-		{
-			const s32 index11 = getIndex(patchZ, patchX, index, x, z);
-			const s32 index21 = getIndex(patchZ, patchX, index, x + step, z);
-			const s32 index12 = getIndex(patchZ, patchX, index, x, z + step);
-			const s32 index22 = getIndex(patchZ, patchX, index, x + step, z + step);
-
-			indices[rv++] = index12;
-			indices[rv++] = index11;
-			indices[rv++] = index22;
-			indices[rv++] = index22;
-			indices[rv++] = index11;
-			indices[rv++] = index21;
-
-			// increment index position horizontally
-			x += step;
-
-			if (x >= TerrainData.CalcPatchSize) // we've hit an edge
-			{
-				x = 0;
-				z += step;
-			}
-		}
-
-		if (setLODs)
-			setCurrentLODOfPatches(cLODs);
+		const u32 base = TerrainData.CalcPatchSize * (patchX * TerrainData.Size + patchZ);
+		indices.set_used(block->size());
+		for (u32 k=0; k<block->size(); ++k)
+			indices[k] = base + (*block)[k];
 
-		return rv;
+		return block->size();
 	}
 
 
@@ -989,7 +1430,14 @@ namespace scene
 	//! \param LOD: The level of detail to set the patch to.
 	void CTerrainSceneNode::setLODOfPatch(s32 patchX, s32 patchZ, s32 LOD)
 	{
+		// the LOD selects the index block, so it has to be a valid one
+		if (patchX < 0 || patchX >= TerrainData.PatchCount ||
+			patchZ < 0 || patchZ >= TerrainData.PatchCount ||
+			LOD < 0 || LOD >= TerrainData.MaxLOD)
+			return;
+
 		TerrainData.Patches[patchX * TerrainData.PatchCount + patchZ].CurrentLOD = LOD;
+		UpdateIndices = true;
 	}
 
 
@@ -1016,15 +1464,30 @@ namespace scene
 		TCoordScale1 = resolution;
 		TCoordScale2 = resolution2;
 
-		const f32 resBySize = resolution / (f32)(TerrainData.Size-1);
-		const f32 res2BySize = resolution2 / (f32)(TerrainData.Size-1);
+		// in paged mode the mapping spans the whole world, not only the window
+		f32 sizeX = (f32)(TerrainData.Size-1);
+		f32 sizeZ = sizeX;
+		s32 startX = 0;
+		s32 startZ = 0;
+		if (Paging)
+		{
+			sizeX = (f32)(Paging->TilesX * Paging->TileSize);
+			sizeZ = (f32)(Paging->TilesZ * Paging->TileSize);
+			startX = Paging->OriginX * Paging->TileSize;
+			startZ = Paging->OriginZ * Paging->TileSize;
+		}
+
+		const f32 resBySizeX = resolution / sizeX;
+		const f32 res2BySizeX = resolution2 / sizeX;
+		const f32 resBySizeZ = resolution / sizeZ;
+		const f32 res2BySizeZ = resolution2 / sizeZ;
 		u32 index = 0;
-		f32 xval = 0.f;
-		f32 x2val = 0.f;
+		f32 xval = startX * resBySizeX;
+		f32 x2val = startX * res2BySizeX;
 		for (s32 x=0; x<TerrainData.Size; ++x)
 		{
-			f32 zval=0.f;
-			f32 z2val=0.f;
+			f32 zval = startZ * resBySizeZ;
+			f32 z2val = startZ * res2BySizeZ;
 			for (s32 z=0; z<TerrainData.Size; ++z)
 			{
 				RenderBuffer->getVertexBuffer()[index].TCoords.X = 1.f-xval;
@@ -1044,71 +1507,111 @@ namespace scene
 				}
 
 				++index;
-				zval += resBySize;
-				z2val += res2BySize;
+				zval += resBySizeZ;
+				z2val += res2BySizeZ;
 			}
-			xval += resBySize;
-			x2val += res2BySize;
+			xval += resBySizeX;
+			x2val += res2BySizeX;
 		}
 
 		RenderBuffer->setDirty(EBT_VERTEX);
 	}
 
 
-	//! used to get the indices when generating index data for patches at varying levels of detail.
-	u32 CTerrainSceneNode::getIndex(const s32 PatchX, const s32 PatchZ,
-					const s32 PatchIndex, u32 vX, u32 vZ) const
+	//! returns the cached indices of a patch, stitched to its coarser neighbours
+	const core::array<u32>& CTerrainSceneNode::getIndexBlockForPatch(s32 patchIndex, s32 LOD) const
 	{
-		// top border
-		if (vZ == 0)
+		const SPatch& patch = TerrainData.Patches[patchIndex];
+
+		// a border is only stitched if the neighbour is coarser
+		return getIndexBlock(LOD,
+			patch.Top && patch.Top->CurrentLOD > LOD ? patch.Top->CurrentLOD : LOD,
+			patch.Bottom && patch.Bottom->CurrentLOD > LOD ? patch.Bottom->CurrentLOD : LOD,
+			patch.Left && patch.Left->CurrentLOD > LOD ? patch.Left->CurrentLOD : LOD,
+			patch.Right && patch.Right->CurrentLOD > LOD ? patch.Right->CurrentLOD : LOD);
+	}
+
+
+	//! returns the indices of one patch at a LOD, relative to the first vertex of the patch.
+	//! The borders are snapped to the LODs of the neighbours. Blocks are built on first use.
+	const core::array<u32>& CTerrainSceneNode::getIndexBlock(s32 LOD, s32 top, s32 bottom, s32 left, s32 right) const
+	{
+		const s32 lods = TerrainData.MaxLOD;
+		const u32 key = LOD + lods * (top + lods * (bottom + lods * (left + lods * right)));
+
+		if (IndexBlocks.empty())
 		{
-			if (TerrainData.Patches[PatchIndex].Top &&
-				TerrainData.Patches[PatchIndex].CurrentLOD < TerrainData.Patches[PatchIndex].Top->CurrentLOD &&
-				(vX % (1 << TerrainData.Patches[PatchIndex].Top->CurrentLOD)) != 0 )
-			{
-				vX -= vX % (1 << TerrainData.Patches[PatchIndex].Top->CurrentLOD);
-			}
+			IndexBlocks.reallocate(lods * lods * lods * lods * lods);
+			for (s32 i = lods * lods * lods * lods * lods; i > 0; --i)
+				IndexBlocks.push_back(0);
 		}
-		else
-		if (vZ == (u32)TerrainData.CalcPatchSize) // bottom border
+
+		if (IndexBlocks[key])
+			return *IndexBlocks[key];
+
+		core::array<u32>* block = new core::array<u32>();
+		IndexBlocks[key] = block;
+
+		// calculate the step we take this patch, based on the LOD
+		const s32 step = 1 << LOD;
+		block->reallocate((TerrainData.CalcPatchSize / step) * (TerrainData.CalcPatchSize / step) * 6);
+
+		// Loop through patch and generate indices
+		for (s32 z = 0; z < TerrainData.CalcPatchSize; z += step)
 		{
-			if (TerrainData.Patches[PatchIndex].Bottom &&
-				TerrainData.Patches[PatchIndex].CurrentLOD < TerrainData.Patches[PatchIndex].Bottom->CurrentLOD &&
-				(vX % (1 << TerrainData.Patches[PatchIndex].Bottom->CurrentLOD)) != 0)
+			for (s32 x = 0; x < TerrainData.CalcPatchSize; x += step)
 			{
-				vX -= vX % (1 << TerrainData.Patches[PatchIndex].Bottom->CurrentLOD);
+				const u32 index11 = getBlockIndex(x, z, top, bottom, left, right);
+				const u32 index21 = getBlockIndex(x + step, z, top, bottom, left, right);
+				const u32 index12 = getBlockIndex(x, z + step, top, bottom, left, right);
+				const u32 index22 = getBlockIndex(x + step, z + step, top, bottom, left, right);
+
+				block->push_back(index12);
+				block->push_back(index11);
+				block->push_back(index22);
+				block->push_back(index22);
+				block->push_back(index11);
+				block->push_back(index21);
 			}
 		}
 
+		return *block;
+	}
+
+
+	//! used to get the indices when generating index blocks for patches at varying levels of detail.
+	u32 CTerrainSceneNode::getBlockIndex(s32 vX, s32 vZ, s32 top, s32 bottom, s32 left, s32 right) const
+	{
+		// top border
+		if (vZ == 0)
+			vX -= vX % (1 << top);
+		else
+		if (vZ == TerrainData.CalcPatchSize) // bottom border
+			vX -= vX % (1 << bottom);
+
 		// left border
 		if (vX == 0)
-		{
-			if (TerrainData.Patches[PatchIndex].Left &&
-				TerrainData.Patches[PatchIndex].CurrentLOD < TerrainData.Patches[PatchIndex].Left->CurrentLOD &&
-				(vZ % (1 << TerrainData.Patches[PatchIndex].Left->CurrentLOD)) != 0)
-			{
-				vZ -= vZ % (1 << TerrainData.Patches[PatchIndex].Left->CurrentLOD);
-			}
-		}
+			vZ -= vZ % (1 << left);
 		else
-		if (vX == (u32)TerrainData.CalcPatchSize) // right border
-		{
-			if (TerrainData.Patches[PatchIndex].Right &&
-				TerrainData.Patches[PatchIndex].CurrentLOD < TerrainData.Patches[PatchIndex].Right->CurrentLOD &&
-				(vZ % (1 << TerrainData.Patches[PatchIndex].Right->CurrentLOD)) != 0)
-			{
-				vZ -= vZ % (1 << TerrainData.Patches[PatchIndex].Right->CurrentLOD);
-			}
-		}
+		if (vX == TerrainData.CalcPatchSize) // right border
+			vZ -= vZ % (1 << right);
 
-		if (vZ >= (u32)TerrainData.PatchSize)
+		if (vZ >= TerrainData.PatchSize)
 			vZ = TerrainData.CalcPatchSize;
 
-		if (vX >= (u32)TerrainData.PatchSize)
+		if (vX >= TerrainData.PatchSize)
 			vX = TerrainData.CalcPatchSize;
 
-		return (vZ + ((TerrainData.CalcPatchSize) * PatchZ)) * TerrainData.Size +
-			(vX + ((TerrainData.CalcPatchSize) * PatchX));
+		return vZ * TerrainData.Size + vX;
+	}
+
+
+	//! releases all cached index blocks
+	void CTerrainSceneNode::clearIndexBlocks()
+	{
+		for (u32 i=0; i<IndexBlocks.size(); ++i)
+			delete IndexBlocks[i];
+		IndexBlocks.clear();
 	}
 
 
@@ -1266,6 +1769,10 @@ namespace scene
 		if (TerrainData.Patches)
 			delete [] TerrainData.Patches;
 
+		// the blocks depend on the size of the heightmap and the MaxLOD
+		clearIndexBlocks();
+		UpdateIndices = true;
+
 		TerrainData.Patches = new SPatch[TerrainData.PatchCount * TerrainData.PatchCount];
 	}
 
@@ -1329,7 +1836,8 @@ namespace scene
 		TerrainData.Center = TerrainData.BoundingBox.getCenter();
 
 		// if the default rotation pivot is still being used, update it.
-		if (UseDefaultRotationPivot)
+		// The paged mode keeps it in the center of the world.
+		if (UseDefaultRotationPivot && !Paging)
 		{
 			TerrainData.RotationPivot = TerrainData.Center;
 		}
@@ -1387,6 +1895,13 @@ namespace scene
 		pos -= TerrainData.Position;
 		pos /= TerrainData.Scale;
 
+		// the render buffer only holds the window in paged mode
+		if (Paging)
+		{
+			pos.X -= Paging->OriginX * Paging->TileSize;
+			pos.Z -= Paging->OriginZ * Paging->TileSize;
+		}
+
 		s32 X(core::floor32(pos.X));
 		s32 Z(core::floor32(pos.Z));
 
@@ -1411,6 +1926,14 @@ namespace scene
 			height *= TerrainData.Scale.Y;
 			height += TerrainData.Position.Y;
 		}
+		else if (Paging && Paging->getHeight(
+				pos.X + Paging->OriginX * Paging->TileSize,
+				pos.Z + Paging->OriginZ * Paging->TileSize, height))
+		{
+			// outside of the window, but the tile is resident
+			height *= TerrainData.Scale.Y;
+			height += TerrainData.Position.Y;
+		}
 
 		return height;
 	}
@@ -1425,6 +1948,7 @@ namespace scene
 		out->addString("Heightmap", HeightmapFile.c_str());
 		out->addFloat("TextureScale1", TCoordScale1);
 		out->addFloat("TextureScale2", TCoordScale2);
+		out->addInt("PageRadius", Paging ? Paging->PageRadius : -1);
 	}
 
 
@@ -1435,6 +1959,7 @@ namespace scene
 		io::path newHeightmap = in->getAttributeAsString("Heightmap");
 		f32 tcoordScale1 = in->getAttributeAsFloat("TextureScale1");
 		f32 tcoordScale2 = in->getAttributeAsFloat("TextureScale2");
+		const s32 pageRadius = in->existsAttribute("PageRadius") ? in->getAttributeAsInt("PageRadius") : -1;
 
 		// set possible new heightmap
 
@@ -1443,7 +1968,10 @@ namespace scene
 			io::IReadFile* file = FileSystem->createAndOpenFile(newHeightmap.c_str());
 			if (file)
 			{
-				loadHeightMap(file, video::SColor(255,255,255,255), 0);
+				if (pageRadius >= 0)
+					loadHeightMapTiled(file, pageRadius);
+				else
+					loadHeightMap(file, video::SColor(255,255,255,255), 0);
 				file->drop();
 			}
 			else
@@ -1480,44 +2008,52 @@ namespace scene
 			newParent, newManager, FileSystem, ID,
 			4, ETPS_17, getPosition(), getRotation(), getScale());
 
-		nb->cloneMembers(this, newManager);
+		nb->cloneTerrain(this, newManager);
+
+		if ( newParent )
+			nb->drop();
+		return nb;
+	}
+
+
+	//! Copies the scene node members and recreates the terrain of another node.
+	void CTerrainSceneNode::cloneTerrain(CTerrainSceneNode* other, ISceneManager* newManager)
+	{
+		cloneMembers(other, newManager);
 
 		// instead of cloning the data structures, recreate the terrain.
 		// (temporary solution)
 
 		// load file
 
-		io::IReadFile* file = FileSystem->createAndOpenFile(HeightmapFile.c_str());
+		io::IReadFile* file = FileSystem->createAndOpenFile(other->HeightmapFile.c_str());
 		if (file)
 		{
-			nb->loadHeightMap(file, video::SColor(255,255,255,255), 0);
+			if (other->Paging)
+				loadHeightMapTiled(file, other->Paging->PageRadius, other->Paging->MaxResidentTiles, other->Paging->VertexColor);
+			else
+				loadHeightMap(file, video::SColor(255,255,255,255), 0);
 			file->drop();
 		}
 
 		// scale textures
 
-		nb->scaleTexture(TCoordScale1, TCoordScale2);
+		scaleTexture(other->TCoordScale1, other->TCoordScale2);
 
 		// copy materials
 
-		for (unsigned int m = 0; m<Mesh->getMeshBufferCount(); ++m)
+		for (unsigned int m = 0; m<other->Mesh->getMeshBufferCount(); ++m)
 		{
-			if (nb->Mesh->getMeshBufferCount()>m &&
-				nb->Mesh->getMeshBuffer(m) &&
-				Mesh->getMeshBuffer(m))
+			if (Mesh->getMeshBufferCount()>m &&
+				Mesh->getMeshBuffer(m) &&
+				other->Mesh->getMeshBuffer(m))
 			{
-				nb->Mesh->getMeshBuffer(m)->getMaterial() =
-					Mesh->getMeshBuffer(m)->getMaterial();
+				Mesh->getMeshBuffer(m)->getMaterial() =
+					other->Mesh->getMeshBuffer(m)->getMaterial();
 			}
 		}
 
-		nb->RenderBuffer->getMaterial() = RenderBuffer->getMaterial();
-
-		// finish
-
-		if ( newParent )
-			nb->drop();
-		return nb;
+		RenderBuffer->getMaterial() = other->RenderBuffer->getMaterial();
 	}
 
 } // end namespace scene
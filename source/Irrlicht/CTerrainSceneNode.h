@@ -15,6 +15,7 @@
 
 namespace irr
 {
+	class CThreadPool;
 namespace io
 {
 	class IFileSystem;
@@ -23,6 +24,7 @@ namespace io
 namespace scene
 {
 	struct SMesh;
+	struct SViewFrustum;
 	class ITextSceneNode;
 
 	//! A scene node for displaying terrain using the geo mip map algorithm.
@@ -58,6 +60,10 @@ namespace scene
 		virtual bool loadHeightMapRAW(io::IReadFile* file, s32 bitsPerPixel = 16,
 			bool signedData=true, bool floatVals=false, s32 width=0, video::SColor vertexColor = video::SColor ( 255, 255, 255, 255 ), s32 smoothFactor = 0 );
 
+		//! Initializes the terrain in paged mode, loading tiles around the camera on demand.
+		virtual bool loadHeightMapTiled(io::IReadFile* file, s32 pageRadius=2,
+			u32 maxResidentTiles=0, video::SColor vertexColor = video::SColor ( 255, 255, 255, 255 ) );
+
 		//! Returns the material based on the zero based index i. This scene node only uses
 		//! 1 material.
 		//! \param i: Zero based index i. UNUSED, left in for virtual purposes.
@@ -216,7 +222,7 @@ namespace scene
 		virtual ISceneNode* clone(ISceneNode* newParent,
 				ISceneManager* newManager);
 
-	private:
+	protected:
 
 		friend class CTerrainTriangleSelector;
 
@@ -270,11 +276,35 @@ namespace scene
 			SPatch*		Patches;
 		};
 
+		struct STerrainTile;
+		struct SPagedTerrain;
+
 		virtual void preRenderLODCalculations();
 		virtual void preRenderIndicesCalculations();
 
-		//! get indices when generating index data for patches at varying levels of detail.
-		u32 getIndex(const s32 PatchX, const s32 PatchZ, const s32 PatchIndex, u32 vX, u32 vZ) const;
+		//! clamps MaxLOD to what the patch size allows
+		void clampMaxLOD();
+
+		//! requests and releases tiles around the camera, moves the window when possible
+		void updatePaging();
+
+		//! fills the render buffer with the window of tiles starting at the given tile
+		void buildPagedWindow(s32 originX, s32 originZ);
+
+		//! releases all data of the paged mode
+		void dropPaging();
+
+		//! returns the cached indices of a patch, stitched to its coarser neighbours
+		const core::array<u32>& getIndexBlockForPatch(s32 patchIndex, s32 LOD) const;
+
+		//! returns the indices of a patch relative to its first vertex, for a LOD and the LODs of the four borders
+		const core::array<u32>& getIndexBlock(s32 LOD, s32 top, s32 bottom, s32 left, s32 right) const;
+
+		//! get indices when generating index blocks for patches at varying levels of detail.
+		u32 getBlockIndex(s32 vX, s32 vZ, s32 top, s32 bottom, s32 left, s32 right) const;
+
+		//! releases all cached index blocks
+		void clearIndexBlocks();
 
 		//! smooth the terrain
 		void smoothTerrain(IDynamicMeshBuffer* mb, s32 smoothFactor);
@@ -300,9 +330,18 @@ namespace scene
 		//! Apply transformation changes( scale, position, rotation )
 		void applyTransformation();
 
+		//! copies the scene node members and recreates the terrain of another node
+		void cloneTerrain(CTerrainSceneNode* other, ISceneManager* newManager);
+
 		STerrainData TerrainData;
 		SMesh* Mesh;
 
+		//! only set in paged mode
+		SPagedTerrain* Paging;
+
+		//! changes whenever the vertices of the render buffer are replaced
+		u32 GeometryRevision;
+
 		IDynamicMeshBuffer *RenderBuffer;
 
 		u32 VerticesToRender;
@@ -312,6 +351,10 @@ namespace scene
 		bool OverrideDistanceThreshold;
 		bool UseDefaultRotationPivot;
 		bool ForceRecalculation;
+		bool UpdateIndices;
+
+		//! index blocks for each combination of patch LOD and border LODs
+		mutable core::array<core::array<u32>*> IndexBlocks;
 
 		core::vector3df	OldCameraPosition;
 		core::vector3df	OldCameraRotation;
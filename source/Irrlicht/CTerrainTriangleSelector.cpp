@@ -14,7 +14,7 @@ namespace scene
 
 //! constructor
 CTerrainTriangleSelector::CTerrainTriangleSelector ( ITerrainSceneNode* node, s32 LOD )
-	: SceneNode(node)
+	: SceneNode(node), LOD(LOD), GeometryRevision(0)
 {
 	#ifdef _DEBUG
 	setDebugName ("CTerrainTriangleSelector");
@@ -34,7 +34,6 @@ CTerrainTriangleSelector::~CTerrainTriangleSelector()
 //! Clears and sets triangle data
 void CTerrainTriangleSelector::setTriangleData(ITerrainSceneNode* node, s32 LOD)
 {
-	core::triangle3df tri;
 	core::array<u32> indices;
 
 	// Get pointer to the GeoMipMaps vertices
@@ -44,40 +43,59 @@ void CTerrainTriangleSelector::setTriangleData(ITerrainSceneNode* node, s32 LOD)
 	const s32 count = (static_cast<CTerrainSceneNode*>(node))->TerrainData.PatchCount;
 	TrianglePatches.TotalTriangles = 0;
 	TrianglePatches.NumPatches = count*count;
+	GeometryRevision = (static_cast<CTerrainSceneNode*>(node))->GeometryRevision;
+	if (LOD != -1)
+		this->LOD = LOD;
 
-	TrianglePatches.TrianglePatchArray.reallocate(TrianglePatches.NumPatches);
-	for (s32 o=0; o<TrianglePatches.NumPatches; ++o)
-		TrianglePatches.TrianglePatchArray.push_back(SGeoMipMapTrianglePatch());
+	// keep the allocated triangle arrays when the patch count did not change
+	if (TrianglePatches.TrianglePatchArray.size() != (u32)TrianglePatches.NumPatches)
+	{
+		TrianglePatches.TrianglePatchArray.clear();
+		TrianglePatches.TrianglePatchArray.reallocate(TrianglePatches.NumPatches);
+		for (s32 o=0; o<TrianglePatches.NumPatches; ++o)
+			TrianglePatches.TrianglePatchArray.push_back(SGeoMipMapTrianglePatch());
+	}
 
 	s32 tIndex = 0;
 	for(s32 x = 0; x < count; ++x )
 	{
 		for(s32 z = 0; z < count; ++z )
 		{
-			TrianglePatches.TrianglePatchArray[tIndex].NumTriangles = 0;
-			TrianglePatches.TrianglePatchArray[tIndex].Box = node->getBoundingBox( x, z );
-			u32 indexCount = node->getIndicesForPatch( indices, x, z, LOD );
+			SGeoMipMapTrianglePatch& patch = TrianglePatches.TrianglePatchArray[tIndex];
+			patch.Box = node->getBoundingBox( x, z );
+
+			// invisible patches return a negative count
+			const s32 indexCount = core::max_(0, node->getIndicesForPatch( indices, x, z, LOD ));
 
-			TrianglePatches.TrianglePatchArray[tIndex].Triangles.reallocate(indexCount/3);
-			for(u32 i = 0; i < indexCount; i += 3 )
+			patch.NumTriangles = indexCount/3;
+			patch.Triangles.set_used(patch.NumTriangles);
+			for(s32 i = 0; i < patch.NumTriangles; ++i )
 			{
-				tri.pointA = vertices[indices[i+0]].Pos;
-				tri.pointB = vertices[indices[i+1]].Pos;
-				tri.pointC = vertices[indices[i+2]].Pos;
-				TrianglePatches.TrianglePatchArray[tIndex].Triangles.push_back(tri);
-				++TrianglePatches.TrianglePatchArray[tIndex].NumTriangles;
+				core::triangle3df& tri = patch.Triangles[i];
+				tri.pointA = vertices[indices[i*3+0]].Pos;
+				tri.pointB = vertices[indices[i*3+1]].Pos;
+				tri.pointC = vertices[indices[i*3+2]].Pos;
 			}
 
-			TrianglePatches.TotalTriangles += TrianglePatches.TrianglePatchArray[tIndex].NumTriangles;
+			TrianglePatches.TotalTriangles += patch.NumTriangles;
 			++tIndex;
 		}
 	}
 }
 
+//! refreshes the triangles if the terrain replaced its vertices (paged mode)
+void CTerrainTriangleSelector::update() const
+{
+	if (GeometryRevision != (static_cast<CTerrainSceneNode*>(SceneNode))->GeometryRevision)
+		const_cast<CTerrainTriangleSelector*>(this)->setTriangleData(SceneNode, LOD);
+}
+
 //! Gets all triangles.
 void CTerrainTriangleSelector::getTriangles ( core::triangle3df* triangles, s32 arraySize,
 	s32& outTriangleCount, const core::matrix4* transform) const
 {
+	update();
+
 	s32 count = TrianglePatches.TotalTriangles;
 
 	if (count > arraySize)
@@ -114,6 +132,8 @@ void CTerrainTriangleSelector::getTriangles ( core::triangle3df* triangles, s32
 	s32& outTriangleCount, const core::aabbox3d<f32>& box,
 	const core::matrix4* transform) const
 {
+	update();
+
 	s32 count = TrianglePatches.TotalTriangles;
 
 	if (count > arraySize)
@@ -150,6 +170,8 @@ void CTerrainTriangleSelector::getTriangles(core::triangle3df* triangles, s32 ar
 	s32& outTriangleCount, const core::line3d<f32>& line,
 	const core::matrix4* transform) const
 {
+	update();
+
 	const s32 count = core::min_((s32)TrianglePatches.TotalTriangles, arraySize);
 
 	core::matrix4 mat;
@@ -183,6 +205,8 @@ void CTerrainTriangleSelector::getTriangles(core::triangle3df* triangles, s32 ar
 //! Returns amount of all available triangles in this selector
 s32 CTerrainTriangleSelector::getTriangleCount() const
 {
+	update();
+
 	return TrianglePatches.TotalTriangles;
 }
 
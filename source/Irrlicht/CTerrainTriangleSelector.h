@@ -61,6 +61,9 @@ private:
 
 	friend class CTerrainSceneNode;
 
+	//! refreshes the triangles if the terrain replaced its vertices (paged mode)
+	void update() const;
+
 	struct SGeoMipMapTrianglePatch
 	{
 		core::array<core::triangle3df>	Triangles;
@@ -81,7 +84,9 @@ private:
 	};
 
 	ITerrainSceneNode*		SceneNode;
-	SGeoMipMapTrianglePatches	TrianglePatches;
+	mutable SGeoMipMapTrianglePatches	TrianglePatches;
+	s32				LOD;
+	mutable u32			GeometryRevision;
 };
 
 } // end namespace scene
@@ -0,0 +1,383 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#include "CThreadPool.h"
+#include "irrMath.h"
+
+#ifdef _IRR_COMPILE_WITH_THREADS_
+	#if defined(_IRR_WINDOWS_API_)
+		#define WIN32_LEAN_AND_MEAN
+		#include <windows.h>
+	#else
+		#include <pthread.h>
+		#include <unistd.h>
+	#endif
+#endif
+
+namespace irr
+{
+
+// ----------------------------------------------------------------
+// CMutex
+// ----------------------------------------------------------------
+
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_IRR_WINDOWS_API_)
+
+CMutex::CMutex()
+{
+	CRITICAL_SECTION* cs = new CRITICAL_SECTION;
+	InitializeCriticalSection(cs);
+	Handle = cs;
+}
+
+CMutex::~CMutex()
+{
+	DeleteCriticalSection((CRITICAL_SECTION*)Handle);
+	delete (CRITICAL_SECTION*)Handle;
+}
+
+void CMutex::lock()
+{
+	EnterCriticalSection((CRITICAL_SECTION*)Handle);
+}
+
+void CMutex::unlock()
+{
+	LeaveCriticalSection((CRITICAL_SECTION*)Handle);
+}
+
+#elif defined(_IRR_COMPILE_WITH_THREADS_)
+
+CMutex::CMutex()
+{
+	pthread_mutex_t* m = new pthread_mutex_t;
+	pthread_mutex_init(m, 0);
+	Handle = m;
+}
+
+CMutex::~CMutex()
+{
+	pthread_mutex_destroy((pthread_mutex_t*)Handle);
+	delete (pthread_mutex_t*)Handle;
+}
+
+void CMutex::lock()
+{
+	pthread_mutex_lock((pthread_mutex_t*)Handle);
+}
+
+void CMutex::unlock()
+{
+	pthread_mutex_unlock((pthread_mutex_t*)Handle);
+}
+
+#else
+
+CMutex::CMutex() : Handle(0) {}
+CMutex::~CMutex() {}
+void CMutex::lock() {}
+void CMutex::unlock() {}
+
+#endif
+
+
+// ----------------------------------------------------------------
+// CThreadPool
+// ----------------------------------------------------------------
+
+//! Job queued by parallelFor, one entry per helping thread
+struct CThreadPool::SParallelForJob : public IThreadJob
+{
+	SParallelForJob(CThreadPool* pool, ParallelForFunction func, void* userData,
+			u32 count, u32 band)
+		: Pool(pool), Func(func), UserData(userData), Count(count),
+		Band(band), Next(0), Finished(0), Outstanding(0)
+	{
+	}
+
+	//! called from the workers
+	virtual void run()
+	{
+		process();
+
+		CMutexLock lock(Pool->Mutex);
+		--Outstanding;
+	}
+
+	//! takes bands until none are left
+	void process()
+	{
+		Pool->Mutex.lock();
+		while (Next < Count)
+		{
+			const u32 begin = Next;
+			const u32 end = core::min_(Count, begin + Band);
+			Next = end;
+			Pool->Mutex.unlock();
+
+			Func(UserData, begin, end);
+
+			Pool->Mutex.lock();
+			Finished += end - begin;
+		}
+		Pool->Mutex.unlock();
+	}
+
+	CThreadPool* Pool;
+	ParallelForFunction Func;
+	void* UserData;
+	u32 Count;
+	u32 Band;
+	u32 Next;
+	u32 Finished;
+	//! queue entries which were neither removed nor finished yet
+	u32 Outstanding;
+};
+
+
+CThreadPool::CThreadPool(u32 threadCount)
+: Condition(0), Running(0), Quit(false)
+{
+	#ifdef _DEBUG
+	setDebugName("CThreadPool");
+	#endif
+
+	if (!threadCount)
+		threadCount = getProcessorCount();
+
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_IRR_WINDOWS_API_)
+	CONDITION_VARIABLE* cv = new CONDITION_VARIABLE;
+	InitializeConditionVariable(cv);
+	Condition = cv;
+
+	for (u32 i=0; i<threadCount; ++i)
+	{
+		HANDLE thread = CreateThread(0, 0, threadEntry, this, 0, 0);
+		if (!thread)
+			break;
+		Threads.push_back(thread);
+	}
+#elif defined(_IRR_COMPILE_WITH_THREADS_)
+	pthread_cond_t* cv = new pthread_cond_t;
+	pthread_cond_init(cv, 0);
+	Condition = cv;
+
+	for (u32 i=0; i<threadCount; ++i)
+	{
+		pthread_t* thread = new pthread_t;
+		if (pthread_create(thread, 0, threadEntry, this))
+		{
+			delete thread;
+			break;
+		}
+		Threads.push_back(thread);
+	}
+#endif
+}
+
+
+CThreadPool::~CThreadPool()
+{
+	waitForAll();
+
+	Mutex.lock();
+	Quit = true;
+	signalAll();
+	Mutex.unlock();
+
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_IRR_WINDOWS_API_)
+	for (u32 i=0; i<Threads.size(); ++i)
+	{
+		WaitForSingleObject((HANDLE)Threads[i], INFINITE);
+		CloseHandle((HANDLE)Threads[i]);
+	}
+	delete (CONDITION_VARIABLE*)Condition;
+#elif defined(_IRR_COMPILE_WITH_THREADS_)
+	for (u32 i=0; i<Threads.size(); ++i)
+	{
+		pthread_join(*(pthread_t*)Threads[i], 0);
+		delete (pthread_t*)Threads[i];
+	}
+	pthread_cond_destroy((pthread_cond_t*)Condition);
+	delete (pthread_cond_t*)Condition;
+#endif
+}
+
+
+void CThreadPool::addJob(IThreadJob* job)
+{
+	if (!job)
+		return;
+
+	if (Threads.empty())
+	{
+		job->run();
+		return;
+	}
+
+	CMutexLock lock(Mutex);
+	Queue.push_back(job);
+	signalAll();
+}
+
+
+void CThreadPool::waitForAll()
+{
+	if (Threads.empty())
+		return;
+
+	CMutexLock lock(Mutex);
+	while (!Queue.empty() || Running)
+		waitCondition();
+}
+
+
+u32 CThreadPool::getThreadCount() const
+{
+	return Threads.size();
+}
+
+
+void CThreadPool::parallelFor(u32 count, u32 minBandSize, ParallelForFunction func, void* userData)
+{
+	if (!count || !func)
+		return;
+
+	// one band more than threads, so the caller has something to do as well
+	const u32 workers = Threads.size() + 1;
+	u32 band = core::max_(1u, minBandSize);
+	if (count / workers > band)
+		band = (count + workers - 1) / workers;
+
+	if (Threads.empty() || band >= count)
+	{
+		func(userData, 0, count);
+		return;
+	}
+
+	SParallelForJob job(this, func, userData, count, band);
+
+	const u32 helpers = core::min_(Threads.size(), (count + band - 1) / band - 1);
+	Mutex.lock();
+	for (u32 i=0; i<helpers; ++i)
+	{
+		Queue.push_back(&job);
+		++job.Outstanding;
+	}
+	signalAll();
+	Mutex.unlock();
+
+	job.process();
+
+	CMutexLock lock(Mutex);
+
+	// remove the entries no worker picked up
+	core::list<IThreadJob*>::Iterator it = Queue.begin();
+	while (it != Queue.end())
+	{
+		if (*it == &job)
+		{
+			it = Queue.erase(it);
+			--job.Outstanding;
+		}
+		else
+			++it;
+	}
+
+	while (job.Outstanding || job.Finished < count)
+		waitCondition();
+}
+
+
+u32 CThreadPool::getProcessorCount()
+{
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_IRR_WINDOWS_API_)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return core::max_(1u, (u32)info.dwNumberOfProcessors);
+#elif defined(_IRR_COMPILE_WITH_THREADS_) && defined(_SC_NPROCESSORS_ONLN)
+	const long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (u32)count : 1;
+#else
+	return 1;
+#endif
+}
+
+
+//! guards the creation of the shared pool, which may be first used by several threads
+static CMutex SharedPoolMutex;
+
+CThreadPool* CThreadPool::getSharedPool()
+{
+	// never destroyed, the threads end with the process
+	static CThreadPool* pool = 0;
+	CMutexLock lock(SharedPoolMutex);
+	if (!pool)
+		pool = new CThreadPool(getProcessorCount() > 1 ? getProcessorCount() - 1 : 1);
+	return pool;
+}
+
+
+void CThreadPool::workerLoop()
+{
+	CMutexLock lock(Mutex);
+	while (true)
+	{
+		while (Queue.empty() && !Quit)
+			waitCondition();
+
+		if (Queue.empty())
+			break;
+
+		core::list<IThreadJob*>::Iterator first = Queue.begin();
+		IThreadJob* job = *first;
+		Queue.erase(first);
+		++Running;
+
+		Mutex.unlock();
+		job->run();
+		Mutex.lock();
+
+		--Running;
+		signalAll();
+	}
+}
+
+
+//! waits on the condition, the mutex must be locked
+void CThreadPool::waitCondition()
+{
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_IRR_WINDOWS_API_)
+	SleepConditionVariableCS((CONDITION_VARIABLE*)Condition,
+		(CRITICAL_SECTION*)Mutex.Handle, INFINITE);
+#elif defined(_IRR_COMPILE_WITH_THREADS_)
+	pthread_cond_wait((pthread_cond_t*)Condition, (pthread_mutex_t*)Mutex.Handle);
+#endif
+}
+
+
+//! wakes all waiting threads, the mutex must be locked
+void CThreadPool::signalAll()
+{
+#if defined(_IRR_COMPILE_WITH_THREADS_) && defined(_IRR_WINDOWS_API_)
+	WakeAllConditionVariable((CONDITION_VARIABLE*)Condition);
+#elif defined(_IRR_COMPILE_WITH_THREADS_)
+	pthread_cond_broadcast((pthread_cond_t*)Condition);
+#endif
+}
+
+
+#if defined(_IRR_WINDOWS_API_)
+unsigned long __stdcall
+#else
+void*
+#endif
+CThreadPool::threadEntry(void* pool)
+{
+	((CThreadPool*)pool)->workerLoop();
+	return 0;
+}
+
+} // end namespace irr
+
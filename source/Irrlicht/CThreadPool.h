@@ -0,0 +1,135 @@
+// Copyright (C) 2002-2010 Nikolaus Gebhardt
+// This file is part of the "Irrlicht Engine".
+// For conditions of distribution and use, see copyright notice in irrlicht.h
+
+#ifndef __C_THREAD_POOL_H_INCLUDED__
+#define __C_THREAD_POOL_H_INCLUDED__
+
+#include "IrrCompileConfig.h"
+#include "IReferenceCounted.h"
+#include "irrArray.h"
+#include "irrList.h"
+
+namespace irr
+{
+
+	//! Simple non recursive mutex
+	class CMutex
+	{
+	public:
+		CMutex();
+		~CMutex();
+
+		void lock();
+		void unlock();
+
+	private:
+		friend class CThreadPool;
+
+		// not copyable
+		CMutex(const CMutex&);
+		CMutex& operator=(const CMutex&);
+
+		void* Handle;
+	};
+
+
+	//! Locks a mutex for the lifetime of the object
+	class CMutexLock
+	{
+	public:
+		CMutexLock(CMutex& mutex) : Mutex(mutex) { Mutex.lock(); }
+		~CMutexLock() { Mutex.unlock(); }
+
+	private:
+		CMutexLock& operator=(const CMutexLock&);
+
+		CMutex& Mutex;
+	};
+
+
+	//! A piece of work which can be handed to a CThreadPool
+	class IThreadJob
+	{
+	public:
+		virtual ~IThreadJob() {}
+
+		//! Does the work, called on one of the worker threads.
+		virtual void run() = 0;
+	};
+
+
+	//! Function called by CThreadPool::parallelFor for the range [begin,end)
+	typedef void (*ParallelForFunction)(void* userData, u32 begin, u32 end);
+
+
+	//! A fixed set of worker threads processing queued jobs
+	/** If the engine is compiled without _IRR_COMPILE_WITH_THREADS_, or
+	if the threads could not be created, all jobs are executed directly
+	in the calling thread. Users should therefore never rely on jobs
+	being asynchronous. */
+	class CThreadPool : public IReferenceCounted
+	{
+	public:
+
+		//! Constructor
+		/** \param threadCount Number of worker threads. 0 means one
+		thread per available processor. */
+		CThreadPool(u32 threadCount=0);
+
+		//! Destructor, finishes all queued jobs first
+		virtual ~CThreadPool();
+
+		//! Queues a job.
+		/** The pool does not take ownership of the job, it must stay
+		valid until it was executed. */
+		void addJob(IThreadJob* job);
+
+		//! Blocks until the queue is empty and all jobs have finished.
+		void waitForAll();
+
+		//! Returns the number of worker threads, 0 if jobs run synchronously.
+		u32 getThreadCount() const;
+
+		//! Splits [0,count) into bands of at least minBandSize and processes them on all threads
+		/** The calling thread takes part in the work, and the call only
+		returns when all bands are finished. This makes it safe to use from
+		within jobs of the same pool. */
+		void parallelFor(u32 count, u32 minBandSize, ParallelForFunction func, void* userData);
+
+		//! Returns the number of processors available to the process.
+		static u32 getProcessorCount();
+
+		//! Returns a pool shared by the whole engine, created on first use.
+		/** Can be called from any thread. The returned pointer must not
+		be dropped. */
+		static CThreadPool* getSharedPool();
+
+	private:
+
+		struct SParallelForJob;
+
+		void workerLoop();
+		void waitCondition();
+		void signalAll();
+
+		static
+		#if defined(_IRR_WINDOWS_API_)
+		unsigned long __stdcall
+		#else
+		void*
+		#endif
+		threadEntry(void* pool);
+
+		CMutex Mutex;
+		void* Condition;
+		core::array<void*> Threads;
+		core::list<IThreadJob*> Queue;
+		u32 Running;
+		bool Quit;
+	};
+
+} // end namespace irr
+
+#endif
+
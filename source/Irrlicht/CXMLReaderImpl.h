@@ -32,8 +32,11 @@ public:
 	//! Constructor
 	CXMLReaderImpl(IFileReadCallBack* callback, bool deleteCallBack = true)
 		: TextData(0), P(0), TextBegin(0), TextSize(0), CurrentNodeType(EXN_NONE),
-		SourceFormat(ETF_ASCII), TargetFormat(ETF_ASCII)
+		SourceFormat(ETF_ASCII), TargetFormat(ETF_ASCII), NodeName(0),
+		IsEmptyElement(false), TagPending(false)
 	{
+		NodeName = EmptyString.c_str();
+
 		if (!callback)
 			return;
 
@@ -55,7 +58,25 @@ public:
 		// set pointer to text begin
 		P = TextBegin;
 	}
-    	
+
+
+	//! Constructor parsing a borrowed buffer in place
+	/** The buffer has to be in the character format of the parser and
+	terminated by a 0 character, which is not included in size. It is
+	modified while parsing and must stay valid as long as the parser. */
+	CXMLReaderImpl(char_type* buffer, unsigned int size)
+		: TextData(0), P(buffer), TextBegin(buffer), TextSize(size+1),
+		CurrentNodeType(EXN_NONE), SourceFormat(ETF_ASCII), TargetFormat(ETF_ASCII),
+		NodeName(0), IsEmptyElement(false), TagPending(false)
+	{
+		NodeName = EmptyString.c_str();
+
+		storeTargetFormat();
+		SourceFormat = TargetFormat;
+
+		createSpecialCharacterList();
+	}
+
 
 	//! Destructor
 	virtual ~CXMLReaderImpl()
@@ -69,7 +90,7 @@ public:
 	virtual bool read()
 	{
 		// if not end reached, parse the node
-		if (P && (unsigned int)(P - TextBegin) < TextSize - 1 && *P != 0)
+		if (P && (unsigned int)(P - TextBegin) < TextSize - 1 && (*P != 0 || TagPending))
 		{
 			return parseCurrentNode();
 		}
@@ -99,7 +120,7 @@ public:
 		if ((u32)idx >= Attributes.size())
 			return 0;
 
-		return Attributes[idx].Name.c_str();
+		return Attributes[idx].Name;
 	}
 
 
@@ -109,7 +130,7 @@ public:
 		if ((unsigned int)idx >= Attributes.size())
 			return 0;
 
-		return Attributes[idx].Value.c_str();
+		return Attributes[idx].Value;
 	}
 
 
@@ -120,7 +141,7 @@ public:
 		if (!attr)
 			return 0;
 
-		return attr->Value.c_str();
+		return attr->Value;
 	}
 
 
@@ -131,7 +152,7 @@ public:
 		if (!attr)
 			return EmptyString.c_str();
 
-		return attr->Value.c_str();
+		return attr->Value;
 	}
 
 
@@ -143,8 +164,7 @@ public:
 		if (!attr)
 			return 0;
 
-		core::stringc c(attr->Value.c_str());
-		return core::strtol10(c.c_str());
+		return toInt(attr->Value);
 	}
 
 
@@ -155,8 +175,7 @@ public:
 		if (!attrvalue)
 			return 0;
 
-		core::stringc c(attrvalue);
-		return core::strtol10(c.c_str());
+		return toInt(attrvalue);
 	}
 
 
@@ -167,8 +186,7 @@ public:
 		if (!attr)
 			return 0;
 
-		core::stringc c = attr->Value.c_str();
-		return core::fast_atof(c.c_str());
+		return toFloat(attr->Value);
 	}
 
 
@@ -179,22 +197,21 @@ public:
 		if (!attrvalue)
 			return 0;
 
-		core::stringc c = attrvalue;
-		return core::fast_atof(c.c_str());
+		return toFloat(attrvalue);
 	}
 
 
 	//! Returns the name of the current node.
 	virtual const char_type* getNodeName() const
 	{
-		return NodeName.c_str();
+		return NodeName;
 	}
 
 
 	//! Returns data of the current node.
 	virtual const char_type* getNodeData() const
 	{
-		return NodeName.c_str();
+		return NodeName;
 	}
 
 
@@ -218,25 +235,37 @@ public:
 
 private:
 
+	// All names and values point into the text buffer. They are
+	// terminated in place once the parser moved past their end, and xml
+	// special characters are only replaced in values containing a '&'.
+
 	// Reads the current xml node
 	// return false if no further node is found
 	bool parseCurrentNode()
 	{
-		char_type* start = P;
+		if (TagPending)
+		{
+			// the '<' after the last text was overwritten to terminate it
+			TagPending = false;
+		}
+		else
+		{
+			char_type* start = P;
 
-		// more forward until '<' found
-		while(*P != L'<' && *P)
-			++P;
+			// more forward until '<' found
+			while(*P != L'<' && *P)
+				++P;
 
-		// not a node, so return false
-		if (!*P)
-			return false;
+			// not a node, so return false
+			if (!*P)
+				return false;
 
-		if (P - start > 0)
-		{
-			// we found some text, store it
-			if (setText(start, P))
-				return true;
+			if (P - start > 0)
+			{
+				// we found some text, store it
+				if (setText(start, P))
+					return true;
+			}
 		}
 
 		++P;
@@ -279,8 +308,15 @@ private:
 		}
 
 		// set current text to the parsed text, and replace xml special characters
-		core::string<char_type> s(start, (int)(end - start));
-		NodeName = replaceSpecialCharacters(s);
+		bool special = false;
+		for (const char_type* p = start; p != end && !special; ++p)
+			special = (*p == L'&');
+
+		*end = 0;
+		TagPending = true;
+		if (special)
+			replaceSpecialCharacters(start);
+		NodeName = start;
 
 		// current XML node type is text
 		CurrentNodeType = EXN_TEXT;
@@ -326,7 +362,13 @@ private:
 		}
 
 		P -= 3;
-		NodeName = core::string<char_type>(pCommentBegin+2, (int)(P - pCommentBegin-2));
+		if (P >= pCommentBegin+2)
+		{
+			*P = 0;
+			NodeName = pCommentBegin+2;
+		}
+		else
+			NodeName = EmptyString.c_str();
 		P += 3;
 	}
 
@@ -336,16 +378,17 @@ private:
 	{
 		CurrentNodeType = EXN_ELEMENT;
 		IsEmptyElement = false;
-		Attributes.clear();
+		Attributes.set_used(0);
+		NodeName = EmptyString.c_str();
 
 		// find name
-		const char_type* startName = P;
+		char_type* startName = P;
 
 		// find end of element
 		while(*P != L'>' && !isWhiteSpace(*P))
 			++P;
 
-		const char_type* endName = P;
+		char_type* endName = P;
 
 		// find Attributes
 		while(*P != L'>')
@@ -359,12 +402,12 @@ private:
 					// we've got an attribute
 
 					// read the attribute names
-					const char_type* attributeNameBegin = P;
+					char_type* attributeNameBegin = P;
 
 					while(!isWhiteSpace(*P) && *P != L'=')
 						++P;
 
-					const char_type* attributeNameEnd = P;
+					char_type* attributeNameEnd = P;
 					++P;
 
 					// read the attribute value
@@ -378,25 +421,30 @@ private:
 					const char_type attributeQuoteChar = *P;
 
 					++P;
-					const char_type* attributeValueBegin = P;
-					
+					char_type* attributeValueBegin = P;
+					bool special = false;
+
 					while(*P != attributeQuoteChar && *P)
+					{
+						special |= (*P == L'&');
 						++P;
+					}
 
 					if (!*P) // malformatted xml file
 						return;
 
-					const char_type* attributeValueEnd = P;
+					char_type* attributeValueEnd = P;
 					++P;
 
-					SAttribute attr;
-					attr.Name = core::string<char_type>(attributeNameBegin, 
-						(int)(attributeNameEnd - attributeNameBegin));
+					// both ends are behind the parser now
+					*attributeNameEnd = 0;
+					*attributeValueEnd = 0;
+					if (special)
+						replaceSpecialCharacters(attributeValueBegin);
 
-					core::string<char_type> s(attributeValueBegin, 
-						(int)(attributeValueEnd - attributeValueBegin));
-
-					attr.Value = replaceSpecialCharacters(s);
+					SAttribute attr;
+					attr.Name = attributeNameBegin;
+					attr.Value = attributeValueBegin;
 					Attributes.push_back(attr);
 				}
 				else
@@ -417,9 +465,10 @@ private:
 			endName--;
 		}
 		
-		NodeName = core::string<char_type>(startName, (int)(endName - startName));
-
 		++P;
+
+		*endName = 0;
+		NodeName = startName;
 	}
 
 
@@ -428,15 +477,16 @@ private:
 	{
 		CurrentNodeType = EXN_ELEMENT_END;
 		IsEmptyElement = false;
-		Attributes.clear();
+		Attributes.set_used(0);
 
 		++P;
-		const char_type* pBeginClose = P;
+		char_type* pBeginClose = P;
 
 		while(*P != L'>')
 			++P;
 
-		NodeName = core::string<char_type>(pBeginClose, (int)(P - pBeginClose));
+		*P = 0;
+		NodeName = pBeginClose;
 		++P;
 	}
 
@@ -476,19 +526,22 @@ private:
 		}
 
 		if ( cDataEnd )
-			NodeName = core::string<char_type>(cDataBegin, (int)(cDataEnd - cDataBegin));
+		{
+			*cDataEnd = 0;
+			NodeName = cDataBegin;
+		}
 		else
-			NodeName = "";
+			NodeName = EmptyString.c_str();
 
 		return true;
 	}
 
 
-	// structure for storing attribute-name pairs
+	// structure for storing attribute-name pairs, pointing into the text
 	struct SAttribute
 	{
-		core::string<char_type> Name;
-		core::string<char_type> Value;
+		const char_type* Name;
+		const char_type* Value;
 	};
 
 	// finds a current attribute by name, returns 0 if not found
@@ -497,64 +550,74 @@ private:
 		if (!name)
 			return 0;
 
-		core::string<char_type> n = name;
-
 		for (int i=0; i<(int)Attributes.size(); ++i)
-			if (Attributes[i].Name == n)
+		{
+			const char_type* a = Attributes[i].Name;
+			const char_type* b = name;
+			while (*a && *a == *b)
+			{
+				++a;
+				++b;
+			}
+			if (*a == *b)
 				return &Attributes[i];
+		}
 
 		return 0;
 	}
 
-	// replaces xml special characters in a string and creates a new one
-	core::string<char_type> replaceSpecialCharacters(
-		core::string<char_type>& origstr)
+	// replaces xml special characters of a 0 terminated string in place
+	void replaceSpecialCharacters(char_type* str)
 	{
-		int pos = origstr.findFirst(L'&');
-		int oldPos = 0;
-
-		if (pos == -1)
-			return origstr;
+		char_type* out = str;
 
-		core::string<char_type> newstr;
-
-		while(pos != -1 && pos < (int)origstr.size()-2)
+		for (const char_type* in = str; *in; )
 		{
-			// check if it is one of the special characters
-
-			int specialChar = -1;
-			for (int i=0; i<(int)SpecialCharacters.size(); ++i)
+			if (*in == L'&')
 			{
-				const char_type* p = &origstr.c_str()[pos]+1;
-
-				if (equalsn(&SpecialCharacters[i][1], p, SpecialCharacters[i].size()-1))
+				// check if it is one of the special characters
+				int specialChar = -1;
+				for (int i=0; i<(int)SpecialCharacters.size(); ++i)
 				{
-					specialChar = i;
-					break;
+					if (equalsn(&SpecialCharacters[i][1], in+1, SpecialCharacters[i].size()-1))
+					{
+						specialChar = i;
+						break;
+					}
 				}
-			}
 
-			if (specialChar != -1)
-			{
-				newstr.append(origstr.subString(oldPos, pos - oldPos));
-				newstr.append(SpecialCharacters[specialChar][0]);
-				pos += SpecialCharacters[specialChar].size();
-			}
-			else
-			{
-				newstr.append(origstr.subString(oldPos, pos - oldPos + 1));
-				pos += 1;
+				if (specialChar != -1)
+				{
+					*out++ = SpecialCharacters[specialChar][0];
+					in += SpecialCharacters[specialChar].size();
+					continue;
+				}
 			}
 
-			// find next &
-			oldPos = pos;
-			pos = origstr.findNext(L'&', pos);		
+			*out++ = *in++;
 		}
 
-		if (oldPos < (int)origstr.size()-1)
-			newstr.append(origstr.subString(oldPos, origstr.size()-oldPos));
+		*out = 0;
+	}
+
+	// converts a value to an integer, without a copy for 8 bit text
+	static int toInt(const char_type* value)
+	{
+		if (sizeof(char_type) == 1)
+			return core::strtol10((const c8*)value);
+
+		core::stringc c(value);
+		return core::strtol10(c.c_str());
+	}
+
+	// converts a value to a float, without a copy for 8 bit text
+	static float toFloat(const char_type* value)
+	{
+		if (sizeof(char_type) == 1)
+			return core::fast_atof((const c8*)value);
 
-		return newstr;
+		core::stringc c(value);
+		return core::fast_atof(c.c_str());
 	}
 
 
@@ -790,10 +853,11 @@ private:
 	ETEXT_FORMAT SourceFormat;   // source format of the xml file
 	ETEXT_FORMAT TargetFormat;   // output format of this parser
 
-	core::string<char_type> NodeName;    // name of the node currently in
+	const char_type* NodeName;           // name of the node currently in, points into the text
 	core::string<char_type> EmptyString; // empty string to be returned by getSafe() methods
 
 	bool IsEmptyElement;       // is the currently parsed node empty?
+	bool TagPending;           // was the '<' after the current text overwritten?
 
 	core::array< core::string<char_type> > SpecialCharacters; // see createSpecialCharacterList()
 
@@ -2350,7 +2350,7 @@ f32 CXMeshFileLoader::readFloat()
 	}
 	findNextNoneWhiteSpaceNumber();
 	f32 ftmp;
-	P = core::fast_atof_move(P, ftmp);
+	P = core::fast_atof_exact_move(P, ftmp);
 	return ftmp;
 }
 
@@ -7,9 +7,24 @@
 
 #include "SoftwareDriver2_compile_config.h"
 #include "IBurningShader.h"
+#include "CBlockCompression.h"
+#include "CColorConverter.h"
 
 namespace irr
 {
+
+	//! decodes block bx,by into the slot
+	void sTextureBlockCache::fill ( u32 slot, u32 bx, u32 by )
+	{
+		using namespace video;
+
+		u32 pixels[16];
+		CBlockCompression::decodeBlock ( format, data + by * pitch + bx * blockSize, pixels );
+		CColorConverter::convert_viaFormat ( pixels, ECF_A8R8G8B8, 16,
+				texel[slot], BURNINGSHADER_COLOR_FORMAT );
+		tag[slot] = by << 16 | bx;
+	}
+
 namespace video
 {
 
@@ -31,6 +46,8 @@ namespace video
 		for ( u32 i = 0; i != BURNING_MATERIAL_MAX_TEXTURES; ++i )
 		{
 			IT[i].Texture = 0;
+			IT[i].blockCache = 0;
+			BlockCache[i] = 0;
 		}
 
 		if ( DepthBuffer )
@@ -51,6 +68,7 @@ namespace video
 		{
 			if ( IT[i].Texture )
 				IT[i].Texture->drop();
+			delete BlockCache[i];
 		}
 	}
 
@@ -77,10 +95,14 @@ namespace video
 	{
 		sInternalTexture *it = &IT[stage];
 
+		// the texture is held until here, so the same pointer is the same texture
+		const bool sameTexture = texture && it->Texture == texture;
+
 		if ( it->Texture)
 			it->Texture->drop();
 
 		it->Texture = texture;
+		it->blockCache = 0;
 
 		if ( it->Texture)
 		{
@@ -89,8 +111,11 @@ namespace video
 			// select mignify and magnify ( lodLevel )
 			//SOFTWARE_DRIVER_2_MIPMAPPING_LOD_BIAS
 			it->lodLevel = lodLevel;
-			it->data = (tVideoSample*) it->Texture->lock(true,
-				core::s32_clamp ( lodLevel + SOFTWARE_DRIVER_2_MIPMAPPING_LOD_BIAS, 0, SOFTWARE_DRIVER_2_MIPMAPPING_MAX - 1 ));
+			const s32 level = core::s32_clamp ( lodLevel + SOFTWARE_DRIVER_2_MIPMAPPING_LOD_BIAS, 0, SOFTWARE_DRIVER_2_MIPMAPPING_MAX - 1 );
+
+			// streaming loads the levels the rasterizer asks for
+			it->Texture->requestLevel ( level );
+			it->data = (tVideoSample*) it->Texture->lock(true, level);
 
 			// prepare for optimal fixpoint
 			it->pitchlog2 = s32_log2_s32 ( it->Texture->getPitch() );
@@ -98,6 +123,31 @@ namespace video
 			const core::dimension2d<u32> &dim = it->Texture->getSize();
 			it->textureXMask = s32_to_fixPoint ( dim.Width - 1 ) & FIX_POINT_UNSIGNED_MASK;
 			it->textureYMask = s32_to_fixPoint ( dim.Height - 1 ) & FIX_POINT_UNSIGNED_MASK;
+
+			// compressed textures are sampled through decoded blocks, they
+			// stay valid while the same mip level is drawn and not changed
+			const ECOLOR_FORMAT format = it->Texture->getTexture()->getColorFormat();
+			if ( IImage::isCompressedFormat ( format ) )
+			{
+				if ( !BlockCache[stage] )
+				{
+					BlockCache[stage] = new sTextureBlockCache;
+					BlockCache[stage]->data = 0;
+				}
+
+				sTextureBlockCache *cache = BlockCache[stage];
+				if ( !sameTexture || cache->data != it->data ||
+					cache->changeCount != it->Texture->getChangeCount() )
+				{
+					cache->format = format;
+					cache->data = (const u8*) it->data;
+					cache->pitch = it->Texture->getPitch();
+					cache->blockSize = CBlockCompression::getBlockSize ( format );
+					cache->changeCount = it->Texture->getChangeCount();
+					memset ( cache->tag, 0xFF, sizeof ( cache->tag ) );
+				}
+				it->blockCache = cache;
+			}
 		}
 	}
 
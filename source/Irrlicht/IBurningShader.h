@@ -111,6 +111,9 @@ namespace video
 		ETR_TEXTURE_GOURAUD_ALPHA_NOZ,
 
 		ETR_TEXTURE_BLEND,
+		ETR_STENCIL_SHADOW,
+		ETR_SHADOW_DEPTH,
+		ETR_TEXTURE_GOURAUD_SHADOW,
 		ETR_REFERENCE,
 		ETR_INVALID,
 
@@ -139,6 +142,9 @@ namespace video
 
 		virtual void setMaterial ( const SBurningShaderMaterial &material ) {};
 
+		//! sets the depth of the shadow map, the color and the strength of the shadow in alpha
+		virtual void setShadowMap ( video::IImage* depth, const SColor& color, f32 bias ) {};
+
 	protected:
 
 		video::CImage* RenderTarget;
@@ -146,6 +152,9 @@ namespace video
 
 		sInternalTexture IT[ BURNING_MATERIAL_MAX_TEXTURES ];
 
+		// owned, allocated for stages which sample block compressed textures
+		sTextureBlockCache* BlockCache[ BURNING_MATERIAL_MAX_TEXTURES ];
+
 		static const tFixPointu dithermask[ 4 * 4];
 	};
 
@@ -178,6 +187,10 @@ namespace video
 	IBurningShader* createTRTextureBlend(IDepthBuffer* zbuffer);
 	IBurningShader* createTRTextureInverseAlphaBlend(IDepthBuffer* zbuffer);
 
+	IBurningShader* createTRStencilShadow(IDepthBuffer* zbuffer, IStencilBuffer* stencil);
+	IBurningShader* createTRShadowDepth(IDepthBuffer* zbuffer);
+	IBurningShader* createTRTextureGouraudShadow2(IDepthBuffer* zbuffer);
+
 	IBurningShader* createTriangleRendererReference(IDepthBuffer* zbuffer);
 
 
@@ -44,6 +44,37 @@ namespace video
 	//! creates a ZBuffer
 	IDepthBuffer* createDepthBuffer(const core::dimension2d<u32>& size);
 
+
+	class IStencilBuffer : public virtual IReferenceCounted
+	{
+	public:
+
+		//! destructor
+		virtual ~IStencilBuffer() {};
+
+		//! clears the stencil buffer
+		virtual void clear() = 0;
+
+		//! sets the new size of the stencil buffer
+		virtual void setSize(const core::dimension2d<u32>& size) = 0;
+
+		//! returns the size of the stencil buffer
+		virtual const core::dimension2d<u32>& getSize() const = 0;
+
+		//! locks the stencil buffer
+		virtual void* lock() = 0;
+
+		//! unlocks the stencil buffer
+		virtual void unlock() = 0;
+
+		//! returns pitch of stencil buffer (in bytes)
+		virtual u32 getPitch() const = 0;
+	};
+
+
+	//! creates an 8 bit stencil buffer
+	IStencilBuffer* createStencilBuffer(const core::dimension2d<u32>& size);
+
 } // end namespace video
 } // end namespace irr
 
@@ -332,7 +332,10 @@ enum e4DVertexFlag
 
 	VERTEX4D_FORMAT_MASK_COLOR		= 0x00F00000,
 	VERTEX4D_FORMAT_COLOR_1			= 0x00100000,
-	VERTEX4D_FORMAT_COLOR_2			= 0x00200000
+	VERTEX4D_FORMAT_COLOR_2			= 0x00200000,
+
+	// Tex[1] and ShadowZ hold the position in the shadow map
+	VERTEX4D_FORMAT_SHADOW			= 0x01000000
 
 };
 
@@ -349,6 +352,7 @@ struct s4DVertex_proxy
 #endif
 
 	sVec2 Tex[BURNING_MATERIAL_MAX_TEXTURES];
+	f32 ShadowZ;
 	u32 flag;
 };
 
@@ -368,6 +372,9 @@ struct s4DVertex
 
 	sVec2 Tex[ BURNING_MATERIAL_MAX_TEXTURES ];
 
+	// depth as seen from the light, for shadow maps
+	f32 ShadowZ;
+
 	u32 flag;
 
 	u8 fill [ SIZEOF_SVERTEX - sizeof (s4DVertex_proxy) ];
@@ -394,6 +401,9 @@ struct s4DVertex
 			Tex[i].interpolate ( a.Tex[i], b.Tex[i], t );
 		}
 
+		if ( flag & VERTEX4D_FORMAT_SHADOW )
+			ShadowZ = b.ShadowZ + ( ( a.ShadowZ - b.ShadowZ ) * t );
+
 	}
 };
 
@@ -507,6 +517,9 @@ struct sScanConvertData
 	sVec2 t[BURNING_MATERIAL_MAX_TEXTURES][2];		// texture
 	sVec2 slopeT[BURNING_MATERIAL_MAX_TEXTURES][2];	// texture slope along edges
 
+	f32 s[2];			// shadow map depth
+	f32 slopeS[2];		// shadow map depth slope along edges
+
 };
 
 // passed to scan Line
@@ -526,6 +539,7 @@ struct sScanLineData
 #endif
 
 	sVec2 t[BURNING_MATERIAL_MAX_TEXTURES][2];		// texture start, texture end of scanline
+	f32 s[2];			// shadow map depth start, shadow map depth end of scanline
 };
 
 // passed to pixel Shader
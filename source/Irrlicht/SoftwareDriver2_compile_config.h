@@ -93,6 +93,12 @@
 
 #define SOFTWARE_DRIVER_2_MIPMAPPING_SCALE (8/SOFTWARE_DRIVER_2_MIPMAPPING_MAX)
 
+// filter for generated mip maps, ERF_KAISER gives sharper but slower mip maps
+#define SOFTWARE_DRIVER_2_MIPMAPPING_FILTER ERF_BOX
+
+// decoded 4x4 blocks kept per texture stage for block compressed textures, power of two
+#define SOFTWARE_DRIVER_2_BLOCK_CACHE_SIZE 64
+
 #ifndef REALINLINE
 	#ifdef _MSC_VER
 		#define REALINLINE __forceinline
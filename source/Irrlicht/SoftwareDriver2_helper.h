@@ -639,6 +639,26 @@ struct fp24
 
 // ------------------------ Internal Texture -----------------------------
 
+//! decoded blocks of a block compressed texture
+/** Direct mapped, neighbouring blocks use different slots, so the
+texels of a small screen area are decoded only once. */
+struct sTextureBlockCache
+{
+	video::ECOLOR_FORMAT format;
+	const u8* data;
+	u32 pitch;
+	u32 blockSize;
+
+	//! CSoftwareTexture2::getChangeCount() of the decoded blocks
+	u32 changeCount;
+
+	u32 tag[SOFTWARE_DRIVER_2_BLOCK_CACHE_SIZE];
+	tVideoSample texel[SOFTWARE_DRIVER_2_BLOCK_CACHE_SIZE][16];
+
+	//! decodes block bx,by into the slot
+	void fill ( u32 slot, u32 bx, u32 by );
+};
+
 struct sInternalTexture
 {
 	u32 textureXMask;
@@ -649,13 +669,36 @@ struct sInternalTexture
 
 	video::CSoftwareTexture2 *Texture;
 	s32 lodLevel;
+
+	// set for block compressed textures, data holds the blocks then
+	sTextureBlockCache *blockCache;
 };
 
 
+// get video sample from a block compressed texture
+inline tVideoSample getTexel_block ( const sInternalTexture * t, const tFixPointu tx, const tFixPointu ty )
+{
+	const u32 x = ( tx & t->textureXMask ) >> FIX_POINT_PRE;
+	const u32 y = ( ty & t->textureYMask ) >> FIX_POINT_PRE;
+	const u32 bx = x >> 2;
+	const u32 by = y >> 2;
+
+	sTextureBlockCache *cache = t->blockCache;
+	const u32 slot = ( bx ^ ( by << 3 ) ) & ( SOFTWARE_DRIVER_2_BLOCK_CACHE_SIZE - 1 );
+	if ( cache->tag[slot] != ( by << 16 | bx ) )
+		cache->fill ( slot, bx, by );
+
+	return cache->texel[slot][ ( y & 3 ) << 2 | ( x & 3 ) ];
+}
+
+
 
 // get video sample plain
 inline tVideoSample getTexel_plain ( const sInternalTexture * t, const tFixPointu tx, const tFixPointu ty )
 {
+	if ( t->blockCache )
+		return getTexel_block ( t, tx, ty );
+
 	u32 ofs;
 
 	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
@@ -670,14 +713,8 @@ inline void getTexel_fix ( tFixPoint &r, tFixPoint &g, tFixPoint &b,
 						const sInternalTexture * t, const tFixPointu tx, const tFixPointu ty
 								)
 {
-	u32 ofs;
-
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
-
 	// texel
-	tVideoSample t00;
-	t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
+	const tVideoSample t00 = getTexel_plain ( t, tx, ty );
 
 	r	 =	(t00 & MASK_R) >> ( SHIFT_R - FIX_POINT_PRE);
 	g	 =	(t00 & MASK_G) << ( FIX_POINT_PRE - SHIFT_G );
@@ -704,12 +741,8 @@ inline void getSample_texture_dither (	tFixPoint &r, tFixPoint &g, tFixPoint &b,
 	const tFixPointu _ntx = (tx + dithermask [ index ] ) & t->textureXMask;
 	const tFixPointu _nty = (ty + dithermask [ index ] ) & t->textureYMask;
 
-	u32 ofs;
-	ofs = ( ( _nty ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( _ntx ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
-
 	// texel
-	const tVideoSample t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
+	const tVideoSample t00 = getTexel_plain ( t, _ntx, _nty );
 
 	(tFixPointu &) r	 =	(t00 & MASK_R) >> ( SHIFT_R - FIX_POINT_PRE);
 	(tFixPointu &) g	 =	(t00 & MASK_G) << ( FIX_POINT_PRE - SHIFT_G );
@@ -728,13 +761,8 @@ inline void getSample_texture ( tFixPoint &r, tFixPoint &g, tFixPoint &b,
 						const sInternalTexture * t, const tFixPointu tx, const tFixPointu ty
 								)
 {
-	u32 ofs;
-
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
-
 	// texel
-	const tVideoSample t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
+	const tVideoSample t00 = getTexel_plain ( t, tx, ty );
 
 	(tFixPointu &) r	 =	(t00 & MASK_R) >> ( SHIFT_R - FIX_POINT_PRE);
 	(tFixPointu &) g	 =	(t00 & MASK_G) << ( FIX_POINT_PRE - SHIFT_G );
@@ -745,13 +773,8 @@ inline void getSample_texture ( tFixPointu &a, tFixPointu &r, tFixPointu &g, tFi
 						const sInternalTexture * t, const tFixPointu tx, const tFixPointu ty
 								)
 {
-	u32 ofs;
-
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
-
 	// texel
-	const tVideoSample t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
+	const tVideoSample t00 = getTexel_plain ( t, tx, ty );
 
 	(tFixPointu &)a	 =	(t00 & MASK_A) >> ( SHIFT_A - FIX_POINT_PRE);
 	(tFixPointu &)r	 =	(t00 & MASK_R) >> ( SHIFT_R - FIX_POINT_PRE);
@@ -767,14 +790,8 @@ REALINLINE void getSample_linear ( tFixPointu &r, tFixPointu &g, tFixPointu &b,
 								const sInternalTexture * t, const tFixPointu tx, const tFixPointu ty
 								)
 {
-	u32 ofs;
-
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
-
 	// texel
-	tVideoSample t00;
-	t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
+	const tVideoSample t00 = getTexel_plain ( t, tx, ty );
 
 	r	 =	(t00 & MASK_R) >> SHIFT_R;
 	g	 =	(t00 & MASK_G) >> SHIFT_G;
@@ -831,14 +848,8 @@ REALINLINE void getSample_linear ( tFixPointu &a, tFixPointu &r, tFixPointu &g,
 								const sInternalTexture * t, const tFixPointu tx, const tFixPointu ty
 								)
 {
-	u32 ofs;
-
-	ofs = ( ( ty & t->textureYMask ) >> FIX_POINT_PRE ) << t->pitchlog2;
-	ofs |= ( tx & t->textureXMask ) >> ( FIX_POINT_PRE - VIDEO_SAMPLE_GRANULARITY );
-
 	// texel
-	tVideoSample t00;
-	t00 = *((tVideoSample*)( (u8*) t->data + ofs ));
+	const tVideoSample t00 = getTexel_plain ( t, tx, ty );
 
 	a	 =	(t00 & MASK_A) >> SHIFT_A;
 	r	 =	(t00 & MASK_R) >> SHIFT_R;
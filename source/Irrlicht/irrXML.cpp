@@ -112,6 +112,16 @@ IRRLICHT_API IrrXMLReader* IRRCALLCONV createIrrXMLReader(IFileReadCallBack* cal
 }
 
 
+//! Creates an instance of an UFT-8 or ASCII character xml parser working on a text buffer.
+IRRLICHT_API IrrXMLReader* IRRCALLCONV createIrrXMLReaderInSitu(char* buffer, unsigned int size)
+{
+	if (!buffer)
+		return 0;
+
+	return new CXMLReaderImpl<char, IXMLBase>(buffer, size);
+}
+
+
 //! Creates an instance of an UTF-16 xml parser. 
 IRRLICHT_API IrrXMLReaderUTF16* IRRCALLCONV createIrrXMLReaderUTF16(const char* filename)
 {